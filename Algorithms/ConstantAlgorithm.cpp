@@ -69,7 +69,7 @@ void ConstantAlgorithm::findConstantWeightsEdges( InputData* pData,
       for (lIt = labels.begin(); lIt != labels.end(); ++lIt, l )
       {
          halfWeightsPerClass[ lIt->idx ] += lIt->weight;
-         halfEdges[ lIt->idx ] += lIt->weight * lIt->y;
+         halfEdges[ lIt->idx ] += lIt->weight * pData->getLabelY(i, *lIt);
       }
    }
 
@@ -70,7 +70,7 @@ void ConstantAlgorithmLSHTC::findConstantWeightsEdges( InputData* pData,
       for (lIt = labels.begin(); lIt != labels.end(); ++lIt, l )
       {
          halfWeightsPerClass[ lIt->idx ] += lIt->weight;
-         halfEdges[ lIt->idx ] += lIt->weight * lIt->y;
+         halfEdges[ lIt->idx ] += lIt->weight * pData->getLabelY(i, *lIt);
       }
    }
 
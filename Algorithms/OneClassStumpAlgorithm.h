@@ -129,7 +129,7 @@ namespace MultiBoost {
 			// recompute halfEdges at the next point
 			////// Bottleneck BEGIN
 			for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
-				this->_halfEdges[ lIt->idx ] -= lIt->weight * lIt->y;
+				this->_halfEdges[ lIt->idx ] -= lIt->weight * pData->getLabelY(previousSplitPos->first, *lIt);
 			////// Bottleneck END
 			
 			// points with the same value of data: to skip because we cannot find a cutting point here!
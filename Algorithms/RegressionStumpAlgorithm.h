@@ -268,7 +268,7 @@ namespace MultiBoost {
 			// recompute halfEdges at the next point
 			////// Bottleneck BEGIN
 			for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
-				_halfEdges[ lIt->idx ] -= lIt->weight * lIt->y;
+				_halfEdges[ lIt->idx ] -= lIt->weight * pData->getLabelY(previousSplitPos->first, *lIt);
 			////// Bottleneck END
 
 			// points with the same value of data: to skip because we cannot find a cutting point here!
@@ -415,7 +415,7 @@ namespace MultiBoost {
 			vector<Label>& labels = pData->getLabels(previousSplitPos->first);
 
 			for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
-				_halfEdges[ lIt->idx ] -= lIt->weight * lIt->y;
+				_halfEdges[ lIt->idx ] -= lIt->weight * pData->getLabelY(previousSplitPos->first, *lIt);
 
 			// points with the same value of data: to skip because we cannot find a cutting point here!
 			// so we only do the cutting if there is a "hole":
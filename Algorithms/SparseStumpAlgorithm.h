@@ -47,6 +47,7 @@
 #include "Others/Rates.h"
 #include "IO/NameMap.h"
 #include "Algorithms/ConstantAlgorithm.h"
+#include "Utils/Profiler.h" // for --profile
 
 using namespace std;
 
@@ -208,16 +209,12 @@ namespace MultiBoost {
 	{ 
 		const int numClasses = pData->getNumClasses();
 
-		vpIterator currentSplitPos1; // the iterator of the currently examined example
-		vpIterator previousSplitPos1; // the iterator of the example before the current example
-		vpIterator bestSplitPos1; // the iterator of the best split
-		vpIterator bestPreviousSplitPos1; // the iterator of the example before the best split
-
-		vpIterator currentSplitPos2; // the iterator of the currently examined example
-		vpIterator previousSplitPos2; // the iterator of the example before the current example
-		vpIterator bestSplitPos2; // the iterator of the best split
-		vpIterator bestPreviousSplitPos2; // the iterator of the example before the best split
-
+		vpIterator currentSplitPos; // the iterator of the currently examined example
+		vpIterator previousSplitPos; // the iterator of the example before the current example
+		vpIterator bestSplitPos1; // the iterator of the first split
+		vpIterator bestPreviousSplitPos1; // the iterator of the example before the first split
+		vpIterator bestSplitPos2; // the iterator of the best second split
+		vpIterator bestPreviousSplitPos2; // the iterator of the example before the best second split
 
 		// initialize halfEdges to the constant classifier's half edges 
 		copy(_constantEdges.begin(), _constantEdges.end(), _edges.begin());
@@ -229,73 +226,74 @@ namespace MultiBoost {
 		float currEdge = 0;
 		float bestEdge = -numeric_limits<float>::max();
 		vector<Label>::const_iterator lIt;
-		vector<float> tmpEdges(numClasses);
 
-		// find the best threshold (cutting point)
-		// at the first split we have
+		int numThresholds = 0; // the second splits evaluated (for --profile)
+
+		// The edges at the second split of a pair (t1, t2) are the constant edges
+		// minus the points before t2, whatever t1 is. The pairs were visited
+		// in the order of t1, then of t2, keeping the first maximum: that is the
+		// first split of the column as t1, and the first best split after it as t2.
+		// So a single sweep finds the same pair.
+		bool hasFirstSplit = false;
+
 		// first split: x | x x x x x x x x ..
 		//    previous -^   ^- current
-		for( currentSplitPos1 = previousSplitPos1 = dataBegin, ++currentSplitPos1;
-			currentSplitPos1 != dataEnd; 
-			previousSplitPos1 = currentSplitPos1, ++currentSplitPos1)
+		if ( dataBegin != dataEnd )
 		{
-			vector<Label>& labels1 = pData->getLabels(previousSplitPos1->first);
+			for( currentSplitPos = previousSplitPos = dataBegin, ++currentSplitPos;
+				currentSplitPos != dataEnd; 
+				previousSplitPos = currentSplitPos, ++currentSplitPos)
+			{
+				vector<Label>& labels = pData->getLabels(previousSplitPos->first);
 
-			// recompute edges at the next point
-			////// Bottleneck BEGIN
-			for (lIt = labels1.begin(); lIt != labels1.end(); ++lIt )
-				_edges[ lIt->idx ] -= lIt->weight * lIt->y;
-			////// Bottleneck END
+				// recompute edges at the next point
+				////// Bottleneck BEGIN
+				for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
+					_edges[ lIt->idx ] -= lIt->weight * pData->getLabelY(previousSplitPos->first, *lIt);
+				////// Bottleneck END
 
-			copy(_edges.begin(), _edges.end(), tmpEdges.begin());
+				// points with the same value of data: to skip because we cannot find a cutting point here!
+				// so we only do the cutting if there is a "hole":
+				if ( previousSplitPos->second == currentSplitPos->second ) 
+					continue;
 
-			// points with the same value of data: to skip because we cannot find a cutting point here!
-			// so we only do the cutting if there is a "hole":
-			if ( previousSplitPos1->second != currentSplitPos1->second ) 
-			{
-				for( currentSplitPos2 = previousSplitPos2 = currentSplitPos1, ++currentSplitPos2;
-					currentSplitPos2 != dataEnd; 
-					previousSplitPos2 = currentSplitPos2, ++currentSplitPos2)				
+				if ( !hasFirstSplit )
 				{
-					vector<Label>& labels2 = pData->getLabels(previousSplitPos2->first);
-
-					// recompute edges at the next point
-					////// Bottleneck BEGIN
-					for (lIt = labels2.begin(); lIt != labels2.end(); ++lIt )
-						tmpEdges[ lIt->idx ] -= lIt->weight * lIt->y;
-					////// Bottleneck END
-
-					if ( previousSplitPos2->second != currentSplitPos2->second ) 
-					{
-						currEdge = 0;
-
-						////// Bottleneck BEGIN
-						for (int l = 0; l < numClasses; ++l) { 
-							// flip the class-wise edge if it is negative
-							// but store the flipping bit only at the end (below**)
-							if ( tmpEdges[l] > 0 )
-								currEdge += tmpEdges[l];
-							else
-								currEdge -= tmpEdges[l];
-						}
-						////// Bottleneck END
-
-						// the current edge is the new maximum
-						if (currEdge > bestEdge)
-						{
-							bestEdge = currEdge;
-							bestSplitPos1 = currentSplitPos1; 
-							bestPreviousSplitPos1 = previousSplitPos1; 
-							bestSplitPos2 = currentSplitPos2; 
-							bestPreviousSplitPos2 = previousSplitPos2; 
-
-							for (int l = 0; l < numClasses; ++l)
-								_bestEdges[l] = tmpEdges[l];
-						}
-					} //endif
-				} // endfor
-			} // endif
-		} //endfor
+					hasFirstSplit = true;
+					bestSplitPos1 = currentSplitPos; 
+					bestPreviousSplitPos1 = previousSplitPos; 
+					continue;
+				}
+
+				++numThresholds;
+				currEdge = 0;
+
+				////// Bottleneck BEGIN
+				for (int l = 0; l < numClasses; ++l) { 
+					// flip the class-wise edge if it is negative
+					// but store the flipping bit only at the end (below**)
+					if ( _edges[l] > 0 )
+						currEdge += _edges[l];
+					else
+						currEdge -= _edges[l];
+				}
+				////// Bottleneck END
+
+				// the current edge is the new maximum
+				if (currEdge > bestEdge)
+				{
+					bestEdge = currEdge;
+					bestSplitPos2 = currentSplitPos; 
+					bestPreviousSplitPos2 = previousSplitPos; 
+
+					for (int l = 0; l < numClasses; ++l)
+						_bestEdges[l] = _edges[l];
+				}
+			} //endfor
+		}
+
+		Profiler::count( Profiler::CN_COLUMNS, 1 );
+		Profiler::count( Profiler::CN_THRESHOLDS, numThresholds );
 
 		// If we found a valid stump in this dimension
 		if (bestEdge >  -numeric_limits<float>::max()) 
@@ -44,9 +44,11 @@
 #include <cassert>
 
 #include "IO/InputData.h"
+#include "IO/SortedData.h"
 #include "Others/Rates.h"
 #include "IO/NameMap.h"
 #include "Algorithms/ConstantAlgorithm.h"
+#include "Utils/Profiler.h" // for --profile
 
 using namespace std;
 
@@ -55,6 +57,11 @@ namespace MultiBoost {
 	//////////////////////////////////////////////////////////////////////////
 	//////////////////////////////////////////////////////////////////////////
 
+	/**
+	* The number of positions the column walk prefetches ahead the labels of.
+	*/
+#define STUMP_PREFETCH_DISTANCE 8
+
 	/**
 	* Class specialized in solving decision stump-type algorithms.
 	* A decision stump is a decision tree with a single level.
@@ -74,7 +81,7 @@ namespace MultiBoost {
 		*/
 		typedef typename vector< pair<int, T> >::const_iterator cvpIterator;
 
-		StumpAlgorithm( int numClasses )
+		StumpAlgorithm( int numClasses ) : _denseLabels(false)
 		{
 			// resize: it's done here to avoid a reallocation
 			// for each dimension.
@@ -87,7 +94,9 @@ namespace MultiBoost {
 
 		/**
 		* Initilizes halfWeightsPerClass and constantHalfEdges for subsequent calls
-		* to findSingleThresholdWithInit or findMultiThresholdWithInit
+		* to findSingleThresholdWithInit or findMultiThresholdWithInit.
+		* It also gathers the labels and weights of the examples into a contiguous
+		* buffer used by the SortedColumn versions of the search.
 		* \param pData The pointer to the data class.
 		* \date 03/07/2006
 		*/
@@ -197,8 +206,62 @@ namespace MultiBoost {
 			vector<float>& thresholds,
 			vector<sRates>* pMu = NULL, vector<float>* pV = NULL);
 
+		/**
+		* Same as findSingleThresholdWithInit, but on a column in split form.
+		* The labels are not read from \a pData but from the buffer filled
+		* by initSearchLoop, so the column walk is a streaming pass over
+		* contiguous arrays.
+		* \param column The sorted column (see SortedData::getFilteredColumn()).
+		* \param pData The pointer to the original data class.
+		* \param halfTheta The half of the edge offset.
+		* \param pMu The The class-wise rates to update. (if provided)
+		* \param pV The alignment vector to update. (if provided)
+		* \return The threshold found, NaN if there is none.
+		* \see findSingleThresholdWithInit
+		*/
+		float findSingleThresholdWithInit(const SortedColumn& column,
+			InputData* pData,
+			float halfTheta,
+			vector<sRates>* pMu = NULL, vector<float>* pV = NULL);
+
+		/**
+		* Same as findMultiThresholdsWithInit, but on a column in split form.
+		* \param column The sorted column (see SortedData::getFilteredColumn()).
+		* \param pData The pointer to the original data class.
+		* \param thresholds The thresholds to update.
+		* \param pMu The The class-wise rates to update. (if provided)
+		* \param pV The alignment vector to update. (if provided)
+		* \see findMultiThresholdsWithInit
+		*/
+		void findMultiThresholdsWithInit(const SortedColumn& column,
+			InputData* pData, 
+			vector<float>& thresholds,
+			vector<sRates>* pMu = NULL, vector<float>* pV = NULL);
+
 	protected:
 
+		/**
+		* Subtract the weighted labels of example \a idx from _halfEdges,
+		* using the buffer filled by initSearchLoop.
+		* \param idx The index of the example.
+		*/
+		inline void removeExample(int idx)
+		{
+			if ( _denseLabels )
+			{
+				const float* pWeightedLabels = &_weightedLabels[ idx * _halfEdges.size() ];
+				const int numClasses = static_cast<int>( _halfEdges.size() );
+				for (int l = 0; l < numClasses; ++l)
+					_halfEdges[l] -= pWeightedLabels[l];
+			}
+			else
+			{
+				const int end = _labelOffsets[idx+1];
+				for (int k = _labelOffsets[idx]; k < end; ++k)
+					_halfEdges[ _labelIndices[k] ] -= _weightedLabels[k];
+			}
+		}
+
 		vector<float> _halfEdges; //!< half of the class-wise edges
 		vector<float> _constantHalfEdges; //!< half of the class-wise edges of the constant classifier
 		vector<float> _bestHalfEdges; //!< half of the edges of the best found threshold.
@@ -206,6 +269,17 @@ namespace MultiBoost {
 		vector<vpIterator> _bestSplitPoss; // the iterator of the best split
 		vector<vpIterator> _bestPreviousSplitPoss; // the iterator of the example before the best split
 
+		/**
+		* The labels of the examples multiplied by their weights (w * y), one
+		* contiguous block per example. If the labels are dense the block of 
+		* example i starts at i*numClasses and _labelOffsets/_labelIndices are
+		* not used, otherwise it starts at _labelOffsets[i].
+		*/
+		vector<float> _weightedLabels;
+		vector<int>   _labelOffsets; //!< The start of the block of each example (sparse labels only).
+		vector<int>   _labelIndices; //!< The class index of each element of _weightedLabels (sparse labels only).
+		bool          _denseLabels; //!< True if every example has all the labels in class order.
+
 	};
 
 	//////////////////////////////////////////////////////////////////////////
@@ -217,6 +291,61 @@ namespace MultiBoost {
 	{
 		ConstantAlgorithm cAlgo;
 		cAlgo.findConstantWeightsEdges(pData,_halfWeightsPerClass,_constantHalfEdges);
+
+		const int numExamples = pData->getNumExamples();
+		const int numClasses = pData->getNumClasses();
+		vector<Label>::const_iterator lIt;
+
+		// check whether the labels are dense (all the classes, in order)
+		_denseLabels = true;
+		for (int i = 0; i < numExamples && _denseLabels; ++i)
+		{
+			const vector<Label>& labels = pData->getLabels(i);
+			if ( static_cast<int>(labels.size()) != numClasses )
+				_denseLabels = false;
+			else
+			{
+				for (int l = 0; l < numClasses; ++l)
+				{
+					if ( labels[l].idx != l )
+					{
+						_denseLabels = false;
+						break;
+					}
+				}
+			}
+		}
+
+		_weightedLabels.clear();
+		_labelOffsets.clear();
+		_labelIndices.clear();
+
+		if ( _denseLabels )
+		{
+			_weightedLabels.resize( numExamples * numClasses );
+			float* pWeightedLabels = _weightedLabels.empty() ? NULL : &_weightedLabels[0];
+			for (int i = 0; i < numExamples; ++i)
+			{
+				const vector<Label>& labels = pData->getLabels(i);
+				for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
+					*pWeightedLabels++ = lIt->weight * pData->getLabelY(i, *lIt);
+			}
+		}
+		else
+		{
+			_labelOffsets.reserve( numExamples + 1 );
+			_labelOffsets.push_back( 0 );
+			for (int i = 0; i < numExamples; ++i)
+			{
+				const vector<Label>& labels = pData->getLabels(i);
+				for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
+				{
+					_labelIndices.push_back( lIt->idx );
+					_weightedLabels.push_back( lIt->weight * pData->getLabelY(i, *lIt) );
+				}
+				_labelOffsets.push_back( static_cast<int>( _weightedLabels.size() ) );
+			}
+		}
 	} // end of initSearchLoop
 
 	//////////////////////////////////////////////////////////////////////////
@@ -255,6 +384,8 @@ namespace MultiBoost {
 		float bestHalfEdge = -numeric_limits<float>::max();
 		vector<Label>::const_iterator lIt;
 
+		int numThresholds = 0; // the distinct values visited (for --profile)
+
 		// find the best threshold (cutting point)
 		// at the first split we have
 		// first split: x | x x x x x x x x ..
@@ -268,13 +399,14 @@ namespace MultiBoost {
 			// recompute halfEdges at the next point
 			////// Bottleneck BEGIN
 			for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
-				_halfEdges[ lIt->idx ] -= lIt->weight * lIt->y;
+				_halfEdges[ lIt->idx ] -= lIt->weight * pData->getLabelY(previousSplitPos->first, *lIt);
 			////// Bottleneck END
 
 			// points with the same value of data: to skip because we cannot find a cutting point here!
 			// so we only do the cutting if there is a "hole":
 			if ( previousSplitPos->second != currentSplitPos->second ) 
 			{
+				++numThresholds;
 
 				currHalfEdge = 0;
 
@@ -314,6 +446,9 @@ namespace MultiBoost {
 			}
 		}
 
+		Profiler::count( Profiler::CN_COLUMNS, 1 );
+		Profiler::count( Profiler::CN_THRESHOLDS, numThresholds );
+
 		// If we found a valid stump in this dimension
 		if (bestHalfEdge >  -numeric_limits<float>::max()) 
 		{
@@ -402,6 +537,8 @@ namespace MultiBoost {
 
 		vector<Label>::const_iterator lIt;
 
+		int numThresholds = 0; // the distinct values visited (for --profile)
+
 		// find the best threshold (cutting point)
 		// at the first split we have
 		// first split: x | x x x x x x x x ..
@@ -415,12 +552,13 @@ namespace MultiBoost {
 			vector<Label>& labels = pData->getLabels(previousSplitPos->first);
 
 			for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
-				_halfEdges[ lIt->idx ] -= lIt->weight * lIt->y;
+				_halfEdges[ lIt->idx ] -= lIt->weight * pData->getLabelY(previousSplitPos->first, *lIt);
 
 			// points with the same value of data: to skip because we cannot find a cutting point here!
 			// so we only do the cutting if there is a "hole":
 			if ( previousSplitPos->second != currentSplitPos->second ) 
 			{
+				++numThresholds;
 				for (int l = 0; l < numClasses; ++l)
 				{ 
 					if (_halfEdges[l] > 0)
@@ -449,6 +587,9 @@ namespace MultiBoost {
 			}
 		}
 
+		Profiler::count( Profiler::CN_COLUMNS, 1 );
+		Profiler::count( Profiler::CN_THRESHOLDS, numThresholds );
+
 		// Fill the mus if present. This could have been done in the threshold loop, 
 		// but here is done just once
 		if ( pMu ) 
@@ -470,6 +611,229 @@ namespace MultiBoost {
 
 	//////////////////////////////////////////////////////////////////////////
 
+	template <typename T> 
+	float StumpAlgorithm<T>::findSingleThresholdWithInit
+		(const SortedColumn& column, InputData* pData, float halfTheta, 
+		vector<sRates>* pMu, vector<float>* pV)
+	{ 
+		const int numClasses = pData->getNumClasses();
+		const int* indices = column.indices;
+		const float* values = column.values;
+		const int columnSize = column.size;
+
+		int bestSplitPos = -1; // the position of the best split
+
+		// initialize halfEdges to the constant classifier's half edges 
+		copy(_constantHalfEdges.begin(), _constantHalfEdges.end(), _halfEdges.begin());
+
+		float currHalfEdge = 0;
+		float bestHalfEdge = -numeric_limits<float>::max();
+
+		int numThresholds = 0; // the distinct values visited (for --profile)
+
+		// find the best threshold (cutting point)
+		// at the first split we have
+		// first split: x | x x x x x x x x ..
+		//    previous -^   ^- current
+		for (int curr = 1; curr < columnSize; ++curr)
+		{
+			const int prev = curr - 1;
+
+#ifdef __GNUC__
+			if ( curr + STUMP_PREFETCH_DISTANCE < columnSize )
+			{
+				const int ahead = indices[ curr + STUMP_PREFETCH_DISTANCE ];
+				if ( _denseLabels )
+					__builtin_prefetch( &_weightedLabels[ ahead * numClasses ] );
+				else
+					__builtin_prefetch( &_labelOffsets[ ahead ] );
+			}
+#endif
+
+			// recompute halfEdges at the next point
+			removeExample( indices[prev] );
+
+			// points with the same value of data: to skip because we cannot find a cutting point here!
+			// so we only do the cutting if there is a "hole":
+			if ( values[prev] != values[curr] ) 
+			{
+				++numThresholds;
+				currHalfEdge = 0;
+
+				if ( nor_utils::is_zero(halfTheta) ) { // we save an "if" in the loop, 20% faster
+					for (int l = 0; l < numClasses; ++l) { 
+						// flip the class-wise edge if it is negative
+						// but store the flipping bit only at the end (below**)
+						if ( _halfEdges[l] > 0 )
+							currHalfEdge += _halfEdges[l];
+						else
+							currHalfEdge -= _halfEdges[l];
+					}
+				}
+				else {
+					for (int l = 0; l < numClasses; ++l) { 
+						if ( _halfEdges[l] > halfTheta )
+							currHalfEdge += _halfEdges[l];
+						else if ( _halfEdges[l] < -halfTheta )
+							currHalfEdge -= _halfEdges[l];
+					}
+				}
+
+				// the current edge is the new maximum
+				if (currHalfEdge > bestHalfEdge)
+				{
+					bestHalfEdge = currHalfEdge;
+					bestSplitPos = curr; 
+
+					for (int l = 0; l < numClasses; ++l)
+						_bestHalfEdges[l] = _halfEdges[l];
+				}
+			}
+		}
+
+		Profiler::count( Profiler::CN_COLUMNS, 1 );
+		Profiler::count( Profiler::CN_THRESHOLDS, numThresholds );
+
+		// If we found a valid stump in this dimension
+		if (bestHalfEdge >  -numeric_limits<float>::max()) 
+		{
+			float threshold = static_cast<float>( values[bestSplitPos - 1] + 
+				values[bestSplitPos] ) / 2;
+
+			// Fill the mus if present.
+			if ( pMu ) 
+			{
+				for (int l = 0; l < numClasses; ++l)
+				{
+					// **here
+					if (_bestHalfEdges[l] > 0)
+						(*pV)[l] = +1;
+					else
+						(*pV)[l] = -1;
+
+					(*pMu)[l].classIdx = l;
+
+					(*pMu)[l].rPls  = _halfWeightsPerClass[l] + (*pV)[l] * _bestHalfEdges[l];
+					(*pMu)[l].rMin  = _halfWeightsPerClass[l] - (*pV)[l] * _bestHalfEdges[l];
+					(*pMu)[l].rZero = (*pMu)[l].rPls + (*pMu)[l].rMin; // == weightsPerClass[l]
+				}
+			}
+			return threshold;
+		}
+		else
+			return numeric_limits<float>::signaling_NaN();
+
+	} // end of findSingleThresholdWithInit
+
+	//////////////////////////////////////////////////////////////////////////
+
+	template <typename T> 
+	void StumpAlgorithm<T>::findMultiThresholdsWithInit
+		(const SortedColumn& column, InputData* pData, 
+		vector<float>& thresholds, vector<sRates>* pMu, vector<float>* pV)
+	{ 
+		const int numClasses = pData->getNumClasses();
+		const int* indices = column.indices;
+		const float* values = column.values;
+		const int columnSize = column.size;
+
+		// Initializing halfEdges to the constant classifier's half edges 
+		copy(_constantHalfEdges.begin(), _constantHalfEdges.end(), _halfEdges.begin());
+
+		// Initializing bestHalfEdges, thresholds, and pV to the constant classifier 
+		copy(_constantHalfEdges.begin(), _constantHalfEdges.end(), _bestHalfEdges.begin());
+		for (int l = 0; l < numClasses; ++l)
+			thresholds[l] = -numeric_limits<float>::max(); // constant cut
+
+		bool alignAlloc = false;
+		if (pV == NULL)
+		{
+			pV = new vector<float>(numClasses);
+			alignAlloc = true;
+		}
+
+		int numThresholds = 0; // the distinct values visited (for --profile)
+
+		for (int l = 0; l < numClasses; ++l)
+		{
+			if (_halfEdges[l] > 0) // constant cut
+				(*pV)[l] = 1;
+			else
+				(*pV)[l] = -1;
+		}
+
+		for (int curr = 1; curr < columnSize; ++curr)
+		{
+			const int prev = curr - 1;
+
+#ifdef __GNUC__
+			if ( curr + STUMP_PREFETCH_DISTANCE < columnSize )
+			{
+				const int ahead = indices[ curr + STUMP_PREFETCH_DISTANCE ];
+				if ( _denseLabels )
+					__builtin_prefetch( &_weightedLabels[ ahead * numClasses ] );
+				else
+					__builtin_prefetch( &_labelOffsets[ ahead ] );
+			}
+#endif
+
+			// recompute halfEdges at the next point
+			removeExample( indices[prev] );
+
+			// points with the same value of data: to skip because we cannot find a cutting point here!
+			// so we only do the cutting if there is a "hole":
+			if ( values[prev] != values[curr] ) 
+			{
+				++numThresholds;
+				for (int l = 0; l < numClasses; ++l)
+				{ 
+					if (_halfEdges[l] > 0)
+					{
+						// the current edge is the new maximum
+						if (_halfEdges[l] > _bestHalfEdges[l] * (*pV)[l]) 
+						{
+							(*pV)[l] = 1;
+							_bestHalfEdges[l] = _halfEdges[l];
+							thresholds[l] = static_cast<float>( values[prev] + values[curr] ) / 2;
+						}
+					}
+					else
+					{
+						// the current edge is the new maximum
+						if (-_halfEdges[l] > _bestHalfEdges[l] * (*pV)[l]) 
+						{
+							(*pV)[l] = -1;
+							_bestHalfEdges[l] = _halfEdges[l];
+							thresholds[l] = static_cast<float>( values[prev] + values[curr] ) / 2;
+						}
+					}
+				}
+			}
+		}
+
+		Profiler::count( Profiler::CN_COLUMNS, 1 );
+		Profiler::count( Profiler::CN_THRESHOLDS, numThresholds );
+
+		// Fill the mus if present.
+		if ( pMu ) 
+		{
+			for (int l = 0; l < numClasses; ++l)
+			{	    
+				(*pMu)[l].classIdx = l;
+
+				(*pMu)[l].rPls  = _halfWeightsPerClass[l] + (*pV)[l] * _bestHalfEdges[l];
+				(*pMu)[l].rMin  = _halfWeightsPerClass[l] - (*pV)[l] * _bestHalfEdges[l];
+				(*pMu)[l].rZero = (*pMu)[l].rPls + (*pMu)[l].rMin; // == weightsPerClass[l]
+			}
+		}
+
+		if (alignAlloc)
+			delete pV;
+
+	} // end of findMultiThresholdWithInit (SortedColumn)
+
+	//////////////////////////////////////////////////////////////////////////
+
 } // end of namespace MultiBoost
 
 #endif // __STUMP_ALGORITHM_H
@@ -75,6 +75,7 @@ namespace MultiBoost {
 		typedef typename vector< pair<int, T> >::const_reverse_iterator cvpReverseIterator;
 
 		StumpAlgorithmLSHTC( int numClasses )
+			: _constantEdgeSum(0), _constantEdgeSumHalfTheta(0), _isConstantEdgeSumValid(false)
 		{
 			// resize: it's done here to avoid a reallocation
 			// for each dimension.
@@ -85,6 +86,7 @@ namespace MultiBoost {
 			//_bestHalfEdgesNegative.resize(numClasses);
 			_halfWeightsPerClass.resize(numClasses);   
 			//_edgeOfZeroElements.resize(numClasses);
+			_isTouched.resize(numClasses, 0);
 		}
 
 		/**
@@ -209,6 +211,67 @@ namespace MultiBoost {
 		vector<vpReverseIterator> _bestSplitPoss; // the iterator of the best split
 		vector<vpReverseIterator> _bestPreviousSplitPoss; // the iterator of the example before the best split
 
+		/**
+		* The contribution of a class-wise half edge to the edge of a split in
+		* findSingleThresholdWithInit.
+		* \date 18/10/2026
+		*/
+		static float edgeContribution(float halfEdge, float halfTheta, bool zeroTheta)
+		{
+			// flip the class-wise edge if it is negative
+			if ( zeroTheta )
+				return ( halfEdge > 0 ) ? -halfEdge : halfEdge;
+			else if ( halfEdge < halfTheta )
+				return halfEdge;
+			else if ( halfEdge < -halfTheta )
+				return -halfEdge;
+			return 0;
+		}
+
+		/**
+		* Add the labels of an example to _halfEdges, and mark the classes touched.
+		* \return The change of the sum of the contributions of the classes.
+		* \date 18/10/2026
+		*/
+		double addLabels(InputData* pData, int idx, float halfTheta, bool zeroTheta)
+		{
+			const vector<Label>& labels = pData->getLabels(idx);
+			double change = 0;
+			for (vector<Label>::const_iterator lIt = labels.begin(); lIt != labels.end(); ++lIt )
+			{
+				const int l = lIt->idx;
+				if ( !_isTouched[l] )
+				{
+					_isTouched[l] = 1;
+					_touchedClasses.push_back(l);
+				}
+				change -= edgeContribution( _halfEdges[l], halfTheta, zeroTheta );
+				_halfEdges[l] += lIt->weight * pData->getLabelY(idx, *lIt);
+				change += edgeContribution( _halfEdges[l], halfTheta, zeroTheta );
+			}
+			return change;
+		}
+
+		/**
+		* Reset the touched classes of _halfEdges to the neg of the constant edge.
+		* \date 18/10/2026
+		*/
+		void restoreHalfEdges()
+		{
+			for (vector<int>::const_iterator it = _touchedClasses.begin(); it != _touchedClasses.end(); ++it)
+			{
+				_halfEdges[*it] = -_constantHalfEdges[*it];
+				_isTouched[*it] = 0;
+			}
+			_touchedClasses.clear();
+		}
+
+		vector<int> _touchedClasses; //!< The classes of _halfEdges changed since the last restoreHalfEdges()
+		vector<char> _isTouched; //!< The flags of _touchedClasses.
+		double _constantEdgeSum; //!< The sum of the contributions of the classes of the constant edge.
+		float _constantEdgeSumHalfTheta; //!< The halfTheta of _constantEdgeSum.
+		bool _isConstantEdgeSumValid;
+
 	};
 
 	//////////////////////////////////////////////////////////////////////////
@@ -220,6 +283,13 @@ namespace MultiBoost {
 	{
 		ConstantAlgorithmLSHTC cAlgo;
 		cAlgo.findConstantWeightsEdges(pData,_halfWeightsPerClass,_constantHalfEdges);
+
+		// neg of the constant edge because the reverse iteration
+		for( int i=0 ; i < _constantHalfEdges.size(); i++ ) _halfEdges[i] = -_constantHalfEdges[i];
+		for (vector<int>::const_iterator it = _touchedClasses.begin(); it != _touchedClasses.end(); ++it)
+			_isTouched[*it] = 0;
+		_touchedClasses.clear();
+		_isConstantEdgeSumValid = false;
 	} // end of initSearchLoop
 
 	//////////////////////////////////////////////////////////////////////////
@@ -296,13 +366,28 @@ namespace MultiBoost {
 		vpReverseIterator bestSplitPos; // the iterator of the best split
 		vpReverseIterator bestPreviousSplitPos; // the iterator of the example before the best split
 
-		// initialize halfEdges to the constant classifier's half edges 
-		//copy(_constantHalfEdges.begin(), _constantHalfEdges.end(), _halfEdges.begin());
-		for( int i=0 ; i < _constantHalfEdges.size(); i++ ) _halfEdges[i] = -_constantHalfEdges[i]; // neg of the constant edge because the reverse iteration
+		// _halfEdges holds the neg of the constant edge between the scans (because the 
+		// reverse iteration), only the classes touched by the scan are restored at its end.
+		// The edge of a split is the sum of the class-wise contributions, kept up to date
+		// as the labels are added, so a split costs the labels of one example, not numClasses.
+		// The running sum is a double, not the float sum over the classes of each split, 
+		// so among splits whose edges differ by a rounding error another one can be chosen.
+		const bool zeroTheta = nor_utils::is_zero(halfTheta);
+		if ( !_isConstantEdgeSumValid || _constantEdgeSumHalfTheta != halfTheta )
+		{
+			_constantEdgeSum = 0;
+			for (int l = 0; l < numClasses; ++l)
+				_constantEdgeSum += edgeContribution( _halfEdges[l], halfTheta, zeroTheta );
+			_constantEdgeSumHalfTheta = halfTheta;
+			_isConstantEdgeSumValid = true;
+		}
+		double halfEdgeSum = _constantEdgeSum;
 
 		float currHalfEdge = 0;
 		float bestHalfEdge = -numeric_limits<float>::max();
-		vector<Label>::const_iterator lIt;
+		int numAdded = 0; // the number of examples added to the edges so far
+		int bestNumAdded = 0; // the number of examples added at the best split
+		bool bestIsLast = false; // the best split is the one after the last non-zero element
 		
 		int currentDataIndex = 0;
 		float currentDataValue = 0.0;
@@ -316,44 +401,15 @@ namespace MultiBoost {
 			currentSplitPos != dataEnd; 
 			previousSplitPos = currentSplitPos, currentDataIndex = currentSplitPos->first, currentDataValue = currentSplitPos->second, ++currentSplitPos, i++ )
 		{
-			//cout << previousSplitPos->first << endl;
-			vector<Label>& labels = pData->getLabels(previousSplitPos->first);
-
 			// recompute halfEdges at the next point
-			////// Bottleneck BEGIN
-			for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
-				_halfEdges[ lIt->idx ] += lIt->weight * lIt->y;
-			////// Bottleneck END
+			halfEdgeSum += addLabels( pData, previousSplitPos->first, halfTheta, zeroTheta );
+			++numAdded;
 
 			// points with the same value of data: to skip because we cannot find a cutting point here!
 			// so we only do the cutting if there is a "hole":
 			if ( previousSplitPos->second != currentSplitPos->second ) 
 			{
-
-				currHalfEdge = 0;
-
-				////// Bottleneck BEGIN
-				if ( nor_utils::is_zero(halfTheta) ) { // we save an "if" in the loop, 20% faster
-					for (int l = 0; l < numClasses; ++l) { 
-						// flip the class-wise edge if it is negative
-						// but store the flipping bit only at the end (below**)
-						if ( _halfEdges[l] > 0 )
-							currHalfEdge -= _halfEdges[l];
-						else
-							currHalfEdge += _halfEdges[l];
-					}
-				}
-				else {
-					for (int l = 0; l < numClasses; ++l) { 
-						// flip the class-wise edge if it is negative
-						// but store the flipping bit only at the end (below**)
-						if ( _halfEdges[l] < halfTheta )
-							currHalfEdge += _halfEdges[l];
-						else if ( _halfEdges[l] < -halfTheta )
-							currHalfEdge -= _halfEdges[l];
-					}
-				}
-				////// Bottleneck END
+				currHalfEdge = static_cast<float>( halfEdgeSum );
 
 				// the current edge is the new maximum
 				if (currHalfEdge > bestHalfEdge)
@@ -361,63 +417,26 @@ namespace MultiBoost {
 					bestHalfEdge = currHalfEdge;
 					bestSplitPos = currentSplitPos; 
 					bestPreviousSplitPos = previousSplitPos; 
-
-					for (int l = 0; l < numClasses; ++l)
-						_bestHalfEdges[l] = _halfEdges[l];
+					bestNumAdded = numAdded;
 				}
 			}
 		}
 
 		// we need to store the split position in float because the iterator don't acces the non-zero elements
 		
-		float bestPreviousSplitPosFloat;
-		float bestSplitPosFloat; 
+		float bestPreviousSplitPosFloat = 0.0;
+		float bestSplitPosFloat = 0.0; 
 		
 		if (bestHalfEdge > -numeric_limits<float>::max()) { //there is only one non-zeru value
 			bestPreviousSplitPosFloat = bestPreviousSplitPos->second;
 			bestSplitPosFloat = bestSplitPos->second; 
-		} else {
-			//currentDataValue = dataBegin->second;
-			//currentDataIndex = dataBegin->first;
-			//bestPreviousSplitPosFloat = 0.0;
-			//bestSplitPosFloat = 1.0; 
 		}
 
-
 		// dataEnd will contain the smallest value wich isn't equal to zero
 		// the edge of this element will be extracted
-		vector<Label>& labelsLast = pData->getLabels( currentDataIndex );
-
-		// recompute halfEdges at the next point
-		////// Bottleneck BEGIN
-		for (lIt = labelsLast.begin(); lIt != labelsLast.end(); ++lIt )
-			_halfEdges[ lIt->idx ] += lIt->weight * lIt->y;
-		////// Bottleneck END
-
-		currHalfEdge = 0;
-
-		////// Bottleneck BEGIN
-		if ( nor_utils::is_zero(halfTheta) ) { // we save an "if" in the loop, 20% faster
-			for (int l = 0; l < numClasses; ++l) { 
-				// flip the class-wise edge if it is negative
-				// but store the flipping bit only at the end (below**)
-				if ( _halfEdges[l] > 0 )
-					currHalfEdge -= _halfEdges[l];
-				else
-					currHalfEdge += _halfEdges[l];
-			}
-		}
-		else {
-			for (int l = 0; l < numClasses; ++l) { 
-				// flip the class-wise edge if it is negative
-				// but store the flipping bit only at the end (below**)
-				if ( _halfEdges[l] < halfTheta )
-					currHalfEdge += _halfEdges[l];
-				else if ( _halfEdges[l] < -halfTheta )
-					currHalfEdge -= _halfEdges[l];
-			}
-		}
-		////// Bottleneck END
+		halfEdgeSum += addLabels( pData, currentDataIndex, halfTheta, zeroTheta );
+
+		currHalfEdge = static_cast<float>( halfEdgeSum );
 
 		// the current edge is the new maximum
 		if (currHalfEdge > bestHalfEdge)
@@ -425,9 +444,7 @@ namespace MultiBoost {
 			bestHalfEdge = currHalfEdge;
 			bestPreviousSplitPosFloat = currentDataValue;
 			bestSplitPosFloat = 0.0; 
-			
-			for (int l = 0; l < numClasses; ++l)
-				_bestHalfEdges[l] = _halfEdges[l];
+			bestIsLast = true;
 		}
 		//end of the investigation of the last non-zero elements		
 
@@ -440,26 +457,41 @@ namespace MultiBoost {
 			// but here is done just once
 			if ( pMu ) 
 			{
+				// replay the examples up to the best split (in the same order, so the 
+				// class-wise edges are the same as they were there)
+				if ( !bestIsLast ) 
+				{
+					restoreHalfEdges();
+					vpReverseIterator replayPos = dataBegin;
+					for (int k = 0; k < bestNumAdded; ++k, ++replayPos)
+						addLabels( pData, replayPos->first, halfTheta, zeroTheta );
+				}
+
 				for (int l = 0; l < numClasses; ++l)
 				{
 					// **here
-					if (_bestHalfEdges[l] > 0)
+					if (_halfEdges[l] > 0)
 						(*pV)[l] = +1;
 					else
 						(*pV)[l] = -1;
 
 					(*pMu)[l].classIdx = l;
 
-					(*pMu)[l].rPls  = _halfWeightsPerClass[l] + (*pV)[l] * _bestHalfEdges[l];
-					(*pMu)[l].rMin  = _halfWeightsPerClass[l] - (*pV)[l] * _bestHalfEdges[l];
+					(*pMu)[l].rPls  = _halfWeightsPerClass[l] + (*pV)[l] * _halfEdges[l];
+					(*pMu)[l].rMin  = _halfWeightsPerClass[l] - (*pV)[l] * _halfEdges[l];
 					(*pMu)[l].rZero = (*pMu)[l].rPls + (*pMu)[l].rMin; // == weightsPerClass[l]
 				}
 			}
+			restoreHalfEdges();
+
 			//cout << 2 * bestHalfEdge << endl << flush;
 			return threshold;
 		}
 		else
+		{
+			restoreHalfEdges();
 			return numeric_limits<float>::signaling_NaN();
+		}
 
 	} // end of findSingleThresholdWithInit
 
@@ -531,7 +563,7 @@ namespace MultiBoost {
 			vector<Label>& labels = pData->getLabels(previousSplitPos->first);
 
 			for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
-				_halfEdges[ lIt->idx ] -= lIt->weight * lIt->y;
+				_halfEdges[ lIt->idx ] -= lIt->weight * pData->getLabelY(previousSplitPos->first, *lIt);
 
 			// points with the same value of data: to skip because we cannot find a cutting point here!
 			// so we only do the cutting if there is a "hole":
@@ -57,6 +57,7 @@ namespace MultiBoost {
 class ExampleResults;
 class InputData;
 class BaseLearner;
+class EvaluationOutput;
 
 /**
 * Classify a dataset with AdaBoost.MH learner.
@@ -157,6 +158,20 @@ public:
    void saveROC(const string& dataFileName, const string& shypFileName,
                        const string& outFileName, int numIterations);
 
+   /**
+   * Evaluate the strong hypothesis on the data with a single pass over the
+   * weak hypotheses, and write all the given outputs (posteriors, likelihood, ROC...).
+   * The step-by-step information is also written if --outputinfo is set.
+   * \param dataFileName The file name of the data to be classified.
+   * \param shypFileName The strong hypothesis filename.
+   * \param numIterations The number of weak learners to use.
+   * \param outputs The outputs to be written. They are deleted, and the vector is cleared.
+   * \see IncrementalEvaluator
+   * \date 18/10/2026
+   */
+   void evaluate(const string& dataFileName, const string& shypFileName,
+                 int numIterations, vector<EvaluationOutput*>& outputs);
+
 
    /**
    * Save the data generated by using the strong hypothesis file of 
@@ -218,10 +233,7 @@ protected:
    virtual void computeResults(InputData* pData, vector<BaseLearner*>& weakHypotheses, 
                        vector< ExampleResults* >& results, int numIterations );
 
-	
-   virtual void continueComputingResults(InputData* pData, vector<BaseLearner*>& weakHypotheses, 
-					   vector< ExampleResults* >& results, int fromIteration, int toIteration);
-	
+		
    /**
    * Compute the overall error on the data.
    * \param pData A pointer to the data. Needed to get the actual class of 
@@ -38,9 +38,9 @@
 #include "IO/InputData.h"
 #include "Utils/Utils.h"
 #include "IO/Serialization.h"
-#include "IO/OutputInfo.h"
 #include "Classifiers/FilterBoostClassifier.h"
 #include "Classifiers/ExampleResults.h"
+#include "Classifiers/IncrementalEvaluator.h"
 
 #include "WeakLearners/SingleStumpLearner.h" // for saveSingleStumpFeatureData
 
@@ -334,8 +334,8 @@ namespace MultiBoost {
 
 	// -------------------------------------------------------------------------
 
-	void FilterBoostClassifier::savePosteriors(const string& dataFileName, const string& shypFileName, 
-		const string& outFileName, int numIterations)
+	void FilterBoostClassifier::evaluate(const string& dataFileName, const string& shypFileName, 
+		int numIterations, vector<EvaluationOutput*>& outputs)
 	{
 		InputData* pData = loadInputData(dataFileName, shypFileName);
 
@@ -357,38 +357,25 @@ namespace MultiBoost {
 		if (_verbose > 0)
 			cout << "Classifying..." << flush;
 
-		// get the results
-		computeResults( pData, weakHypotheses, results, numIterations );
-
-		const int numClasses = pData->getNumClasses();
-		const int numExamples = pData->getNumExamples();
+		// a single pass over the weak hypotheses for all the outputs
+		IncrementalEvaluator evaluator(pData, results);
 
-		ofstream outFile(outFileName.c_str());
-		string exampleName;
+		vector<EvaluationOutput*>::iterator oIt;
+		for (oIt = outputs.begin(); oIt != outputs.end(); ++oIt)
+			evaluator.addOutput( *oIt );
+		outputs.clear();
 
-		if (_verbose > 0)
-			cout << "Output posteriors..." << flush;
+		if ( !_outputInfoFile.empty() )
+			evaluator.addErrorCurve( _outputInfoFile, false );
 
-		for (int i = 0; i < numExamples; ++i)
-		{
-			// output the name if it exists, otherwise the number
-			// of the example
-			exampleName = pData->getExampleName(i);
-			if ( !exampleName.empty() )
-				outFile << exampleName << ',';
-
-			// output the posteriors
-			outFile << results[i]->getVotesVector()[0];
-			for (int l = 1; l < numClasses; ++l)
-				outFile << ',' << results[i]->getVotesVector()[l];
-			outFile << '\n';
-		}
+		evaluator.run( weakHypotheses, numIterations );
 
 		if (_verbose > 0)
 			cout << "Done!" << endl;
 
 		if (_verbose > 1)
 		{
+			const int numClasses = pData->getNumClasses();
 			cout << "\nClass order (You can change it in the header of the data file):" << endl;
 			for (int l = 0; l < numClasses; ++l)
 				cout << "- " << pData->getClassMap().getNameFromIdx(l) << endl;
@@ -403,394 +390,44 @@ namespace MultiBoost {
 			delete (*it);
 	}
 
-
 	// -------------------------------------------------------------------------
 
-
-	void FilterBoostClassifier::saveCalibratedPosteriors(const string& dataFileName, const string& shypFileName, 
+	void FilterBoostClassifier::savePosteriors(const string& dataFileName, const string& shypFileName, 
 		const string& outFileName, int numIterations)
 	{
-		InputData* pData = loadInputData(dataFileName, shypFileName);
-
-		if (_verbose > 0)
-			cout << "Loading strong hypothesis..." << flush;
-
-		// The class that loads the weak hypotheses
-		UnSerialization us;
-
-		// Where to put the weak hypotheses
-		vector<BaseLearner*> weakHypotheses;
-
-		// loads them
-		us.loadHypotheses(shypFileName, weakHypotheses, pData);
-
-		// where the results go
-		vector< ExampleResults* > results;
-
-		if (_verbose > 0)
-			cout << "Classifying..." << flush;
-
-		// get the results
-		computeResults( pData, weakHypotheses, results, numIterations );
-
-		const int numClasses = pData->getNumClasses();
-		const int numExamples = pData->getNumExamples();
-
-		ofstream outFile(outFileName.c_str());
-		string exampleName;
-
-		if (_verbose > 0)
-			cout << "Output posteriors..." << flush;
-
-		for (int i = 0; i < numExamples; ++i)
-		{
-			// output the name if it exists, otherwise the number
-			// of the example
-			exampleName = pData->getExampleName(i);
-			if ( !exampleName.empty() )
-				outFile << exampleName << ',';
-
-			// output the posteriors
-			outFile << results[i]->getVotesVector()[0];
-			for (int l = 1; l < numClasses; ++l)
-				outFile << ',' << results[i]->getVotesVector()[l];
-			outFile << '\n';
-		}
-
-		if (_verbose > 0)
-			cout << "Done!" << endl;
-
-		if (_verbose > 1)
-		{
-			cout << "\nClass order (You can change it in the header of the data file):" << endl;
-			for (int l = 0; l < numClasses; ++l)
-				cout << "- " << pData->getClassMap().getNameFromIdx(l) << endl;
-		}
-
-		// delete the input data file
-		if (pData) 
-			delete pData;
-
-		vector<ExampleResults*>::iterator it;
-		for (it = results.begin(); it != results.end(); ++it)
-			delete (*it);
+		vector<EvaluationOutput*> outputs;
+		outputs.push_back( new PosteriorsOutput(outFileName, numIterations, 0, _verbose) );
+		evaluate(dataFileName, shypFileName, numIterations, outputs);
 	}
 
+	// -------------------------------------------------------------------------
 
+	void FilterBoostClassifier::saveCalibratedPosteriors(const string& dataFileName, const string& shypFileName, 
+		const string& outFileName, int numIterations)
+	{
+		vector<EvaluationOutput*> outputs;
+		outputs.push_back( new PosteriorsOutput(outFileName, numIterations, 0, _verbose) );
+		evaluate(dataFileName, shypFileName, numIterations, outputs);
+	}
 
 	// -------------------------------------------------------------------------
 
 	void FilterBoostClassifier::saveLikelihoods(const string& dataFileName, const string& shypFileName, 
 		const string& outFileName, int numIterations)
 	{
-		InputData* pData = loadInputData(dataFileName, shypFileName);
-
-		if (_verbose > 0)
-			cout << "Loading strong hypothesis..." << flush;
-
-		// The class that loads the weak hypotheses
-		UnSerialization us;
-
-		// Where to put the weak hypotheses
-		vector<BaseLearner*> weakHypotheses;
-
-		// loads them
-		us.loadHypotheses(shypFileName, weakHypotheses, pData);
-
-		// where the results go
-		vector< ExampleResults* > results;
-
-		if (_verbose > 0)
-			cout << "Classifying..." << flush;
-
-		const int numClasses = pData->getNumClasses();
-		const int numExamples = pData->getNumExamples();
-
-
-		ofstream outFile(outFileName.c_str());
-		string exampleName;
-
-		if (_verbose > 0)
-			cout << "Output likelihoods..." << flush;
-
-		// get the results
-		/////////////////////////////////////////////////////////////////////
-		// computeResults( pData, weakHypotheses, results, numIterations );
-		assert( !weakHypotheses.empty() );
-
-		// Initialize the output info
-		OutputInfo* pOutInfo = NULL;
-
-		if ( !_outputInfoFile.empty() )
-			pOutInfo = new OutputInfo(_outputInfoFile);
-
-		// Creating the results structures. See file Structures.h for the
-		// PointResults structure
-		results.clear();
-		results.reserve(numExamples);
-		for (int i = 0; i < numExamples; ++i)
-			results.push_back( new ExampleResults(i, numClasses) );
-
-		// sum votes for classes
-		vector< float > votesForExamples( numClasses );
-		vector< double > expVotesForExamples( numClasses );
-
-		// iterator over all the weak hypotheses
-		vector<BaseLearner*>::const_iterator whyIt;
-		int t;
-
-		pOutInfo->initialize( pData );
-
-		// for every feature: 1..T
-		for (whyIt = weakHypotheses.begin(), t = 0; 
-			whyIt != weakHypotheses.end() && t < numIterations; ++whyIt, ++t)
-		{
-			BaseLearner* currWeakHyp = *whyIt;
-			float alpha = currWeakHyp->getAlpha();
-
-			// for every point
-			for (int i = 0; i < numExamples; ++i)
-			{
-				// a reference for clarity and speed
-				vector<float>& currVotesVector = results[i]->getVotesVector();
-
-				// for every class
-				for (int l = 0; l < numClasses; ++l)
-					currVotesVector[l] += alpha * currWeakHyp->classify(pData, i, l);
-			}
-
-			// if needed output the step-by-step information
-			if ( pOutInfo )
-			{
-				pOutInfo->outputIteration(t);
-				pOutInfo->outputError(pData, currWeakHyp);
-
-				// Margins and edge requires an update of the weight,
-				// therefore I keep them out for the moment
-				//outInfo.outputMargins(pData, currWeakHyp);
-				//outInfo.outputEdge(pData, currWeakHyp);
-				pOutInfo->endLine();
-			} // for (int i = 0; i < numExamples; ++i)
-			// calculate likelihoods from votes
-
-			fill( votesForExamples.begin(), votesForExamples.end(), 0.0 );
-			double lLambda = 0.0;
-			for (int i = 0; i < numExamples; ++i)
-			{
-				// a reference for clarity and speed
-				vector<float>& currVotesVector = results[i]->getVotesVector();
-				double sumExp = 0.0;
-				// for every class
-				for (int l = 0; l < numClasses; ++l) 
-				{				 
-					expVotesForExamples[l] =  exp( currVotesVector[l] ) ;
-					sumExp += expVotesForExamples[l];
-				}			
-
-				if ( sumExp > numeric_limits<double>::epsilon() ) 
-				{
-					for (int l = 0; l < numClasses; ++l) 
-					{
-						expVotesForExamples[l] /= sumExp;
-					}
-				}
-
-				Example ex = pData->getExample( results[i]->getIdx() );
-				vector<Label> labs = ex.getLabels();
-				double m = numeric_limits<double>::infinity();
-				for (int l = 0; l < numClasses; ++l)  
-				{
-					if ( labs[l].y > 0 )
-					{
-						if ( expVotesForExamples[l] > numeric_limits<double>::epsilon() )
-						{
-							double logVal = log( expVotesForExamples[l] );
-							
-							if ( logVal != m ) {
-								lLambda += ( ( 1.0/(double)numExamples ) * logVal );
-							}
-						}
-					}
-				}
-
-
-			}
-			
-
-			outFile << t << "\t" << lLambda ;
-			outFile << '\n';
-			
-			outFile.flush();
-		}
-
-		if (pOutInfo)
-			delete pOutInfo;
-
-		// computeResults( pData, weakHypotheses, results, numIterations );
-		///////////////////////////////////////////////////////////////////////////////////
-
-
-		/*
-		for (int i = 0; i < numExamples; ++i)
-		{
-			// output the name if it exists, otherwise the number
-			// of the example
-			exampleName = pData->getExampleName(i);
-			if ( !exampleName.empty() )
-				outFile << exampleName << ',';
-
-			// output the posteriors
-			outFile << results[i]->getVotesVector()[0];
-			for (int l = 1; l < numClasses; ++l)
-				outFile << ',' << results[i]->getVotesVector()[l];
-			outFile << '\n';
-		}
-		*/
-
-		if (_verbose > 0)
-			cout << "Done!" << endl;
-
-		if (_verbose > 1)
-		{
-			cout << "\nClass order (You can change it in the header of the data file):" << endl;
-			for (int l = 0; l < numClasses; ++l)
-				cout << "- " << pData->getClassMap().getNameFromIdx(l) << endl;
-		}
-
-		// delete the input data file
-		if (pData) 
-			delete pData;
-
-		vector<ExampleResults*>::iterator it;
-		for (it = results.begin(); it != results.end(); ++it)
-			delete (*it);
+		vector<EvaluationOutput*> outputs;
+		outputs.push_back( new LikelihoodOutput(outFileName, numIterations) );
+		evaluate(dataFileName, shypFileName, numIterations, outputs);
 	}
 
-
-	// -------------------------------------------------------------------------
-
 	// -------------------------------------------------------------------------
 
 	void FilterBoostClassifier::saveROC(const string& dataFileName, const string& shypFileName, 
 		const string& outFileName, int numIterations)
 	{
-		InputData* pData = loadInputData(dataFileName, shypFileName);
-		ofstream outFile(outFileName.c_str());
-		
-		if ( ! outFile.is_open() )
-		{
-			cout << "Cannot open outfile" << endl;
-			exit( -1 );
-		}
-
-		if (_verbose > 0)
-			cout << "Loading strong hypothesis..." << flush;
-
-		// The class that loads the weak hypotheses
-		UnSerialization us;
-
-		// Where to put the weak hypotheses
-		vector<BaseLearner*> weakHypotheses;
-
-		// loads them
-		us.loadHypotheses(shypFileName, weakHypotheses, pData);
-		weakHypotheses.resize( numIterations );
-
-		// where the results go
-		vector< ExampleResults* > results;
-
-		if (_verbose > 0)
-			cout << "Classifying..." << flush;
-
-		// get the results
-		computeResults( pData, weakHypotheses, results, weakHypotheses.size());
-
-		const int numClasses = pData->getNumClasses();
-		const int numExamples = pData->getNumExamples();
-
-		if (_verbose > 0)
-			cout << "Done!" << endl;
-
-		const int colSize = 7;
-
-		vector< pair< int, double> > sortedExample( numExamples );
-		
-		for( int i=0; i<numExamples; i++ )
-		{
-			sortedExample[i].first = i;
-			sortedExample[i].second = results[i]->getVotesVector()[0];
-		}
-		sort( sortedExample.begin(), sortedExample.end(), nor_utils::comparePair< 2, int, double, greater<double> >() );
-
-		vector<double> positiveWeights( numExamples );
-		double sumOfPositiveWeights = 0.0;
-
-		vector<double>  negativeWeights( numExamples );
-		double sumOfNegativeWeights = 0.0;
-		
-		fill( positiveWeights.begin(), positiveWeights.end(), 0.0 );
-		fill( negativeWeights.begin(), negativeWeights.end(), 0.0 );
-
-		string className = pData->getClassMap().getNameFromIdx( 0 );
-
-		vector<Label>& labels = pData->getLabels( sortedExample[0].first );
-		vector<Label>::iterator labIt = find( labels.begin(), labels.end(), 0);
-		
-		if ( labIt != labels.end() )
-		{
-			if ( labIt->y > 0.0 )
-			{
-				positiveWeights[0] = labIt->initialWeight;
-				sumOfPositiveWeights += labIt->initialWeight;
-			} else
-			{
-				negativeWeights[0] = labIt->initialWeight;
-				sumOfNegativeWeights += labIt->initialWeight;
-			}
-		}
-		
-		for( int i=1; i<numExamples; i++ )
-		{
-			labels = pData->getLabels( sortedExample[i].first );
-			labIt = find( labels.begin(), labels.end(), 0);
-			if ( labIt != labels.end() )
-			{
-				if ( labIt->y > 0.0 )
-				{
-					negativeWeights[i] = negativeWeights[i-1];
-					positiveWeights[i] = positiveWeights[i-1] + labIt->initialWeight;
-					sumOfPositiveWeights += labIt->initialWeight;
-				} else
-				{
-					positiveWeights[i] = positiveWeights[i-1];
-					negativeWeights[i] = negativeWeights[i-1] + labIt->initialWeight;
-					sumOfNegativeWeights += labIt->initialWeight;
-				}
-			} else {
-				positiveWeights[i] = positiveWeights[i-1];
-				negativeWeights[i] = negativeWeights[i-1];
-			}
-		}
-
-		outFile << "Class name: " << className << endl;
-		for( int i=0; i<numExamples; i++ )
-		{
-			outFile <<  sortedExample[i].first << " ";
-			// false positive rate
-			outFile << ( positiveWeights[i] / sumOfPositiveWeights ) << " ";
-			//true negative rate
-			outFile << ( negativeWeights[i] / sumOfNegativeWeights ) << endl;
-		}		
-
-		outFile.close();
-
-		// delete the input data file
-		if (pData) 
-			delete pData;
-
-		vector<ExampleResults*>::iterator it;
-		for (it = results.begin(); it != results.end(); ++it)
-			delete (*it);
+		vector<EvaluationOutput*> outputs;
+		outputs.push_back( new ROCOutput(outFileName, numIterations) );
+		evaluate(dataFileName, shypFileName, numIterations, outputs);
 	}
 
 
@@ -921,6 +558,11 @@ namespace MultiBoost {
 		// Move until it finds the algo tag
 		string basicLearnerName = UnSerialization::seekAndParseEnclosedValue<string>(st, "algo");
 
+		// the columns of hashed features must be reproduced exactly
+		int hashBits = 0;
+		unsigned int hashSeed = 0;
+		const bool hasFeatureHashing = UnSerialization::parseFeatureHashing(st, hashBits, hashSeed);
+
 		// Check if the weak learner exists
 		if ( !BaseLearner::RegisteredLearners().hasLearner(basicLearnerName) )
 		{
@@ -935,6 +577,8 @@ namespace MultiBoost {
 
 		// set the non-default arguments of the input data
 		pData->initOptions(_args);
+		if ( hasFeatureHashing )
+			pData->setFeatureHashing(hashBits, hashSeed);
 		// load the data
 		pData->load(dataFileName, IT_TEST, _verbose);
 
@@ -949,69 +593,13 @@ namespace MultiBoost {
 	{
 		assert( !weakHypotheses.empty() );
 
-		const int numClasses = pData->getNumClasses();
-		const int numExamples = pData->getNumExamples();
-
-		// Initialize the output info
-		OutputInfo* pOutInfo = NULL;
+		IncrementalEvaluator evaluator(pData, results);
 
+		// if needed output the step-by-step information
 		if ( !_outputInfoFile.empty() )
-			pOutInfo = new OutputInfo(_outputInfoFile);
-
-		// Creating the results structures. See file Structures.h for the
-		// PointResults structure
-		results.clear();
-		results.reserve(numExamples);
-		for (int i = 0; i < numExamples; ++i)
-			results.push_back( new ExampleResults(i, numClasses) );
-
-		// iterator over all the weak hypotheses
-		vector<BaseLearner*>::const_iterator whyIt;
-		int t;
-
-		if ( pOutInfo )
-			pOutInfo->initialize( pData );
-
-		// for every feature: 1..T
-		for (whyIt = weakHypotheses.begin(), t = 0; 
-			whyIt != weakHypotheses.end() && t < numIterations; ++whyIt, ++t)
-		{
-			BaseLearner* currWeakHyp = *whyIt;
-			float alpha = currWeakHyp->getAlpha();
-
-			// for every point
-			for (int i = 0; i < numExamples; ++i)
-			{
-				// a reference for clarity and speed
-				vector<float>& currVotesVector = results[i]->getVotesVector();
-
-				// for every class
-				for (int l = 0; l < numClasses; ++l)
-					currVotesVector[l] += alpha * currWeakHyp->classify(pData, i, l);
-			}
-
-			// if needed output the step-by-step information
-			if ( pOutInfo )
-			{
-				pOutInfo->outputIteration(t);
-				pOutInfo->outputError(pData, currWeakHyp);
-				
-				//pOutInfo->outputBalancedError(pData);
-				if ( ( t % 1 ) == 0 ) {
-					pOutInfo->outputROC(pData);
-				}
-
-				// Margins and edge requires an update of the weight,
-				// therefore I keep them out for the moment
-				//outInfo.outputMargins(pData, currWeakHyp);
-				//outInfo.outputEdge(pData, currWeakHyp);
-				pOutInfo->endLine();
-			}
-		}
-
-		if (pOutInfo)
-			delete pOutInfo;
+			evaluator.addOutput( new ErrorCurveOutput(_outputInfoFile, numIterations, false) );
 
+		evaluator.run( weakHypotheses, numIterations );
 	}
 
 	// -------------------------------------------------------------------------
@@ -0,0 +1,473 @@
+/*
+*
+*    MultiBoost - Multi-purpose boosting package
+*
+*    Copyright (C) 2010   AppStat group
+*                         Laboratoire de l'Accelerateur Lineaire
+*                         Universite Paris-Sud, 11, CNRS
+*
+*    This file is part of the MultiBoost library
+*
+*    This library is free software; you can redistribute it
+*    and/or modify it under the terms of the GNU General Public
+*    License as published by the Free Software Foundation; either
+*    version 2.1 of the License, or (at your option) any later version.
+*
+*    This library is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+*    General Public License for more details.
+*
+*    You should have received a copy of the GNU General Public
+*    License along with this library; if not, write to the Free Software
+*    Foundation, Inc., 51 Franklin St, 5th Floor, Boston, MA 02110-1301 USA
+*
+*    Contact: Balazs Kegl (balazs.kegl@gmail.com)
+*             Norman Casagrande (nova77@gmail.com)
+*             Robert Busa-Fekete (busarobi@gmail.com)
+*
+*    For more information and up-to-date version, please visit
+*
+*                       http://www.multiboost.org/
+*
+*/
+
+
+#include "Classifiers/IncrementalEvaluator.h"
+#include "Classifiers/ExampleResults.h"
+#include "WeakLearners/BaseLearner.h"
+#include "IO/InputData.h"
+#include "IO/OutputInfo.h"
+#include "Utils/Utils.h" // for comparePair
+
+#include <iostream>
+#include <limits>
+#include <functional> // for greater
+#include <algorithm> // for sort
+#include <cmath> // for exp, log
+
+namespace MultiBoost {
+
+// -------------------------------------------------------------------------
+// -------------------------------------------------------------------------
+
+ErrorCurveOutput::ErrorCurveOutput(const string& outputInfoFile, int numIterations,
+                                   bool withTPRFPR, bool withROC)
+   : _numIterations(numIterations), _withTPRFPR(withTPRFPR), _withROC(withROC)
+{
+   _pOutInfo = new OutputInfo(outputInfoFile);
+}
+
+// -------------------------------------------------------------------------
+
+ErrorCurveOutput::~ErrorCurveOutput()
+{
+   delete _pOutInfo;
+}
+
+// -------------------------------------------------------------------------
+
+void ErrorCurveOutput::initialize(InputData* pData)
+{
+   _pOutInfo->initialize(pData);
+}
+
+// -------------------------------------------------------------------------
+
+void ErrorCurveOutput::update(InputData* pData, vector<ExampleResults*>& results, int t)
+{
+   if ( t >= _numIterations )
+      return;
+
+   const int numExamples = pData->getNumExamples();
+
+   // bring the g table up to date with the votes of the labels
+   OutputInfo::table& g = _pOutInfo->getTable(pData);
+   vector<Label>::const_iterator lIt;
+   for (int i = 0; i < numExamples; ++i)
+   {
+      const vector<float>& votes = results[i]->getVotesVector();
+      const vector<Label>& labels = pData->getLabels(i);
+      for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
+         g[i][lIt->idx] = votes[lIt->idx];
+   }
+
+   _pOutInfo->outputIteration(t);
+   _pOutInfo->outputError(pData);
+   if ( _withTPRFPR )
+      _pOutInfo->outTPRFPR(pData);
+   if ( _withROC )
+      _pOutInfo->outputROC(pData);
+   _pOutInfo->endLine();
+}
+
+// -------------------------------------------------------------------------
+// -------------------------------------------------------------------------
+
+PosteriorsOutput::PosteriorsOutput(const string& outFileName, int numIterations, int period, int verbose)
+   : _numIterations(numIterations), _period(period), _lastWritten(0), _verbose(verbose)
+{
+   _outFile.open(outFileName.c_str());
+   if ( !_outFile.is_open() )
+   {
+      cerr << "ERROR: Cannot open the posteriors file <" << outFileName << ">!" << endl;
+      exit(1);
+   }
+
+   if ( _period <= 0 )
+      _period = numIterations;
+   _isPeriodic = ( _period < numIterations );
+}
+
+// -------------------------------------------------------------------------
+
+void PosteriorsOutput::update(InputData* pData, vector<ExampleResults*>& results, int t)
+{
+   // the last block is the first one at or past _numIterations
+   if ( ( (t+1) % _period ) != 0 || t+1 - _period >= _numIterations )
+      return;
+
+   if ( _verbose > 0 && _lastWritten > 0 )
+      cout << "Write out the posteriors for iteration " << (t+1) << endl;
+   writeBlock(pData, results, t+1);
+}
+
+// -------------------------------------------------------------------------
+
+void PosteriorsOutput::finalize(InputData* pData, vector<ExampleResults*>& results, int numIterations)
+{
+   // the model is shorter than what was asked
+   if ( _lastWritten == 0 )
+      writeBlock(pData, results, numIterations);
+}
+
+// -------------------------------------------------------------------------
+
+void PosteriorsOutput::writeBlock(InputData* pData, vector<ExampleResults*>& results, int iteration)
+{
+   const int numClasses = pData->getNumClasses();
+   const int numExamples = pData->getNumExamples();
+
+   if ( _isPeriodic )
+      _outFile << ( _lastWritten == 0 ? _period : iteration ) << endl;
+
+   for (int i = 0; i < numExamples; ++i)
+   {
+      // output the name if it exists, otherwise the number
+      // of the example
+      const string& exampleName = pData->getExampleName(i);
+      if ( !exampleName.empty() )
+         _outFile << exampleName << ',';
+
+      // output the posteriors
+      const vector<float>& votes = results[i]->getVotesVector();
+      _outFile << votes[0];
+      for (int l = 1; l < numClasses; ++l)
+         _outFile << ',' << votes[l];
+      _outFile << '\n';
+   }
+
+   _lastWritten = iteration;
+}
+
+// -------------------------------------------------------------------------
+// -------------------------------------------------------------------------
+
+LikelihoodOutput::LikelihoodOutput(const string& outFileName, int numIterations)
+   : _numIterations(numIterations)
+{
+   _outFile.open(outFileName.c_str());
+   if ( !_outFile.is_open() )
+   {
+      cerr << "ERROR: Cannot open the likelihood file <" << outFileName << ">!" << endl;
+      exit(1);
+   }
+}
+
+// -------------------------------------------------------------------------
+
+void LikelihoodOutput::update(InputData* pData, vector<ExampleResults*>& results, int t)
+{
+   if ( t >= _numIterations )
+      return;
+
+   const int numClasses = pData->getNumClasses();
+   const int numExamples = pData->getNumExamples();
+
+   _expVotes.resize(numClasses);
+
+   double lLambda = 0.0;
+   for (int i = 0; i < numExamples; ++i)
+   {
+      const vector<float>& votes = results[i]->getVotesVector();
+
+      // softmax of the votes
+      double sumExp = 0.0;
+      for (int l = 0; l < numClasses; ++l) 
+      {
+         _expVotes[l] = exp( votes[l] );
+         sumExp += _expVotes[l];
+      }
+
+      if ( sumExp > numeric_limits<double>::epsilon() ) 
+      {
+         for (int l = 0; l < numClasses; ++l) 
+            _expVotes[l] /= sumExp;
+      }
+
+      const vector<Label>& labels = pData->getLabels( results[i]->getIdx() );
+      vector<Label>::const_iterator lIt;
+      for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
+      {
+         if ( lIt->y > 0 && _expVotes[lIt->idx] > numeric_limits<double>::epsilon() )
+            lLambda += ( 1.0/(double)numExamples ) * log( _expVotes[lIt->idx] );
+      }
+   }
+
+   _outFile << t << "\t" << lLambda << '\n';
+}
+
+// -------------------------------------------------------------------------
+// -------------------------------------------------------------------------
+
+ROCOutput::ROCOutput(const string& outFileName, int numIterations)
+   : _numIterations(numIterations), _isWritten(false)
+{
+   _outFile.open(outFileName.c_str());
+   if ( !_outFile.is_open() )
+   {
+      cerr << "ERROR: Cannot open the ROC file <" << outFileName << ">!" << endl;
+      exit(1);
+   }
+}
+
+// -------------------------------------------------------------------------
+
+void ROCOutput::update(InputData* pData, vector<ExampleResults*>& results, int t)
+{
+   if ( t+1 == _numIterations )
+      writeCurve(pData, results);
+}
+
+// -------------------------------------------------------------------------
+
+void ROCOutput::finalize(InputData* pData, vector<ExampleResults*>& results, int /*numIterations*/)
+{
+   // the model is shorter than what was asked
+   if ( !_isWritten )
+      writeCurve(pData, results);
+}
+
+// -------------------------------------------------------------------------
+
+void ROCOutput::writeCurve(InputData* pData, vector<ExampleResults*>& results)
+{
+   const int numExamples = pData->getNumExamples();
+
+   // sort the examples by decreasing vote for the first class
+   vector< pair< int, double> > sortedExample( numExamples );
+   for( int i=0; i<numExamples; i++ )
+   {
+      sortedExample[i].first = i;
+      sortedExample[i].second = results[i]->getVotesVector()[0];
+   }
+   sort( sortedExample.begin(), sortedExample.end(), nor_utils::comparePair< 2, int, double, greater<double> >() );
+
+   // cumulative (initial) weights of the positive and negative examples
+   vector<double> positiveWeights( numExamples, 0.0 );
+   double sumOfPositiveWeights = 0.0;
+
+   vector<double> negativeWeights( numExamples, 0.0 );
+   double sumOfNegativeWeights = 0.0;
+
+   for( int i=0; i<numExamples; i++ )
+   {
+      if ( i > 0 )
+      {
+         positiveWeights[i] = positiveWeights[i-1];
+         negativeWeights[i] = negativeWeights[i-1];
+      }
+
+      const vector<Label>& labels = pData->getLabels( sortedExample[i].first );
+      vector<Label>::const_iterator labIt = find( labels.begin(), labels.end(), 0 );
+      if ( labIt != labels.end() )
+      {
+         if ( labIt->y > 0 )
+         {
+            positiveWeights[i] += labIt->initialWeight;
+            sumOfPositiveWeights += labIt->initialWeight;
+         } 
+         else
+         {
+            negativeWeights[i] += labIt->initialWeight;
+            sumOfNegativeWeights += labIt->initialWeight;
+         }
+      }
+   }
+
+   _outFile << "Class name: " << pData->getClassMap().getNameFromIdx( 0 ) << endl;
+   for( int i=0; i<numExamples; i++ )
+   {
+      _outFile <<  sortedExample[i].first << " ";
+      // false positive rate
+      _outFile << ( positiveWeights[i] / sumOfPositiveWeights ) << " ";
+      //true negative rate
+      _outFile << ( negativeWeights[i] / sumOfNegativeWeights ) << endl;
+   }
+
+   _isWritten = true;
+}
+
+// -------------------------------------------------------------------------
+// -------------------------------------------------------------------------
+
+IncrementalEvaluator::IncrementalEvaluator(InputData* pData, vector<ExampleResults*>& results)
+   : _pData(pData), _results(results)
+{
+   const int numClasses = pData->getNumClasses();
+   const int numExamples = pData->getNumExamples();
+
+   // Creating the results structures. See file Structures.h for the
+   // PointResults structure
+   _results.clear();
+   _results.reserve(numExamples);
+   for (int i = 0; i < numExamples; ++i)
+      _results.push_back( new ExampleResults(i, numClasses) );
+}
+
+// -------------------------------------------------------------------------
+
+IncrementalEvaluator::~IncrementalEvaluator()
+{
+   vector<EvaluationOutput*>::iterator oIt;
+   for (oIt = _outputs.begin(); oIt != _outputs.end(); ++oIt)
+      delete *oIt;
+}
+
+// -------------------------------------------------------------------------
+
+void IncrementalEvaluator::addErrorCurve(const string& outputInfoFile, bool withTPRFPR)
+{
+   int numIterations = 0;
+   bool withRates = false;
+
+   vector<EvaluationOutput*>::const_iterator oIt;
+   for (oIt = _outputs.begin(); oIt != _outputs.end(); ++oIt)
+   {
+      const int length = (*oIt)->getErrorCurveLength();
+      if ( length > numIterations )
+         numIterations = length;
+      if ( length > 0 && (*oIt)->hasErrorCurveRates() )
+         withRates = true;
+   }
+
+   if ( numIterations > 0 )
+      addOutput( new ErrorCurveOutput(outputInfoFile, numIterations, withRates && withTPRFPR, withRates) );
+}
+
+// -------------------------------------------------------------------------
+
+int IncrementalEvaluator::run(const vector<BaseLearner*>& weakHypotheses, int numIterations)
+{
+   const int numClasses = _pData->getNumClasses();
+   const int numExamples = _pData->getNumExamples();
+
+   vector<EvaluationOutput*>::iterator oIt;
+   for (oIt = _outputs.begin(); oIt != _outputs.end(); ++oIt)
+      (*oIt)->initialize(_pData);
+
+   // iterator over all the weak hypotheses
+   vector<BaseLearner*>::const_iterator whyIt;
+   int t;
+
+   // for every feature: 1..T
+   for (whyIt = weakHypotheses.begin(), t = 0; 
+        whyIt != weakHypotheses.end() && t < numIterations; ++whyIt, ++t)
+   {
+      BaseLearner* currWeakHyp = *whyIt;
+      const float alpha = currWeakHyp->getAlpha();
+
+      // for every point
+      for (int i = 0; i < numExamples; ++i)
+      {
+         // a reference for clarity and speed
+         vector<float>& currVotesVector = _results[i]->getVotesVector();
+
+         // for every class
+         for (int l = 0; l < numClasses; ++l)
+            currVotesVector[l] += alpha * currWeakHyp->classify(_pData, i, l);
+      }
+
+      for (oIt = _outputs.begin(); oIt != _outputs.end(); ++oIt)
+         (*oIt)->update(_pData, _results, t);
+   }
+
+   for (oIt = _outputs.begin(); oIt != _outputs.end(); ++oIt)
+      (*oIt)->finalize(_pData, _results, t);
+
+   return t;
+}
+
+// -------------------------------------------------------------------------
+
+int IncrementalEvaluator::createOutputs(const nor_utils::Args& args, vector<EvaluationOutput*>& outputs,
+                                        string& dataFileName, string& shypFileName, int verbose)
+{
+   const char* modes[] = { "likelihood", "roc", "posteriors", "cposteriors" };
+   const int numModes = 4;
+
+   int maxIterations = 0;
+   dataFileName.clear();
+   shypFileName.clear();
+
+   for (int m = 0; m < numModes; ++m)
+   {
+      const string mode = modes[m];
+      if ( !args.hasArgument(mode) )
+         continue;
+
+      // -<mode> <dataFile> <shypFile> <outFile> <numIters> [<period>]
+      const string modeDataFileName = args.getValue<string>(mode, 0);
+      const string modeShypFileName = args.getValue<string>(mode, 1);
+      const string outFileName = args.getValue<string>(mode, 2);
+      const int numIterations = args.getValue<int>(mode, 3);
+
+      if ( dataFileName.empty() )
+      {
+         dataFileName = modeDataFileName;
+         shypFileName = modeShypFileName;
+      }
+      else if ( dataFileName != modeDataFileName || shypFileName != modeShypFileName )
+      {
+         cerr << "ERROR: --" << mode << " must use the same data and strong hypothesis files "
+              << "as the other outputs computed in the same run!" << endl;
+         exit(1);
+      }
+
+      if ( mode == "likelihood" )
+         outputs.push_back( new LikelihoodOutput(outFileName, numIterations) );
+      else if ( mode == "roc" )
+         outputs.push_back( new ROCOutput(outFileName, numIterations) );
+      else if ( mode == "posteriors" )
+      {
+         int period = 0;
+         if ( args.getNumValues(mode) > 4 )
+            period = args.getValue<int>(mode, 4);
+         PosteriorsOutput* pOutput = new PosteriorsOutput(outFileName, numIterations, period, verbose);
+         outputs.push_back( pOutput );
+         if ( pOutput->getLastIteration() > maxIterations )
+            maxIterations = pOutput->getLastIteration();
+      }
+      else
+         outputs.push_back( new PosteriorsOutput(outFileName, numIterations, 0, verbose) );
+
+      if ( numIterations > maxIterations )
+         maxIterations = numIterations;
+   }
+
+   return maxIterations;
+}
+
+// -------------------------------------------------------------------------
+
+} // end of namespace MultiBoost
@@ -0,0 +1,332 @@
+/*
+*
+*    MultiBoost - Multi-purpose boosting package
+*
+*    Copyright (C) 2010   AppStat group
+*                         Laboratoire de l'Accelerateur Lineaire
+*                         Universite Paris-Sud, 11, CNRS
+*
+*    This file is part of the MultiBoost library
+*
+*    This library is free software; you can redistribute it
+*    and/or modify it under the terms of the GNU General Public
+*    License as published by the Free Software Foundation; either
+*    version 2.1 of the License, or (at your option) any later version.
+*
+*    This library is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+*    General Public License for more details.
+*
+*    You should have received a copy of the GNU General Public
+*    License along with this library; if not, write to the Free Software
+*    Foundation, Inc., 51 Franklin St, 5th Floor, Boston, MA 02110-1301 USA
+*
+*    Contact: Balazs Kegl (balazs.kegl@gmail.com)
+*             Norman Casagrande (nova77@gmail.com)
+*             Robert Busa-Fekete (busarobi@gmail.com)
+*
+*    For more information and up-to-date version, please visit
+*
+*                       http://www.multiboost.org/
+*
+*/
+
+
+/**
+* \file IncrementalEvaluator.h Streams the weak hypotheses of a strong
+* hypothesis over a dataset once, and writes all the requested outputs.
+*/
+
+#ifndef __INCREMENTAL_EVALUATOR_H
+#define __INCREMENTAL_EVALUATOR_H
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <limits>
+
+#include "Utils/Args.h"
+
+using namespace std;
+
+namespace MultiBoost {
+
+// Forward declarations.
+class ExampleResults;
+class InputData;
+class BaseLearner;
+class OutputInfo;
+
+/**
+* An artifact computed from the running discriminant function
+* \f${\bf g}^{(t)}(x) = \sum_{s=1}^t \alpha^{(s)} {\bf h}^{(s)}(x)\f$.
+* The evaluator calls update() after each weak hypothesis has been added to
+* the votes of every example, and finalize() once the last one has been added,
+* so an output never needs to classify the data by itself.
+* \see IncrementalEvaluator
+* \date 18/10/2026
+*/
+class EvaluationOutput
+{
+public:
+
+   virtual ~EvaluationOutput() {}
+
+   /**
+   * Called once before the first weak hypothesis.
+   * \param pData The data being evaluated.
+   * \date 18/10/2026
+   */
+   virtual void initialize(InputData* /*pData*/) {}
+
+   /**
+   * Called after the weak hypothesis \a t (0-based) has been added to the votes.
+   * \param pData The data being evaluated.
+   * \param results The running votes of the examples.
+   * \param t The index of the last weak hypothesis added.
+   * \date 18/10/2026
+   */
+   virtual void update(InputData* /*pData*/, vector<ExampleResults*>& /*results*/, int /*t*/) {}
+
+   /**
+   * Called once after the last weak hypothesis.
+   * \param pData The data being evaluated.
+   * \param results The final votes of the examples.
+   * \param numIterations The number of weak hypotheses that have been added.
+   * \date 18/10/2026
+   */
+   virtual void finalize(InputData* /*pData*/, vector<ExampleResults*>& /*results*/, 
+                         int /*numIterations*/) {}
+
+   /**
+   * The number of iterations of the step-by-step information (--outputinfo)
+   * written along with this output (0: none).
+   * \date 18/10/2026
+   */
+   virtual int getErrorCurveLength() const { return 0; }
+
+   /**
+   * Whether the step-by-step information written along with this output has
+   * the TPR/FPR and AUC columns, or only the error.
+   * \date 18/10/2026
+   */
+   virtual bool hasErrorCurveRates() const { return true; }
+};
+
+// -----------------------------------------------------------------------------
+
+/**
+* The step-by-step information (--outputinfo) of the test mode: error,
+* optionally TPR/FPR and AUC, after each of the first \a numIterations iterations.
+* The g table of OutputInfo is copied from the running votes instead of 
+* classifying the data a second time.
+* \date 18/10/2026
+*/
+class ErrorCurveOutput : public EvaluationOutput
+{
+public:
+   /**
+   * \param outputInfoFile The name of the step-by-step information file.
+   * \param numIterations The number of iterations written.
+   * \param withTPRFPR Whether the TPR/FPR columns are written.
+   * \param withROC Whether the AUC column is written.
+   */
+   ErrorCurveOutput(const string& outputInfoFile, int numIterations = numeric_limits<int>::max(),
+                    bool withTPRFPR = true, bool withROC = true);
+   virtual ~ErrorCurveOutput();
+
+   virtual void initialize(InputData* pData);
+   virtual void update(InputData* pData, vector<ExampleResults*>& results, int t);
+
+private:
+   OutputInfo* _pOutInfo;
+   int         _numIterations;
+   bool        _withTPRFPR;
+   bool        _withROC;
+};
+
+// -----------------------------------------------------------------------------
+
+/**
+* The posteriors (votes) of each example. If \a period is positive and smaller
+* than the number of iterations, a block with the posteriors is written every
+* \a period iterations, preceded by the iteration number, up to the first
+* multiple of \a period that reaches \a numIterations. Otherwise only the
+* votes of the strong hypothesis at \a period (or \a numIterations if 
+* \a period is 0) are written.
+* \date 18/10/2026
+*/
+class PosteriorsOutput : public EvaluationOutput
+{
+public:
+   /**
+   * \param outFileName The name of the output file.
+   * \param numIterations The number of iterations requested.
+   * \param period The number of iterations between two blocks (0: only the last one).
+   * \param verbose The verbosity level.
+   */
+   PosteriorsOutput(const string& outFileName, int numIterations, int period = 0, int verbose = 1);
+
+   virtual void update(InputData* pData, vector<ExampleResults*>& results, int t);
+   virtual void finalize(InputData* pData, vector<ExampleResults*>& results, int numIterations);
+
+   /**
+   * The error curve goes along the first block only.
+   */
+   virtual int getErrorCurveLength() const { return _period; }
+
+   /**
+   * The number of iterations needed for the last block.
+   * \date 18/10/2026
+   */
+   int getLastIteration() const 
+   { return ( (_numIterations + _period - 1) / _period ) * _period; }
+
+private:
+   void writeBlock(InputData* pData, vector<ExampleResults*>& results, int iteration);
+
+   ofstream _outFile;
+   int      _numIterations;
+   int      _period;
+   bool     _isPeriodic; //!< Whether the blocks are preceded by the iteration number.
+   int      _lastWritten; //!< The iteration of the last block written (0: none).
+   int      _verbose;
+};
+
+// -----------------------------------------------------------------------------
+
+/**
+* The average log-likelihood of the softmax of the votes for the positive
+* labels, after each of the first \a numIterations iterations ("t\tlikelihood" per line).
+* \date 18/10/2026
+*/
+class LikelihoodOutput : public EvaluationOutput
+{
+public:
+   /**
+   * \param outFileName The name of the output file.
+   * \param numIterations The number of iterations requested.
+   */
+   LikelihoodOutput(const string& outFileName, int numIterations);
+
+   virtual void update(InputData* pData, vector<ExampleResults*>& results, int t);
+
+   virtual int getErrorCurveLength() const { return _numIterations; }
+   virtual bool hasErrorCurveRates() const { return false; }
+
+private:
+   ofstream       _outFile;
+   int            _numIterations;
+   vector<double> _expVotes; //!< Buffer for the softmax of one example.
+};
+
+// -----------------------------------------------------------------------------
+
+/**
+* The ROC curve of the first class, computed from the votes at \a numIterations.
+* \date 18/10/2026
+*/
+class ROCOutput : public EvaluationOutput
+{
+public:
+   /**
+   * \param outFileName The name of the output file.
+   * \param numIterations The number of iterations requested.
+   */
+   ROCOutput(const string& outFileName, int numIterations);
+
+   virtual void update(InputData* pData, vector<ExampleResults*>& results, int t);
+   virtual void finalize(InputData* pData, vector<ExampleResults*>& results, int numIterations);
+
+   virtual int getErrorCurveLength() const { return _numIterations; }
+
+private:
+   void writeCurve(InputData* pData, vector<ExampleResults*>& results);
+
+   ofstream _outFile;
+   int      _numIterations;
+   bool     _isWritten;
+};
+
+// -----------------------------------------------------------------------------
+
+/**
+* Computes the votes of a strong hypothesis on a dataset incrementally.
+* The weak hypotheses are streamed once: each is classified on every 
+* (example, class) pair, added to the running votes, and then all the registered
+* outputs are updated. This way the error curve, the periodic posteriors, the 
+* likelihood and the ROC of a model are produced in a single pass, whose
+* cost is linear in the number of iterations.
+* \date 18/10/2026
+*/
+class IncrementalEvaluator
+{
+public:
+
+   /**
+   * The constructor. It creates the (zero) votes of every example into \a results.
+   * \param pData The data to be evaluated.
+   * \param results The vector where the results will be stored. The caller
+   * is responsible for deleting its elements.
+   * \date 18/10/2026
+   */
+   IncrementalEvaluator(InputData* pData, vector<ExampleResults*>& results);
+
+   /**
+   * The destructor. Deletes the outputs.
+   */
+   ~IncrementalEvaluator();
+
+   /**
+   * Add an output. The evaluator takes its ownership.
+   * \param pOutput The output to be updated during the evaluation.
+   * \date 18/10/2026
+   */
+   void addOutput(EvaluationOutput* pOutput) { _outputs.push_back(pOutput); }
+
+   /**
+   * Add the step-by-step information that goes along with the outputs,
+   * the longest and widest one asked by them. Must be called after the
+   * outputs have been added.
+   * \param outputInfoFile The name of the step-by-step information file.
+   * \param withTPRFPR Whether the TPR/FPR columns can be written.
+   * \date 18/10/2026
+   */
+   void addErrorCurve(const string& outputInfoFile, bool withTPRFPR = true);
+
+   /**
+   * Add the weak hypotheses to the votes, updating the outputs after each of them.
+   * \param weakHypotheses The list of weak hypotheses.
+   * \param numIterations The maximum number of weak hypotheses used.
+   * \return The number of weak hypotheses actually used.
+   * \date 18/10/2026
+   */
+   int run(const vector<BaseLearner*>& weakHypotheses, int numIterations);
+
+   /**
+   * Create the outputs asked in the arguments among --posteriors, --cposteriors,
+   * --likelihood and --roc, so that they can be computed in a single pass. 
+   * They must all refer to the same data and strong hypothesis files.
+   * \param args The arguments defined by the user in the command line.
+   * \param outputs The returned outputs.
+   * \param dataFileName The returned name of the data file.
+   * \param shypFileName The returned name of the strong hypothesis file.
+   * \param verbose The verbosity level.
+   * \return The number of iterations needed by the outputs.
+   * \date 18/10/2026
+   */
+   static int createOutputs(const nor_utils::Args& args, vector<EvaluationOutput*>& outputs,
+                            string& dataFileName, string& shypFileName, int verbose);
+
+private:
+   InputData*                _pData;
+   vector<ExampleResults*>&  _results;
+   vector<EvaluationOutput*> _outputs;
+
+   IncrementalEvaluator& operator=( const IncrementalEvaluator& ) {return *this;}
+};
+
+} // end of namespace MultiBoost
+
+#endif // __INCREMENTAL_EVALUATOR_H
@@ -0,0 +1,491 @@
+/*
+*
+*    MultiBoost - Multi-purpose boosting package
+*
+*    Copyright (C) 2010   AppStat group
+*                         Laboratoire de l'Accelerateur Lineaire
+*                         Universite Paris-Sud, 11, CNRS
+*
+*    This file is part of the MultiBoost library
+*
+*    This library is free software; you can redistribute it 
+*    and/or modify it under the terms of the GNU General Public
+*    License as published by the Free Software Foundation; either
+*    version 2.1 of the License, or (at your option) any later version.
+*
+*    This library is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+*    General Public License for more details.
+*
+*    You should have received a copy of the GNU General Public
+*    License along with this library; if not, write to the Free Software
+*    Foundation, Inc., 51 Franklin St, 5th Floor, Boston, MA 02110-1301 USA
+*
+*    Contact: Balazs Kegl (balazs.kegl@gmail.com)
+*             Norman Casagrande (nova77@gmail.com)
+*             Robert Busa-Fekete (busarobi@gmail.com)
+*
+*    For more information and up-to-date version, please visit
+*        
+*                       http://www.multiboost.org/
+*
+*/
+
+
+
+#include "Classifiers/PosteriorsServer.h"
+
+#include "WeakLearners/BaseLearner.h"
+#include "IO/InputData.h"
+#include "IO/Serialization.h"
+#include "IO/DataTransform.h"
+#include "Utils/Utils.h" // for murmur_hash
+
+#include <iostream>
+#include <sstream>
+#include <fstream>
+#include <limits> // for the missing values
+#include <cstdlib> // for atoi, atof
+#include <cstring> // for memset, strcpy
+
+#ifndef WIN32
+#include <sys/socket.h> // for --serve on a socket
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace MultiBoost {
+
+	// -------------------------------------------------------------------------
+
+	// Split the characters [begin, end) of a line at the separators.
+	static void tokenize(const string& line, size_t begin, size_t end, const char* sepChars, 
+		vector<string>& tokens)
+	{
+		tokens.clear();
+		while ( begin < end )
+		{
+			begin = line.find_first_not_of(sepChars, begin);
+			if ( begin == string::npos || begin >= end )
+				break;
+
+			size_t tokenEnd = line.find_first_of(sepChars, begin);
+			if ( tokenEnd == string::npos || tokenEnd > end )
+				tokenEnd = end;
+
+			tokens.push_back( line.substr(begin, tokenEnd - begin) );
+			begin = tokenEnd;
+		}
+	}
+
+	// -------------------------------------------------------------------------
+
+	// Read the feature hashing of a strong hypothesis file (0 bits if it has none).
+	static void readFeatureHashing(const string& shypFileName, int& bits, unsigned int& seed)
+	{
+		ifstream inFile(shypFileName.c_str());
+		if (!inFile.is_open())
+		{
+			cerr << "ERROR: Cannot open strong hypothesis file <" << shypFileName << ">!" << endl;
+			exit(1);
+		}
+
+		nor_utils::StreamTokenizer st(inFile, "<>\n\r\t");
+		if ( !UnSerialization::seekSimpleTag(st, "multiboost") )
+		{
+			cerr << "ERROR: Not a valid MultiBoost Strong Hypothesis file!!" << endl;
+			exit(1);
+		}
+		UnSerialization::seekAndParseEnclosedValue<string>(st, "algo");
+
+		bits = 0;
+		seed = 0;
+		UnSerialization::parseFeatureHashing(st, bits, seed);
+	}
+
+	// -------------------------------------------------------------------------
+	// -------------------------------------------------------------------------
+
+	PosteriorsServer::PosteriorsServer(const nor_utils::Args& args, int verbose)
+		: AdaBoostMHClassifier(args, verbose), _pData(NULL), _batchSize(0), _maxBatchSize(256)
+	{
+		if ( args.hasArgument("servebatch") )
+			args.getValue("servebatch", 0, _maxBatchSize);
+
+		if ( _maxBatchSize < 1 )
+			_maxBatchSize = 1;
+	}
+
+	// -------------------------------------------------------------------------
+
+	PosteriorsServer::~PosteriorsServer()
+	{
+		for (size_t m = 0; m < _models.size(); ++m)
+		{
+			vector<BaseLearner*>::iterator whyIt;
+			for (whyIt = _models[m].begin(); whyIt != _models[m].end(); ++whyIt)
+				delete *whyIt;
+		}
+
+		if (_pData)
+			delete _pData;
+	}
+
+	// -------------------------------------------------------------------------
+
+	void PosteriorsServer::load(const string& headerFileName, const string& shypFileNames)
+	{
+		// the standard output is kept for the posteriors
+		streambuf* pCoutBuf = cout.rdbuf( cerr.rdbuf() );
+
+		vector<string> fileNames;
+		tokenize(shypFileNames, 0, shypFileNames.size(), ",", fileNames);
+		if ( fileNames.empty() )
+		{
+			cerr << "ERROR: No strong hypothesis file given to --serve!" << endl;
+			exit(1);
+		}
+
+		// all the models must put the features into the same columns
+		int hashBits;
+		unsigned int hashSeed;
+		readFeatureHashing(fileNames[0], hashBits, hashSeed);
+		for (size_t m = 1; m < fileNames.size(); ++m)
+		{
+			int bits;
+			unsigned int seed;
+			readFeatureHashing(fileNames[m], bits, seed);
+			if ( bits != hashBits || ( bits > 0 && seed != hashSeed ) )
+			{
+				cerr << "ERROR: The feature hashing of the strong hypothesis <" << fileNames[m] 
+					 << "> differs from the one of <" << fileNames[0] << ">!" << endl;
+				exit(1);
+			}
+		}
+
+		// the first model decides the type of the data
+		_pData = loadInputData(headerFileName, fileNames[0]);
+
+		_models.resize( fileNames.size() );
+		for (size_t m = 0; m < fileNames.size(); ++m)
+		{
+			if (_verbose > 0)
+				cerr << "Loading strong hypothesis <" << fileNames[m] << ">..." << endl;
+
+			UnSerialization us;
+			us.loadHypotheses(fileNames[m], _models[m], _pData, _verbose);
+
+			if ( _models[m].empty() )
+			{
+				cerr << "ERROR: The strong hypothesis <" << fileNames[m] << "> is empty!" << endl;
+				exit(1);
+			}
+		}
+
+		cout.rdbuf( pCoutBuf );
+	}
+
+	// -------------------------------------------------------------------------
+
+	void PosteriorsServer::serveStandardInput()
+	{
+		ostream out( cout.rdbuf() );
+		streambuf* pCoutBuf = cout.rdbuf( cerr.rdbuf() );
+
+		if (_verbose > 0)
+			cerr << "Serving the standard input..." << endl;
+
+		string line;
+		while ( getline(cin, line) )
+		{
+			addLine(line, out);
+
+			// answer as soon as no more lines are waiting
+			if ( cin.rdbuf()->in_avail() <= 0 )
+			{
+				if ( _batchSize > 0 )
+					classifyBatch(out);
+				out.flush();
+			}
+		}
+
+		if ( _batchSize > 0 )
+			classifyBatch(out);
+		out.flush();
+
+		cout.rdbuf( pCoutBuf );
+	}
+
+	// -------------------------------------------------------------------------
+
+#ifndef WIN32
+
+	// Write the whole string on a socket. Returns false if the client is gone.
+	static bool sendAll(int fd, const string& str)
+	{
+#ifdef MSG_NOSIGNAL
+		const int flags = MSG_NOSIGNAL;
+#else
+		const int flags = 0;
+#endif
+		size_t sent = 0;
+		while ( sent < str.size() )
+		{
+			const ssize_t n = ::send(fd, str.data() + sent, str.size() - sent, flags);
+			if ( n <= 0 )
+				return false;
+			sent += n;
+		}
+		return true;
+	}
+
+	// -------------------------------------------------------------------------
+
+	void PosteriorsServer::serveSocket(const string& socketPath)
+	{
+		sockaddr_un address;
+		memset(&address, 0, sizeof(address));
+		address.sun_family = AF_UNIX;
+		if ( socketPath.size() >= sizeof(address.sun_path) )
+		{
+			cerr << "ERROR: The socket path <" << socketPath << "> is too long!" << endl;
+			exit(1);
+		}
+		strcpy(address.sun_path, socketPath.c_str());
+
+		const int serverFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+		::unlink( socketPath.c_str() );
+		if ( serverFd < 0 || 
+			 ::bind(serverFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+			 ::listen(serverFd, 8) != 0 )
+		{
+			cerr << "ERROR: Cannot listen on the socket <" << socketPath << ">!" << endl;
+			exit(1);
+		}
+
+		if (_verbose > 0)
+			cerr << "Serving the socket <" << socketPath << ">..." << endl;
+
+		const int bufferSize = 65536;
+		vector<char> buffer(bufferSize);
+		string pending;
+		ostringstream out;
+
+		for (;;)
+		{
+			const int clientFd = ::accept(serverFd, NULL, NULL);
+			if ( clientFd < 0 )
+				continue;
+
+			pending.clear();
+			bool isConnected = true;
+			ssize_t numRead;
+			while ( isConnected && ( numRead = ::read(clientFd, &buffer[0], bufferSize) ) > 0 )
+			{
+				pending.append(&buffer[0], numRead);
+
+				size_t begin = 0, end;
+				while ( ( end = pending.find('\n', begin) ) != string::npos )
+				{
+					addLine( pending.substr(begin, end - begin), out );
+					begin = end + 1;
+				}
+				pending.erase(0, begin);
+
+				// answer the complete lines received so far
+				if ( _batchSize > 0 )
+					classifyBatch(out);
+				isConnected = sendAll(clientFd, out.str());
+				out.str("");
+			}
+
+			// the last line might have no newline
+			if ( isConnected && !pending.empty() )
+			{
+				addLine(pending, out);
+				if ( _batchSize > 0 )
+					classifyBatch(out);
+				sendAll(clientFd, out.str());
+			}
+			out.str("");
+			_batchSize = 0;
+
+			::close(clientFd);
+		}
+	}
+
+#else
+
+	void PosteriorsServer::serveSocket(const string& socketPath)
+	{
+		cerr << "ERROR: --serve on a socket is not available on this platform!" << endl;
+		exit(1);
+	}
+
+#endif
+
+	// -------------------------------------------------------------------------
+
+	bool PosteriorsServer::parseLine(const string& line, Example& example)
+	{
+		const size_t begin = line.find_first_not_of(" \t\r");
+		if ( begin == string::npos || line[begin] == '%' || line[begin] == '#' )
+			return false;
+
+		vector<float>& values = example.getValues();
+		vector<int>& idxs = example.getValuesIndexes();
+		values.clear();
+		idxs.clear();
+
+		// the lines are in the columns of the file, as the load-time 
+		// transformations (--selectcolumns, ...) have not been applied yet
+		TransformPipeline* pTransforms = _pData->getTransforms();
+		const int numAttributes = _pData->getRawNumAttributes();
+		const NameMap& attributeNameMap = _pData->getRawAttributeNameMap();
+		const vector<RawData::eAttributeType>& attributeTypes = _pData->getRawAttributeTypes();
+		const bool isDense = ( _pData->getDataRep() == DR_DENSE );
+
+		if ( line[begin] == '{' ) // ARFF sparse: {index value, ...}
+		{
+			size_t end = line.find('}', begin);
+			if ( end == string::npos )
+				end = line.size();
+			tokenize(line, begin + 1, end, " \t\r,", _tokens);
+
+			for (size_t k = 0; k + 1 < _tokens.size(); k += 2)
+			{
+				const int j = atoi( _tokens[k].c_str() );
+				if ( j < 0 || j >= numAttributes )
+					continue;
+
+				const string& token = _tokens[k+1];
+				if ( j >= (int)attributeTypes.size() || attributeTypes[j] == RawData::ATTRIBUTE_NUMERIC )
+				{
+					// the missing values are read as by ArffParser, which only marks them in dense data
+					if ( isDense && ( token == "?" || token == "NaN" || token == "Nan" ) )
+						values.push_back( numeric_limits<float>::infinity() );
+					else
+						values.push_back( static_cast<float>( atof( token.c_str() ) ) );
+				}
+				else
+				{
+					const int enumIdx = _pData->getRawEnumMap(j).findName( token );
+					if ( enumIdx < 0 )
+						continue;
+					values.push_back( static_cast<float>( enumIdx ) );
+				}
+				idxs.push_back(j);
+			}
+		}
+		else // SVMLight: [label] name:value ...
+		{
+			const int hashBits = _pData->getFeatureHashingBits();
+			const unsigned int hashSeed = _pData->getFeatureHashingSeed();
+
+			tokenize(line, begin, line.size(), " \t\r", _tokens);
+
+			for (size_t k = 0; k < _tokens.size(); ++k)
+			{
+				const string& token = _tokens[k];
+				const size_t colon = token.rfind(':');
+				if ( colon == string::npos ) // the label
+					continue;
+
+				int j;
+				if ( hashBits > 0 )
+					j = (int)( nor_utils::murmur_hash(token.data(), (int)colon, hashSeed) & ((1u << hashBits) - 1) );
+				else
+					j = attributeNameMap.findName( token.substr(0, colon) );
+				if ( j < 0 || j >= numAttributes )
+					continue;
+
+				idxs.push_back(j);
+				values.push_back( static_cast<float>( atof( token.c_str() + colon + 1 ) ) );
+			}
+		}
+
+		if ( isDense )
+		{
+			// the header has dense data: the missing columns are zeros
+			vector<float> denseValues(numAttributes, 0);
+			for (size_t k = 0; k < idxs.size(); ++k)
+				denseValues[ idxs[k] ] = values[k];
+			values.swap(denseValues);
+			idxs.clear();
+		}
+		else
+			example.compactSparseValues();
+
+		// the same transformations as the examples of the file (see RawData::load)
+		if ( pTransforms )
+			pTransforms->transformExample( example, attributeNameMap, attributeTypes );
+
+		return true;
+	}
+
+	// -------------------------------------------------------------------------
+
+	void PosteriorsServer::addLine(const string& line, ostream& out)
+	{
+		if ( _batchSize == static_cast<int>( _batch.size() ) )
+			_batch.push_back( Example() );
+
+		if ( !parseLine(line, _batch[_batchSize]) )
+			return;
+
+		if ( ++_batchSize == _maxBatchSize )
+			classifyBatch(out);
+	}
+
+	// -------------------------------------------------------------------------
+
+	void PosteriorsServer::classifyBatch(ostream& out)
+	{
+		// the batch goes into the data, and the previous examples come back for reuse
+		_batch.resize(_batchSize);
+		_pData->setExamples(_batch);
+		_batchSize = 0;
+
+		const int numClasses = _pData->getNumClasses();
+		const int numExamples = _pData->getNumExamples();
+		const int numModels = static_cast<int>( _models.size() );
+		const int modelStride = numExamples * numClasses;
+
+		// the same sums as in IncrementalEvaluator::run(), one weak hypothesis at a time
+		_votes.assign(numModels * modelStride, 0);
+		for (int m = 0; m < numModels; ++m)
+		{
+			vector<BaseLearner*>::const_iterator whyIt;
+			for (whyIt = _models[m].begin(); whyIt != _models[m].end(); ++whyIt)
+			{
+				BaseLearner* currWeakHyp = *whyIt;
+				const float alpha = currWeakHyp->getAlpha();
+
+				float* pVotes = &_votes[m * modelStride];
+				for (int i = 0; i < numExamples; ++i, pVotes += numClasses)
+				{
+					for (int l = 0; l < numClasses; ++l)
+						pVotes[l] += alpha * currWeakHyp->classify(_pData, i, l);
+				}
+			}
+		}
+
+		for (int i = 0; i < numExamples; ++i)
+		{
+			for (int m = 0; m < numModels; ++m)
+			{
+				const float* pVotes = &_votes[m * modelStride + i * numClasses];
+				if ( m > 0 )
+					out << '\t';
+				out << pVotes[0];
+				for (int l = 1; l < numClasses; ++l)
+					out << ',' << pVotes[l];
+			}
+			out << '\n';
+		}
+	}
+
+	// -------------------------------------------------------------------------
+
+} // end of namespace MultiBoost
@@ -0,0 +1,170 @@
+/*
+*
+*    MultiBoost - Multi-purpose boosting package
+*
+*    Copyright (C) 2010   AppStat group
+*                         Laboratoire de l'Accelerateur Lineaire
+*                         Universite Paris-Sud, 11, CNRS
+*
+*    This file is part of the MultiBoost library
+*
+*    This library is free software; you can redistribute it 
+*    and/or modify it under the terms of the GNU General Public
+*    License as published by the Free Software Foundation; either
+*    version 2.1 of the License, or (at your option) any later version.
+*
+*    This library is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+*    General Public License for more details.
+*
+*    You should have received a copy of the GNU General Public
+*    License along with this library; if not, write to the Free Software
+*    Foundation, Inc., 51 Franklin St, 5th Floor, Boston, MA 02110-1301 USA
+*
+*    Contact: Balazs Kegl (balazs.kegl@gmail.com)
+*             Norman Casagrande (nova77@gmail.com)
+*             Robert Busa-Fekete (busarobi@gmail.com)
+*
+*    For more information and up-to-date version, please visit
+*        
+*                       http://www.multiboost.org/
+*
+*/
+
+
+
+/**
+* \file PosteriorsServer.h Outputs the posteriors of examples read line by line,
+* with the models loaded once.
+*/
+#pragma warning( disable : 4786 )
+
+#ifndef __POSTERIORS_SERVER_H
+#define __POSTERIORS_SERVER_H
+
+#include "Classifiers/AdaBoostMHClassifier.h"
+#include "Others/Example.h"
+
+#include <vector>
+#include <string>
+#include <iosfwd>
+
+using namespace std;
+
+namespace MultiBoost {
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+// Forward declarations.
+class InputData;
+class BaseLearner;
+
+/**
+* A long-running classifier (--serve). One or more strong hypotheses are loaded
+* once, then the examples are read line by line, either in the ARFF sparse syntax
+* \code
+* {3 0.5, 17 1, 42 red}
+* \endcode
+* where the columns are the 0-based indexes of the attributes, or in the SVMLight syntax
+* \code
+* c1 age:0.5 height:1
+* \endcode
+* where the label is optional and the features are the names of the attributes (or
+* they are hashed, if the models were trained with --featurehashing). Anything after 
+* the closing brace of an ARFF line is ignored, and so are the unknown attributes.
+* For each example a line is written back with the posteriors of each model, as in
+* --posteriors, separated by tabs. Empty lines and comments (% or #) get no answer.
+*
+* The lines that are already available are classified together, up to a maximum
+* batch size: each weak hypothesis is then applied to the whole batch, and the 
+* batch goes into the same InputData, whose memory is reused.
+*
+* The header file (an ARFF or SVMLight file, possibly without data) gives the
+* attributes and the classes. All the models must have been trained on them, with
+* the same feature hashing. The columns of the served lines are the ones of the 
+* header file: the load-time transformations (--selectcolumns, --missingvalue, 
+* --quantize) are applied to each line as to the examples of the file.
+* \date 18/10/2026
+*/
+class PosteriorsServer : public AdaBoostMHClassifier
+{
+public:
+
+   /**
+   * The constructor.
+   * \param args The arguments defined by the user in the command line.
+   * \param verbose The level of verbosity.
+   * \date 18/10/2026
+   */
+   PosteriorsServer(const nor_utils::Args& args, int verbose = 1);
+
+   /**
+   * The destructor. Deletes the data and the weak hypotheses.
+   */
+   ~PosteriorsServer();
+
+   /**
+   * Load the header and the models. The messages go to the standard error.
+   * \param headerFileName The file with the attributes and the classes.
+   * \param shypFileNames The strong hypothesis files, separated by commas.
+   * \date 18/10/2026
+   */
+   void load(const string& headerFileName, const string& shypFileNames);
+
+   /**
+   * Answer the lines of the standard input on the standard output, until the end of
+   * the input. Everything else written on the standard output goes to the standard error.
+   * \date 18/10/2026
+   */
+   void serveStandardInput();
+
+   /**
+   * Answer the clients of a local (UNIX) socket, one connection at a time, forever.
+   * \param socketPath The path of the socket. An existing file is replaced.
+   * \date 18/10/2026
+   */
+   void serveSocket(const string& socketPath);
+
+protected:
+
+   /**
+   * Parse a line into an example.
+   * \param line The line.
+   * \param example The returned example. Its previous values are cleared.
+   * \return false if the line is empty or a comment.
+   * \date 18/10/2026
+   */
+   bool parseLine(const string& line, Example& example);
+
+   /**
+   * Classify the examples of _batch, and write their posteriors.
+   * \param out The stream where the posteriors go.
+   * \date 18/10/2026
+   */
+   void classifyBatch(ostream& out);
+
+   /**
+   * Add a line to the batch, classifying the batch once it is full.
+   * \param line The line.
+   * \param out The stream where the posteriors go.
+   * \date 18/10/2026
+   */
+   void addLine(const string& line, ostream& out);
+
+   InputData* _pData; //!< The header, and then the current batch.
+
+   vector< vector<BaseLearner*> > _models; //!< The weak hypotheses of each model.
+
+   vector<Example> _batch; //!< The examples waiting to be classified. Only the first _batchSize are used.
+   int             _batchSize; //!< The number of examples in _batch.
+   int             _maxBatchSize; //!< The maximum number of examples classified together (--servebatch).
+
+   vector<float>   _votes; //!< The votes of the batch, example by example.
+   vector<string>  _tokens; //!< Buffer for the tokens of a line.
+};
+
+} // end of namespace MultiBoost
+
+#endif // __POSTERIORS_SERVER_H
@@ -74,6 +74,13 @@ public:
    */
    const vector<ADTreePredictionNode*>& getPredictionNodes() { return _predictionNodesFound; }
 
+   /**
+   * No views: a SortedData view would not hold the prediction nodes.
+   * \see SortedData::createPartitionView
+   * \date 18/10/2026
+   */
+   virtual InputData* createPartitionView( int /*nodeIdx*/ ) { return NULL; }
+
 protected:
 
    /**
@@ -37,6 +37,7 @@
 #include <cmath> // for abs
 
 #include "IO/ArffParser.h"
+#include "IO/DataTransform.h"
 #include "Utils/Utils.h"
 
 namespace MultiBoost {
@@ -68,7 +69,7 @@ namespace MultiBoost {
 		_labelRep = LR_UNKNOWN;
 
 		readHeader(inFile, classMap, enumMaps, attributeNameMap, attributeTypes);
-		readData(inFile, examples, classMap, enumMaps, attributeTypes);
+		readData(inFile, examples, classMap, enumMaps, attributeNameMap, attributeTypes);
 
 	}
 
@@ -214,7 +215,7 @@ namespace MultiBoost {
 	// ------------------------------------------------------------------------
 
 	void ArffParser::readData( ifstream& in, vector<Example>& examples,
-		NameMap& classMap, vector<NameMap>& enumMaps,
+		NameMap& classMap, vector<NameMap>& enumMaps, const NameMap& attributeNameMap,
 		const vector<RawData::eAttributeType>& attributeTypes )
 	{
 		char firstChar = 0;
@@ -289,8 +290,9 @@ namespace MultiBoost {
 				ssSparse.clear();
 				ssSparse.str(tmpLine);
 
-				readSparseValues(ssSparse, currExample.getValues(), currExample.getValuesIndexes(), currExample.getValuesIndexesMap(),
+				readSparseValues(ssSparse, currExample.getValues(), currExample.getValuesIndexes(),
 					enumMaps, attributeTypes );
+				currExample.compactSparseValues();
 			}
 			else // dense!
 			{
@@ -314,6 +316,10 @@ namespace MultiBoost {
 				*/
 			}
 
+			// fused preprocessing (projection, missing values, ...)
+			if ( _pTransform )
+				_pTransform->transformExample(currExample, attributeNameMap, attributeTypes);
+
 			//////////////////////////////////////////////////////////////////////////
 			while ( !in.eof() )
 			{
@@ -457,17 +463,15 @@ namespace MultiBoost {
 	// -----------------------------------------------------------------------------
 
 	void ArffParser::readSparseValues(istringstream& ss, vector<float>& values, 
-		vector<int>& idxs, map<int, int>& idxmap, vector<NameMap>& enumMaps, 
+		vector<int>& idxs, vector<NameMap>& enumMaps, 
 		const vector<RawData::eAttributeType>& attributeTypes)
 	{
 		string tmpVal;
 		int tmpIdx;
-		int i = 0;
 		while (!ss.eof())
 		{
 			ss >> tmpIdx;
 			idxs.push_back(tmpIdx);
-			idxmap[ tmpIdx ] = i++;
 			ss >> tmpVal;
 			if ( attributeTypes[tmpIdx] == RawData::ATTRIBUTE_NUMERIC ) 
 				values.push_back( atof(tmpVal.c_str()) );
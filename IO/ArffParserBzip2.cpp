@@ -37,6 +37,7 @@
 #include <cmath> // for abs
 
 #include "IO/ArffParserBzip2.h"
+#include "IO/DataTransform.h"
 #include "Utils/Utils.h"
 
 namespace MultiBoost {
@@ -70,7 +71,7 @@ namespace MultiBoost {
 		_labelRep = LR_UNKNOWN;
 
 		readHeader(inFile, classMap, enumMaps, attributeNameMap, attributeTypes);
-		readData(inFile, examples, classMap, enumMaps, attributeTypes);
+		readData(inFile, examples, classMap, enumMaps, attributeNameMap, attributeTypes);
 
 	}
 
@@ -207,7 +208,7 @@ namespace MultiBoost {
 	// ------------------------------------------------------------------------
 
 	void ArffParserBzip2::readData( Bzip2WrapperReader& in, vector<Example>& examples,
-		NameMap& classMap, vector<NameMap>& enumMaps,
+		NameMap& classMap, vector<NameMap>& enumMaps, const NameMap& attributeNameMap,
 		const vector<RawData::eAttributeType>& attributeTypes )
 	{
 		char firstChar = 0;
@@ -285,8 +286,9 @@ namespace MultiBoost {
 				ssSparse.clear();
 				ssSparse.str(tmpLine);
 
-				readSparseValues(ssSparse, currExample.getValues(), currExample.getValuesIndexes(), currExample.getValuesIndexesMap(),
+				readSparseValues(ssSparse, currExample.getValues(), currExample.getValuesIndexes(),
 					enumMaps, attributeTypes );
+				currExample.compactSparseValues();
 			}
 			else // dense!
 			{
@@ -312,6 +314,10 @@ namespace MultiBoost {
 				*/
 			}
 
+			// fused preprocessing (projection, missing values, ...)
+			if ( _pTransform )
+				_pTransform->transformExample(currExample, attributeNameMap, attributeTypes);
+
 			//////////////////////////////////////////////////////////////////////////
 			while ( !in.eof() )
 			{
@@ -453,17 +459,15 @@ namespace MultiBoost {
 	// -----------------------------------------------------------------------------
 
 	void ArffParserBzip2::readSparseValues(istringstream& ss, vector<float>& values, 
-		vector<int>& idxs, map<int,int>& idxmap, vector<NameMap>& enumMaps, 
+		vector<int>& idxs, vector<NameMap>& enumMaps, 
 		const vector<RawData::eAttributeType>& attributeTypes)
 	{
 		string tmpVal;
 		int tmpIdx;
-		int i = 0;
 		while (!ss.eof())
 		{
 			ss >> tmpIdx;
 			idxs.push_back(tmpIdx);
-			idxmap[ tmpIdx ] = i++;
 			ss >> tmpVal;
 			if ( attributeTypes[tmpIdx] == RawData::ATTRIBUTE_NUMERIC ) 
 				values.push_back( atof(tmpVal.c_str()) );
@@ -73,7 +73,7 @@ protected:
 		   vector<NameMap>& enumMaps, NameMap& attributeNameMap, 
 		   vector<RawData::eAttributeType>& attributeTypes);
    void readData(Bzip2WrapperReader& in, vector<Example>& examples, NameMap& classMap, 
-		 vector<NameMap>& enumMaps, 
+		 vector<NameMap>& enumMaps, const NameMap& attributeNameMap,
 		 const vector<RawData::eAttributeType>& attributeTypes);
 
    string readName(Bzip2WrapperReader& in);
@@ -82,7 +82,7 @@ protected:
 			vector<NameMap>& enumMaps, 
 			const vector<RawData::eAttributeType>& attributeTypes);
 
-   void readSparseValues(istringstream& ss, vector<float>& values, vector<int>& idxs, map<int,int>& idxmap, 
+   void readSparseValues(istringstream& ss, vector<float>& values, vector<int>& idxs, 
 			 vector<NameMap>& enumMaps, 
 			 const vector<RawData::eAttributeType>& attributeTypes);
 
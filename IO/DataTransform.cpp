@@ -0,0 +1,276 @@
+/*
+*
+*    MultiBoost - Multi-purpose boosting package
+*
+*    Copyright (C) 2010   AppStat group
+*                         Laboratoire de l'Accelerateur Lineaire
+*                         Universite Paris-Sud, 11, CNRS
+*
+*    This file is part of the MultiBoost library
+*
+*    This library is free software; you can redistribute it
+*    and/or modify it under the terms of the GNU General Public
+*    License as published by the Free Software Foundation; either
+*    version 2.1 of the License, or (at your option) any later version.
+*
+*    This library is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+*    General Public License for more details.
+*
+*    You should have received a copy of the GNU General Public
+*    License along with this library; if not, write to the Free Software
+*    Foundation, Inc., 51 Franklin St, 5th Floor, Boston, MA 02110-1301 USA
+*
+*    Contact: Balazs Kegl (balazs.kegl@gmail.com)
+*             Norman Casagrande (nova77@gmail.com)
+*             Robert Busa-Fekete (busarobi@gmail.com)
+*
+*    For more information and up-to-date version, please visit
+*
+*                       http://www.multiboost.org/
+*
+*/
+
+
+#include <fstream>
+#include <sstream>
+#include <iostream> // for cerr
+#include <cmath> // for floor
+#include <limits> // for numeric_limits
+
+#include "IO/DataTransform.h"
+
+namespace MultiBoost {
+
+// ------------------------------------------------------------------------
+
+ColumnProjection::ColumnProjection(const string& fileName)
+   : _numSelected(0)
+{
+   ifstream inFile(fileName.c_str());
+   if ( !inFile.is_open() )
+   {
+      cerr << "ERROR: Cannot open the column selection file <" << fileName << ">!" << endl;
+      exit(1);
+   }
+
+   string name;
+   while ( inFile >> name )
+      _selectedNames.insert(name);
+
+   if ( _selectedNames.empty() )
+   {
+      cerr << "ERROR: No attribute listed in the column selection file <" << fileName << ">!" << endl;
+      exit(1);
+   }
+}
+
+// ------------------------------------------------------------------------
+
+string ColumnProjection::getColumnName(const NameMap& attributeNameMap, int j) const
+{
+   if ( j < attributeNameMap.getNumNames() )
+      return attributeNameMap.getNameFromIdx(j);
+
+   // unnamed column (simple text format)
+   ostringstream ss;
+   ss << j;
+   return ss.str();
+}
+
+// ------------------------------------------------------------------------
+
+void ColumnProjection::updateMapping(const NameMap& attributeNameMap, int numColumns)
+{
+   for (int j = (int)_newIdxs.size(); j < numColumns; ++j)
+   {
+      if ( isAttributeUsed( getColumnName(attributeNameMap, j) ) )
+         _newIdxs.push_back(_numSelected++);
+      else
+         _newIdxs.push_back(-1);
+   }
+}
+
+// ------------------------------------------------------------------------
+
+void ColumnProjection::transformExample(Example& example, const NameMap& attributeNameMap,
+                                        const vector<RawData::eAttributeType>& /*attributeTypes*/)
+{
+   vector<float>& values = example.getValues();
+   vector<int>& idxs = example.getValuesIndexes();
+
+   const int numNames = attributeNameMap.getNumNames();
+
+   if ( idxs.empty() )
+   {
+      // dense: compact the kept values to the front
+      updateMapping( attributeNameMap, max(numNames, (int)values.size()) );
+
+      int k = 0;
+      for (int j = 0; j < (int)values.size(); ++j)
+      {
+         if ( _newIdxs[j] >= 0 )
+            values[k++] = values[j];
+      }
+      values.resize(k);
+   }
+   else
+   {
+      // sparse: filter the (index, value) pairs and renumber the indexes
+      // (the mapping is monotone, so the indexes stay sorted)
+      int maxIdx = numNames - 1;
+      for (int i = 0; i < (int)idxs.size(); ++i)
+         maxIdx = max(maxIdx, idxs[i]);
+      updateMapping( attributeNameMap, maxIdx + 1 );
+
+      int k = 0;
+      for (int i = 0; i < (int)idxs.size(); ++i)
+      {
+         const int newIdx = _newIdxs[ idxs[i] ];
+         if ( newIdx < 0 )
+            continue;
+
+         idxs[k] = newIdx;
+         values[k] = values[i];
+         ++k;
+      }
+      idxs.resize(k);
+      values.resize(k);
+   }
+}
+
+// ------------------------------------------------------------------------
+
+void ColumnProjection::transformHeader(NameMap& attributeNameMap,
+                                       vector<RawData::eAttributeType>& attributeTypes,
+                                       vector<NameMap>& enumMaps)
+{
+   updateMapping( attributeNameMap, attributeNameMap.getNumNames() );
+
+   NameMap newNameMap;
+   vector<RawData::eAttributeType> newTypes(_numSelected, RawData::ATTRIBUTE_NUMERIC);
+   vector<NameMap> newEnumMaps;
+
+   const bool hasEnumMaps = ( enumMaps.size() == _newIdxs.size() );
+   if ( hasEnumMaps )
+      newEnumMaps.resize(_numSelected);
+
+   for (int j = 0; j < (int)_newIdxs.size(); ++j)
+   {
+      const int newIdx = _newIdxs[j];
+      if ( newIdx < 0 )
+         continue;
+
+      newNameMap.addName( getColumnName(attributeNameMap, j) );
+      if ( j < (int)attributeTypes.size() )
+         newTypes[newIdx] = attributeTypes[j];
+      if ( hasEnumMaps )
+         newEnumMaps[newIdx] = enumMaps[j];
+   }
+
+   attributeNameMap = newNameMap;
+   attributeTypes.swap(newTypes);
+   if ( hasEnumMaps )
+      enumMaps.swap(newEnumMaps);
+}
+
+// ------------------------------------------------------------------------
+// ------------------------------------------------------------------------
+
+void MissingValueImputation::transformExample(Example& example, const NameMap& /*attributeNameMap*/,
+                                              const vector<RawData::eAttributeType>& attributeTypes)
+{
+   vector<float>& values = example.getValues();
+   const vector<int>& idxs = example.getValuesIndexes();
+   const float inf = numeric_limits<float>::infinity();
+
+   for (int i = 0; i < (int)values.size(); ++i)
+   {
+      const int j = idxs.empty() ? i : idxs[i];
+      if ( j < (int)attributeTypes.size() && attributeTypes[j] == RawData::ATTRIBUTE_ENUM )
+         continue;
+
+      const float val = values[i];
+      if ( val != val || val == inf || val == -inf )
+         values[i] = _value;
+   }
+}
+
+// ------------------------------------------------------------------------
+// ------------------------------------------------------------------------
+
+void ValueQuantization::transformExample(Example& example, const NameMap& /*attributeNameMap*/,
+                                         const vector<RawData::eAttributeType>& attributeTypes)
+{
+   vector<float>& values = example.getValues();
+   const vector<int>& idxs = example.getValuesIndexes();
+
+   for (int i = 0; i < (int)values.size(); ++i)
+   {
+      const int j = idxs.empty() ? i : idxs[i];
+      if ( j < (int)attributeTypes.size() && attributeTypes[j] == RawData::ATTRIBUTE_ENUM )
+         continue;
+
+      // non-finite (missing) values are left untouched
+      values[i] = floor( values[i] / _step + 0.5f ) * _step;
+   }
+}
+
+// ------------------------------------------------------------------------
+// ------------------------------------------------------------------------
+
+TransformPipeline::~TransformPipeline()
+{
+   vector<DataTransform*>::iterator it;
+   for (it = _stages.begin(); it != _stages.end(); ++it)
+      delete *it;
+}
+
+// ------------------------------------------------------------------------
+
+bool TransformPipeline::isAttributeUsed(const string& name) const
+{
+   vector<DataTransform*>::const_iterator it;
+   for (it = _stages.begin(); it != _stages.end(); ++it)
+   {
+      if ( !(*it)->isAttributeUsed(name) )
+         return false;
+   }
+   return true;
+}
+
+// ------------------------------------------------------------------------
+
+void TransformPipeline::transformExample(Example& example, const NameMap& attributeNameMap,
+                                         const vector<RawData::eAttributeType>& attributeTypes)
+{
+   vector<DataTransform*>::iterator it;
+   for (it = _stages.begin(); it != _stages.end(); ++it)
+      (*it)->transformExample(example, attributeNameMap, attributeTypes);
+}
+
+// ------------------------------------------------------------------------
+
+void TransformPipeline::transformHeader(NameMap& attributeNameMap,
+                                        vector<RawData::eAttributeType>& attributeTypes,
+                                        vector<NameMap>& enumMaps)
+{
+   vector<DataTransform*>::iterator it;
+   for (it = _stages.begin(); it != _stages.end(); ++it)
+      (*it)->transformHeader(attributeNameMap, attributeTypes, enumMaps);
+}
+
+// ------------------------------------------------------------------------
+
+int TransformPipeline::getNumAttributes(int numAttributes) const
+{
+   vector<DataTransform*>::const_iterator it;
+   for (it = _stages.begin(); it != _stages.end(); ++it)
+      numAttributes = (*it)->getNumAttributes(numAttributes);
+   return numAttributes;
+}
+
+// ------------------------------------------------------------------------
+
+} // end of namespace MultiBoost
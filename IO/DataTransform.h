@@ -0,0 +1,229 @@
+/*
+*
+*    MultiBoost - Multi-purpose boosting package
+*
+*    Copyright (C) 2010   AppStat group
+*                         Laboratoire de l'Accelerateur Lineaire
+*                         Universite Paris-Sud, 11, CNRS
+*
+*    This file is part of the MultiBoost library
+*
+*    This library is free software; you can redistribute it
+*    and/or modify it under the terms of the GNU General Public
+*    License as published by the Free Software Foundation; either
+*    version 2.1 of the License, or (at your option) any later version.
+*
+*    This library is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+*    General Public License for more details.
+*
+*    You should have received a copy of the GNU General Public
+*    License along with this library; if not, write to the Free Software
+*    Foundation, Inc., 51 Franklin St, 5th Floor, Boston, MA 02110-1301 USA
+*
+*    Contact: Balazs Kegl (balazs.kegl@gmail.com)
+*             Norman Casagrande (nova77@gmail.com)
+*             Robert Busa-Fekete (busarobi@gmail.com)
+*
+*    For more information and up-to-date version, please visit
+*
+*                       http://www.multiboost.org/
+*
+*/
+
+
+/**
+* \file DataTransform.h Transformations applied to the examples while they are parsed.
+*/
+
+#ifndef __DATA_TRANSFORM_H
+#define __DATA_TRANSFORM_H
+
+#include <string>
+#include <vector>
+#include <set>
+
+#include "IO/RawData.h"
+#include "IO/NameMap.h"
+#include "Others/Example.h"
+
+using namespace std;
+
+namespace MultiBoost {
+
+/**
+* A preprocessing stage that is fused into the parsing pass.
+* The parsers call transformExample() on each example as soon as its values
+* have been read (before the labels, and before the next line is parsed), so
+* no stage needs a second copy of the data. Once the whole file has been read
+* RawData calls transformHeader(), which lets the stages that change the
+* layout of the columns rewrite the attribute names, types and enum maps.
+* \remark The stages must be data-independent (they cannot look at statistics
+* of the training set), because the very same options are applied to the
+* test set by the classifiers.
+* \date 18/10/2026
+*/
+class DataTransform
+{
+public:
+
+   virtual ~DataTransform() {}
+
+   /**
+   * Tells the parsers that register attribute names on the fly (SVMLight)
+   * whether an attribute will survive the transformation, so that the
+   * name does not even need to be stored.
+   * \param name The name of the attribute.
+   * \date 18/10/2026
+   */
+   virtual bool isAttributeUsed(const string& /*name*/) const { return true; }
+
+   /**
+   * Transform the values of a single example in place.
+   * \param example The example just parsed. For sparse data the value indexes
+   * are updated too, and must stay sorted.
+   * \param attributeNameMap The attribute names registered so far.
+   * \param attributeTypes The (original) types of the attributes. It can be
+   * shorter than the number of columns if the parser fills it at the end.
+   * \date 18/10/2026
+   */
+   virtual void transformExample(Example& example, const NameMap& attributeNameMap,
+                                 const vector<RawData::eAttributeType>& attributeTypes) = 0;
+
+   /**
+   * Update the description of the columns once all the examples have been transformed.
+   * \date 18/10/2026
+   */
+   virtual void transformHeader(NameMap& /*attributeNameMap*/,
+                                vector<RawData::eAttributeType>& /*attributeTypes*/,
+                                vector<NameMap>& /*enumMaps*/) {}
+
+   /**
+   * Returns the number of columns after the transformation.
+   * \param numAttributes The number of columns returned by the parser.
+   * \date 18/10/2026
+   */
+   virtual int getNumAttributes(int numAttributes) const { return numAttributes; }
+};
+
+// -----------------------------------------------------------------------------
+
+/**
+* Keeps only the attributes listed (by name) in a file, dropping the others
+* before SortedData allocates and sorts them.
+* The attribute names are separated by white spaces. For the simple text format,
+* which has no attribute names, the columns are named by their (0-based) index.
+* \date 18/10/2026
+*/
+class ColumnProjection : public DataTransform
+{
+public:
+   explicit ColumnProjection(const string& fileName);
+
+   virtual bool isAttributeUsed(const string& name) const 
+   { return _selectedNames.find(name) != _selectedNames.end(); }
+
+   virtual void transformExample(Example& example, const NameMap& attributeNameMap,
+                                 const vector<RawData::eAttributeType>& attributeTypes);
+
+   virtual void transformHeader(NameMap& attributeNameMap,
+                                vector<RawData::eAttributeType>& attributeTypes,
+                                vector<NameMap>& enumMaps);
+
+   virtual int getNumAttributes(int /*numAttributes*/) const { return _numSelected; }
+
+protected:
+
+   /**
+   * Extends the mapping from the original to the projected column indexes
+   * up to \a numColumns columns.
+   * \date 18/10/2026
+   */
+   void updateMapping(const NameMap& attributeNameMap, int numColumns);
+
+   string getColumnName(const NameMap& attributeNameMap, int j) const;
+
+   set<string>   _selectedNames; //!< The names of the attributes to keep.
+   vector<int>   _newIdxs; //!< Original column index -> projected index (-1 if dropped).
+   int           _numSelected; //!< The number of projected columns.
+};
+
+// -----------------------------------------------------------------------------
+
+/**
+* Replaces the missing values (stored as non-finite numbers by the parsers)
+* of the numeric attributes with a constant.
+* \date 18/10/2026
+*/
+class MissingValueImputation : public DataTransform
+{
+public:
+   explicit MissingValueImputation(float value) : _value(value) {}
+
+   virtual void transformExample(Example& example, const NameMap& attributeNameMap,
+                                 const vector<RawData::eAttributeType>& attributeTypes);
+
+protected:
+   float _value; //!< The value that replaces the missing ones.
+};
+
+// -----------------------------------------------------------------------------
+
+/**
+* Rounds the values of the numeric attributes to the nearest multiple of a step.
+* It bounds the number of distinct values per column, and with them the number
+* of thresholds the stump search has to evaluate.
+* \date 18/10/2026
+*/
+class ValueQuantization : public DataTransform
+{
+public:
+   explicit ValueQuantization(float step) : _step(step) {}
+
+   virtual void transformExample(Example& example, const NameMap& attributeNameMap,
+                                 const vector<RawData::eAttributeType>& attributeTypes);
+
+protected:
+   float _step; //!< The quantization step.
+};
+
+// -----------------------------------------------------------------------------
+
+/**
+* An ordered list of stages, applied as a single stage. 
+* It owns (and deletes) the stages added to it.
+* \date 18/10/2026
+*/
+class TransformPipeline : public DataTransform
+{
+public:
+   virtual ~TransformPipeline();
+
+   /**
+   * Append a stage. The stages are applied in the order they are added.
+   * \param pStage The stage, which is deleted by the pipeline.
+   * \date 18/10/2026
+   */
+   void addStage(DataTransform* pStage) { _stages.push_back(pStage); }
+
+   bool empty() const { return _stages.empty(); }
+
+   virtual bool isAttributeUsed(const string& name) const;
+
+   virtual void transformExample(Example& example, const NameMap& attributeNameMap,
+                                 const vector<RawData::eAttributeType>& attributeTypes);
+
+   virtual void transformHeader(NameMap& attributeNameMap,
+                                vector<RawData::eAttributeType>& attributeTypes,
+                                vector<NameMap>& enumMaps);
+
+   virtual int getNumAttributes(int numAttributes) const;
+
+protected:
+   vector<DataTransform*> _stages; //!< The stages of the pipeline.
+};
+
+} // end of namespace MultiBoost
+
+#endif // __DATA_TRANSFORM_H
@@ -0,0 +1,208 @@
+/*
+*
+*    MultiBoost - Multi-purpose boosting package
+*
+*    Copyright (C) 2010   AppStat group
+*                         Laboratoire de l'Accelerateur Lineaire
+*                         Universite Paris-Sud, 11, CNRS
+*
+*    This file is part of the MultiBoost library
+*
+*    This library is free software; you can redistribute it 
+*    and/or modify it under the terms of the GNU General Public
+*    License as published by the Free Software Foundation; either
+*    version 2.1 of the License, or (at your option) any later version.
+*
+*    This library is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+*    General Public License for more details.
+*
+*    You should have received a copy of the GNU General Public
+*    License along with this library; if not, write to the Free Software
+*    Foundation, Inc., 51 Franklin St, 5th Floor, Boston, MA 02110-1301 USA
+*
+*    Contact: Balazs Kegl (balazs.kegl@gmail.com)
+*             Norman Casagrande (nova77@gmail.com)
+*             Robert Busa-Fekete (busarobi@gmail.com)
+*
+*    For more information and up-to-date version, please visit
+*        
+*                       http://www.multiboost.org/
+*
+*/
+
+#include "EnumData.h"
+
+#include "Utils/Args.h"
+
+#include <iostream>
+
+// ------------------------------------------------------------------------
+namespace MultiBoost {
+
+// ------------------------------------------------------------------------
+
+void EnumData::initOptions(const nor_utils::Args& args)
+{
+   InputData::initOptions(args);
+
+   if ( args.hasArgument("enumthreads") )
+      args.getValue("enumthreads", 0, _numThreads);
+#ifndef _OPENMP
+   if ( _numThreads > 1 )
+      cerr << "Warning: compiled without OpenMP, the enum values are weighted sequentially." << endl;
+#endif
+}
+
+// ------------------------------------------------------------------------
+
+void EnumData::load(const string& fileName, eInputType inputType, int verboseLevel)
+{
+   InputData::load(fileName, inputType, verboseLevel);
+
+   // Test does not need the codes
+   if (inputType == IT_TEST)
+      return;
+
+   const int numAttributes = _pData->getNumAttributes();
+   const int numRawExamples = _pData->getNumExample();
+
+   _columnBegins.assign(numAttributes, -1);
+   int numStored = 0;
+   for (int j = 0; j < numAttributes; ++j)
+   {
+      if ( _pData->getAttributeType(j) == RawData::ATTRIBUTE_ENUM &&
+           _pData->getEnumMap(j).getNumNames() < missingCode )
+         _columnBegins[j] = numStored++ * numRawExamples;
+   }
+
+   _codes.resize( static_cast<size_t>(numStored) * numRawExamples );
+
+   for (int j = 0; j < numAttributes; ++j)
+   {
+      if ( _columnBegins[j] < 0 )
+         continue;
+
+      const int numValues = _pData->getEnumMap(j).getNumNames();
+      unsigned short* pCodes = &_codes[ _columnBegins[j] ];
+      for (int i = 0; i < numRawExamples; ++i)
+      {
+         const float val = _pData->getValue(i, j);
+         if ( val != val || val < 0 || val >= numValues ) // NaN: missing value
+            pCodes[i] = missingCode;
+         else
+            pCodes[i] = static_cast<unsigned short>(val);
+      }
+   }
+}
+
+// ------------------------------------------------------------------------
+
+void EnumData::getGammas(int colIdx, vector<float>& gammasPls, vector<float>& gammasMin)
+{
+   const int numClasses = getNumClasses();
+   const int numValues = getEnumMap(colIdx).getNumNames();
+   const int tableSize = numValues * numClasses;
+   const unsigned short* pCodes = getEnumCodes(colIdx);
+
+   gammasPls.assign(tableSize, 0);
+   gammasMin.assign(tableSize, 0);
+   if ( tableSize == 0 )
+      return;
+
+   const int numThreads = ( _numThreads < 1 || _numExamples < _numThreads ) ? 1 : _numThreads;
+   if ( numThreads > 1 )
+      _threadGammas.assign( 2 * static_cast<size_t>(numThreads) * tableSize, 0 );
+
+   // each thread sums a contiguous range of the examples into its own tables
+#pragma omp parallel for num_threads(numThreads) schedule(static, 1) if (numThreads > 1)
+   for (int t = 0; t < numThreads; ++t)
+   {
+      float* pPls = numThreads > 1 ? &_threadGammas[ 2 * static_cast<size_t>(t) * tableSize ] : &gammasPls[0];
+      float* pMin = numThreads > 1 ? pPls + tableSize : &gammasMin[0];
+
+      const int begin = static_cast<int>( static_cast<double>(_numExamples) * t / numThreads );
+      const int end = static_cast<int>( static_cast<double>(_numExamples) * (t + 1) / numThreads );
+      for (int i = begin; i < end; ++i)
+      {
+         int code;
+         if ( pCodes )
+            code = pCodes[ _indirectIndices[i] ];
+         else
+         {
+            const float val = getValue(i, colIdx);
+            code = ( val != val || val < 0 || val >= numValues ) ? missingCode : static_cast<int>(val);
+         }
+         if ( code >= numValues ) // missing value
+            continue;
+
+         float* pRowPls = pPls + code * numClasses;
+         float* pRowMin = pMin + code * numClasses;
+         const vector<Label>& labels = getLabels(i);
+         for (vector<Label>::const_iterator lIt = labels.begin(); lIt != labels.end(); ++lIt)
+         {
+            const float entry = lIt->weight * getLabelY(i, *lIt);
+            if (entry > 0)
+               pRowPls[lIt->idx] += entry;
+            else if (entry < 0)
+               pRowMin[lIt->idx] -= entry;
+         }
+      }
+   }
+
+   // add up the tables of the threads, in thread order
+   for (int t = 0; t < numThreads && numThreads > 1; ++t)
+   {
+      const float* pPls = &_threadGammas[ 2 * static_cast<size_t>(t) * tableSize ];
+      const float* pMin = pPls + tableSize;
+      float* pGammasPls = &gammasPls[0];
+      float* pGammasMin = &gammasMin[0];
+      for (int k = 0; k < tableSize; ++k)
+      {
+         pGammasPls[k] += pPls[k];
+         pGammasMin[k] += pMin[k];
+      }
+   }
+}
+
+// ------------------------------------------------------------------------
+
+void EnumData::computeGammas(InputData* pData, int colIdx, vector<float>& gammasPls, vector<float>& gammasMin)
+{
+   EnumData* pEnumData = dynamic_cast<EnumData*>(pData);
+   if ( pEnumData )
+   {
+      pEnumData->getGammas(colIdx, gammasPls, gammasMin);
+      return;
+   }
+
+   const int numClasses = pData->getNumClasses();
+   const int numValues = pData->getEnumMap(colIdx).getNumNames();
+   const int numExamples = pData->getNumExamples();
+
+   gammasPls.assign(numValues * numClasses, 0);
+   gammasMin.assign(numValues * numClasses, 0);
+
+   for (int i = 0; i < numExamples; ++i)
+   {
+      const float val = pData->getValue(i, colIdx);
+      if ( val != val || val < 0 || val >= numValues ) // missing value
+         continue;
+
+      const int rowBegin = static_cast<int>(val) * numClasses;
+      const vector<Label>& labels = pData->getLabels(i);
+      for (vector<Label>::const_iterator lIt = labels.begin(); lIt != labels.end(); ++lIt)
+      {
+         const float entry = lIt->weight * pData->getLabelY(i, *lIt);
+         if (entry > 0)
+            gammasPls[rowBegin + lIt->idx] += entry;
+         else if (entry < 0)
+            gammasMin[rowBegin + lIt->idx] -= entry;
+      }
+   }
+}
+
+// ------------------------------------------------------------------------
+
+} // end of namespace MultiBoost
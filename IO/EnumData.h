@@ -0,0 +1,154 @@
+/*
+*
+*    MultiBoost - Multi-purpose boosting package
+*
+*    Copyright (C) 2010   AppStat group
+*                         Laboratoire de l'Accelerateur Lineaire
+*                         Universite Paris-Sud, 11, CNRS
+*
+*    This file is part of the MultiBoost library
+*
+*    This library is free software; you can redistribute it 
+*    and/or modify it under the terms of the GNU General Public
+*    License as published by the Free Software Foundation; either
+*    version 2.1 of the License, or (at your option) any later version.
+*
+*    This library is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+*    General Public License for more details.
+*
+*    You should have received a copy of the GNU General Public
+*    License along with this library; if not, write to the Free Software
+*    Foundation, Inc., 51 Franklin St, 5th Floor, Boston, MA 02110-1301 USA
+*
+*    Contact: Balazs Kegl (balazs.kegl@gmail.com)
+*             Norman Casagrande (nova77@gmail.com)
+*             Robert Busa-Fekete (busarobi@gmail.com)
+*
+*    For more information and up-to-date version, please visit
+*        
+*                       http://www.multiboost.org/
+*
+*/
+
+/**
+* \file EnumData.h Input data which keeps the enum columns as arrays of codes.
+*/
+
+#ifndef __ENUM_DATA_H
+#define __ENUM_DATA_H
+
+#include "IO/InputData.h"
+
+#include <vector>
+#include <string>
+
+using namespace std;
+
+namespace MultiBoost {
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+* Overloading of the InputData class for the learners working on the values of
+* the enum attributes (EnumLearnerSA, IndicatorLearner). At load time the enum 
+* columns are stored once as arrays of 16 bit codes (the index of the value in
+* the enum map of the column), so that the per-iteration histogram of the 
+* weights over the values is a pass over a compact array instead of a call to
+* getValue() per example.
+* \see BaseLearner::createInputData()
+* \date 18/10/2026
+*/
+class EnumData : public InputData
+{
+public:
+
+   /**
+   * The constructor. It does nothing but initializing some variables.
+   * \date 18/10/2026
+   */
+   EnumData() : _numThreads(1) {}
+
+   /**
+   * Set the arguments of the data, adding --enumthreads.
+   * \see InputData::initOptions
+   * \date 18/10/2026
+   */
+   virtual void initOptions(const nor_utils::Args& args);
+
+   /**
+   * Overloading of the load function to store the codes of the enum columns.
+   * \param fileName The name of the file to be loaded.
+   * \param inputType The type of input.
+   * \param verboseLevel The level of verbosity.
+   * \see InputData::load()
+   * \date 18/10/2026
+   */
+   virtual void load(const string& fileName, eInputType inputType = IT_TRAIN, int verboseLevel = 1);
+
+   /**
+   * Get the codes of an enum column.
+   * \param colIdx The column index.
+   * \return The codes of the column, indexed by the raw index of the examples 
+   * (see InputData::getRawIndex()), missingCode for the missing values. NULL if 
+   * the column is not stored (numeric column, more than missingCode values, or
+   * test data).
+   * \date 18/10/2026
+   */
+   const unsigned short* getEnumCodes(int colIdx) const
+   { return _columnBegins.empty() || _columnBegins[colIdx] < 0 ? NULL : &_codes[_columnBegins[colIdx]]; }
+
+   /**
+   * Compute the weights of the positive and negative labels per value of an enum
+   * column: gammasPls[v*numClasses+l] (resp. gammasMin) is the sum of the weights
+   * of the labels l with a positive (resp. negative) sign over the examples 
+   * having the value v, with the sign overlay applied (see getLabelY()).
+   * The examples are split among --enumthreads threads, each summing into its 
+   * own table, and the tables are added up in thread order.
+   * \param colIdx The column index.
+   * \param gammasPls The table of the positive labels (numValues x numClasses, resized).
+   * \param gammasMin The table of the negative labels (numValues x numClasses, resized).
+   * \remark The columns which are not stored are read with getValue().
+   * \date 18/10/2026
+   */
+   void getGammas(int colIdx, vector<float>& gammasPls, vector<float>& gammasMin);
+
+   /**
+   * Compute the gamma tables of getGammas() on any input data. The learners 
+   * inside a meta-learner may be given data which is not an EnumData (for 
+   * instance a partition view), then the values are read with getValue().
+   * \param pData The input data.
+   * \param colIdx The column index.
+   * \param gammasPls The table of the positive labels (numValues x numClasses, resized).
+   * \param gammasMin The table of the negative labels (numValues x numClasses, resized).
+   * \see getGammas()
+   * \date 18/10/2026
+   */
+   static void computeGammas(InputData* pData, int colIdx, vector<float>& gammasPls, vector<float>& gammasMin);
+
+   static const unsigned short missingCode = 0xFFFF; //!< The code of the missing (or unknown) values.
+
+protected:
+
+   /**
+   * The codes of the stored enum columns, column-wise: the code of the raw 
+   * example i in column j is _codes[_columnBegins[j] + i]. _columnBegins[j]
+   * is -1 if column j is not stored.
+   */
+   vector<unsigned short> _codes;
+   vector<int>            _columnBegins; //!< The offset of each column in _codes (-1 if not stored).
+
+   int _numThreads; //!< The number of threads of getGammas() (--enumthreads).
+
+   /**
+   * The per-thread tables of getGammas(), the positive and the negative one
+   * of each thread next to each other. Kept between the calls.
+   */
+   vector<float> _threadGammas;
+};
+
+} // end of namespace MultiBoost
+
+#endif // __ENUM_DATA_H
@@ -47,12 +47,15 @@
 #include "Others/Example.h"
 #include "NameMap.h"
 #include "InputData.h"
+#include "Utils/Utils.h" // for murmur_hash
 
 using namespace std;
 
 namespace MultiBoost
 {
 
+class DataTransform;
+
 ////////////////////////////////////////////////////////////////
 
 class GenericParser 
@@ -60,7 +63,8 @@ class GenericParser
 public:
 
    GenericParser(const string& fileName)
-      : _fileName(fileName), _dataRep(DR_DENSE), _labelRep(LR_DENSE), _hasWeigthInit(false) {}
+      : _fileName(fileName), _dataRep(DR_DENSE), _labelRep(LR_DENSE), _hasWeigthInit(false),
+        _pTransform(NULL), _hashBits(0), _hashSeed(0) {}
 
    virtual void		readData(vector<Example>& examples, NameMap& classMap, 
 			      vector<NameMap>& enumMaps, NameMap& attributeNameMap,
@@ -73,6 +77,23 @@ public:
 
    bool  hasWeightInitialized()    const { return _hasWeigthInit; }
 
+   /**
+   * Set the transformation applied to each example right after its values
+   * have been parsed. The parser does not own it.
+   * \see DataTransform
+   * \date 18/10/2026
+   */
+   void  setTransform(DataTransform* pTransform) { _pTransform = pTransform; }
+
+   /**
+   * Map the sparse features into 2^bits columns with the hashing trick
+   * instead of registering their names. Only the sparse parsers support it.
+   * \param bits The number of bits of the column space (0 disables the hashing).
+   * \param seed The seed of the hash function.
+   * \date 18/10/2026
+   */
+   void  setFeatureHashing(int bits, unsigned int seed) { _hashBits = bits; _hashSeed = seed; }
+
 protected:
 
    const string& _fileName;
@@ -81,6 +102,20 @@ protected:
 
    bool          _hasWeigthInit;
 
+   DataTransform* _pTransform; //!< The load-time transformation (NULL if none).
+
+   /**
+   * Returns the column of a hashed feature.
+   * \param key The bytes identifying the feature (its name or its index).
+   * \param len The number of bytes of the key.
+   * \date 18/10/2026
+   */
+   int   getHashedColumn(const void* key, int len) const
+   { return (int)( nor_utils::murmur_hash(key, len, _hashSeed) & ((1u << _hashBits) - 1) ); }
+
+   int           _hashBits; //!< The size (in bits) of the hashed column space. 0 if no hashing.
+   unsigned int  _hashSeed; //!< The seed of the feature hashing.
+
 };
 
 ////////////////////////////////////////////////////////////////
@@ -170,6 +170,13 @@ public:
    */
    static short areaHeight() { return _height; }
 
+   /**
+   * Set the size of the integral images, when they are not loaded
+   * (otherwise it is given by --iisize).
+   * \date 18/10/2026
+   */
+   static void setAreaSize(short width, short height) { _width = width; _height = height; }
+
 protected:
     bool checkInput(const string& line, int numColumns);
 
@@ -46,6 +46,7 @@
 #include "IO/ArffParser.h"
 
 #include "Utils/Utils.h" // for white_tabs
+#include "Utils/Profiler.h" // for --profile
 #include "IO/InputData.h"
 
 //#include <cassert>
@@ -56,22 +57,30 @@ namespace MultiBoost {
 
 	// ------------------------------------------------------------------------
 	int		InputData::loadIndexSet( set< int > ind ) {
-		int i = 0;
-		//upload the indirection
-		this->_usedIndices.clear();
-		this->_rawIndices.clear();
+		vector<int> rawIndices( ind.begin(), ind.end() );
+		loadIndexArray( rawIndices.empty() ? NULL : &rawIndices[0], static_cast<int>( rawIndices.size() ) );
+		_currPartitionNode = -1;
+		return 0;
+	}
 
-		map<int, int> tmpPointsPerClass;
-		
-		for( set< int >::iterator it = ind.begin(); it != ind.end(); it++ ) {
-			this->_indirectIndices[i] = *it;
-			this->_usedIndices.insert( *it );
+	// ------------------------------------------------------------------------
+	void	InputData::loadIndexArray( const int* rawIndices, int numIndices ) {
+		ScopedTimer timer( Profiler::PH_INDEX_SET );
+		const int numClasses = this->_pData->getNumClasses();
 
-			this->_rawIndices[*it] = i;
+		// forget the previous inverse indirection
+		for( int i = 0; i < this->_numExamples; i++ )
+			this->_orderOfRaw[ this->_indirectIndices[i] ] = -1;
 
-			i++;
+		_nExamplesPerClass.assign( numClasses, 0 );
 
-			const vector<Label>& labels = _pData->getLabels( *it );
+		//upload the indirection
+		for( int i = 0; i < numIndices; i++ ) {
+			const int rawIdx = rawIndices[i];
+			this->_indirectIndices[i] = rawIdx;
+			this->_orderOfRaw[rawIdx] = i;
+
+			const vector<Label>& labels = _pData->getLabels( rawIdx );
 			vector<Label>::const_iterator lIt;
 
 			for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
@@ -79,40 +88,123 @@ namespace MultiBoost {
 				switch ( this->_pData->getLabelRep() ) {
 					case LR_DENSE:
 						if ( lIt->y > 0 )
-							tmpPointsPerClass[lIt->idx]++;
+							_nExamplesPerClass[lIt->idx]++;
 						break;
 					case LR_SPARSE:
 						if ( lIt->y > 0 )
-							tmpPointsPerClass[lIt->idx]++;
+							_nExamplesPerClass[lIt->idx]++;
 						break;
 				}
 			}
 		}
-		
-		_nExamplesPerClass.clear();
-		for (int l = 0; l < this->_pData->getNumClasses(); ++l)
-			_nExamplesPerClass.push_back( tmpPointsPerClass[l] );
-
 
-		this->_numExamples = ind.size();
-		return 0;
+		this->_numExamples = numIndices;
 	}
 
-
 	// ------------------------------------------------------------------------
 	void		InputData::clearIndexSet( void ) {
-		this->_usedIndices.clear();
-		this->_rawIndices.clear();
-
+		ScopedTimer timer( Profiler::PH_INDEX_SET );
 		for( int i = 0; i < this->_pData->getNumExample(); i++ ) {
 			this->_indirectIndices[ i ] = i;
-			this->_usedIndices.insert( i );
-			this->_rawIndices[ i ] = i;
+			this->_orderOfRaw[ i ] = i;
 		}
 		this->_numExamples = this->_pData->getNumExample();
 		
 		_nExamplesPerClass.clear();
 		_nExamplesPerClass = this->_pData->getExamplesPerClass();
+		_currPartitionNode = -1;
+	}
+
+	// ------------------------------------------------------------------------
+	void		InputData::setExamples( vector<Example>& examples ) {
+		_pData->swapExamples( examples );
+		this->_numExamples = this->_pData->getNumExample();
+		this->_indirectIndices.resize( this->_numExamples );
+		this->_orderOfRaw.resize( this->_numExamples );
+		for( int i = 0; i < this->_numExamples; i++ ) {
+			this->_indirectIndices[ i ] = i;
+			this->_orderOfRaw[ i ] = i;
+		}
+		_nExamplesPerClass.assign( this->_pData->getNumClasses(), 0 );
+		_currPartitionNode = -1;
+	}
+
+	// ------------------------------------------------------------------------
+	int		InputData::beginPartition( void ) {
+		// the root is the current index set, which is sorted by raw index
+		_savedIndices.assign( _indirectIndices.begin(), _indirectIndices.begin() + _numExamples );
+		sort( _savedIndices.begin(), _savedIndices.end() );
+
+		_partitionExamples = _savedIndices;
+		_partitionNodes.clear();
+		_partitionNodes.push_back( make_pair( 0, _numExamples ) );
+
+		return 0;
+	}
+
+	// ------------------------------------------------------------------------
+	void	InputData::selectPartitionNode( int nodeIdx ) {
+		const pair<int, int>& node = _partitionNodes[nodeIdx];
+		const int numIndices = node.second - node.first;
+		loadIndexArray( numIndices > 0 ? &_partitionExamples[node.first] : NULL, numIndices );
+		_currPartitionNode = nodeIdx;
+	}
+
+	// ------------------------------------------------------------------------
+	void	InputData::splitPartitionNode( int nodeIdx, const vector<signed char>& sides, 
+										   int& leftIdx, int& rightIdx ) {
+		assert( nodeIdx == _currPartitionNode );
+
+		const int begin = _partitionNodes[nodeIdx].first;
+		const int end = _partitionNodes[nodeIdx].second;
+
+		// stable partition: the left examples are moved in place, the right ones
+		// to the front of the buffer and the dropped ones to its back
+		const int size = end - begin;
+		_partitionBuffer.resize( size );
+		int numLeft = 0, numRight = 0, numDropped = 0;
+		for( int k = 0; k < size; k++ ) {
+			const int rawIdx = _partitionExamples[begin + k];
+			if ( sides[k] > 0 ) _partitionExamples[ begin + numLeft++ ] = rawIdx;
+			else if ( sides[k] < 0 ) _partitionBuffer[ numRight++ ] = rawIdx;
+			else _partitionBuffer[ size - ++numDropped ] = rawIdx;
+		}
+		copy( _partitionBuffer.begin(), _partitionBuffer.begin() + numRight, 
+			  _partitionExamples.begin() + begin + numLeft );
+		reverse_copy( _partitionBuffer.end() - numDropped, _partitionBuffer.end(), 
+					  _partitionExamples.begin() + begin + numLeft + numRight );
+
+		leftIdx = static_cast<int>( _partitionNodes.size() );
+		_partitionNodes.push_back( make_pair( begin, begin + numLeft ) );
+		rightIdx = static_cast<int>( _partitionNodes.size() );
+		_partitionNodes.push_back( make_pair( begin + numLeft, begin + numLeft + numRight ) );
+	}
+
+	// ------------------------------------------------------------------------
+	void	InputData::initPartitionView( InputData* pSource, int nodeIdx ) {
+		InputData* pOwner = pSource->_pPartitionOwner;
+
+		// the raw data is shared (and never deleted by the views)
+		delete _pData;
+		_pData = pOwner->_pData;
+		_pPartitionOwner = pOwner;
+		_pLabelSigns = pSource->_pLabelSigns;
+		_labelSignStride = pSource->_labelSignStride;
+
+		const pair<int, int>& node = pOwner->_partitionNodes[nodeIdx];
+		const int numIndices = node.second - node.first;
+		_numExamples = 0;
+		_indirectIndices.resize( numIndices );
+		_orderOfRaw.assign( _pData->getNumExample(), -1 );
+		loadIndexArray( numIndices > 0 ? &pOwner->_partitionExamples[node.first] : NULL, numIndices );
+		_currPartitionNode = nodeIdx;
+	}
+
+	// ------------------------------------------------------------------------
+	void	InputData::endPartition( void ) {
+		loadIndexArray( _savedIndices.empty() ? NULL : &_savedIndices[0], static_cast<int>( _savedIndices.size() ) );
+		_currPartitionNode = -1;
+		_partitionNodes.clear();
 	}
 
 } // end of namespace MultiBoost
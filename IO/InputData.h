@@ -42,6 +42,7 @@
 
 #include <vector>
 #include <map> // for class mappings
+#include <set>
 #include <utility> // for pair
 #include <iosfwd> // for I/O
 #include <limits> 
@@ -83,22 +84,27 @@ namespace MultiBoost {
 		// these will be moved soon
 	protected:
 		bool   _hasExampleName, _classInLastColumn;
-		vector< int >	_indirectIndices;
-		set< int >		_usedIndices; // this  will contain the indeces we use
-		map< int, int > _rawIndices;
+		vector< int >	_indirectIndices; // the raw index of the examples we use
+		vector< int >	_orderOfRaw; // the inverse of _indirectIndices (-1 if the raw example is not used)
 	public:
 
 		/**
 		* The constructor. It does noting but initializing some variables.
 		* \date 12/11/2005
 		*/
-		InputData() : _hasExampleName(false), _classInLastColumn(false), _numExamples(0) { _pData = new RawData(); }
+		InputData() : _hasExampleName(false), _classInLastColumn(false), 
+			_pLabelSigns(NULL), _labelSignStride(0),
+			_currPartitionNode(-1), _numExamples(0) { _pData = new RawData(); _pPartitionOwner = this; }
+
+		/**
+		* The destructor. Must be declared (virtual) for the proper destruction of 
+		* the object.
+		*/
+		virtual ~InputData() {}
 
 
 		virtual int getOrderBasedOnRawIndex( int rawIndex ) {
-			map<int, int>::iterator it = this->_rawIndices.find( rawIndex );
-			if ( it == this->_rawIndices.end() ) return -1;
-			else return it->second;
+			return this->_orderOfRaw[ rawIndex ];
 		}
 
 		virtual bool isSamplesFromOneClass() {
@@ -142,8 +148,7 @@ namespace MultiBoost {
 				// need to set the indirect indices
 				for( i=0; i < _numExamples; i++ ) {
 					_indirectIndices.push_back( i );
-					_usedIndices.insert( i );
-					_rawIndices[i] = i;
+					_orderOfRaw.push_back( i );
 				}
 				
 				_nExamplesPerClass = _pData->getExamplesPerClass();				
@@ -158,6 +163,35 @@ namespace MultiBoost {
 		inline const vector<Label>& getLabels(const int idx) const { return _pData->getLabels( _indirectIndices[idx] ); }
 		inline       vector<Label>& getLabels(const int idx)       { return _pData->getLabels( _indirectIndices[idx] ); }
 
+		/**
+		* Get the sign of a label, with the sign overlay (see setLabelSigns()) applied.
+		* The learners must read the labels with this rather than with Label::y.
+		* \param idx The index of the example.
+		* \param label One of the labels of the example.
+		* \return The sign of the label (+1, -1 or 0).
+		* \date 18/10/2026
+		*/
+		inline char getLabelY(const int idx, const Label& label) const
+		{
+			if ( _pLabelSigns == NULL ) return label.y;
+			return label.y * _pLabelSigns[ _indirectIndices[idx] * _labelSignStride + label.idx ];
+		}
+
+		/**
+		* Set a sign overlay on the labels. The overlay lets a learner (e.g. 
+		* ProductLearner) train on modified labels without touching the labels
+		* themselves, which might be shared with other learners.
+		* \param pSigns The signs (+1, -1, or 0 to ignore the label), indexed by
+		* rawIndex * getNumClasses() + label index, NULL to remove the overlay.
+		* \remark The array is not copied.
+		* \see getLabelY
+		* \date 18/10/2026
+		*/
+		void setLabelSigns(const signed char* pSigns) 
+		{ _pLabelSigns = pSigns; _labelSignStride = _pData->getNumClasses(); }
+
+		const signed char* getLabelSigns() const { return _pLabelSigns; } //!< NULL if there is no overlay.
+
 		inline const bool  hasLabel(const int idx, const int labelIdx) const 
 		{ return _pData->hasLabel( _indirectIndices[idx], labelIdx); }
 
@@ -191,9 +225,9 @@ namespace MultiBoost {
 				return _pData->getExamples(); 
 			} else {		
 				_subset.clear();
-				for ( set<int>::iterator it = _usedIndices.begin(); it != _usedIndices.end(); it++ ) {
+				for ( int i = 0; i < _numExamples; i++ ) {
 					//Example e = this->getExample( *it );
-					_subset.push_back( this->_pData->getExample( *it ) );
+					_subset.push_back( this->_pData->getExample( _indirectIndices[i] ) );
 				}
 				return _subset;
 			}
@@ -208,6 +242,9 @@ namespace MultiBoost {
 		inline const NameMap& getEnumMap(int j)
 		{ return _pData->getEnumMap( j ); }
 
+		RawData::eAttributeType getAttributeType(int j) const { return _pData->getAttributeType( j ); }
+		eDataRep getDataRep() const { return _pData->getDataRep(); }
+
 		/**
 		* Get the label of the example.
 		* \param idx The index of the example.
@@ -219,6 +256,7 @@ namespace MultiBoost {
 
 		int      getNumAttributes()  const { return _pData->getNumAttributes(); }   //!< Returns the number of attributes.
 		int      getNumExamples()    const { return _numExamples; } //!< Returns the number of examples.
+		int      getNumRawExamples() const { return _pData->getNumExample(); } //!< Returns the number of examples, filtered or not.
 		int      getNumClasses()    const { return _pData->getNumClasses(); } //!< Returns the number of classes.
 
 		//void     addDataColumn(const vector<float>& col);
@@ -240,9 +278,68 @@ namespace MultiBoost {
 		
 		virtual void getIndexSet( set< int >& ind )
 		{
-			ind = _usedIndices;
+			ind.clear();
+			for( int i = 0; i < _numExamples; i++ ) 
+				ind.insert( ind.end(), _indirectIndices[i] );
 		}
 
+		/**
+		* Start the partition-based growth of a tree on the current index set.
+		* The examples of every node of the partition are a contiguous range of a 
+		* single permutation of the raw indices, sorted by raw index within the range
+		* (so that selecting a node gives the same order as loadIndexSet() would).
+		* \return The index of the root node, which contains the current index set.
+		* \see selectPartitionNode
+		* \see splitPartitionNode
+		* \date 18/10/2026
+		*/
+		virtual int		beginPartition( void );
+
+		/**
+		* Use the examples of a node of the partition as the index set.
+		* \param nodeIdx The index of the node.
+		* \date 18/10/2026
+		*/
+		virtual void	selectPartitionNode( int nodeIdx );
+
+		/**
+		* Split a node of the partition into two children with a stable in-place 
+		* partition of its range. The node must be the selected one, and it 
+		* cannot be selected any more once split.
+		* \param nodeIdx The index of the node.
+		* \param sides The side of each example of the node (in the order of the 
+		* current index set): positive for the left child, negative for the right 
+		* child, 0 if the example goes to neither.
+		* \param leftIdx The returned index of the left child.
+		* \param rightIdx The returned index of the right child.
+		* \date 18/10/2026
+		*/
+		virtual void	splitPartitionNode( int nodeIdx, const vector<signed char>& sides, 
+											int& leftIdx, int& rightIdx );
+
+		/**
+		* Stop the partition-based growth, and reload the index set that was used 
+		* when beginPartition() was called.
+		* \date 18/10/2026
+		*/
+		virtual void	endPartition( void );
+
+		int		getPartitionNodeSize( int nodeIdx ) const 
+		{ return _partitionNodes[nodeIdx].second - _partitionNodes[nodeIdx].first; }
+
+		/**
+		* Create a view on a node of the partition. The view shares the raw data 
+		* and the partition with this object but it has its own index set, so several 
+		* nodes can be used at the same time (by different threads, for instance).
+		* No node may be split while the view is in use, and the view does not 
+		* support the index set and partition operations.
+		* \param nodeIdx The index of the node.
+		* \return The view, to be deleted by the caller, or NULL if this type of 
+		* data has no views.
+		* \date 18/10/2026
+		*/
+		virtual InputData* createPartitionView( int /*nodeIdx*/ ) { return NULL; }
+
 
 		/**
 		* Clear the indices of subset we use, the whole dataset containing _pData will be used 
@@ -252,6 +349,49 @@ namespace MultiBoost {
 
 		inline bool isFiltered() { return _numExamples != _pData->getNumExample(); }
 
+		/**
+		* Set the weights of the examples of the index set with a weight policy, 
+		* e.g. to restart the weighting on the examples left by a cascade stage.
+		* \param weightInitType The policy.
+		* \return The sum of the new weights.
+		* \see RawData::applyWeightPolicy()
+		* \date 18/10/2026
+		*/
+		double applyWeightPolicy( RawData::eWeightInitType weightInitType )
+		{ return _pData->applyWeightPolicy( weightInitType, _numExamples > 0 ? &_indirectIndices[0] : NULL, _numExamples ); }
+
+		/**
+		* Replace the examples by \a examples and use all of them, keeping the header.
+		* The structures built at load time by the derived classes (e.g. the sorted
+		* columns) are not updated, so the data can only be classified afterwards.
+		* \param examples The new examples. It gets the previous ones, so that
+		* their memory can be reused.
+		* \see RawData::swapExamples
+		* \date 18/10/2026
+		*/
+		void	setExamples( vector<Example>& examples );
+
+		/**
+		* Set the feature hashing used when parsing the data.
+		* \see RawData::setFeatureHashing
+		* \date 18/10/2026
+		*/
+		void setFeatureHashing(int bits, unsigned int seed) { _pData->setFeatureHashing(bits, seed); }
+
+		int          getFeatureHashingBits() const { return _pData->getFeatureHashingBits(); }
+		unsigned int getFeatureHashingSeed() const { return _pData->getFeatureHashingSeed(); }
+
+		/**
+		* The load-time transformations and the columns of the file they apply to.
+		* \see RawData::getTransforms()
+		* \date 18/10/2026
+		*/
+		TransformPipeline* getTransforms() { return _pData->getTransforms(); }
+		int getRawNumAttributes() const { return _pData->getRawNumAttributes(); }
+		const NameMap& getRawAttributeNameMap() const { return _pData->getRawAttributeNameMap(); }
+		const vector<RawData::eAttributeType>& getRawAttributeTypes() const { return _pData->getRawAttributeTypes(); }
+		const NameMap& getRawEnumMap(int j) const { return _pData->getRawEnumMap(j); }
+
 		inline int getRawIndex( int i ) { return _indirectIndices[i]; }
 
 		float getFeaturewiseMax( int idx ) {
@@ -275,6 +415,35 @@ namespace MultiBoost {
 		}
 
 	protected:
+		/**
+		* Set the index set from an array of raw indices.
+		* It replaces the indirection, its inverse, and the number of examples per class.
+		* \param rawIndices The raw indices of the examples.
+		* \param numIndices The size of the array.
+		* \date 18/10/2026
+		*/
+		void	loadIndexArray( const int* rawIndices, int numIndices );
+
+		/**
+		* Turn this (freshly constructed) object into a view on a node of the 
+		* partition of another one.
+		* \param pSource The data holding the partition (or a view on it).
+		* \param nodeIdx The index of the node.
+		* \see createPartitionView
+		* \date 18/10/2026
+		*/
+		void	initPartitionView( InputData* pSource, int nodeIdx );
+
+		vector<int>   _partitionExamples; //!< The permutation of the raw indices of the partition.
+		vector< pair<int, int> > _partitionNodes; //!< The range [first, second) of each node in _partitionExamples.
+		vector<int>   _partitionBuffer; //!< Buffer for the stable partitions.
+		vector<int>   _savedIndices; //!< The index set at beginPartition().
+		const signed char* _pLabelSigns; //!< The sign overlay on the labels (see setLabelSigns()).
+		int           _labelSignStride; //!< The number of signs per example in _pLabelSigns.
+
+		int           _currPartitionNode; //!< The selected node of the partition (-1 if none).
+		InputData*    _pPartitionOwner; //!< The data holding the partition: this, unless it is a view.
+
 		int           _numExamples;  //!<  The number of examples.
 		vector<int>   _nExamplesPerClass;   //!< The number of examples per class.
 
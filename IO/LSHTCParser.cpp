@@ -37,6 +37,7 @@
 #include <cmath> // for abs
 
 #include "IO/LSHTCParser.h"
+#include "IO/DataTransform.h"
 #include "Utils/Utils.h"
 
 namespace MultiBoost {
@@ -82,20 +83,20 @@ namespace MultiBoost {
 		// ez a teljes hierarchiat
 		_originalHierarchy.load( _hierarchyFile );
 		// ez az osszes kategoriat, meg azokat is, amelyeket atvaltunk
-		_usedCategories.clear();
+		set<int> usedCategories;
 
 		if ( _labelSetting == LS_FULL ) {
-			_originalHierarchy.getCategorySet( _usedCategories );
+			_originalHierarchy.getCategorySet( usedCategories );
 		} else if ( _labelSetting == LS_SUBCAT ) {
 			_hierarchy.subcat( _labelSettingParameter );
-			_hierarchy.getCategorySet( _usedCategories );
+			_hierarchy.getCategorySet( usedCategories );
 		} else if ( _labelSetting == LS_DEPTH ) {
 			_hierarchy.eraseTreeUptoDepth( _labelSettingParameter ); //pl ha 1, akkor csak az elso szintu kategoriak maradnak meg
-			_originalHierarchy.getCategorySet( _usedCategories );
+			_originalHierarchy.getCategorySet( usedCategories );
 		} else if ( _labelSetting == LS_NDEPTH ) {
-			_originalHierarchy.getCategorySet( _usedCategories );
+			_originalHierarchy.getCategorySet( usedCategories );
 		}else if ( _labelSetting == LS_LEAF ) {
-			_originalHierarchy.getCategorySet( _usedCategories );
+			_originalHierarchy.getCategorySet( usedCategories );
 		}else if ( _labelSetting == LS_CHILDREN ) {
 			//megszoritjuk a reszfat erre a kategoriara, de meg kell hagyni a gyerek kategoriakat is, hogy at tudjuk valtani a szulokategoriara
 			//pl. adott egy 1 2 34 kategoriaju elem, akkor a ennek az osztalya 2 lesz
@@ -106,10 +107,17 @@ namespace MultiBoost {
 			_originalHierarchy.getDescendants( tmpVec, _labelSettingParameter );
 
 			for( vector<int>::iterator it = tmpVec.begin(); it != tmpVec.end(); it++ ) {
-				_usedCategories.insert( *it );
+				usedCategories.insert( *it );
 			}
 
 		}
+
+		// flags over the nodes of the original hierarchy, looked up once per example
+		_usedNodes.assign( _originalHierarchy.getNumOfCategories(), 0 );
+		for( set<int>::iterator it = usedCategories.begin(); it != usedCategories.end(); it++ ) {
+			const int node = _originalHierarchy.getNode( *it );
+			if ( node >= 0 ) _usedNodes[node] = 1;
+		}
 			
 	}
 
@@ -193,9 +201,9 @@ namespace MultiBoost {
 			
 
 			//ha nincs ez a kategoria, a hierachiaban, akkor be se olvassuk
-			set<int>::iterator it = _usedCategories.find( category );
+			const int usedNode = _originalHierarchy.getNode( category );
 			
-			if ( it == _usedCategories.end() ) continue;
+			if ( usedNode < 0 || !_usedNodes[usedNode] ) continue;
 			
 			Example& currExample = examples[currentSize++];
 
@@ -207,14 +215,13 @@ namespace MultiBoost {
 			}
 
 			//now read values
-			readSparseValues(ss, currExample.getValues(), currExample.getValuesIndexes(), currExample.getValuesIndexesMap(),
+			readSparseValues(ss, currExample.getValues(), currExample.getValuesIndexes(),
 				enumMaps, attributeTypes );
+			currExample.compactSparseValues();
 
-			//determine the number of column			
-			map<int,int> featIdxs = currExample.getValuesIndexesMap();
-			for( map<int,int>::iterator it = featIdxs.begin(); it != featIdxs.end(); it++ ) {
-				if ( it->first > maxColumnIdx ) maxColumnIdx = it->first;
-			}
+			//determine the number of column (the indexes are sorted)
+			const vector<int>& featIdxs = currExample.getValuesIndexes();
+			if ( !featIdxs.empty() && featIdxs.back() > maxColumnIdx ) maxColumnIdx = featIdxs.back();
 
 		}
 
@@ -232,6 +239,13 @@ namespace MultiBoost {
 		}
 
 
+		if ( _hashBits > 0 ) {
+			// hashing trick: the column space is fixed and the feature names are not stored
+			attributeNameMap.setImplicitNames( 1 << _hashBits );
+			attributeTypes.assign( 1 << _hashBits, RawData::ATTRIBUTE_NUMERIC );
+			maxColumnIdx = -1;
+		}
+
 		for( int j = 0; j <= maxColumnIdx; j++ ) {
 			string s;
 			stringstream sstream;
@@ -251,6 +265,14 @@ namespace MultiBoost {
 			examples.resize( currentSize );
 		}
 
+		// the attribute names are only known at the end of the pass, so the
+		// preprocessing runs here (still before any column is sorted)
+		if ( _pTransform )
+		{
+			for ( vector<Example>::iterator eIt = examples.begin(); eIt != examples.end(); ++eIt )
+				_pTransform->transformExample(*eIt, attributeNameMap, attributeTypes);
+		}
+
 		// set the number of attributes, it can be problem, that the test dataset contains such attributes which isn't presented in the training data
 		_numAttributes = attributeNameMap.getNumNames();
 
@@ -270,66 +292,30 @@ namespace MultiBoost {
 			
 			labels.clear();
 			
-			vector<int> siblingCategories;
-			vector<int> ancestorCategories;
-			vector<int>::iterator itParent;
-			vector<int>::iterator itSibling;
-
 			//get its ancestor categories
-			_hierarchy.getAncestors( ancestorCategories, category );
-			
-
-
-			for( itParent = ancestorCategories.begin(); itParent != ancestorCategories.end(); itParent++ ) {
-				_hierarchy.getSiblings( siblingCategories, *itParent );
-				
-				for( itSibling = siblingCategories.begin(); itSibling != siblingCategories.end(); itSibling++ ) {
-					Label tmpLabel;
-					tmpLabel.idx = _hierarchy.convertCategoryToIdx( *itSibling );
-					if ( *itParent == *itSibling ) {
-						tmpLabel.y = +1;
-						tmpLabel.weight = 1.0;
-					} else { 
-						tmpLabel.y = -1;
-						tmpLabel.weight = 1.0;
-					}
+			const int node = _hierarchy.getNode( category );
+			if ( node < 0 ) return;
 
-					// now get the declared labels
-					labels.push_back( tmpLabel );
+			const int* pAncestors = _hierarchy.getAncestorNodes( node );
+			const int numAncestors = _hierarchy.getNumOfAncestors( node );
 
-				}
+			for( int a = 0; a < numAncestors; a++ ) {
+				addSiblingLabels( pAncestors[a], labels );
 			}
 		} else if ( _labelSetting == LS_DEPTH ) {
 			labels.clear();
 			
-			vector<int> siblingCategories;
-			vector<int> ancestorCategories;
-			vector<int>::iterator itParent;
-			vector<int>::iterator itSibling;
-
 			//get its ancestor categories
-			_originalHierarchy.getAncestors( ancestorCategories, category );
-			
+			const int originalNode = _originalHierarchy.getNode( category );
+			if ( originalNode < 0 ) return;
 
-			int depth;
-			for( depth = 1, itParent = ancestorCategories.begin(); itParent != ancestorCategories.end(); itParent++, depth++ ) {
-				_hierarchy.getSiblings( siblingCategories, *itParent );
-				
-				for( itSibling = siblingCategories.begin(); itSibling != siblingCategories.end(); itSibling++ ) {
-					Label tmpLabel;
-					tmpLabel.idx = _hierarchy.convertCategoryToIdx( *itSibling );
-					if ( *itParent == *itSibling ) {
-						tmpLabel.y = +1;
-						tmpLabel.weight = 1.0;
-					} else { 
-						tmpLabel.y = -1;
-						tmpLabel.weight = 1.0;
-					}
-
-					// now get the declared labels
-					labels.push_back( tmpLabel );
+			const int* pAncestors = _originalHierarchy.getAncestorNodes( originalNode );
+			const int numAncestors = _originalHierarchy.getNumOfAncestors( originalNode );
 
-				}
+			for( int a = 0; a < numAncestors; a++ ) {
+				// the ancestors below the kept depth are not in the hierarchy
+				const int node = _hierarchy.getNode( _originalHierarchy.getNodeCategory( pAncestors[a] ) );
+				if ( node >= 0 ) addSiblingLabels( node, labels );
 			}
 
 		} else if ( _labelSetting == LS_CHILDREN ) {
@@ -345,17 +331,17 @@ namespace MultiBoost {
 				labels[i].y = -1;
 			}
 
-			
-
-			vector<int> ancestorCategories;
-			vector<int>::iterator itParent;
-			
 			//get its ancestor categories
-			_originalHierarchy.getAncestors( ancestorCategories, category );
+			const int originalNode = _originalHierarchy.getNode( category );
+			if ( originalNode < 0 ) return;
+
+			const int* pAncestors = _originalHierarchy.getAncestorNodes( originalNode );
+			const int numAncestors = _originalHierarchy.getNumOfAncestors( originalNode );
 
-			for( itParent = ancestorCategories.begin(); itParent != ancestorCategories.end(); itParent++ ) {
-				if ( _hierarchy.existCategory( *itParent ) )
-					labels[ _hierarchy.convertCategoryToIdx( *itParent ) ].y = +1;
+			for( int a = 0; a < numAncestors; a++ ) {
+				const int node = _hierarchy.getNode( _originalHierarchy.getNodeCategory( pAncestors[a] ) );
+				if ( node >= 0 )
+					labels[ _hierarchy.getNodeIdx( node ) ].y = +1;
 			}
 
 		} else {
@@ -368,6 +354,24 @@ namespace MultiBoost {
 
 	// ------------------------------------------------------------------------
 
+	void LSHTCParser::addSiblingLabels( int node, vector<Label>& labels )
+	{
+		const int* pSiblings = _hierarchy.getSiblingNodes( node );
+		const int numSiblings = _hierarchy.getNumOfSiblings( node );
+
+		for( int s = 0; s < numSiblings; s++ ) {
+			Label tmpLabel;
+			tmpLabel.idx = _hierarchy.getNodeIdx( pSiblings[s] );
+			tmpLabel.y = ( pSiblings[s] == node ) ? +1 : -1;
+			tmpLabel.weight = 1.0;
+
+			// now get the declared labels
+			labels.push_back( tmpLabel );
+		}
+	}
+
+	// ------------------------------------------------------------------------
+
 	void LSHTCParser::setHierchicalDenseLabelLabels( int category, vector<Label>& labels,
 		NameMap& classMap )
 	{
@@ -381,24 +385,17 @@ namespace MultiBoost {
 			labels[i].y = -1;
 		}
 
-		
-
-		vector<int> siblingCategories;
-		vector<int> ancestorCategories;
-		vector<int>::iterator itParent;
-		vector<int>::iterator itSibling;
-
 		//get its ancestor categories
-		_hierarchy.getAncestors( ancestorCategories, category );
-		
+		const int node = _hierarchy.getNode( category );
+		if ( node < 0 ) return;
 
+		const int* pAncestors = _hierarchy.getAncestorNodes( node );
+		const int numAncestors = _hierarchy.getNumOfAncestors( node );
 
-		for( itParent = ancestorCategories.begin(); itParent != ancestorCategories.end(); itParent++ ) {
-			labels[ _hierarchy.convertCategoryToIdx( *itParent ) ].y = +1;
+		for( int a = 0; a < numAncestors; a++ ) {
+			labels[ _hierarchy.getNodeIdx( pAncestors[a] ) ].y = +1;
 		}
 
-
-
 	}
 
 
@@ -431,17 +428,20 @@ namespace MultiBoost {
 	// -----------------------------------------------------------------------------
 
 	void LSHTCParser::readSparseValues(istringstream& ss, vector<float>& values, 
-		vector<int>& idxs, map<int, int>& idxmap, vector<NameMap>& enumMaps, 
+		vector<int>& idxs, vector<NameMap>& enumMaps, 
 		const vector<RawData::eAttributeType>& attributeTypes)
 	{
 		int tmpVal;
 		int tmpIdx;
-		int i = 0;
 		while (!ss.eof())
 		{
 			ss >> tmpIdx;
+
+			// colliding hashed features are summed up by Example::compactSparseValues()
+			if ( _hashBits > 0 )
+				tmpIdx = getHashedColumn( &tmpIdx, sizeof(tmpIdx) );
+
 			idxs.push_back(tmpIdx);
-			idxmap[ tmpIdx ] = i++;
 			ss >> tmpVal;
 
 			values.push_back( tmpVal );
@@ -81,12 +81,14 @@ namespace MultiBoost {
 
 		void setHierchicalSparseLabelLabels( int category, vector<Label>& labels, NameMap& classMap );
 		void setHierchicalDenseLabelLabels( int category, vector<Label>& labels, NameMap& classMap );
+		// the labels of the children of the parent of node (a node of _hierarchy), +1 for node
+		void addSiblingLabels( int node, vector<Label>& labels );
 
 		void readDenseValues(ifstream& in, vector<float>& values,
 			vector<NameMap>& enumMaps, 
 			const vector<RawData::eAttributeType>& attributeTypes);
 
-		void readSparseValues(istringstream& ss, vector<float>& values, vector<int>& idxs, map<int, int>& idxmap, 
+		void readSparseValues(istringstream& ss, vector<float>& values, vector<int>& idxs, 
 			vector<NameMap>& enumMaps, 
 			const vector<RawData::eAttributeType>& attributeTypes);
 
@@ -126,7 +128,7 @@ namespace MultiBoost {
 		string			_hierarchyFile;
 		ClassHierarchy	_hierarchy;
 		ClassHierarchy	_originalHierarchy;
-		set<int>		_usedCategories;
+		vector<char>	_usedNodes;	// the examples of these nodes of _originalHierarchy are read
 	public:
 		void setLabeling( string type, int par ) 
 		{
@@ -38,6 +38,8 @@
 #include "Defaults.h" // for MB_DEBUG
 #include <fstream> // for ifstream
 #include <iostream> // for cerr
+#include <sstream>
+#include <cstdlib> // for atoi
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////////////////////
@@ -48,6 +50,9 @@ namespace MultiBoost {
 
 int NameMap::addName(const string& name)
 {
+   if ( _isImplicit )
+      return getIdxFromName(name);
+
    // if we haven't seen yet this name, add it to the mapping structures
    if ( _mapNameToIdx.find(name) == _mapNameToIdx.end() )
    {
@@ -63,6 +68,13 @@ int NameMap::addName(const string& name)
 
 string NameMap::getNameFromIdx(int idx) const
 {
+   if ( _isImplicit )
+   {
+      ostringstream ss;
+      ss << idx;
+      return ss.str();
+   }
+
 #if MB_DEBUG
    if ( idx >= _mapIdxToName.size() )
    {
@@ -79,6 +91,9 @@ string NameMap::getNameFromIdx(int idx) const
 
 int NameMap::getIdxFromName(const string& name) const
 { 
+   if ( _isImplicit )
+      return atoi( name.c_str() );
+
 #if MB_DEBUG
    if ( _mapNameToIdx.find(name) == _mapNameToIdx.end() )
    {
@@ -93,10 +108,34 @@ int NameMap::getIdxFromName(const string& name) const
 
 // ------------------------------------------------------------------------
 
+int NameMap::findName(const string& name) const
+{ 
+   if ( _isImplicit )
+      return atoi( name.c_str() );
+
+   map<string, int>::const_iterator it = _mapNameToIdx.find(name);
+   if ( it == _mapNameToIdx.end() )
+      return -1;
+   return it->second; 
+}
+
+// ------------------------------------------------------------------------
+
+void NameMap::setImplicitNames(int numNames)
+{
+   _mapIdxToName.clear();
+   _mapNameToIdx.clear();
+   _numRegNames = numNames;
+   _isImplicit = true;
+}
+
+// ------------------------------------------------------------------------
+
 void NameMap::clear( void ) {
 	_mapIdxToName.clear();
 	_mapNameToIdx.clear();
 	_numRegNames = 0;
+	_isImplicit = false;
 }
 
 
@@ -65,7 +65,7 @@ public:
    * The constructor. It does noting but initializing some variables.
    * \date 19/04/2007
    */
-   NameMap() : _numRegNames(0) {  }
+   NameMap() : _numRegNames(0), _isImplicit(false) {  }
 
    /**
    * Add a name to the registered list.
@@ -96,8 +96,27 @@ public:
    */
    int getIdxFromName(const string& name) const;
 
+   /**
+   * Get the index using the name, without registering it.
+   * \param name The name.
+   * \return The index of the name, -1 if it is not registered.
+   * \date 18/10/2026
+   */
+   int findName(const string& name) const;
+
    int getNumNames() const { return _numRegNames; }   //!< Returns the number of names 
 
+   /**
+   * Turn the map into an implicit one, where the name of each index is
+   * the index itself written in decimal. Nothing is stored, which makes it
+   * suitable for the (possibly huge) column space of hashed features.
+   * \param numNames The number of names (indexes) of the map.
+   * \date 18/10/2026
+   */
+   void setImplicitNames(int numNames);
+
+   bool isImplicit() const { return _isImplicit; }
+
    void clear( void );
 private:
    /**
@@ -115,6 +134,8 @@ private:
    mutable map<string, int> _mapNameToIdx;
 
    int _numRegNames; //!< The number of the names registered. 
+
+   bool _isImplicit; //!< The names are the decimal indexes, and are not stored.
 };
 
 } // end of namespace MultiBoost
@@ -42,12 +42,14 @@
 #include "WeakLearners/BaseLearner.h"
 #include "Others/Example.h"
 #include "Utils/Utils.h"
+#include "Utils/Profiler.h"
 
 namespace MultiBoost {
 	
 	// -------------------------------------------------------------------------
 	
 	OutputInfo::OutputInfo(const string& outputInfoFile)
+		: _withProfile( Profiler::isEnabled() )
 	{
 		// open the stream
 		_outStream.open(outputInfoFile.c_str());
@@ -68,7 +70,10 @@ namespace MultiBoost {
 		// column names
 		//_outStream << "t\tErrTrn\tErrTst\tMinMTrn\tErrMTrn\tEdge\tMinMTst\tErrMTst\tMAETrn\tMSETrn\tMAETst\tMSETst\tTime\n";
 		//_outStream << "t\tErrTrn\tErrTst\tTime\n";
-		_outStream << "t\tErrTrn\tErrTst\tErrWTrn\tErrWTst\tTime\n";
+		_outStream << "t\tErrTrn\tErrTst\tErrWTrn\tErrWTst\tTime";
+		if ( _withProfile )
+			Profiler::outputHeader(_outStream);
+		_outStream << "\n";
 		// Intial values for 0th iteration. Basically it's because gnuplot fails
 		// if there isn't any number in a column, which happens with "NA". On the other hand, 
 		// NA is for having exactly the same number and order of columns all the time. 
@@ -83,6 +88,15 @@ namespace MultiBoost {
 	}
 	// -------------------------------------------------------------------------
 	
+	void OutputInfo::endLine()
+	{
+		if ( _withProfile )
+			Profiler::outputIteration(_outStream);
+		_outStream << endl;
+	}
+	
+	// -------------------------------------------------------------------------
+	
 	void OutputInfo::outputCurrentTime( void )
 	{ 
 		time_t seconds;
@@ -137,6 +151,7 @@ namespace MultiBoost {
 		
 		table& g = _gTableMap[pData];
 		vector<Label>::const_iterator lIt;
+		int numClassify = 0;
 		
 		// Building the strong learner (discriminant function)
 		for (int i = 0; i < numExamples; ++i)
@@ -148,7 +163,9 @@ namespace MultiBoost {
 				g[i][lIt->idx] += pWeakHypothesis->getAlpha() * // alpha
 				pWeakHypothesis->classify( pData, i, lIt->idx ); 
 			}
+			numClassify += static_cast<int>( labels.size() );
 		}
+		Profiler::count( Profiler::CN_CLASSIFY, numClassify );
 		
 		//for (int i = 0; i < numExamples; ++i)
 		//{
@@ -159,6 +176,18 @@ namespace MultiBoost {
 		//   }
 		//}
 		
+		outputError(pData);
+	}
+	
+	// -------------------------------------------------------------------------
+	
+	void OutputInfo::outputError(InputData* pData)
+	{
+		const int numExamples = pData->getNumExamples();
+		
+		table& g = _gTableMap[pData];
+		vector<Label>::const_iterator lIt;
+		
 		int numErrors = 0;   
 		
 		for (int i = 0; i < numExamples; ++i)
@@ -125,6 +125,16 @@ namespace MultiBoost {
 		 */
 		void outputError(InputData* pData, BaseLearner* pWeakHypothesis);
 		
+		/**
+		 * Output the error of the given data using the current \f${\bf g}(x)\f$ table,
+		 * without adding any weak hypothesis. It is used when the table is kept
+		 * up to date by the caller (see IncrementalEvaluator).
+		 * \param pData The input data.
+		 * \see getTable
+		 * \date 18/10/2026
+		 */
+		void outputError(InputData* pData);
+		
 		void outputWeightedError(InputData* pData);
 		
 		void outTPRFPR( InputData* pData );
@@ -176,9 +186,11 @@ namespace MultiBoost {
 		/**
 		 * End of line in the file stream.
 		 * Call it when all the needed information has been outputted.
+		 * With --profile the times and counters of the iteration are 
+		 * output first (see Profiler::outputIteration()).
 		 * \date 16/11/2005
 		 */
-		void endLine() { _outStream << endl; }
+		void endLine();
 		
 		void outUserData( float data )
 		{
@@ -224,6 +236,8 @@ namespace MultiBoost {
 		
 		time_t				   _beginingTime;
 		
+		bool                    _withProfile; //!< The lines end with the columns of the Profiler.
+		
 		/**
 		 * Maps the data to its g(x) table.
 		 * It is needed to keep this information saved from iteration to
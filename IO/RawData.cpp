@@ -47,6 +47,7 @@
 #include "IO/ArffParserBzip2.h"
 #include "IO/LSHTCParser.h"
 #include "IO/SVMLightParser.h"
+#include "IO/DataTransform.h"
 
 #include "Utils/Utils.h" // for white_tabs
 #include "IO/RawData.h"
@@ -61,6 +62,14 @@ namespace MultiBoost {
 
 
 
+	// ------------------------------------------------------------------------
+
+	RawData::~RawData()
+	{
+		if ( _pTransforms )
+			delete _pTransforms;
+	}
+
 	// ------------------------------------------------------------------------
 
 	RawData* RawData::load( const string& fileName, 
@@ -99,10 +108,28 @@ namespace MultiBoost {
 		if (verboseLevel > 0)
 			cout << "Loading file " << fileName << ":" << endl;
 
+		pParser->setTransform( _pTransforms );
+		pParser->setFeatureHashing( _hashBits, _hashSeed );
 		pParser->readData( _data, _classMap, _enumMaps, _attributeNameMap, _attributeTypes );
 
 		_numClasses = _classMap.getNumNames();
 		_numAttributes = pParser->getNumAttributes();
+
+		if ( _pTransforms )
+		{
+			// the examples are already transformed, now the header. The header of the
+			// file is kept for the examples that come later (see getTransforms())
+			_rawNumAttributes = _numAttributes;
+			_rawAttributeNameMap = _attributeNameMap;
+			_rawAttributeTypes = _attributeTypes;
+			_rawEnumMaps = _enumMaps;
+
+			_pTransforms->transformHeader( _attributeNameMap, _attributeTypes, _enumMaps );
+			_numAttributes = _pTransforms->getNumAttributes( _numAttributes );
+
+			if (verboseLevel > 1)
+				cout << "Attributes kept by the transformations: " << _numAttributes << endl;
+		}
 		_dataRep = pParser->getDataRep();
 		_labelRep = pParser->getLabelRep();
 
@@ -254,6 +281,70 @@ namespace MultiBoost {
 			}
 		}
 
+		if ( args.hasArgument("weightthreads") )
+			_weightThreads = args.getValue<int>("weightthreads");
+#ifndef _OPENMP
+		if ( _weightThreads > 1 )
+			cerr << "Warning: compiled without OpenMP, the weights are initialized sequentially." << endl;
+#endif
+
+		/////////////////////////////////////////////////////////////////////
+		// preprocessing fused into the parsing. The stages that work on the values
+		// come first, as they index the columns before the projection.
+		if ( _pTransforms )
+		{
+			delete _pTransforms;
+			_pTransforms = NULL;
+		}
+
+		TransformPipeline* pTransforms = new TransformPipeline();
+
+		if ( args.hasArgument("missingvalue") )
+			pTransforms->addStage( new MissingValueImputation( args.getValue<float>("missingvalue") ) );
+
+		if ( args.hasArgument("quantize") )
+		{
+			const float step = args.getValue<float>("quantize");
+			if ( step <= 0 )
+			{
+				cerr << "ERROR: The quantization step of option --quantize must be positive!" << endl;
+				exit(1);
+			}
+			pTransforms->addStage( new ValueQuantization( step ) );
+		}
+
+		if ( args.hasArgument("selectcolumns") )
+			pTransforms->addStage( new ColumnProjection( args.getValue<string>("selectcolumns") ) );
+
+		/////////////////////////////////////////////////////////////////////
+		// hashing trick for huge sparse vocabularies
+		if ( args.hasArgument("featurehashing") )
+		{
+			_hashBits = args.getValue<int>("featurehashing", 0);
+			_hashSeed = args.getValue<unsigned int>("featurehashing", 1);
+
+			if ( _hashBits < 1 || _hashBits > 30 )
+			{
+				cerr << "ERROR: The number of bits of --featurehashing must be between 1 and 30!" << endl;
+				exit(1);
+			}
+			if ( _fileFormat != FF_SVMLIGHT && _fileFormat != FF_LSHTC )
+			{
+				cerr << "ERROR: --featurehashing is only available for the svmlight and lshtc file formats!" << endl;
+				exit(1);
+			}
+			if ( args.hasArgument("selectcolumns") )
+			{
+				cerr << "ERROR: --selectcolumns cannot be used with --featurehashing!" << endl;
+				exit(1);
+			}
+		}
+
+		if ( pTransforms->empty() )
+			delete pTransforms;
+		else
+			_pTransforms = pTransforms;
+
 		// LSHTC: set the labelling
 		if ( args.hasArgument("labelsetting") ) {
 			_labelingType = args.getValue<string>( "labelsetting", 0 );
@@ -269,247 +360,174 @@ namespace MultiBoost {
 
 	void RawData::initWeights()
 	{
-		vector<Example>::iterator eIt;
-		vector<Label>::iterator lIt;
-		float sumWeight; // sum of the weight for each example
-
-		//switch ( _labelRep )
-		//{
-		//case LR_BINARY:
-		//case LR_MULTI_DENSE:
-		//   {
-		//      int numLabels = ClassMappings::getNumClasses();
-		//      float    posClassWeightDiv = 2.0*_numExamples;
-		//      float nonPosClassWeightDiv = 2.0*_numExamples*(numLabels-1);
-
-		//      int numPos;
-		//      int numNeg;
+		const double sumWeight = applyWeightPolicy( _weightInitType, NULL, _numExamples );
 
-		//      // for each example
-		//      for ( eIt = _data.begin(); eIt != _data.end(); ++eIt )
-		//      {
-		//         vector<Label>& labels = eIt->getLabels();
-		//         vector<Label>::iterator lIt;
-
-		//         // for dense labels the size MUST always be the same!
-		//         assert (labels.size() == numLabels );
-
-		//         numPos = 0; numNeg = 0;
-		//         // first count the number of positives y
-		//         for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
-		//            if ( lIt->y > 0)
-		//               numPos += lIt->y;
-
-		//         for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
-		//         {
-		//            if (lIt->y > 0) // +1
-		//               lIt->weight = numLabels / posClassWeightDiv;
-		//            else // -1
-		//               lIt->weight = numLabels / nonPosClassWeightDiv;
-		//         }
+		// check for the sum of weights!
+		if ( !_data.empty() && !nor_utils::is_zero(sumWeight-1.0, 1E-3 ) )
+		{
+			cerr << "\nERROR: Sum of weights (" << sumWeight << ") != 1!" << endl;
+			cerr << "Try a different weight policy (--weightpolicy under 'Basic Algorithm Options')!" << endl;
+			//exit(1);
+		}
 
-		//      }
-		//   }
+		// set the initial weights needed to calculate the initial weighted error (11)
+#ifndef NOTIWEIGHT
+		vector<Example>::iterator eIt;
+		vector<Label>::iterator lIt;
+		for ( eIt = _data.begin(); eIt != _data.end(); ++eIt )
+		{
+			vector<Label>& labels = eIt->getLabels();
+			for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
+				lIt->initialWeight = lIt->weight;
+		}
+#endif
+	}
 
-		//   break;
+	// ------------------------------------------------------------------------
 
-		switch ( _weightInitType )
+	double RawData::applyWeightPolicy( eWeightInitType weightInitType, const int* pRawIndices, int numIndices )
+	{
+		const int numClasses = getNumClasses();
+		const int numThreads = ( _weightThreads < 1 || numIndices < _weightThreads ) ? 1 : _weightThreads;
+
+		// The totals needed by the policy: the sum of the weights (proportional) and
+		// the number of positive labels per class (balanced). Each thread sums a 
+		// contiguous range of the examples, and the ranges are added up in order.
+		float sumWeight = 0;
+		vector<int> numPerClasses( numClasses, 0 );
+		if ( weightInitType == WIT_PROP_ONLY || weightInitType == WIT_BALANCED )
 		{
-		case WIT_SHARE_POINT:
-			{
-				double oneDiv2n;
-				// for each example
-				for ( eIt = _data.begin(); eIt != _data.end(); ++eIt )
-				{
-					vector<Label>& labels = eIt->getLabels();
+			vector<float> threadSums( numThreads, 0 );
+			vector<int> threadCounts( numThreads * numClasses, 0 );
 
-					double sumPos = 0;
-					double sumNeg = 0;
+#pragma omp parallel for num_threads(numThreads) schedule(static, 1) if (numThreads > 1)
+			for (int t = 0; t < numThreads; ++t)
+			{
+				const int begin = static_cast<int>( static_cast<double>(numIndices) * t / numThreads );
+				const int end = static_cast<int>( static_cast<double>(numIndices) * (t + 1) / numThreads );
+				int* pCounts = numClasses > 0 ? &threadCounts[t * numClasses] : NULL;
+				float sum = 0;
 
-					// first find the sum of the weights
+				for (int i = begin; i < end; ++i)
+				{
+					const vector<Label>& labels = _data[ pRawIndices ? pRawIndices[i] : i ].getLabels();
+					vector<Label>::const_iterator lIt;
 					for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
 					{
+						sum += lIt->weight;
 						if ( lIt->y > 0 )
-							sumPos += lIt->weight;
-						else if ( lIt->y < 0 )
-							sumNeg += lIt->weight;
-					}
-
-					if ( nor_utils::is_zero(sumPos) || nor_utils::is_zero(sumNeg) )
-						oneDiv2n = 1.0/(_numExamples);
-					else
-						oneDiv2n = 1.0/(2.0*_numExamples);
-
-					// for each label
-					for ( lIt = labels.begin(); lIt != labels.end(); ++lIt )
-					{
-						// clearly this can be optimized, but the current format is
-						// just for clarity
-						if ( lIt->y > 0 )
-							lIt->weight = oneDiv2n * ( lIt->weight / sumPos );
-						else if ( lIt->y < 0 )
-							lIt->weight = oneDiv2n * ( lIt->weight / sumNeg );
-						else
-							lIt->weight = 0; // should never happen!
+							pCounts[lIt->idx]++;
 					}
 				}
+				threadSums[t] = sum;
 			}
 
-			break;
-
-		case WIT_SHARE_LABEL:
-
-			// for each example
-			for ( eIt = _data.begin(); eIt != _data.end(); ++eIt )
+			for (int t = 0; t < numThreads; ++t)
 			{
-				vector<Label>& labels = eIt->getLabels();
-				sumWeight = 0;
-
-				// first find the sum of the weights
-				for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
-					sumWeight += lIt->weight;
-
-				// now set the weights
-				for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
-					lIt->weight /= (sumWeight * _numExamples);
+				sumWeight += threadSums[t];
+				for (int l = 0; l < numClasses; ++l)
+					numPerClasses[l] += threadCounts[t * numClasses + l];
 			}
+		}
 
-			break;
-
-		case WIT_PROP_ONLY:
-
-			sumWeight = 0;
-
-			// first compute the whole sum of weights-examples
-			for ( eIt = _data.begin(); eIt != _data.end(); ++eIt )
+		// we assume pl = 1/K
+		vector<double> wi( numClasses );
+		vector<double> wic( numClasses );
+		if ( weightInitType == WIT_BALANCED )
+		{
+			for (int l = 0; l < numClasses; ++l)
 			{
-				vector<Label>& labels = eIt->getLabels();
-				for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
-					sumWeight += lIt->weight;
+				wi[l] =  (1.0 / numClasses) / (2.0 * numPerClasses[l]);
+				wic[l] = (1.0 / numClasses) / (2.0 * ( numIndices - numPerClasses[l] ));
 			}
+		}
 
-			// now re-weight 
-			for ( eIt = _data.begin(); eIt != _data.end(); ++eIt )
-			{
-				vector<Label>& labels = eIt->getLabels();
-
-				// now set the weights
-				for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
-					lIt->weight /= sumWeight;
-			}
+		// Now set the weights, and sum them up for the check of the caller
+		vector<double> threadTotals( numThreads, 0 );
 
-			break;
+#pragma omp parallel for num_threads(numThreads) schedule(static, 1) if (numThreads > 1)
+		for (int t = 0; t < numThreads; ++t)
+		{
+			const int begin = static_cast<int>( static_cast<double>(numIndices) * t / numThreads );
+			const int end = static_cast<int>( static_cast<double>(numIndices) * (t + 1) / numThreads );
+			double total = 0;
 
-		case WIT_BALANCED:
+			for (int i = begin; i < end; ++i)
 			{
-				/*
-				double* equationCoeffM = new double[ numOfClasses * numOfClasses ];
-				double* wiCommas = new double[ numOfClasses ];
-				int* dim = new int;
-				*dim = numOfClasses;
-				
-
-				for( int i = 0; i < numOfClasses; i ++ ) {
-					for( int j = 0; j < numOfClasses; j ++ ) {
-						if ( i != j ) {
-							equationCoeffM[ (i* numOfClasses ) + j ] = numPerClasses[ j ];
-						} else {
-							equationCoeffM[ (i* numOfClasses ) + j ] = numPerClasses[ i ] * ( numOfClasses - 1.0 );
-						}
-					}
-					wiCommas[i] = 1.0 / numOfClasses;
-				}
-
+				vector<Label>& labels = _data[ pRawIndices ? pRawIndices[i] : i ].getLabels();
+				vector<Label>::iterator lIt;
 
-				solveEquationSystem( equationCoeffM, wiCommas, dim );
-				
-				vector< double > wi( numOfClasses );
-				vector< double > wic( numOfClasses );
+				switch ( weightInitType )
+				{
+				case WIT_SHARE_POINT:
+					{
+						double sumPos = 0;
+						double sumNeg = 0;
+
+						// first find the sum of the weights
+						for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
+						{
+							if ( lIt->y > 0 )
+								sumPos += lIt->weight;
+							else if ( lIt->y < 0 )
+								sumNeg += lIt->weight;
+						}
 
-				
-				for( int i = 0; i < numOfClasses; i ++ ) {
-					cout << wiCommas[i] << "\t";
-					wic[i] = wiCommas[i];
-					wi[i] = wiCommas[i] * ( numOfClasses - 1.0 );
-				}
-				cout << endl;
-
-				delete [] wiCommas;
-				delete [] equationCoeffM;
-				delete dim;
-				*/
-				
-				int numOfClasses = this->getNumClasses();
-				vector< int > numPerClasses = this->getExamplesPerClass();
-				int numOfSamples = this->getNumExample();
-				vector< double > wi( numOfClasses );
-				vector< double > wic( numOfClasses );
-
-				// we assume pl = 1/K
-				for( int i = 0; i < numOfClasses; i ++ ) {
-					wi[i] =  (1.0 / numOfClasses) / (2.0 * numPerClasses[i]);
-					wic[i] = (1.0 / numOfClasses) / (2.0 * ( numOfSamples - numPerClasses[i] ));
-					
-					//cout << wi[i] << "\t" << wic[i] << endl;
-				}
-				//cout << endl;
+						double oneDiv2n;
+						if ( nor_utils::is_zero(sumPos) || nor_utils::is_zero(sumNeg) )
+							oneDiv2n = 1.0/(numIndices);
+						else
+							oneDiv2n = 1.0/(2.0*numIndices);
+
+						for ( lIt = labels.begin(); lIt != labels.end(); ++lIt )
+						{
+							if ( lIt->y > 0 )
+								lIt->weight = oneDiv2n * ( lIt->weight / sumPos );
+							else if ( lIt->y < 0 )
+								lIt->weight = oneDiv2n * ( lIt->weight / sumNeg );
+							else
+								lIt->weight = 0; // should never happen!
+						}
+					}
+					break;
 
+				case WIT_SHARE_LABEL:
+					{
+						float exampleWeight = 0;
+						for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
+							exampleWeight += lIt->weight;
 
-				//this->_nExamplesPerClass
-				// for each example
-				for ( eIt = _data.begin(); eIt != _data.end(); ++eIt )
-				{
-					vector<Label>& labels = eIt->getLabels();
+						for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
+							lIt->weight /= (exampleWeight * numIndices);
+					}
+					break;
 
-					float sumPos = 0;
-					float sumNeg = 0;
+				case WIT_PROP_ONLY:
+					for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
+						lIt->weight /= sumWeight;
+					break;
 
-					// first find the sum of the weights					
-					int i = 0;
-					for ( lIt = labels.begin(); lIt != labels.end(); ++lIt, i++ )
+				case WIT_BALANCED:
+					for ( lIt = labels.begin(); lIt != labels.end(); ++lIt )
 					{
 						if ( lIt->y > 0 )
 							lIt->weight = wi[lIt->idx];
 						else if ( lIt->y < 0 )
 							lIt->weight = wic[lIt->idx];
 					}
-
+					break;
 				}
-			}
-
-			break;
-
-		}
-
-		// check for the sum of weights!
-		sumWeight = 0;
-		for ( eIt = _data.begin(); eIt != _data.end(); ++eIt )
-		{
-			vector<Label>& labels = eIt->getLabels();
-			vector<Label>::iterator lIt;
 
-			// first find the sum of the weights
-			for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
-				sumWeight += lIt->weight;
-		}
-
-		if ( !nor_utils::is_zero(sumWeight-1.0, 1E-3 ) )
-		{
-			cerr << "\nERROR: Sum of weights (" << sumWeight << ") != 1!" << endl;
-			cerr << "Try a different weight policy (--weightpolicy under 'Basic Algorithm Options')!" << endl;
-			//exit(1);
-		}
-
-		// set the initial weights needed to calculate the initial weighted error (11)
-		for ( eIt = _data.begin(); eIt != _data.end(); ++eIt )
-		{
-			vector<Label>& labels = eIt->getLabels();
-#ifndef NOTIWEIGHT
-			for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
-				lIt->initialWeight = lIt->weight;
-#endif
+				for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
+					total += lIt->weight;
+			}
+			threadTotals[t] = total;
 		}
 
+		double sum = 0;
+		for (int t = 0; t < numThreads; ++t)
+			sum += threadTotals[t];
+		return sum;
 	}
 
 	// ------------------------------------------------------------------------
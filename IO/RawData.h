@@ -59,6 +59,8 @@ using namespace std;
 
 namespace MultiBoost {
 
+	class TransformPipeline;
+
 	/////////////////////////////////////////////////////////////////////////////
 	/////////////////////////////////////////////////////////////////////////////
 	enum eFileFormat
@@ -98,7 +100,14 @@ namespace MultiBoost {
 	   * \date 12/11/2005
 	   */
 	   RawData() : _hasExampleName(false), _classInLastColumn(false), _sepChars(" \t\n"),
-					 _numAttributes(0), _numExamples(0), _fileFormat(FF_SIMPLE) {  }
+					 _numAttributes(0), _numExamples(0), _fileFormat(FF_SIMPLE), _pTransforms(NULL), _rawNumAttributes(0),
+					 _hashBits(0), _hashSeed(0), _weightThreads(1) {  }
+
+		/**
+		* The destructor. Deletes the load-time transformations.
+		* \date 18/10/2026
+		*/
+		virtual ~RawData();
 
 
 		/**
@@ -165,9 +174,7 @@ namespace MultiBoost {
 		inline float   getValue(int idx, int columnIdx) const { 
 			if ( _dataRep == DR_DENSE )	return _data[idx].getValues()[columnIdx]; 
 			else {
-				map<int,int>::iterator it = ((Example &)_data[idx]).getValuesIndexesMap().find( columnIdx );
-				if ( it == ((Example &)_data[idx]).getValuesIndexesMap().end() ) return 0;
-				else return _data[idx].getValues()[it->second];
+				return _data[idx].getSparseValue( columnIdx );
 			}
 		}
 			
@@ -183,6 +190,17 @@ namespace MultiBoost {
 			_numExamples++; 
 		} 
 
+		/**
+		* Replace the examples by \a examples, in constant time. The header (the name
+		* maps, the attribute types and the representation) is kept.
+		* \param examples The new examples. It gets the previous ones.
+		* \date 18/10/2026
+		*/
+		void swapExamples( vector<Example>& examples ) {
+			_data.swap( examples );
+			_numExamples = static_cast<int>( _data.size() );
+		}
+
 
 		inline const Example& getExample(int idx)
 		{ return _data[idx]; }
@@ -238,6 +256,56 @@ namespace MultiBoost {
 		vector<Example>::iterator rawEnd() {return _data.end();}
 
 		vector< int >&	getExamplesPerClass() { return _nExamplesPerClass; }
+
+		eAttributeType getAttributeType(int j) const { return _attributeTypes[j]; } //!< The type of the column \a j.
+
+		/**
+		* Set the weights of a subset of the examples with a weight policy, from the
+		* weights they have (the ones given by the user at load time). The totals 
+		* of the policy (the sum of the weights, the number of positive labels per 
+		* class) are computed over the subset in one pass, and the weights are set 
+		* in a second pass, both split among --weightthreads threads.
+		* \param weightInitType The policy (see initWeights() and --weightpolicy).
+		* \param pRawIndices The raw indices of the examples of the subset, NULL for the 
+		* first \a numIndices examples.
+		* \param numIndices The number of examples of the subset.
+		* \return The sum of the new weights, which should be 1.
+		* \remark The initial weights (Label::initialWeight) are not touched.
+		* \see InputData::applyWeightPolicy()
+		* \date 18/10/2026
+		*/
+		double applyWeightPolicy( eWeightInitType weightInitType, const int* pRawIndices, int numIndices );
+
+		/**
+		* Set the feature hashing of the sparse parsers (SVMLight, LSHTC).
+		* The classifiers use it to reproduce the mapping stored in the shyp file.
+		* \param bits The columns are 2^bits. 0 disables the hashing.
+		* \param seed The seed of the hash function.
+		* \date 18/10/2026
+		*/
+		void setFeatureHashing(int bits, unsigned int seed) { _hashBits = bits; _hashSeed = seed; }
+
+		int          getFeatureHashingBits() const { return _hashBits; } //!< 0 if there is no hashing.
+		unsigned int getFeatureHashingSeed() const { return _hashSeed; }
+
+		/**
+		* The load-time transformations, for the examples parsed outside of load()
+		* (see --serve). Their columns are the ones of the file, described by the
+		* getRaw...() methods, and transformExample() maps them to the columns of the data.
+		* \return NULL if no transformation was asked.
+		* \date 18/10/2026
+		*/
+		TransformPipeline* getTransforms() { return _pTransforms; }
+
+		/**
+		* The columns of the file, before the load-time transformations. Without 
+		* transformations they are the columns of the data.
+		* \date 18/10/2026
+		*/
+		int getRawNumAttributes() const { return _pTransforms ? _rawNumAttributes : _numAttributes; }
+		const NameMap& getRawAttributeNameMap() const { return _pTransforms ? _rawAttributeNameMap : _attributeNameMap; }
+		const vector<eAttributeType>& getRawAttributeTypes() const { return _pTransforms ? _rawAttributeTypes : _attributeTypes; }
+		const NameMap& getRawEnumMap(int j) const { return _pTransforms ? _rawEnumMaps[j] : _enumMaps[j]; }
 	protected:
 		int           _numAttributes;   //!< The number of columns (dimensions).
 		int           _numExamples;  //!<  The number of examples.
@@ -258,6 +326,7 @@ namespace MultiBoost {
 		*  \end{cases} 
 		* \f]
 		* where \f$n\f$ is the number of examples and \f$k\f$ the number of classes.
+		* \see applyWeightPolicy
 		* \see Example
 		* \see _data
 		* \date 11/11/2005
@@ -281,6 +350,23 @@ namespace MultiBoost {
 
 		vector<eAttributeType> _attributeTypes; //!< The vector of attribute types. 
 		
+		/**
+		* The preprocessing stages fused into the parsing (NULL if none was asked).
+		* Built by initOptions() from --selectcolumns, --missingvalue and --quantize.
+		* \see DataTransform
+		*/
+		TransformPipeline* _pTransforms;
+
+		int                    _rawNumAttributes; //!< The number of columns of the file (only kept with _pTransforms).
+		NameMap                _rawAttributeNameMap; //!< The attribute names of the file (only kept with _pTransforms).
+		vector<eAttributeType> _rawAttributeTypes; //!< The attribute types of the file (only kept with _pTransforms).
+		vector<NameMap>        _rawEnumMaps; //!< The enum maps of the file (only kept with _pTransforms).
+
+		int           _hashBits; //!< The hashed features are mapped into 2^_hashBits columns (0: no hashing).
+		unsigned int  _hashSeed; //!< The seed of the feature hashing.
+
+		int           _weightThreads; //!< The number of threads of applyWeightPolicy() (--weightthreads).
+
 		//for LSHTC challenge		
 		string			_hierarchyFile;
 		string			_labelingType;
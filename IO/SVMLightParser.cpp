@@ -37,6 +37,7 @@
 #include <cmath> // for abs
 
 #include "IO/SVMLightParser.h"
+#include "IO/DataTransform.h"
 #include "Utils/Utils.h"
 
 namespace MultiBoost {
@@ -69,6 +70,14 @@ namespace MultiBoost {
 		
 		if ( ! _headerFileName.empty() ) // there is no file name
 			readHeader( classMap, enumMaps, attributeNameMap, attributeTypes);
+
+		if ( _hashBits > 0 )
+		{
+			// hashing trick: the column space is fixed and the feature names are not stored
+			attributeNameMap.setImplicitNames( 1 << _hashBits );
+			attributeTypes.assign( 1 << _hashBits, RawData::ATTRIBUTE_NUMERIC );
+		}
+
 		readData(inFile, examples, classMap, enumMaps, attributeNameMap, attributeTypes);
 	}
 
@@ -237,8 +246,13 @@ namespace MultiBoost {
 
 			Example& currExample = examples[currentSize++];
 			//now read values
-			readSparseValues(ss, currExample.getValues(), currExample.getValuesIndexes(), currExample.getValuesIndexesMap(),
+			readSparseValues(ss, currExample.getValues(), currExample.getValuesIndexes(),
 				enumMaps, attributeTypes, attributeNameMap );
+			currExample.compactSparseValues();
+
+			// fused preprocessing (projection, missing values, ...)
+			if ( _pTransform )
+				_pTransform->transformExample(currExample, attributeNameMap, attributeTypes);
 		}
 
 		if ( attributeTypes.empty() )
@@ -299,24 +313,33 @@ namespace MultiBoost {
 	// -----------------------------------------------------------------------------
 
 	void SVMLightParser::readSparseValues(istringstream& ss, vector<float>& values, 
-		vector<int>& idxs, map<int, int>& idxmap, vector<NameMap>& enumMaps, 
+		vector<int>& idxs, vector<NameMap>& enumMaps, 
 		const vector<RawData::eAttributeType>& attributeTypes, NameMap& attributeNameMap)
 	{
 		float tmpFeatVal;
 		string tmpFeatName;
-		int i = 0;
 		while (!ss.eof())
 		{
 			//read the name of the next feature name and its value
 			ss >> tmpFeatName;
 			ss >> tmpFeatVal;
 
-			//add the feature to the namemap if it doesn't exist
-			int tmpIdx = attributeNameMap.addName( tmpFeatName );
+			// do not even register the features dropped by the transformation
+			if ( _pTransform && !_pTransform->isAttributeUsed( tmpFeatName ) )
+				continue;
+
+			// colliding hashed features are summed up by Example::compactSparseValues()
+			int tmpIdx;
+			if ( _hashBits > 0 )
+				tmpIdx = getHashedColumn( tmpFeatName.data(), (int)tmpFeatName.size() );
+			else
+			{
+				//add the feature to the namemap if it doesn't exist
+				tmpIdx = attributeNameMap.addName( tmpFeatName );
+			}
 			
 			// add the feature value and its index
 			idxs.push_back(tmpIdx);
-			idxmap[ tmpIdx ] = i++;
 			values.push_back( tmpFeatVal );
 		}
 	}
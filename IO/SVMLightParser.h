@@ -90,7 +90,7 @@ namespace MultiBoost {
 			vector<NameMap>& enumMaps, 
 			const vector<RawData::eAttributeType>& attributeTypes);
 
-		void readSparseValues(istringstream& ss, vector<float>& values, vector<int>& idxs, map<int, int>& idxmap, 
+		void readSparseValues(istringstream& ss, vector<float>& values, vector<int>& idxs, 
 			vector<NameMap>& enumMaps, 
 			const vector<RawData::eAttributeType>& attributeTypes, NameMap& attributeNameMap);
 
@@ -40,11 +40,17 @@
 
 #include <cctype> // for isspace
 
+#ifndef WIN32
+#include <fcntl.h> // for open
+#include <unistd.h> // for fsync
+#endif
+
 namespace MultiBoost {
 	
 	// -----------------------------------------------------------------------
 	
 	Serialization::Serialization(const string& shypFileName, bool isComp )
+		: _writerRunning(false), _maxQueued(0), _syncPeriod(0), _numUnsynced(0)
 	{ 
 		_shypFile.open(shypFileName.c_str());
 		_shypFileName = shypFileName;
@@ -56,6 +62,171 @@ namespace MultiBoost {
 	
 	// -----------------------------------------------------------------------
 	
+	Serialization::~Serialization()
+	{
+#ifndef WIN32
+		if ( _writerRunning )
+			stopWriter();
+#endif
+	}
+	
+	// -----------------------------------------------------------------------
+	
+	void Serialization::startWriter(int maxQueued, int syncPeriod)
+	{
+		_maxQueued = maxQueued > 0 ? maxQueued : 1;
+		_syncPeriod = syncPeriod;
+		_numUnsynced = 0;
+		
+#ifndef WIN32
+		if ( _writerRunning )
+			return;
+		
+		_isWriting = false;
+		_stopWriting = false;
+		pthread_mutex_init( &_queueMutex, NULL );
+		pthread_cond_init( &_queueChanged, NULL );
+		
+		if ( pthread_create( &_writer, NULL, &Serialization::writerThread, this ) != 0 )
+		{
+			cerr << "WARNING: cannot start the writer thread, the hypotheses will be written right away." << endl;
+			pthread_cond_destroy( &_queueChanged );
+			pthread_mutex_destroy( &_queueMutex );
+			return;
+		}
+		_writerRunning = true;
+#endif
+	}
+	
+	// -----------------------------------------------------------------------
+	
+	void Serialization::queueHypothesis(int iteration, BaseLearner* pWeakHypothesis)
+	{
+#ifndef WIN32
+		if ( _writerRunning )
+		{
+			pthread_mutex_lock( &_queueMutex );
+			// the queue is bounded: wait for the writer to take it
+			while ( (int)_queue.size() >= _maxQueued )
+				pthread_cond_wait( &_queueChanged, &_queueMutex );
+			
+			_queue.push_back( make_pair(iteration, pWeakHypothesis) );
+			pthread_cond_broadcast( &_queueChanged );
+			pthread_mutex_unlock( &_queueMutex );
+			return;
+		}
+#endif
+		
+		writeHypothesis( iteration, pWeakHypothesis );
+		delete pWeakHypothesis;
+		
+		if ( _syncPeriod > 0 && ++_numUnsynced >= _syncPeriod )
+			syncFile();
+	}
+	
+	// -----------------------------------------------------------------------
+	
+	void Serialization::waitForWriter()
+	{
+#ifndef WIN32
+		if ( !_writerRunning )
+			return;
+		
+		pthread_mutex_lock( &_queueMutex );
+		while ( !_queue.empty() || _isWriting )
+			pthread_cond_wait( &_queueChanged, &_queueMutex );
+		pthread_mutex_unlock( &_queueMutex );
+#endif
+	}
+	
+#ifndef WIN32
+	// -----------------------------------------------------------------------
+	
+	void* Serialization::writerThread(void* pSerialization)
+	{
+		static_cast<Serialization*>(pSerialization)->writeQueue();
+		return NULL;
+	}
+	
+	// -----------------------------------------------------------------------
+	
+	void Serialization::writeQueue()
+	{
+		deque< pair<int, BaseLearner*> > batch;
+		
+		pthread_mutex_lock( &_queueMutex );
+		while ( true )
+		{
+			while ( _queue.empty() && !_stopWriting )
+				pthread_cond_wait( &_queueChanged, &_queueMutex );
+			
+			if ( _queue.empty() )
+				break; // stopped
+			
+			// take the whole queue, and let the boosting loop go on
+			batch.swap( _queue );
+			_isWriting = true;
+			pthread_cond_broadcast( &_queueChanged );
+			pthread_mutex_unlock( &_queueMutex );
+			
+			deque< pair<int, BaseLearner*> >::iterator bIt;
+			for ( bIt = batch.begin(); bIt != batch.end(); ++bIt )
+			{
+				writeHypothesis( bIt->first, bIt->second );
+				delete bIt->second;
+				++_numUnsynced;
+			}
+			batch.clear();
+			
+			if ( _syncPeriod > 0 && _numUnsynced >= _syncPeriod )
+				syncFile();
+			
+			pthread_mutex_lock( &_queueMutex );
+			_isWriting = false;
+			pthread_cond_broadcast( &_queueChanged );
+		}
+		pthread_mutex_unlock( &_queueMutex );
+	}
+	
+	// -----------------------------------------------------------------------
+	
+	void Serialization::stopWriter()
+	{
+		pthread_mutex_lock( &_queueMutex );
+		_stopWriting = true;
+		pthread_cond_broadcast( &_queueChanged );
+		pthread_mutex_unlock( &_queueMutex );
+		
+		// the thread writes what is left in the queue before stopping
+		pthread_join( _writer, NULL );
+		pthread_cond_destroy( &_queueChanged );
+		pthread_mutex_destroy( &_queueMutex );
+		_writerRunning = false;
+	}
+#endif
+	
+	// -----------------------------------------------------------------------
+	
+	void Serialization::syncFile()
+	{
+		_numUnsynced = 0;
+		if ( !_shypFile.is_open() )
+			return;
+		
+		_shypFile.flush();
+#ifndef WIN32
+		// the data of the file is synced whatever the descriptor
+		const int fd = ::open( _shypFileName.c_str(), O_RDONLY );
+		if ( fd >= 0 )
+		{
+			fsync( fd );
+			::close( fd );
+		}
+#endif
+	}
+	
+	// -----------------------------------------------------------------------
+	
 	void Serialization::writeHeader(const string& weakLearnerName)
 	{
 		// print the header
@@ -69,6 +240,14 @@ namespace MultiBoost {
 	
 	// -----------------------------------------------------------------------
 	
+	void Serialization::writeFeatureHashing(int bits, unsigned int seed)
+	{
+		_shypFile << standardTag("hashbits", bits, 1) << endl;
+		_shypFile << standardTag("hashseed", seed, 1) << endl;
+	}
+	
+	// -----------------------------------------------------------------------
+	
 	void Serialization::writeCascadeHeader(const string& weakLearnerName)
 	{
 		// print the header
@@ -83,18 +262,25 @@ namespace MultiBoost {
 	
 	void Serialization::writeFooter()
 	{
+		waitForWriter();
+		
 		// close tag
 		_shypFile << "</multiboost>" << endl;
 		
 		if ( _isComp ) {
 			flushCompressedBuffer();
 		}
+		else if ( _syncPeriod > 0 ) {
+			syncFile();
+		}
 		
 	}
 	// -----------------------------------------------------------------------
 	
 	void Serialization::writeCascadeFooter()
 	{
+		waitForWriter();
+		
 		// close tag
 		_shypFile << "</cascade>" << endl;
 		
@@ -148,6 +334,8 @@ namespace MultiBoost {
 	// -----------------------------------------------------------------------	
 	void Serialization::appendStageSeparatorHeader( int stageIndex, int weakhypnum, double threshold )
 	{		
+		waitForWriter();
+
 		//_shypFile << "\t<stage num=\""  << stageIndex << "\" weakhypnum=\"" <<  weakhypnum << "\" threshold=\""<< threshold << "\">" << endl;
 		_shypFile << "\t<stage num=\""  << stageIndex << "\">" << endl; 
 		_shypFile << "\t\t<weakhypnum>" <<  weakhypnum << "</weakhypnum>" << endl;
@@ -167,6 +355,14 @@ namespace MultiBoost {
 	// -----------------------------------------------------------------------
 	
 	void  Serialization::appendHypothesis(int iteration, BaseLearner* pWeakHypothesis)
+	{
+		waitForWriter();
+		writeHypothesis( iteration, pWeakHypothesis );
+	}
+	
+	// -----------------------------------------------------------------------
+	
+	void  Serialization::writeHypothesis(int iteration, BaseLearner* pWeakHypothesis)
 	{
 		// open the hypothesis tag (parameters: iteration, weak learner's name)
 		_shypFile << "\t<weakhyp iter=\"" << iteration << "\">" << endl;
@@ -320,6 +516,25 @@ namespace MultiBoost {
 	
 	// -----------------------------------------------------------------------
 	
+	bool UnSerialization::parseFeatureHashing(nor_utils::StreamTokenizer& st, int& bits, unsigned int& seed)
+	{
+		// skip the closing algo tag
+		string token = st.next_token();
+		if ( !token.empty() && token[0] == '/' )
+			token = st.next_token();
+		
+		if ( !nor_utils::cmp_nocase(token, "hashbits") )
+			return false;
+		
+		istringstream ss( st.next_token() );
+		ss >> bits;
+		seed = seekAndParseEnclosedValue<unsigned int>(st, "hashseed");
+		
+		return true;
+	}
+	
+	// -----------------------------------------------------------------------
+	
 	bool UnSerialization::seekSimpleTag(nor_utils::StreamTokenizer& st, const string& tag)
 	{
 		do{
@@ -51,6 +51,11 @@
 #include <algorithm> // for fill
 #include <fstream> // input/output on file
 #include <iomanip> // for setprecision
+#include <deque> // for the queue of the writer thread
+
+#ifndef WIN32
+#include <pthread.h> // for the writer thread
+#endif
 
 using namespace std;
 
@@ -66,6 +71,8 @@ namespace MultiBoost {
 	
 	/**
 	 * The serialization (saving) of the weak learners found.
+	 * The hypotheses can also be written by a background thread (see startWriter()),
+	 * so that the boosting loop does not wait for the formatting and the disk.
 	 * \see UnSerialization
 	 * \date 13/11/2005
 	 */
@@ -81,6 +88,45 @@ namespace MultiBoost {
 		 */
 		Serialization(const string& shypFileName, bool isComp = false );
 		
+		/**
+		 * The destructor. Waits for the writer thread to write the queued
+		 * hypotheses, and stops it.
+		 * \date 18/10/2026
+		 */
+		~Serialization();
+		
+		/**
+		 * Start the thread that writes the hypotheses passed to queueHypothesis().
+		 * The thread takes the whole queue at each wake up and writes it as a batch.
+		 * \param maxQueued The maximum number of hypotheses waiting to be written:
+		 * queueHypothesis() blocks when the queue is full.
+		 * \param syncPeriod The file is synced to the disk (fsync) every \a syncPeriod
+		 * hypotheses and at the end, so that a crash loses at most the last ones.
+		 * 0 leaves it to the system.
+		 * \remark Without pthreads (WIN32) the hypotheses are written right away.
+		 * \date 18/10/2026
+		 */
+		void startWriter(int maxQueued, int syncPeriod);
+		
+		/**
+		 * Append the passed weak hypothesis to the file through the writer thread,
+		 * or right away if startWriter() has not been called.
+		 * The hypothesis is given away: it is deleted once written, so it must not 
+		 * be used (or deleted) by the caller after the call.
+		 * \param iteration The iteration index.
+		 * \param pWeakHypothesis The current weak hypothesis.
+		 * \see appendHypothesis
+		 * \date 18/10/2026
+		 */
+		void  queueHypothesis(int iteration, BaseLearner* pWeakHypothesis);
+		
+		/**
+		 * Wait until the writer thread has written all the queued hypotheses.
+		 * Called by the methods writing to the file directly.
+		 * \date 18/10/2026
+		 */
+		void  waitForWriter();
+		
 		/**
 		 * Write the header.
 		 * \param weakLearnerName The name of the weak learner used to find the weak
@@ -89,6 +135,17 @@ namespace MultiBoost {
 		 */
 		void writeHeader(const string& weakLearnerName);
 		
+		/**
+		 * Write the parameters of the feature hashing used to load the training data,
+		 * so that the classification of new data reproduces the same columns.
+		 * Must be called right after writeHeader().
+		 * \param bits The number of bits of the hashed column space.
+		 * \param seed The seed of the hash function.
+		 * \see UnSerialization::parseFeatureHashing
+		 * \date 18/10/2026
+		 */
+		void writeFeatureHashing(int bits, unsigned int seed);
+		
 		/**
 		 * Write the footer. Important because it closes the xml file.
 		 * \date 27/12/2005
@@ -177,12 +234,46 @@ namespace MultiBoost {
 		//virtual void appendStageSeparatorFooter();
 	protected:
 		void flushCompressedBuffer();
+		
+		/**
+		 * Write the hypothesis to the file (the body of appendHypothesis(), 
+		 * also called by the writer thread).
+		 * \date 18/10/2026
+		 */
+		void writeHypothesis(int iteration, BaseLearner* pWeakHypothesis);
+		
+		/**
+		 * Flush the file and sync it to the disk.
+		 * \date 18/10/2026
+		 */
+		void syncFile();
+		
+#ifndef WIN32
+		static void* writerThread(void* pSerialization); //!< The body of the writer thread.
+		void writeQueue(); //!< Write the queue until stopWriter() is called.
+		void stopWriter();
+#endif
+		
 	private:
 		ofstream _shypFile; //!< The strong learner file
 		string	_shypFileName;
 		string   _bzipFileName;
 		bool		_isComp;
 		
+		bool     _writerRunning; //!< True between startWriter() and the destruction.
+		int      _maxQueued;
+		int      _syncPeriod;
+		int      _numUnsynced; //!< The hypotheses written since the last sync.
+		
+#ifndef WIN32
+		deque< pair<int, BaseLearner*> > _queue; //!< The (iteration, hypothesis) to write.
+		bool            _isWriting; //!< The writer thread is writing a batch.
+		bool            _stopWriting;
+		pthread_t       _writer;
+		pthread_mutex_t _queueMutex;
+		pthread_cond_t  _queueChanged; //!< Signaled when the queue or _isWriting change.
+#endif
+		
 	};
 	
 	// -----------------------------------------------------------------------
@@ -310,6 +401,18 @@ namespace MultiBoost {
 		 */
 		static string getWeakLearnerName(const string& shypFileName);
 		
+		/**
+		 * Parse the feature hashing parameters, if any. The stream must be
+		 * right after the value of the algo tag.
+		 * \param st The stream tokenizer on the file stream.
+		 * \param bits The number of bits of the hashed column space to be filled.
+		 * \param seed The seed of the hash function to be filled.
+		 * \return True if the strong hypothesis was trained on hashed features.
+		 * \see Serialization::writeFeatureHashing
+		 * \date 18/10/2026
+		 */
+		static bool parseFeatureHashing(nor_utils::StreamTokenizer& st, int& bits, unsigned int& seed);
+		
 		/**
 		 * Move in the stream until it finds the given tag. 
 		 * For instance if the stream is at the beginning of
@@ -40,10 +40,55 @@
 #include <algorithm> // for sort
 
 #include <limits>
+#include <fstream>
+#include <sstream>
+#include <cstdio> // for rename
+#include <cstring> // for memcmp
+
+#ifndef WIN32
+#include <sys/mman.h> // for --shareddata
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 // ------------------------------------------------------------------------
 namespace MultiBoost {
 
+// The header of a --shareddata file, followed by the column begins 
+// (numAttributes+1), the indices and the values (numElements each).
+struct SharedColumnsHeader
+{
+   char         magic[8];
+   int          numExamples;
+   int          numAttributes;
+   int          numElements;
+   unsigned int fingerprint;
+};
+
+static const char sharedColumnsMagic[8] = { 'M', 'B', 'S', 'O', 'R', 'T', '1', 0 };
+
+// ------------------------------------------------------------------------
+
+SortedData::~SortedData()
+{
+#ifndef WIN32
+   if ( _pSharedMemory )
+      munmap( _pSharedMemory, _sharedMemorySize );
+#endif
+}
+
+// ------------------------------------------------------------------------
+
+void SortedData::initOptions(const nor_utils::Args& args)
+{
+   InputData::initOptions(args);
+
+   if ( args.hasArgument("shareddata") )
+      args.getValue("shareddata", 0, _sharedFileName);
+}
+
+// ------------------------------------------------------------------------
+
 void SortedData::load(const string& fileName, eInputType inputType, int verboseLevel)
 {
    InputData::load(fileName, inputType, verboseLevel);
@@ -52,17 +97,23 @@ void SortedData::load(const string& fileName, eInputType inputType, int verboseL
    if (inputType == IT_TEST)
       return;
 
+   // another process might have sorted the same data already
+   if ( !_sharedFileName.empty() && attachSharedColumns(verboseLevel) )
+      return;
+
    if (verboseLevel > 0)
       cout << "Sorting data..." << flush;
 
-   // set the number of columns for the stored data
-   _sortedData.resize(_pData->getNumAttributes()); 
+   const int numAttributes = _pData->getNumAttributes();
+
+   // the columns are collected as pairs first, and split once sorted
+   vector<column> tmpSortedData(numAttributes);
    int i = 0;
 
    if ( _pData->getDataRep() == DR_DENSE )
    {
-	   for ( i = 0; i < _pData->getNumAttributes(); ++i )
-         _sortedData[i].reserve(_numExamples);
+	   for ( i = 0; i < numAttributes; ++i )
+         tmpSortedData[i].reserve(_numExamples);
    }
    
    //////////////////////////////////////////////////////////////////////////
@@ -82,64 +133,499 @@ void SortedData::load(const string& fileName, eInputType inputType, int verboseL
 
       if ( valIdx.empty() ) // dense data!
       {
-         //_sortedData[j].reserve(values.size()); // <-- this should be done before, and only of dense!
          // for each attribute of the example
          for (vIt = values.begin(); vIt != values.end(); ++vIt, ++j )
-            _sortedData[j].push_back( make_pair(i, *vIt) ); // store the index of the example and the value
+            tmpSortedData[j].push_back( make_pair(i, *vIt) ); // store the index of the example and the value
       }
       else // sparse data
       {
          // for each attribute of the example
          for (vIt = values.begin(); vIt != values.end(); ++vIt, ++j )
-            _sortedData[ valIdx[j] ].push_back( make_pair(i, *vIt) ); // store the index of the example and the value
+            tmpSortedData[ valIdx[j] ].push_back( make_pair(i, *vIt) ); // store the index of the example and the value
       }
    }
 
    //////////////////////////////////////////////////////////////////////////
-   // Now sort the data.
-   
+   // Now sort the data, and split each column into the index and value arrays.
+   size_t numElements = 0;
+   for (int j = 0; j < numAttributes; ++j)
+      numElements += tmpSortedData[j].size();
+
+   _columnBegins.resize(numAttributes + 1);
+   _sortedIndices.clear();
+   _sortedValues.clear();
+   _sortedIndices.reserve(numElements);
+   _sortedValues.reserve(numElements);
+
    // For each column
-   for (int j = 0; j < _pData->getNumAttributes(); ++j)
+   for (int j = 0; j < numAttributes; ++j)
    {
+      column& currColumn = tmpSortedData[j];
 
 #if STABLE_SORT
-      stable_sort( _sortedData[j].begin(), _sortedData[j].end(), 
+      stable_sort( currColumn.begin(), currColumn.end(), 
                    nor_utils::comparePair<2, int, float, less<float> >() );
 #else
-      sort( _sortedData[j].begin(), _sortedData[j].end(), 
+      sort( currColumn.begin(), currColumn.end(), 
             nor_utils::comparePair< 2, int, float, less<float> >() );
 #endif
+
+      _columnBegins[j] = static_cast<int>( _sortedIndices.size() );
+
+      for ( column::iterator it = currColumn.begin(); it != currColumn.end(); ++it )
+      {
+         if ( it->second != it->second ) // NaN: missing value
+            continue;
+         _sortedIndices.push_back( it->first );
+         _sortedValues.push_back( it->second );
+      }
+
+      // release the memory of the pair column
+      column().swap(currColumn);
    }
+   _columnBegins[numAttributes] = static_cast<int>( _sortedIndices.size() );
+
+   _pColumnBegins = &_columnBegins[0];
+   _pSortedIndices = _sortedIndices.empty() ? NULL : &_sortedIndices[0];
+   _pSortedValues = _sortedValues.empty() ? NULL : &_sortedValues[0];
 
    if (verboseLevel > 0)
       cout << "Done!" << endl;
+
+   if ( !_sharedFileName.empty() )
+      publishSharedColumns(verboseLevel);
 }
 
 // ------------------------------------------------------------------------
 
-pair<vpIterator,vpIterator> SortedData::getFileteredBeginEnd(int colIdx) {
-	_filteredColumn.clear();
-	for( column::iterator it = _sortedData[colIdx].begin(); it != _sortedData[colIdx].end(); it ++ ) {
-		set<int>::iterator setIt = this->_usedIndices.find( (*it).first ); 
-		if ( ( setIt != this->_usedIndices.end() ) && ( it->second == it->second ) ) {
-			int i = this->getOrderBasedOnRawIndex( it->first );
-			_filteredColumn.push_back( pair<int, float>(i, it->second) );
+unsigned int SortedData::getDataFingerprint()
+{
+   unsigned int fingerprint = static_cast<unsigned int>( _pData->getNumAttributes() );
+
+   vector<Example>::iterator eIt;
+   for ( eIt = _pData->rawBegin(); eIt != _pData->rawEnd(); ++eIt )
+   {
+      const vector<float>& values = eIt->getValues();
+      const vector<int>& valIdx = eIt->getValuesIndexes();
+      if ( !values.empty() )
+         fingerprint = nor_utils::murmur_hash( &values[0], (int)( values.size() * sizeof(float) ), fingerprint );
+      if ( !valIdx.empty() )
+         fingerprint = nor_utils::murmur_hash( &valIdx[0], (int)( valIdx.size() * sizeof(int) ), fingerprint );
+      fingerprint = nor_utils::murmur_hash( "\n", 1, fingerprint ); // the end of the example
+   }
+
+   return fingerprint;
+}
+
+// ------------------------------------------------------------------------
+
+#ifndef WIN32
+
+bool SortedData::attachSharedColumns(int verboseLevel)
+{
+   const int fd = open( _sharedFileName.c_str(), O_RDONLY );
+   if ( fd < 0 )
+      return false;
+
+   const off_t fileSize = lseek( fd, 0, SEEK_END );
+   if ( fileSize < (off_t)sizeof(SharedColumnsHeader) )
+   {
+      close(fd);
+      return false;
+   }
+
+   // the pages are shared by all the processes mapping the file
+   void* pMemory = mmap( NULL, fileSize, PROT_READ, MAP_SHARED, fd, 0 );
+   close(fd);
+   if ( pMemory == MAP_FAILED )
+      return false;
+
+   const SharedColumnsHeader* pHeader = static_cast<const SharedColumnsHeader*>( pMemory );
+   const int numAttributes = _pData->getNumAttributes();
+   const size_t expectedSize = sizeof(SharedColumnsHeader) + 
+      ( numAttributes + 1 ) * sizeof(int) + 
+      (size_t)pHeader->numElements * ( sizeof(int) + sizeof(float) );
+
+   if ( memcmp( pHeader->magic, sharedColumnsMagic, sizeof(sharedColumnsMagic) ) != 0 ||
+        pHeader->numExamples != _pData->getNumExample() ||
+        pHeader->numAttributes != numAttributes ||
+        pHeader->numElements < 0 ||
+        (size_t)fileSize != expectedSize ||
+        pHeader->fingerprint != getDataFingerprint() )
+   {
+      if (verboseLevel > 0)
+         cout << "The shared data <" << _sharedFileName << "> belongs to other data, it will be replaced." << endl;
+      munmap( pMemory, fileSize );
+      return false;
+   }
+
+   if ( _pSharedMemory )
+      munmap( _pSharedMemory, _sharedMemorySize );
+   _pSharedMemory = pMemory;
+   _sharedMemorySize = fileSize;
+
+   const char* pArrays = static_cast<const char*>( pMemory ) + sizeof(SharedColumnsHeader);
+   _pColumnBegins = reinterpret_cast<const int*>( pArrays );
+   _pSortedIndices = _pColumnBegins + numAttributes + 1;
+   _pSortedValues = reinterpret_cast<const float*>( _pSortedIndices + pHeader->numElements );
+
+   // the private columns are not needed anymore
+   vector<int>().swap(_columnBegins);
+   vector<int>().swap(_sortedIndices);
+   vector<float>().swap(_sortedValues);
+
+   if (verboseLevel > 0)
+      cout << "Using the sorted data shared in <" << _sharedFileName << ">." << endl;
+
+   return true;
+}
+
+// ------------------------------------------------------------------------
+
+void SortedData::publishSharedColumns(int verboseLevel)
+{
+   SharedColumnsHeader header;
+   memcpy( header.magic, sharedColumnsMagic, sizeof(sharedColumnsMagic) );
+   header.numExamples = _pData->getNumExample();
+   header.numAttributes = _pData->getNumAttributes();
+   header.numElements = static_cast<int>( _sortedIndices.size() );
+   header.fingerprint = getDataFingerprint();
+
+   // written aside and renamed, so that the other processes see either 
+   // no file or a complete one
+   ostringstream tmpFileName;
+   tmpFileName << _sharedFileName << "." << getpid();
+
+   ofstream outFile( tmpFileName.str().c_str(), ios::binary );
+   if ( !outFile.is_open() )
+   {
+      cerr << "WARNING: Cannot write the shared data <" << _sharedFileName << ">!" << endl;
+      return;
+   }
+
+   outFile.write( reinterpret_cast<const char*>(&header), sizeof(header) );
+   outFile.write( reinterpret_cast<const char*>(&_columnBegins[0]), _columnBegins.size() * sizeof(int) );
+   if ( !_sortedIndices.empty() )
+   {
+      outFile.write( reinterpret_cast<const char*>(&_sortedIndices[0]), _sortedIndices.size() * sizeof(int) );
+      outFile.write( reinterpret_cast<const char*>(&_sortedValues[0]), _sortedValues.size() * sizeof(float) );
+   }
+   outFile.close();
+
+   if ( outFile.fail() || rename( tmpFileName.str().c_str(), _sharedFileName.c_str() ) != 0 )
+   {
+      cerr << "WARNING: Cannot write the shared data <" << _sharedFileName << ">!" << endl;
+      unlink( tmpFileName.str().c_str() );
+      return;
+   }
+
+   if (verboseLevel > 0)
+      cout << "Sorted data shared in <" << _sharedFileName << ">." << endl;
+
+   // this process uses the shared pages too
+   attachSharedColumns(0);
+}
+
+#else
+
+bool SortedData::attachSharedColumns(int verboseLevel)
+{
+   return false;
+}
+
+void SortedData::publishSharedColumns(int verboseLevel)
+{
+   cerr << "WARNING: --shareddata is not available on this platform, the data is not shared!" << endl;
+}
+
+#endif
+
+// ------------------------------------------------------------------------
+
+SortedColumn SortedData::getFilteredColumn(int colIdx)
+{
+	return getFilteredColumn( colIdx, _filteredIndices, _filteredValues );
+}
+
+// ------------------------------------------------------------------------
+
+SortedColumn SortedData::getFilteredColumn(int colIdx, vector<int>& indexBuffer, vector<float>& valueBuffer)
+{
+	SortedColumn sortedColumn;
+
+	if ( _currPartitionNode >= 0 )
+	{
+		// the node is a contiguous range: only the indices need to be mapped
+		SortedData* pOwner = static_cast<SortedData*>( this->_pPartitionOwner );
+		pOwner->loadPartitionColumn( colIdx );
+		const int begin = pOwner->_partitionColumnRanges[_currPartitionNode][2*colIdx];
+		const int end = pOwner->_partitionColumnRanges[_currPartitionNode][2*colIdx+1];
+		const vector<int>& indices = pOwner->_partitionIndices[colIdx];
+
+		indexBuffer.resize( end - begin );
+		for( int k = begin; k < end; ++k )
+			indexBuffer[k - begin] = this->_orderOfRaw[ indices[k] ];
+
+		sortedColumn.indices = ( end > begin ) ? &indexBuffer[0] : NULL;
+		sortedColumn.values = ( end > begin ) ? &pOwner->_partitionValues[colIdx][begin] : NULL;
+		sortedColumn.size = end - begin;
+		return sortedColumn;
+	}
+
+	const int columnBegin = _pColumnBegins[colIdx];
+	const int columnSize = _pColumnBegins[colIdx+1] - columnBegin;
+
+	if ( !this->isFiltered() ) 
+	{
+		sortedColumn.indices = ( columnSize > 0 ) ? _pSortedIndices + columnBegin : NULL;
+		sortedColumn.values = ( columnSize > 0 ) ? _pSortedValues + columnBegin : NULL;
+		sortedColumn.size = columnSize;
+		return sortedColumn;
+	}
+
+	const int* indices = _pSortedIndices + columnBegin;
+	const float* values = _pSortedValues + columnBegin;
+
+	indexBuffer.clear();
+	valueBuffer.clear();
+
+	for( int k = 0; k < columnSize; ++k ) {
+		const int order = this->_orderOfRaw[ indices[k] ];
+		if ( order >= 0 ) {
+			indexBuffer.push_back( order );
+			valueBuffer.push_back( values[k] );
 		}
 	}
-	return make_pair(_filteredColumn.begin(),_filteredColumn.end());
+
+	sortedColumn.indices = indexBuffer.empty() ? NULL : &indexBuffer[0];
+	sortedColumn.values = valueBuffer.empty() ? NULL : &valueBuffer[0];
+	sortedColumn.size = static_cast<int>( indexBuffer.size() );
+	return sortedColumn;
 }
 
 // ------------------------------------------------------------------------
 
-pair<vpReverseIterator,vpReverseIterator> SortedData::getFileteredReverseBeginEnd(int colIdx) {
+void SortedData::fillFilteredColumn(int colIdx) {
 	_filteredColumn.clear();
-	for( column::iterator it = _sortedData[colIdx].begin(); it != _sortedData[colIdx].end(); it ++ ) {
-		set<int>::iterator setIt = this->_usedIndices.find( (*it).first ); 
-		if ( ( setIt != this->_usedIndices.end() ) && ( it->second == it->second )  ) {
-			int i = this->getOrderBasedOnRawIndex( it->first );
-			_filteredColumn.push_back( pair<int, float>(i, it->second) );
+
+	if ( _currPartitionNode >= 0 )
+	{
+		SortedData* pOwner = static_cast<SortedData*>( this->_pPartitionOwner );
+		pOwner->loadPartitionColumn( colIdx );
+		const int begin = pOwner->_partitionColumnRanges[_currPartitionNode][2*colIdx];
+		const int end = pOwner->_partitionColumnRanges[_currPartitionNode][2*colIdx+1];
+		const vector<int>& indices = pOwner->_partitionIndices[colIdx];
+		const vector<float>& values = pOwner->_partitionValues[colIdx];
+
+		_filteredColumn.reserve( end - begin );
+		for( int k = begin; k < end; ++k )
+			_filteredColumn.push_back( pair<int, float>(this->_orderOfRaw[ indices[k] ], values[k]) );
+		return;
+	}
+
+	const int columnBegin = _pColumnBegins[colIdx];
+	const int columnSize = _pColumnBegins[colIdx+1] - columnBegin;
+	const int* indices = _pSortedIndices + columnBegin;
+	const float* values = _pSortedValues + columnBegin;
+
+	for( int k = 0; k < columnSize; ++k ) {
+		const int order = this->_orderOfRaw[ indices[k] ];
+		if ( order >= 0 )
+			_filteredColumn.push_back( pair<int, float>(order, values[k]) );
+	}
+}
+
+// ------------------------------------------------------------------------
+
+int SortedData::beginPartition()
+{
+	const int rootIdx = InputData::beginPartition();
+	const int numAttributes = _pData->getNumAttributes();
+
+	// the columns are copied into the partition when a node first uses them 
+	// (see loadPartitionColumn()), most of them are never touched by a tree
+	_partitionIndices.resize( numAttributes );
+	_partitionValues.resize( numAttributes );
+	_partitionColumnLoaded.assign( numAttributes, 0 );
+	_partitionColumnRanges.resize( 1 );
+	_partitionColumnRanges[rootIdx].resize( 2 * numAttributes );
+	_partitionKeyNodes = 0;
+
+	_partitionSideOfRaw.resize( _pData->getNumExample() );
+
+	return rootIdx;
+}
+
+// ------------------------------------------------------------------------
+
+void SortedData::loadPartitionColumn( int colIdx )
+{
+#pragma omp critical (SortedDataPartitionColumn)
+	if ( !_partitionColumnLoaded[colIdx] )
+	{
+		const int numPositions = static_cast<int>( _partitionExamples.size() );
+		const int numNodes = static_cast<int>( _partitionNodes.size() );
+
+		// The key of an example is the beginning of the smallest range of the 
+		// nodes that holds it (a leaf or the dropped examples of a split). The 
+		// ranges are nested, so a stable counting sort on the keys puts the 
+		// elements of every node in a contiguous range, sorted by value.
+		if ( _partitionKeyNodes != numNodes )
+		{
+			_partitionKeyCounts.assign( numPositions + 1, 0 );
+			for( int n = 0; n < numNodes; ++n ) {
+				_partitionKeyCounts[ _partitionNodes[n].first ] = 1;
+				_partitionKeyCounts[ _partitionNodes[n].second ] = 1;
+			}
+
+			_partitionKeyOfRaw.assign( _pData->getNumExample(), -1 );
+			int key = 0;
+			for( int pos = 0; pos < numPositions; ++pos ) {
+				if ( _partitionKeyCounts[pos] )
+					key = pos;
+				_partitionKeyOfRaw[ _partitionExamples[pos] ] = key;
+			}
+			_partitionKeyNodes = numNodes;
 		}
+
+		const int columnBegin = _pColumnBegins[colIdx];
+		const int columnEnd = _pColumnBegins[colIdx+1];
+
+		// the number of elements of each key, then their offsets
+		_partitionKeyCounts.assign( numPositions + 1, 0 );
+		for( int k = columnBegin; k < columnEnd; ++k ) {
+			const int key = _partitionKeyOfRaw[ _pSortedIndices[k] ];
+			if ( key >= 0 )
+				++_partitionKeyCounts[key + 1];
+		}
+		for( int pos = 0; pos < numPositions; ++pos )
+			_partitionKeyCounts[pos + 1] += _partitionKeyCounts[pos];
+
+		vector<int>& partIndices = _partitionIndices[colIdx];
+		vector<float>& partValues = _partitionValues[colIdx];
+		partIndices.resize( _partitionKeyCounts[numPositions] );
+		partValues.resize( _partitionKeyCounts[numPositions] );
+
+		// the ranges of the nodes, before the counts are used as insertion points
+		for( int n = 0; n < numNodes; ++n ) {
+			_partitionColumnRanges[n][2*colIdx] = _partitionKeyCounts[ _partitionNodes[n].first ];
+			_partitionColumnRanges[n][2*colIdx+1] = _partitionKeyCounts[ _partitionNodes[n].second ];
+		}
+
+		for( int k = columnBegin; k < columnEnd; ++k ) {
+			const int rawIdx = _pSortedIndices[k];
+			const int key = _partitionKeyOfRaw[rawIdx];
+			if ( key >= 0 ) {
+				const int dest = _partitionKeyCounts[key]++;
+				partIndices[dest] = rawIdx;
+				partValues[dest] = _pSortedValues[k];
+			}
+		}
+
+		_partitionColumnLoaded[colIdx] = 1;
 	}
+}
+
+// ------------------------------------------------------------------------
+
+void SortedData::splitPartitionNode( int nodeIdx, const vector<signed char>& sides, 
+                                     int& leftIdx, int& rightIdx )
+{
+	// the side of the examples by raw index (the node is the current index set)
+	const int numNodeExamples = this->_numExamples;
+	for( int i = 0; i < numNodeExamples; ++i )
+		_partitionSideOfRaw[ this->_indirectIndices[i] ] = sides[i];
+
+	InputData::splitPartitionNode( nodeIdx, sides, leftIdx, rightIdx );
+
+	const int numAttributes = static_cast<int>( _partitionIndices.size() );
+	_partitionColumnRanges.resize( _partitionNodes.size() );
+	vector<int>& leftRanges = _partitionColumnRanges[leftIdx];
+	vector<int>& rightRanges = _partitionColumnRanges[rightIdx];
+	leftRanges.resize( 2 * numAttributes );
+	rightRanges.resize( 2 * numAttributes );
+
+	const vector<int>& nodeRanges = _partitionColumnRanges[nodeIdx];
+
+	for( int j = 0; j < numAttributes; ++j )
+	{
+		if ( !_partitionColumnLoaded[j] )
+			continue;
+
+		vector<int>& indices = _partitionIndices[j];
+		vector<float>& values = _partitionValues[j];
+		const int begin = nodeRanges[2*j];
+		const int end = nodeRanges[2*j+1];
+
+		// stable three-way partition: the left elements are moved in place, the 
+		// right ones to the front of the buffers and the dropped ones to their back
+		const int size = end - begin;
+		this->_partitionBuffer.resize( size );
+		_partitionValueBuffer.resize( size );
+		int numLeft = 0, numRight = 0, numDropped = 0;
+		for( int k = begin; k < end; ++k ) {
+			const int rawIdx = indices[k];
+			const float value = values[k];
+			const signed char side = _partitionSideOfRaw[rawIdx];
+			if ( side > 0 ) {
+				indices[ begin + numLeft ] = rawIdx;
+				values[ begin + numLeft ] = value;
+				++numLeft;
+			} else if ( side < 0 ) {
+				this->_partitionBuffer[ numRight ] = rawIdx;
+				_partitionValueBuffer[ numRight ] = value;
+				++numRight;
+			} else {
+				++numDropped;
+				this->_partitionBuffer[ size - numDropped ] = rawIdx;
+				_partitionValueBuffer[ size - numDropped ] = value;
+			}
+		}
+		copy( this->_partitionBuffer.begin(), this->_partitionBuffer.begin() + numRight, 
+			  indices.begin() + begin + numLeft );
+		copy( _partitionValueBuffer.begin(), _partitionValueBuffer.begin() + numRight, 
+			  values.begin() + begin + numLeft );
+		reverse_copy( this->_partitionBuffer.end() - numDropped, this->_partitionBuffer.end(), 
+					  indices.begin() + begin + numLeft + numRight );
+		reverse_copy( _partitionValueBuffer.end() - numDropped, _partitionValueBuffer.end(), 
+					  values.begin() + begin + numLeft + numRight );
+
+		leftRanges[2*j] = begin;
+		leftRanges[2*j+1] = begin + numLeft;
+		rightRanges[2*j] = begin + numLeft;
+		rightRanges[2*j+1] = begin + numLeft + numRight;
+	}
+}
+
+// ------------------------------------------------------------------------
+
+void SortedData::endPartition()
+{
+	InputData::endPartition();
+	_partitionColumnRanges.clear();
+	_partitionColumnLoaded.clear();
+}
+
+// ------------------------------------------------------------------------
+
+InputData* SortedData::createPartitionView( int nodeIdx )
+{
+	SortedData* pView = new SortedData();
+	pView->initPartitionView( this, nodeIdx );
+	return pView;
+}
+
+// ------------------------------------------------------------------------
+
+pair<vpIterator,vpIterator> SortedData::getFileteredBeginEnd(int colIdx) {
+	fillFilteredColumn( colIdx );
+	return make_pair(_filteredColumn.begin(),_filteredColumn.end());
+}
+
+// ------------------------------------------------------------------------
+
+pair<vpReverseIterator,vpReverseIterator> SortedData::getFileteredReverseBeginEnd(int colIdx) {
+	fillFilteredColumn( colIdx );
 	return make_pair(_filteredColumn.rbegin(),_filteredColumn.rend());
 }
 
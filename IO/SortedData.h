@@ -43,6 +43,7 @@
 #include "IO/InputData.h"
 
 #include <vector>
+#include <string>
 #include <utility> // for pair
 
 using namespace std;
@@ -52,6 +53,26 @@ namespace MultiBoost {
 //////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////////////////////
 
+/**
+* A read-only view on a sorted column in split form. The example indices and
+* the values are stored in two separate arrays, so that the threshold search
+* can stream through them without touching the examples themselves.
+* \remark The indices are the ones of the (possibly filtered) InputData, that is
+* they can be used directly with InputData::getLabels().
+* \see SortedData::getFilteredColumn()
+*/
+struct SortedColumn
+{
+   SortedColumn() : indices(NULL), values(NULL), size(0) {}
+
+   const int*   indices; //!< The index of the examples, in increasing order of value.
+   const float* values;  //!< The values of the column, aligned with indices.
+   int          size;    //!< The number of elements in the column.
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////
+
 /**
 * Overloading of the InputData class to support sorting of the column.
 * This is particularly useful for stump-based learner, because
@@ -69,11 +90,25 @@ class SortedData : public InputData
 {
 public:
 
+   /**
+   * The constructor. It does noting but initializing some variables.
+   * \date 18/10/2026
+   */
+   SortedData() : _pColumnBegins(NULL), _pSortedIndices(NULL), _pSortedValues(NULL),
+                  _pSharedMemory(NULL), _sharedMemorySize(0), _partitionKeyNodes(0) {}
+
    /**
    * The destructor. Must be declared (virtual) for the proper destruction of 
-   * the object.
+   * the object. It unmaps the shared columns.
    */
-   virtual ~SortedData() {}
+   virtual ~SortedData();
+
+   /**
+   * Set the arguments of the data, adding --shareddata.
+   * \see InputData::initOptions
+   * \date 18/10/2026
+   */
+   virtual void initOptions(const nor_utils::Args& args);
 
    /**
    * Overloading of the load function to support sorting.
@@ -96,7 +131,8 @@ public:
    */
 
    virtual bool isAttributeEmpty( int idx ) {
-	   return _sortedData[idx].empty();
+	   const int* pColumnBegins = static_cast<SortedData*>(_pPartitionOwner)->_pColumnBegins;
+	   return pColumnBegins[idx] == pColumnBegins[idx+1];
    }
 
    virtual bool isFilteredAttributeEmpty() {
@@ -107,14 +143,63 @@ public:
 	   return ( _filteredColumn[0].second == _filteredColumn[_filteredColumn.size()-1].second );
    }
 
+   /**
+   * Get the sorted column in split (index array + value array) form.
+   * If the data is not filtered the view points directly to the stored column,
+   * otherwise the column is filtered into an internal buffer, which is 
+   * overwritten by the next call.
+   * \param colIdx The column index.
+   * \return The view on the column.
+   * \remark This is the preferred way to walk a column: unlike getFileteredBeginEnd()
+   * it does not copy anything when the whole dataset is used.
+   * \see SortedColumn
+   */
+   virtual SortedColumn getFilteredColumn(int colIdx);
+
+   /**
+   * Same as getFilteredColumn(int), but the column is filtered into the given
+   * buffers, so several threads can walk the columns of the same data (each 
+   * with its own buffers) as long as the index set does not change.
+   * \param colIdx The column index.
+   * \param indexBuffer The buffer of the indices, overwritten if the data is filtered.
+   * \param valueBuffer The buffer of the values, overwritten if the data is filtered.
+   * \return The view on the column.
+   * \date 18/10/2026
+   */
+   SortedColumn getFilteredColumn(int colIdx, vector<int>& indexBuffer, vector<float>& valueBuffer);
+
+   /**
+   * Start the partition-based growth of a tree. Besides the examples, the 
+   * sorted columns are partitioned too: the elements of a node are a contiguous
+   * range of each column, still sorted by value, so selecting a node costs 
+   * nothing and getFilteredColumn() only walks the elements of the node.
+   * A column is copied into the partition the first time a node uses it.
+   * \see InputData::beginPartition
+   * \date 18/10/2026
+   */
+   virtual int beginPartition();
+
+   /**
+   * Split a node, partitioning each column range of the node stably (so that
+   * the children ranges are sorted by value without sorting).
+   * \see InputData::splitPartitionNode
+   * \date 18/10/2026
+   */
+   virtual void splitPartitionNode( int nodeIdx, const vector<signed char>& sides, 
+                                    int& leftIdx, int& rightIdx );
+
+   virtual void endPartition();
+
+   /**
+   * Create a view on a node of the partition. The view walks the column ranges
+   * of the node stored in this object, with its own filtering buffers.
+   * \remark The view is a SortedData: the derived classes that hold data of 
+   * their own must override it (or return NULL).
+   * \see InputData::createPartitionView
+   * \date 18/10/2026
+   */
+   virtual InputData* createPartitionView( int nodeIdx );
 
-protected:
-   virtual pair<vpIterator,vpIterator> getSortedBeginEnd(int colIdx) { 
-	   if ( this->isFiltered() ) {
-		   return this->getFileteredBeginEnd( colIdx );
-	   } else {
-		return make_pair(_sortedData[colIdx].begin(),_sortedData[colIdx].end()); }
-   }
 public: 
    virtual pair<vpIterator,vpIterator> getFileteredBeginEnd(int colIdx);
    virtual pair<vpReverseIterator,vpReverseIterator> getFileteredReverseBeginEnd(int colIdx);
@@ -123,18 +208,99 @@ protected:
    /**
    * A column of the data.
    * The pair represents the index of the example and the value of the column.
-   * The index of the column is the index of the vector itself.
-   * \remark I am storing both the index and the value because it is a trade off between
-   * speed in a key part of the code (finding the threshold) and the memory consumption.
-   * In case of very large databases, this could be turned into a index only vector.
+   * \remark It is only used for the iterator-based interface (getFileteredBeginEnd()),
+   * the columns themselves are stored in split form.
    * \date 11/11/2005
    */
    typedef vector< pair<int, float> > column;
 
-   vector<column>    _sortedData; //!< the sorted data.
+   /**
+   * Fill _filteredColumn with the elements of the given column that belong
+   * to the current index set.
+   * \param colIdx The column index.
+   */
+   void fillFilteredColumn(int colIdx);
+
+   /**
+   * Map the sorted columns of the file given with --shareddata, if it holds 
+   * the columns of the loaded data.
+   * \param verboseLevel The level of verbosity.
+   * \return true if the columns have been mapped.
+   * \date 18/10/2026
+   */
+   bool attachSharedColumns(int verboseLevel);
+
+   /**
+   * Write the sorted columns into the file given with --shareddata, and map it
+   * in place of the private columns.
+   * \param verboseLevel The level of verbosity.
+   * \date 18/10/2026
+   */
+   void publishSharedColumns(int verboseLevel);
+
+   /**
+   * Copy a column into the partition if no node has used it yet, grouping
+   * the elements of each node of the partition in a contiguous range.
+   * \param colIdx The column index.
+   * \date 18/10/2026
+   */
+   void loadPartitionColumn( int colIdx );
+
+   /**
+   * A checksum of the loaded examples, which identifies the columns of a shared file.
+   * \date 18/10/2026
+   */
+   unsigned int getDataFingerprint();
+
+   /**
+   * The sorted data, stored column-wise in split form: the elements of column j
+   * are in [_pColumnBegins[j], _pColumnBegins[j+1]), _pSortedIndices holds the
+   * index of the examples in increasing order of the value of the column, 
+   * _pSortedValues the corresponding values.
+   * The arrays point either to the private vectors below or to the file mapped
+   * read-only with --shareddata, which is shared by all the processes using it.
+   * \remark Missing (NaN) values are not stored.
+   * \remark The two arrays are kept separate so that a threshold search is a 
+   * streaming pass over two contiguous arrays.
+   */
+   const int*   _pColumnBegins;
+   const int*   _pSortedIndices; //!< The indices of the sorted columns.
+   const float* _pSortedValues; //!< The values, aligned with _pSortedIndices.
+
+   vector<int>   _columnBegins; //!< The private storage of _pColumnBegins.
+   vector<int>   _sortedIndices; //!< The private storage of _pSortedIndices.
+   vector<float> _sortedValues; //!< The private storage of _pSortedValues.
+
+   string _sharedFileName; //!< The file of the shared columns (--shareddata), empty if none.
+   void*  _pSharedMemory; //!< The mapping of _sharedFileName (NULL if not mapped).
+   size_t _sharedMemorySize; //!< The size of the mapping.
 
    column _filteredColumn;
 
+   vector<int>   _filteredIndices; //!< The buffer of getFilteredColumn() (indices)
+   vector<float> _filteredValues; //!< The buffer of getFilteredColumn() (values)
+
+   /**
+   * The columns of the partition (see beginPartition()): the same layout as 
+   * _sortedIndices and _sortedValues, but with the elements of each node 
+   * grouped in a contiguous range.
+   */
+   vector< vector<int> >   _partitionIndices;
+   vector< vector<float> > _partitionValues; //!< The values, aligned with _partitionIndices.
+
+   /**
+   * The range of each node in each column: _partitionColumnRanges[node][2*j] 
+   * and _partitionColumnRanges[node][2*j+1] are the begin and the end of column j.
+   */
+   vector< vector<int> >   _partitionColumnRanges;
+
+   vector<char>        _partitionColumnLoaded; //!< Whether a column has been copied into the partition.
+   vector<int>         _partitionKeyOfRaw; //!< The key of each raw example in the partition (see loadPartitionColumn()).
+   vector<int>         _partitionKeyCounts; //!< Buffer for the counting sort of loadPartitionColumn().
+   int                 _partitionKeyNodes; //!< The number of nodes when _partitionKeyOfRaw was computed.
+   vector<signed char> _partitionSideOfRaw; //!< The side of the split of each raw example.
+   vector<float>       _partitionValueBuffer; //!< Buffer for the stable partitions (values).
+
 };
 
 
@@ -38,6 +38,7 @@
 #include <sstream>
 
 #include "IO/TxtParser.h"
+#include "IO/DataTransform.h"
 #include "Utils/Utils.h"
 
 namespace MultiBoost {
@@ -124,6 +125,10 @@ void TxtParser::readData( vector<Example>& examples, NameMap& classMap,
       if ( inFile.eof() )
          break;
 
+      // fused preprocessing (projection, missing values, ...)
+      if ( _pTransform )
+         _pTransform->transformExample(currExample, attributeNameMap, attributeTypes);
+
       if (_hasClassEnd)
          inFile >> tmpClassName; // store class
 
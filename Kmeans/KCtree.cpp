@@ -22,6 +22,10 @@
 #include "KMfilterCenters.h"		// center set structure
 #include "KMrand.h"			// random number includes
 
+#ifdef _OPENMP
+#include <omp.h>			// OpenMP (omp_in_parallel)
+#endif
+
 //----------------------------------------------------------------------
 //  Declaration of local utilities.  These are used in getNeighbors().
 //----------------------------------------------------------------------
@@ -42,6 +46,13 @@ static void postNeigh(			// assign neighbors to center
     int			n_data,			// number of points
     KMctrIdx		ctrIdx);		// center index
 
+#ifdef _OPENMP
+static void splitTree(			// split the tree for the threads
+    KCptr		root,			// root of the tree
+    int			kCtrs,			// number of centers
+    std::vector<KCsubtree>& subtrees);		// the subtrees (returned)
+#endif
+
 //----------------------------------------------------------------------
 //  KCtree constructors
 //	There is a skeleton kc-tree constructor which does (almost)
@@ -106,6 +117,8 @@ void KCtree::skeletonTree(		// construct skeleton tree
 int		kcDim;			// dimension of space
 int		kcDataSize;		// number of data points
 KMdataArray	kcPoints;		// data points
+					// (one copy per thread, see getNeighbors)
+#pragma omp threadprivate(kcDim, kcDataSize, kcPoints)
 
 //----------------------------------------------------------------------
 //  initBasicGlobals - initialize basic globals
@@ -501,6 +514,8 @@ KMpointArray	kcSums;			// sums
 double*		kcSumSqs;		// sum of squares
 double*		kcDists;		// distortions
 KMpoint		kcBoxMidpt;		// bounding-box midpoint
+#pragma omp threadprivate(kcKCtrs, kcWeights, kcCenters, kcSums)
+#pragma omp threadprivate(kcSumSqs, kcDists, kcBoxMidpt)
 
 //----------------------------------------------------------------------
 //  initDistGlobals - initialize distortion globals
@@ -559,12 +574,76 @@ static void deleteDistGlobals()		// delete distortion globals
 //	function pruneTest() determines whether another candidate is
 //	close enough to the cell to be closer to some part of the cell
 //	than the nearest candidate.
+//
+//	When kmNumThreads > 1 (and we are not already inside a parallel
+//	region, e.g., in kmRestarts), the top of the tree is first split
+//	into subtrees (see getSubtrees), which are dealt round-robin to
+//	the threads.  Each thread posts its neighbors into its own sums,
+//	sums of squares and weights, and these are added up in thread
+//	order at the end, so the result does not depend on the timing.
 //----------------------------------------------------------------------
 
 void KCtree::getNeighbors(		// compute neighbors for centers
     KMfilterCenters& ctrs)			// the centers
 {
     initDistGlobals(ctrs);			// initialize globals
+#ifdef _OPENMP
+    if (kmNumThreads > 1 && !omp_in_parallel()) {
+	std::vector<KCsubtree> subtrees;	// the subtrees
+	splitTree(root, kcKCtrs, subtrees);
+	int nSubtrees = (int) subtrees.size();
+	int nThreads = kmNumThreads;
+	int kCtrs = kcKCtrs;
+						// per-thread accumulators
+	int* weights = new int[nThreads*kCtrs];
+	double* sumSqs = new double[nThreads*kCtrs];
+	KMpointArray sums = kmAllocPts(nThreads*kCtrs, kcDim);
+	for (int j = 0; j < nThreads*kCtrs; j++) {
+	    weights[j] = 0;
+	    sumSqs[j] = 0;
+	    for (int d = 0; d < kcDim; d++) {
+		sums[j][d] = 0;
+	    }
+	}
+	KMpoint boxMidpt = kcBoxMidpt;		// save master's midpoint
+
+	#pragma omp parallel num_threads(nThreads) copyin(kcDim, kcPoints, kcKCtrs, kcCenters)
+	{
+	    int t = omp_get_thread_num();
+	    kcWeights = weights + t*kCtrs;	// post into our accumulators
+	    kcSumSqs = sumSqs + t*kCtrs;
+	    kcSums = sums + t*kCtrs;
+	    kcBoxMidpt = kmAllocPt(kcDim);
+
+	    #pragma omp for schedule(static, 1)
+	    for (int s = 0; s < nSubtrees; s++) {
+		subtrees[s].node->getNeighbors(&subtrees[s].cands[0],
+			(int) subtrees[s].cands.size());
+	    }
+	    kmDeallocPt(kcBoxMidpt);
+	}
+						// restore master's globals
+	kcWeights	= ctrs.getWeights(false);
+	kcSums		= ctrs.getSums(false);
+	kcSumSqs	= ctrs.getSumSqs(false);
+	kcBoxMidpt	= boxMidpt;
+	for (int t = 0; t < nThreads; t++) {	// add up the accumulators
+	    for (int j = 0; j < kCtrs; j++) {
+		int tj = t*kCtrs + j;
+		kcWeights[j] += weights[tj];
+		kcSumSqs[j] += sumSqs[tj];
+		for (int d = 0; d < kcDim; d++) {
+		    kcSums[j][d] += sums[tj][d];
+		}
+	    }
+	}
+	kmDeallocPts(sums);
+	delete [] sumSqs;
+	delete [] weights;
+	deleteDistGlobals();			// delete globals
+	return;
+    }
+#endif
     int *candIdx = new int[kcKCtrs];		// allocate center indices
     for (int j = 0; j < kcKCtrs; j++) {		// initialize everything
     	candIdx[j] = j;				// initialize indices
@@ -650,6 +729,28 @@ void KCtree::getAssignments(		// compute assignments for points
     double*	 	sqDist)			// sq'd distance to center
 {
     initDistGlobals(ctrs);			// initialize globals
+#ifdef _OPENMP
+    if (kmNumThreads > 1 && !omp_in_parallel()) {
+	std::vector<KCsubtree> subtrees;	// the subtrees
+	splitTree(root, kcKCtrs, subtrees);
+	int nSubtrees = (int) subtrees.size();
+	KMpoint boxMidpt = kcBoxMidpt;		// save master's midpoint
+						// points are disjoint
+	#pragma omp parallel num_threads(kmNumThreads) copyin(kcDim, kcPoints, kcKCtrs, kcCenters)
+	{
+	    kcBoxMidpt = kmAllocPt(kcDim);
+	    #pragma omp for schedule(static, 1)
+	    for (int s = 0; s < nSubtrees; s++) {
+		subtrees[s].node->getAssignments(&subtrees[s].cands[0],
+			(int) subtrees[s].cands.size(), closeCtr, sqDist);
+	    }
+	    kmDeallocPt(kcBoxMidpt);
+	}
+	kcBoxMidpt = boxMidpt;			// restore master's midpoint
+	deleteDistGlobals();			// delete globals
+	return;
+    }
+#endif
 
     int *candIdx = new int[kcKCtrs];		// allocate center indices
     for (int j = 0; j < kcKCtrs; j++) {		// initialize everything
@@ -719,10 +820,87 @@ void KCleaf::getAssignments(		// get assignments for leaf node
     }
 }
 
+//----------------------------------------------------------------------
+// getSubtrees
+//	This splits the top levels of the tree into subtrees for the
+//	parallel traversals.  The candidates are filtered exactly as in
+//	getNeighbors, and the descent stops at a leaf, at a node with a
+//	single candidate left, or after depth levels.  Each subtree is
+//	returned with its candidates.
+//----------------------------------------------------------------------
+
+void KCnode::getSubtrees(		// this node is a subtree
+    KMctrIdxArray	cands,			// candidate centers
+    int			kCands,			// number of centers
+    int			/*depth*/,		// levels left to split (unused)
+    std::vector<KCsubtree>& subtrees)		// the subtrees (returned)
+{
+    subtrees.push_back(KCsubtree());
+    subtrees.back().node = this;
+    subtrees.back().cands.assign(cands, cands + kCands);
+}
+
+//----------------------------------------------------------------------
+void KCsplit::getSubtrees(		// split internal node
+    KMctrIdxArray	cands,			// candidate centers
+    int			kCands,			// number of centers
+    int			depth,			// levels left to split
+    std::vector<KCsubtree>& subtrees)		// the subtrees (returned)
+{
+    if (kCands == 1 || depth == 0) {		// nothing left to split
+	KCnode::getSubtrees(cands, kCands, depth, subtrees);
+    }
+    else {
+    						// get closest cand to box
+	int cc = closestToBox(cands, kCands, bnd_box);
+	KMctrIdx closeCand = cands[cc];		// closest candidate index
+						// space for new candidates
+	KMctrIdxArray newCands = new KMctrIdx[kCands];
+	int newK = 0;				// number of new candidates
+	for (int j = 0; j < kCands; j++) {
+	    if (j == cc || !pruneTest(		// is candidate close enough?
+	    			kcCenters[cands[j]],
+	    			kcCenters[closeCand],
+				bnd_box)) {
+	    	newCands[newK++] = cands[j];	// yes, keep it
+	    }
+	}
+						// apply to children
+	child[KM_LO]->getSubtrees(newCands, newK, depth-1, subtrees);
+	child[KM_HI]->getSubtrees(newCands, newK, depth-1, subtrees);
+	delete [] newCands;			// delete new candidates
+    }
+}
+
 //----------------------------------------------------------------------
 //  Local utilities
 //----------------------------------------------------------------------
 
+#ifdef _OPENMP
+//----------------------------------------------------------------------
+//  splitTree - split the tree for kmNumThreads threads
+//	About 16 subtrees per thread are asked for, so that the threads
+//	stay busy even if the subtrees are unbalanced.  The distortion
+//	globals must have been initialized.
+//----------------------------------------------------------------------
+
+static void splitTree(			// split the tree for the threads
+    KCptr		root,			// root of the tree
+    int			kCtrs,			// number of centers
+    std::vector<KCsubtree>& subtrees)		// the subtrees (returned)
+{
+    int depth = 4;				// levels to split
+    while ((1 << depth) < 16*kmNumThreads) depth++;
+
+    KMctrIdxArray candIdx = new KMctrIdx[kCtrs];
+    for (int j = 0; j < kCtrs; j++) {		// all centers are candidates
+    	candIdx[j] = j;
+    }
+    root->getSubtrees(candIdx, kCtrs, depth, subtrees);
+    delete [] candIdx;
+}
+#endif
+
 //----------------------------------------------------------------------
 //  closestToBox - compute the closest point to the box
 //	This procedure is given a list of candidates (cands), the number
@@ -23,6 +23,7 @@
 
 #include "KMeans.h"				// all k-means includes
 #include "KCutil.h"				// kc-tree utilities
+#include <vector>				// STL vector
 
 class KMfilterCenters;				// see KMfilterCenters.h
 
@@ -53,6 +54,18 @@ class KMfilterCenters;				// see KMfilterCenters.h
 class KCnode;
 typedef KCnode	*KCptr;			// pointer to kc-node
 
+//----------------------------------------------------------------------
+//  KCsubtree - a subtree of the kc-tree and its candidate centers
+//	When kmNumThreads > 1, getNeighbors() and getAssignments() first
+//	filter the candidates down the top levels of the tree (see
+//	KCnode::getSubtrees), and then traverse the resulting subtrees
+//	in parallel.
+//----------------------------------------------------------------------
+struct KCsubtree {
+    KCptr			node;		// root of the subtree
+    std::vector<KMctrIdx>	cands;		// its candidate centers
+};
+
 class KCtree {
 protected:
     int			dim;		// dimension of space
@@ -169,6 +182,12 @@ public:
 	KMctrIdxArray 	closeCtr,		// closest center per point
 	double*	 	sqDist) = 0;		// sq'd distance to center
 
+    virtual void getSubtrees(		// split tree into subtrees
+	KMctrIdxArray	cands,			// candidate centers
+	int		kCands,			// number of centers
+	int		depth,			// levels left to split
+	std::vector<KCsubtree>& subtrees);	// the subtrees (returned)
+
 					// sample a center point c
     virtual void sampleCtr(KMpoint c, KMorthRect& bb) = 0;
 						//
@@ -286,6 +305,12 @@ public:
 	KMctrIdxArray 	closeCtr,		// closest center per point
 	double*	 	sqDist);		// sq'd distance to center
 
+    virtual void getSubtrees(		// split tree into subtrees
+	KMctrIdxArray	cands,			// candidate centers
+	int		kCands,			// number of centers
+	int		depth,			// levels left to split
+	std::vector<KCsubtree>& subtrees);	// the subtrees (returned)
+
 					// sample a center point c
     virtual void sampleCtr(KMpoint c, KMorthRect& bb);
 
@@ -35,6 +35,7 @@ StatLev		kmStatLev	= SILENT;	// global stats output level
 ostream*	kmOut		= &std::cout;	// standard output stream
 ostream*	kmErr		= &std::cerr;	// output error stream
 istream*	kmIn		= &std::cin;	// input stream
+int		kmNumThreads	= 1;		// threads of the kc-tree traversals
 
 //----------------------------------------------------------------------
 //  Output utilities
@@ -115,6 +115,7 @@ extern StatLev		kmStatLev;	// statistics output level
 extern ostream*		kmOut;		// standard output stream
 extern ostream*		kmErr;		// error output stream
 extern istream*		kmIn;		// input stream
+extern int		kmNumThreads;	// threads of the kc-tree traversals
 
 //----------------------------------------------------------------------
 //  Printing utilities
@@ -25,6 +25,7 @@
 //  basic includes
 //----------------------------------------------------------------------
 #include <cmath>				// math includes (exp, log)
+#include <vector>				// STL vector
 #include "KMeans.h"				// kmeans includes
 #include "KMdata.h"				// data points
 #include "KMfilterCenters.h"			// centers
@@ -843,4 +844,47 @@ protected:					// overridden methods
     }
 };
 
+//------------------------------------------------------------------------
+//  kmRestarts - independent restarts of a local search
+//	This runs nRestarts independent copies of the algorithm ALG (e.g.,
+//	KMlocalSwap or KMlocalHybrid) from the solution sol on up to
+//	numThreads threads, and returns the one of lowest distortion (the
+//	first one on ties).  Each restart draws from its own random stream
+//	(see kmRanPrivateStream), seeded from the shared generator before
+//	the runs, so the result does not depend on the number of threads.
+//	Inside the restarts the kc-tree traversals are sequential.
+//------------------------------------------------------------------------
+
+template <class ALG>
+KMfilterCenters kmRestarts(
+    const KMfilterCenters&	sol,		// initial solution
+    const KMterm&		term,		// termination conditions
+    int				nRestarts,	// number of restarts
+    int				numThreads)	// number of threads
+{
+#ifndef _OPENMP
+    (void) numThreads;				// (sequential without OpenMP)
+#endif
+    std::vector<unsigned int> seeds(nRestarts);
+    for (int r = 0; r < nRestarts; r++) {	// seed the streams
+	seeds[r] = (unsigned int) kmRanInt(0x7fffffff) + 1;
+    }
+    std::vector<KMfilterCenters> results(nRestarts, sol);
+
+    #pragma omp parallel for num_threads(numThreads) schedule(dynamic, 1) if (numThreads > 1)
+    for (int r = 0; r < nRestarts; r++) {
+	kmRanPrivateStream(seeds[r]);		// our own stream
+	ALG alg(sol, term);
+	results[r] = alg.execute();
+	results[r].getDist();			// (computed in the thread)
+	kmRanPrivateStream(0);
+    }
+
+    int best = 0;				// the best of the runs
+    for (int r = 1; r < nRestarts; r++) {
+	if (results[r].getDist() < results[best].getDist()) best = r;
+    }
+    return results[best];
+}
+
 #endif
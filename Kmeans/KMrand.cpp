@@ -30,6 +30,25 @@ long random(void) { return long(rand()); }
 //----------------------------------------------------------------------
 int	kmIdum = 0;			// used for random number generation
 
+static unsigned int kmStream = 0;	// private stream state (0 = none)
+#pragma omp threadprivate(kmStream)
+
+//------------------------------------------------------------------------
+//	kmRanPrivateStream - switch to a private random stream
+//
+//	The generator below shares its state (and random()) between all
+//	the threads.  Parallel runs (see kmRestarts in KMlocal.h) call this
+//	with a nonzero seed to draw from a xorshift stream of the calling
+//	thread instead, which makes each run reproducible whatever the
+//	other threads do.  A zero seed goes back to the shared generator.
+//------------------------------------------------------------------------
+
+void kmRanPrivateStream(
+    unsigned int	seed)
+{
+    kmStream = seed;
+}
+
 //------------------------------------------------------------------------
 //	kmRan0 - (safer) uniform random number generator
 //
@@ -48,6 +67,13 @@ static double kmRan0()
 {
     int j;
 
+    if (kmStream != 0) {		// private stream (never 0)
+	kmStream ^= kmStream << 13;
+	kmStream ^= kmStream >> 17;
+	kmStream ^= kmStream << 5;
+	return kmStream / 4294967296.0;
+    }
+
     static double y, maxran, v[98];	// The exact number 98 is unimportant
     static int iff = 0;
 
@@ -37,6 +37,9 @@ extern	int	kmIdum;			// used for random number generation
 //  External entry points
 //----------------------------------------------------------------------
 
+void kmRanPrivateStream(		// private stream of this thread
+	unsigned int	seed);		// its seed (0 = shared stream)
+
 int kmRanInt(			// random integer
 	int		n);		// in the range [0,n-1]
 
@@ -0,0 +1,260 @@
+//----------------------------------------------------------------------
+//	File:           KMsparse.cpp
+//	Description:    Mini-batch k-means on sparse data points
+//----------------------------------------------------------------------
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or (at
+// your option) any later version.  See the file Copyright.txt in the
+// main directory.
+//----------------------------------------------------------------------
+
+#include "KMsparse.h"
+#include "KMrand.h"			// provides kmRanInt(), kmRanUnif()
+
+#include <algorithm>			// for stable_sort, fill
+
+using namespace std;
+
+//------------------------------------------------------------------------
+//  KMsparseData - sparse data points
+//------------------------------------------------------------------------
+
+static bool kmSparseEntryLess(		// order of the entries
+    const KMsparseEntry& a,
+    const KMsparseEntry& b)
+{
+    return a.pt < b.pt || (a.pt == b.pt && a.col < b.col);
+}
+
+KMsparseData::KMsparseData(int d, int n, vector<KMsparseEntry>& entries)
+    : dim(d), nPts(n), rowBegins(n+1, 0), sqNorms(n, 0.0)
+{
+					// sort by point and coordinate,
+					// the first of the duplicates stays first
+    stable_sort(entries.begin(), entries.end(), kmSparseEntryLess);
+
+    cols.reserve(entries.size());
+    vals.reserve(entries.size());
+    for (size_t e = 0; e < entries.size(); e++) {
+	if (e > 0 && entries[e].pt == entries[e-1].pt && entries[e].col == entries[e-1].col)
+	    continue;				// duplicate entry
+	assert(entries[e].pt >= 0 && entries[e].pt < nPts);
+	assert(entries[e].col >= 0 && entries[e].col < dim);
+	rowBegins[entries[e].pt + 1]++;
+	cols.push_back(entries[e].col);
+	vals.push_back(entries[e].val);
+	sqNorms[entries[e].pt] += (double) entries[e].val * entries[e].val;
+    }
+    for (int i = 0; i < nPts; i++)
+	rowBegins[i+1] += rowBegins[i];
+}
+
+KMsparseData KMsparseData::transpose() const
+{
+    KMsparseData t(*this);
+    t.dim = nPts;
+    t.nPts = dim;
+    t.rowBegins.assign(dim + 1, 0);
+    t.sqNorms.assign(dim, 0.0);
+
+    for (size_t p = 0; p < cols.size(); p++)	// count the nonzeros of the columns
+	t.rowBegins[cols[p] + 1]++;
+    for (int j = 0; j < dim; j++)
+	t.rowBegins[j+1] += t.rowBegins[j];
+
+    vector<int> pos(t.rowBegins.begin(), t.rowBegins.end() - 1);
+    for (int i = 0; i < nPts; i++) {		// the points in increasing order
+	for (int p = rowBegins[i]; p < rowBegins[i+1]; p++) {
+	    const int q = pos[cols[p]]++;
+	    t.cols[q] = i;
+	    t.vals[q] = vals[p];
+	    t.sqNorms[cols[p]] += (double) vals[p] * vals[p];
+	}
+    }
+    return t;
+}
+
+//------------------------------------------------------------------------
+//  KMsparseLloyds - mini-batch Lloyd's algorithm on sparse points
+//------------------------------------------------------------------------
+
+KMsparseLloyds::KMsparseLloyds(
+    const KMsparseData& d,
+    int			k,
+    int			stages,
+    int			batch,
+    int			threads)
+    : data(d), kCtrs(min(k, d.getNPts())), maxStages(stages),
+      batchSize(batch), numThreads(threads), distortion(0.0)
+{
+    ctrs.assign((size_t) kCtrs * data.getDim(), 0.0);
+    scales.assign(kCtrs, 1.0);
+    ctrSqNorms.assign(kCtrs, 0.0);
+    ctrCounts.assign(kCtrs, 0);
+    closeCtr.assign(data.getNPts(), 0);
+}
+
+double KMsparseLloyds::sqDist(int i, int c) const
+{
+    const double* ctr = &ctrs[(size_t) c * data.getDim()];
+    double dot = 0.0;
+    for (int p = data.rowBegin(i); p < data.rowEnd(i); p++)
+	dot += data.getVal(p) * ctr[data.getCol(p)];
+
+    const double dist = data.getSqNorm(i) - 2.0 * scales[c] * dot
+	+ scales[c] * scales[c] * ctrSqNorms[c];
+    return dist > 0.0 ? dist : 0.0;		// rounding
+}
+
+int KMsparseLloyds::closestCtr(int i, double& dist) const
+{
+    int best = 0;
+    dist = KM_HUGE;
+    for (int c = 0; c < kCtrs; c++) {
+	const double d = sqDist(i, c);
+	if (d < dist) {
+	    dist = d;
+	    best = c;
+	}
+    }
+    return best;
+}
+
+void KMsparseLloyds::setCtr(int c, int i)
+{
+    double* ctr = &ctrs[(size_t) c * data.getDim()];
+    fill(ctr, ctr + data.getDim(), 0.0);
+    for (int p = data.rowBegin(i); p < data.rowEnd(i); p++)
+	ctr[data.getCol(p)] = data.getVal(p);
+    scales[c] = 1.0;
+    ctrSqNorms[c] = data.getSqNorm(i);
+}
+
+//------------------------------------------------------------------------
+//  addToCtr - c <- (1-eta) c + eta x
+//	Only the scale and the nonzeros of x are touched; the squared
+//	norm of the center is recomputed by the caller at the end of the
+//	stage.
+//------------------------------------------------------------------------
+
+void KMsparseLloyds::addToCtr(int c, int i, double eta)
+{
+    if (eta >= 1.0) {				// the first point of the center
+	setCtr(c, i);
+	return;
+    }
+    scales[c] *= (1.0 - eta);
+    double* ctr = &ctrs[(size_t) c * data.getDim()];
+    const double w = eta / scales[c];
+    for (int p = data.rowBegin(i); p < data.rowEnd(i); p++)
+	ctr[data.getCol(p)] += w * data.getVal(p);
+}
+
+//------------------------------------------------------------------------
+//  seedCtrs - k-means++ seeding
+//	The first center is a random point, each next one is a point drawn
+//	with probability proportional to its squared distance to the closest
+//	center chosen so far.
+//------------------------------------------------------------------------
+
+void KMsparseLloyds::seedCtrs()
+{
+    const int nPts = data.getNPts();
+    vector<double> minDist(nPts);
+
+    setCtr(0, kmRanInt(nPts));
+#pragma omp parallel for num_threads(numThreads) if (numThreads > 1)
+    for (int i = 0; i < nPts; i++)
+	minDist[i] = sqDist(i, 0);
+
+    for (int c = 1; c < kCtrs; c++) {
+	double total = 0.0;
+	for (int i = 0; i < nPts; i++)
+	    total += minDist[i];
+
+	int pick = nPts - 1;
+	if (total > 0.0) {			// D^2 sampling
+	    double r = kmRanUnif(0.0, total);
+	    for (int i = 0; i < nPts; i++) {
+		r -= minDist[i];
+		if (r <= 0.0 && minDist[i] > 0.0) {
+		    pick = i;
+		    break;
+		}
+	    }
+	}
+	else					// all the points are centers
+	    pick = kmRanInt(nPts);
+	setCtr(c, pick);
+
+#pragma omp parallel for num_threads(numThreads) if (numThreads > 1)
+	for (int i = 0; i < nPts; i++) {
+	    const double d = sqDist(i, c);
+	    if (d < minDist[i]) minDist[i] = d;
+	}
+    }
+}
+
+//------------------------------------------------------------------------
+//  execute - run the algorithm
+//	Each stage assigns a mini-batch in parallel and then moves the
+//	centers sequentially (learning rate 1/count), so the result does not
+//	depend on the number of threads.
+//------------------------------------------------------------------------
+
+double KMsparseLloyds::execute()
+{
+    const int nPts = data.getNPts();
+    const int dim = data.getDim();
+    if (kCtrs <= 0) return 0.0;
+
+    seedCtrs();
+    fill(ctrCounts.begin(), ctrCounts.end(), 0);
+
+    const int bSize = min(batchSize, nPts);
+    vector<int> batch(bSize);
+    vector<int> batchCtr(bSize);
+    vector<char> touched(kCtrs);
+
+    for (int stage = 0; stage < maxStages; stage++) {
+	for (int b = 0; b < bSize; b++)		// draw the mini-batch
+	    batch[b] = kmRanInt(nPts);
+
+#pragma omp parallel for num_threads(numThreads) if (numThreads > 1)
+	for (int b = 0; b < bSize; b++) {	// assign it
+	    double dist;
+	    batchCtr[b] = closestCtr(batch[b], dist);
+	}
+
+	fill(touched.begin(), touched.end(), 0);
+	for (int b = 0; b < bSize; b++) {	// move the centers
+	    const int c = batchCtr[b];
+	    ctrCounts[c]++;
+	    addToCtr(c, batch[b], 1.0 / ctrCounts[c]);
+	    touched[c] = 1;
+	}
+
+	for (int c = 0; c < kCtrs; c++) {	// fold the scales back
+	    if (!touched[c]) continue;
+	    double* ctr = &ctrs[(size_t) c * dim];
+	    double sqNorm = 0.0;
+	    for (int j = 0; j < dim; j++) {
+		ctr[j] *= scales[c];
+		sqNorm += ctr[j] * ctr[j];
+	    }
+	    scales[c] = 1.0;
+	    ctrSqNorms[c] = sqNorm;
+	}
+    }
+
+    vector<double> dists(nPts);
+#pragma omp parallel for num_threads(numThreads) if (numThreads > 1)
+    for (int i = 0; i < nPts; i++)		// final assignment
+	closeCtr[i] = closestCtr(i, dists[i]);
+
+    distortion = 0.0;
+    for (int i = 0; i < nPts; i++)
+	distortion += dists[i];
+    return distortion;
+}
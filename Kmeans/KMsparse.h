@@ -0,0 +1,139 @@
+//----------------------------------------------------------------------
+//	File:           KMsparse.h
+//	Description:    Mini-batch k-means on sparse data points
+//----------------------------------------------------------------------
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or (at
+// your option) any later version.  See the file Copyright.txt in the
+// main directory.
+//----------------------------------------------------------------------
+
+#ifndef KM_SPARSE_H
+#define KM_SPARSE_H
+
+#include <vector>			// STL vector
+#include "KMeans.h"			// kmeans includes
+
+//------------------------------------------------------------------------
+//  KMsparseData - sparse data points
+//	The points are stored in compressed sparse row form: the nonzero
+//	coordinates of point i are cols[p] (values vals[p]) for
+//	rowBegins[i] <= p < rowBegins[i+1], in increasing order of the
+//	coordinate.  The points are built from a list of (point,
+//	coordinate, value) entries; if an entry appears several times, the
+//	first one is kept.  Nothing of size nPts*dim is ever allocated.
+//------------------------------------------------------------------------
+
+struct KMsparseEntry {			// an entry of a sparse point
+    int			pt;			// the point
+    int			col;			// the coordinate
+    KMcoord		val;			// the value
+};
+
+class KMsparseData {
+private:
+    int			dim;		// dimension
+    int			nPts;		// number of data points
+    std::vector<int>	rowBegins;	// begins of the points (nPts+1)
+    std::vector<int>	cols;		// coordinates of the nonzeros
+    std::vector<KMcoord> vals;		// values of the nonzeros
+    std::vector<double>	sqNorms;	// squared norms of the points
+public:
+    KMsparseData(			// standard constructor
+	int		d,			// dimension
+	int		n,			// number of points
+	std::vector<KMsparseEntry>& entries);	// the entries (sorted in place)
+
+    int getDim() const {		// get dimension
+	return dim;
+    }
+    int getNPts() const {		// get number of data points
+	return nPts;
+    }
+    int getNNonZeros() const {		// get number of nonzeros
+	return (int) cols.size();
+    }
+    int rowBegin(int i) const {		// first nonzero of point i
+	return rowBegins[i];
+    }
+    int rowEnd(int i) const {		// past the last nonzero of point i
+	return rowBegins[i+1];
+    }
+    int getCol(int p) const {		// coordinate of a nonzero
+	return cols[p];
+    }
+    KMcoord getVal(int p) const {	// value of a nonzero
+	return vals[p];
+    }
+    double getSqNorm(int i) const {	// squared norm of point i
+	return sqNorms[i];
+    }
+					// the transposed data (the points
+    KMsparseData transpose() const;	// are the coordinates)
+};
+
+//------------------------------------------------------------------------
+//  KMsparseLloyds - mini-batch Lloyd's algorithm on sparse points
+//	The centers are seeded with k-means++ (D^2 sampling), then each
+//	stage draws a mini-batch of points, assigns them to their closest
+//	centers and moves every center towards its points with a per-center
+//	learning rate of 1/(number of points it has seen).  The final
+//	assignment is done over all the points.
+//
+//	The distances are computed as |x|^2 - 2 x.c + |c|^2, with sparse dot
+//	products, so a stage costs O(k * nonzeros of the batch).  A center
+//	is stored as scale*v so that shrinking it costs O(1) and adding a
+//	sparse point costs O(nonzeros of the point).  The assignment steps
+//	are spread over numThreads threads (OpenMP).
+//------------------------------------------------------------------------
+
+class KMsparseLloyds {
+private:
+    const KMsparseData&	data;		// the data points
+    int			kCtrs;		// number of centers
+    int			maxStages;	// number of mini-batches
+    int			batchSize;	// points per mini-batch
+    int			numThreads;	// threads of the assignment steps
+    std::vector<double>	ctrs;		// the unscaled centers (k*dim)
+    std::vector<double>	scales;		// the scales of the centers
+    std::vector<double>	ctrSqNorms;	// the squared norms of the unscaled centers
+    std::vector<int>	ctrCounts;	// points seen by the centers
+    std::vector<int>	closeCtr;	// the closest centers of the points
+    double		distortion;	// total distortion
+private:
+    KMsparseLloyds(const KMsparseLloyds& p)	// copy constructor (not implemented)
+      : data(p.data) { assert(false); }
+    KMsparseLloyds& operator=(const KMsparseLloyds& /*p*/)
+      { assert(false);  return *this; }
+
+    double sqDist(int i, int c) const;	// squared distance of point to center
+    int closestCtr(int i, double& dist) const; // closest center of a point
+    void setCtr(int c, int i);		// set a center to a point
+    void addToCtr(int c, int i, double eta); // move a center towards a point
+    void seedCtrs();			// k-means++ seeding
+public:
+    KMsparseLloyds(			// standard constructor
+	const KMsparseData& d,			// the data points
+	int		k,			// number of centers
+	int		stages = 100,		// number of mini-batches
+	int		batch = 1000,		// points per mini-batch
+	int		threads = 1);		// threads of the assignment steps
+
+    double execute();			// run, return the distortion
+
+    int getK() const {			// get number of centers
+	return kCtrs;
+    }
+    double getDist() const {		// get total distortion
+	return distortion;
+    }
+    const std::vector<int>& getAssignments() const { // closest centers
+	return closeCtr;
+    }
+    double getCtrCoord(int c, int j) const { // coordinate of a center
+	return scales[c] * ctrs[(size_t) c * data.getDim() + j];
+    }
+};
+
+#endif
@@ -46,7 +46,7 @@
 #include <string>
 #include <vector>
 #include <algorithm>
-#include <map>
+#include <utility> // for pair
 //#define NOTIWEIGHT
 
 using namespace std;
@@ -179,8 +179,41 @@ public:
    inline const vector<int>&    getValuesIndexes() const { return _valIdxs; }
    inline       vector<int>&    getValuesIndexes()       { return _valIdxs; }
 
-   inline  const map<int,int>&  getValuesIndexesMap() const { return _valIdxsMap; }
-   inline		 map<int,int>&  getValuesIndexesMap()       { return _valIdxsMap; }
+   /**
+   * Get the value of a column of a sparse example.
+   * The indexes must be sorted (see compactSparseValues()). The search is a 
+   * branch-free binary search on the index array.
+   * \param columnIdx The index of the column.
+   * \return The value of the column, 0 if it is not stored.
+   * \date 18/10/2026
+   */
+   inline float getSparseValue(int columnIdx) const
+   {
+      const int numValues = (int)_valIdxs.size();
+      if ( numValues == 0 )
+         return 0;
+
+      // find the last stored index <= columnIdx
+      const int* pBase = &_valIdxs[0];
+      const int* pIdx = pBase;
+      int len = numValues;
+      while ( len > 1 )
+      {
+         const int half = len >> 1;
+         pIdx += ( pIdx[half] <= columnIdx ) ? half : 0;
+         len -= half;
+      }
+
+      return ( *pIdx == columnIdx ) ? _values[pIdx - pBase] : 0;
+   }
+
+   /**
+   * Sort the (index, value) pairs of a sparse example by index, which is what
+   * getSparseValue() expects. The values of repeated indexes are summed up
+   * (it happens with hashed features).
+   * \date 18/10/2026
+   */
+   void compactSparseValues();
 
    //////////////////////////////////////////////////////////////////////////
 
@@ -212,16 +245,56 @@ private:
    * (we ignore the label at column 4 for the moment)
    * _values would be  = {X, Y}
    * _valIdxs would be = {1, 3}
+   * Once parsed, the indexes are sorted and unique (a compact sparse row).
    * \remark This might be a heavy memory footprint for dense data, since it that case it
    * is simply not used. For each example the total memory usage (empty) is 16 bytes.
    */
    vector<int>    _valIdxs; 
-   map<int,int>	  _valIdxsMap;
    string         _name; //<! The name of the example
 
    //void print(ostream &);
 };
 
+// -----------------------------------------------------------------------------
+
+inline void Example::compactSparseValues()
+{
+   const int numValues = (int)_valIdxs.size();
+
+   // most of the files are already sorted
+   bool isCompact = true;
+   for (int i = 1; i < numValues; ++i)
+   {
+      if ( _valIdxs[i-1] >= _valIdxs[i] )
+      {
+         isCompact = false;
+         break;
+      }
+   }
+   if ( isCompact )
+      return;
+
+   vector< pair<int, float> > pairs(numValues);
+   for (int i = 0; i < numValues; ++i)
+      pairs[i] = make_pair(_valIdxs[i], _values[i]);
+   sort( pairs.begin(), pairs.end() );
+
+   int k = -1;
+   for (int i = 0; i < numValues; ++i)
+   {
+      if ( k >= 0 && _valIdxs[k] == pairs[i].first )
+         _values[k] += pairs[i].second;
+      else
+      {
+         ++k;
+         _valIdxs[k] = pairs[i].first;
+         _values[k] = pairs[i].second;
+      }
+   }
+   _valIdxs.resize(k + 1);
+   _values.resize(k + 1);
+}
+
 } // end of namespace MultiBoost
 
 #endif // 
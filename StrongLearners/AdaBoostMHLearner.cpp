@@ -40,6 +40,7 @@
 #include <iomanip> // setprecision
 
 #include "Utils/Utils.h" // for addAndCheckExtension
+#include "Utils/Profiler.h" // for --profile
 #include "Defaults.h" // for defaultLearner
 #include "IO/OutputInfo.h"
 #include "IO/InputData.h"
@@ -49,6 +50,7 @@
 #include "StrongLearners/AdaBoostMHLearner.h"
 
 #include "Classifiers/AdaBoostMHClassifier.h"
+#include "Classifiers/IncrementalEvaluator.h"
 
 namespace MultiBoost {
 
@@ -79,6 +81,13 @@ namespace MultiBoost {
 		else
 			_isShypCompressed = false;
 
+		// --shypwriter <queueSize> <syncPeriod>
+		if ( args.hasArgument("shypwriter") )
+		{
+			args.getValue("shypwriter", 0, _shypQueueSize);
+			args.getValue("shypwriter", 1, _shypSyncPeriod);
+		}
+
 
 		///////////////////////////////////////////////////
 		// Set time limit
@@ -223,10 +232,15 @@ namespace MultiBoost {
 
 		Serialization ss(_shypFileName, _isShypCompressed );
 		ss.writeHeader(_baseLearnerName); // this must go after resumeProcess has been called
+		if ( pTrainingData->getFeatureHashingBits() > 0 )
+			ss.writeFeatureHashing( pTrainingData->getFeatureHashingBits(), pTrainingData->getFeatureHashingSeed() );
 
 		// perform the resuming if necessary. If not it will just return
 		resumeProcess(ss, pTrainingData, pTestData, pOutInfo);
 
+		if (_shypQueueSize > 0)
+			ss.startWriter(_shypQueueSize, _shypSyncPeriod);
+
 		if (_verbose == 1)
 			cout << "Learning in progress..." << endl;
 
@@ -242,37 +256,48 @@ namespace MultiBoost {
 			if (_verbose > 1)
 				cout << "------- WORKING ON ITERATION " << (t+1) << " -------" << endl;
 
-			BaseLearner* pWeakHypothesis = pWeakHypothesisSource->create();
-			pWeakHypothesis->initLearningOptions(args);
-			//pTrainingData->clearIndexSet();
+			BaseLearner* pWeakHypothesis;
+			float energy;
+			{
+				ScopedTimer timer(Profiler::PH_WEAK_LEARNER);
 
-			pWeakHypothesis->setTrainingData(pTrainingData);
-			
-			float energy = pWeakHypothesis->run();
-			
-			//float gamma = pWeakHypothesis->getEdge();
-			//cout << gamma << endl;
+				pWeakHypothesis = pWeakHypothesisSource->create();
+				pWeakHypothesis->initLearningOptions(args);
+				//pTrainingData->clearIndexSet();
 
-			if ( (_withConstantLearner) || ( energy != energy ) ) // check constant learner if user wants it (if energi is nan, then we chose constant learner
-			{
-				BaseLearner* pConstantWeakHypothesis = pConstantWeakHypothesisSource->create() ;
-				pConstantWeakHypothesis->initLearningOptions(args);
-				pConstantWeakHypothesis->setTrainingData(pTrainingData);
-				float constantEnergy = pConstantWeakHypothesis->run();
-
-				if ( (constantEnergy <= energy) || ( energy != energy ) ) {
-					delete pWeakHypothesis;
-					pWeakHypothesis = pConstantWeakHypothesis;
+				pWeakHypothesis->setTrainingData(pTrainingData);
+				
+				energy = pWeakHypothesis->run();
+				
+				//float gamma = pWeakHypothesis->getEdge();
+				//cout << gamma << endl;
+
+				if ( (_withConstantLearner) || ( energy != energy ) ) // check constant learner if user wants it (if energi is nan, then we chose constant learner
+				{
+					BaseLearner* pConstantWeakHypothesis = pConstantWeakHypothesisSource->create() ;
+					pConstantWeakHypothesis->initLearningOptions(args);
+					pConstantWeakHypothesis->setTrainingData(pTrainingData);
+					float constantEnergy = pConstantWeakHypothesis->run();
+
+					if ( (constantEnergy <= energy) || ( energy != energy ) ) {
+						delete pWeakHypothesis;
+						pWeakHypothesis = pConstantWeakHypothesis;
+					}
 				}
 			}
 
 			if (_verbose > 1)
 				cout << "Weak learner: " << pWeakHypothesis->getName()<< endl;
 			// Output the step-by-step information
+			// (the line is ended after the serialization, for the columns of --profile)
 			printOutputInfo(pOutInfo, t, pTrainingData, pTestData, pWeakHypothesis);
 
 			// Updates the weights and returns the edge
-			float gamma = updateWeights(pTrainingData, pWeakHypothesis);
+			float gamma;
+			{
+				ScopedTimer timer(Profiler::PH_UPDATE_WEIGHTS);
+				gamma = updateWeights(pTrainingData, pWeakHypothesis);
+			}
 
 			if (_verbose > 1)
 			{
@@ -301,11 +326,18 @@ namespace MultiBoost {
 			}
 
 			// append the current weak learner to strong hypothesis file,
-			// that is, serialize it.
-			ss.appendHypothesis(t, pWeakHypothesis);
+			// that is, serialize it. The hypothesis is given to the serialization, 
+			// that deletes it once written (by the writer thread with --shypwriter).
+			{
+				ScopedTimer timer(Profiler::PH_SERIALIZATION);
+				ss.queueHypothesis(t, pWeakHypothesis);
+			}
+
+			if (pOutInfo)
+				pOutInfo->endLine();
 
-			// Add it to the internal list of weak hypotheses
-			_foundHypotheses.push_back(pWeakHypothesis); 
+			// pWeakHypothesis now belongs to the serialization and it is not kept:
+			// _foundHypotheses only holds the resumed hypotheses
 
 			// check if the time limit has been reached
 			if (_maxTime > 0)
@@ -322,7 +354,6 @@ namespace MultiBoost {
 					break;     
 				}
 			} // check for maxtime
-			delete pWeakHypothesis;
 		}  // loop on iterations
 		/////////////////////////////////////////////////////////
 
@@ -391,17 +422,25 @@ namespace MultiBoost {
 
 	// -------------------------------------------------------------------------
 
-	void AdaBoostMHLearner::doLikelihoods(const nor_utils::Args& args)
+	void AdaBoostMHLearner::doEvaluations(const nor_utils::Args& args)
 	{
 		AdaBoostMHClassifier classifier(args, _verbose);
 
-		// -posteriors <dataFile> <shypFile> <outFileName>
-		string testFileName = args.getValue<string>("likelihood", 0);
-		string shypFileName = args.getValue<string>("likelihood", 1);
-		string outFileName = args.getValue<string>("likelihood", 2);
-		int numIterations = args.getValue<int>("likelihood", 3);
+		// all the outputs asked among -likelihood, -roc, -posteriors and 
+		// -cposteriors are computed in a single pass over the model
+		string testFileName, shypFileName;
+		vector<EvaluationOutput*> outputs;
+		int numIterations = IncrementalEvaluator::createOutputs(args, outputs, 
+			testFileName, shypFileName, _verbose);
 
-		classifier.saveLikelihoods(testFileName, shypFileName, outFileName, numIterations);
+		classifier.evaluate(testFileName, shypFileName, numIterations, outputs);
+	}
+
+	// -------------------------------------------------------------------------
+
+	void AdaBoostMHLearner::doLikelihoods(const nor_utils::Args& args)
+	{
+		doEvaluations(args);
 	}
 
 	// -------------------------------------------------------------------------
@@ -413,34 +452,14 @@ namespace MultiBoost {
 
 	void AdaBoostMHLearner::doPosteriors(const nor_utils::Args& args)
 	{
-		AdaBoostMHClassifier classifier(args, _verbose);
-		int numofargs = args.getNumValues( "posteriors" );
-		// -posteriors <dataFile> <shypFile> <outFile> <numIters>
-		string testFileName = args.getValue<string>("posteriors", 0);
-		string shypFileName = args.getValue<string>("posteriors", 1);
-		string outFileName = args.getValue<string>("posteriors", 2);
-		int numIterations = args.getValue<int>("posteriors", 3);
-		int period = 0;
-		
-		if ( numofargs == 5 )
-			period = args.getValue<int>("posteriors", 4);
-		
-		classifier.savePosteriors(testFileName, shypFileName, outFileName, numIterations, period);
+		doEvaluations(args);
 	}
 
 	// -------------------------------------------------------------------------
 
 	void AdaBoostMHLearner::doROC(const nor_utils::Args& args)
 	{
-		AdaBoostMHClassifier classifier(args, _verbose);
-
-		// -posteriors <dataFile> <shypFile> <outFileName>
-		string testFileName = args.getValue<string>("roc", 0);
-		string shypFileName = args.getValue<string>("roc", 1);
-		string outFileName = args.getValue<string>("roc", 2);
-		int numIterations = args.getValue<int>("roc", 3);
-
-		classifier.saveROC(testFileName, shypFileName, outFileName, numIterations);
+		doEvaluations(args);
 	}
 
 
@@ -448,15 +467,7 @@ namespace MultiBoost {
 
 	void AdaBoostMHLearner::doCalibratedPosteriors(const nor_utils::Args& args)
 	{
-		AdaBoostMHClassifier classifier(args, _verbose);
-
-		// -posteriors <dataFile> <shypFile> <outFileName>
-		string testFileName = args.getValue<string>("cposteriors", 0);
-		string shypFileName = args.getValue<string>("cposteriors", 1);
-		string outFileName = args.getValue<string>("cposteriors", 2);
-		int numIterations = args.getValue<int>("cposteriors", 3);
-
-		classifier.saveCalibratedPosteriors(testFileName, shypFileName, outFileName, numIterations);
+		doEvaluations(args);
 	}
 
 
@@ -642,6 +653,7 @@ namespace MultiBoost {
 		}
 		// recompute weights
 		// computing the normalization factor Z
+		int numClassify = 0;
 
 		// for each example
 		for (int i = 0; i < numExamples; ++i)
@@ -665,8 +677,11 @@ namespace MultiBoost {
 				// where l is NOT the index of the label (lIt->idx), but the index in the 
 				// label vector of the example
 			}
+			numClassify += static_cast<int>( labels.size() );
 		}
 
+		Profiler::count( Profiler::CN_CLASSIFY, numClassify );
+
 		float gamma = 0;
 
 		// Now do the actual re-weight
@@ -802,6 +817,8 @@ namespace MultiBoost {
 
 				// Output the step-by-step information
 				printOutputInfo(pOutInfo, t, pTrainingData, pTestData, pWeakHypothesis);
+				if (pOutInfo)
+					pOutInfo->endLine();
 
 				// Updates the weights and returns the edge
 				float gamma = updateWeights(pTrainingData, pWeakHypothesis);
@@ -836,6 +853,10 @@ namespace MultiBoost {
 		InputData* pTrainingData, InputData* pTestData, 
 		BaseLearner* pWeakHypothesis)
 	{
+		if (!pOutInfo)
+			return;
+
+		ScopedTimer timer(Profiler::PH_EVALUATION);
 
 		pOutInfo->outputIteration(t);
 		pOutInfo->outputError(pTrainingData, pWeakHypothesis);
@@ -857,7 +878,6 @@ namespace MultiBoost {
 			pOutInfo->outputMAE(pTestData);  
 		*/
 		pOutInfo->outputCurrentTime();
-		pOutInfo->endLine();
 	}
 
 	// -------------------------------------------------------------------------
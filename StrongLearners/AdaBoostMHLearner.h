@@ -72,7 +72,7 @@ public:
    * \date 13/11/2005
    */
    AdaBoostMHLearner()
-      : _numIterations(0), _maxTime(-1), _theta(0), _verbose(1), _smallVal(1E-10),
+      : _shypQueueSize(0), _shypSyncPeriod(0), _numIterations(0), _maxTime(-1), _theta(0), _verbose(1), _smallVal(1E-10),
         _resumeShypFileName(""), _outputInfoFile(""), _weightFile(""), _withConstantLearner(false), _fastResumeProcess(true) {}
 
    /**
@@ -130,6 +130,15 @@ public:
    */
    virtual void doLikelihoods(const nor_utils::Args& args);
 
+   /**
+   * Write all the outputs asked among --likelihood, --roc, --posteriors and --cposteriors
+   * in a single pass over the weak hypotheses. The four modes above call it.
+   * \param args The arguments provided by the command line.
+   * \see IncrementalEvaluator
+   * \date 18/10/2026
+   */
+   void doEvaluations(const nor_utils::Args& args);
+
 
    /**
    * Updates the weights of the examples.
@@ -163,7 +172,9 @@ public:
 
    /**
    * Print output information if option --outputinfo is specified.
-   * Called from run and resumeProcess
+   * Called from run and resumeProcess. The line is not ended, the caller
+   * has to call OutputInfo::endLine() (after the other phases of the iteration
+   * with --profile).
    * \see resumeProcess
    * \see run
    * \date 21/04/2007
@@ -205,11 +216,13 @@ protected:
    void resumeProcess(Serialization& ss, InputData* pTrainingData, InputData* pTestData, 
 		      OutputInfo* pOutInfo);
 
-   vector<BaseLearner*>  _foundHypotheses; //!< The list of the hypotheses found.
+   vector<BaseLearner*>  _foundHypotheses; //!< The hypotheses loaded by --resume (the new ones are handed to the serialization).
 
    string  _baseLearnerName; //!< The name of the basic learner used by AdaBoost. 
    string  _shypFileName; //!< File name of the strong hypothesis.
    bool	   _isShypCompressed; 
+   int     _shypQueueSize; //!< The size of the queue of the shyp writer thread (0: no thread, see --shypwriter).
+   int     _shypSyncPeriod; //!< The shyp file is synced every _shypSyncPeriod hypotheses (0: never).
 
    string  _trainFileName;
    string  _testFileName;
@@ -5,6 +5,7 @@
 #include <iomanip> // setprecision
 
 #include "Utils/Utils.h" // for addAndCheckExtension
+#include "Utils/Profiler.h" // for --profile
 #include "Defaults.h" // for defaultLearner
 #include "IO/OutputInfo.h"
 #include "Others/Rates.h"
@@ -15,6 +16,7 @@
 #include "StrongLearners/FilterBoostLearner.h"
 
 #include "Classifiers/FilterBoostClassifier.h"
+#include "Classifiers/IncrementalEvaluator.h"
 
 namespace MultiBoost {
 
@@ -45,6 +47,13 @@ namespace MultiBoost {
 		else
 			_isShypCompressed = false;
 
+		// --shypwriter <queueSize> <syncPeriod>
+		if ( args.hasArgument("shypwriter") )
+		{
+			args.getValue("shypwriter", 0, _shypQueueSize);
+			args.getValue("shypwriter", 1, _shypSyncPeriod);
+		}
+
 
 		///////////////////////////////////////////////////
 		// Set time limit
@@ -199,10 +208,15 @@ namespace MultiBoost {
 
 		Serialization ss(_shypFileName, _isShypCompressed );
 		ss.writeHeader(_baseLearnerName); // this must go after resumeProcess has been called
+		if ( pTrainingData->getFeatureHashingBits() > 0 )
+			ss.writeFeatureHashing( pTrainingData->getFeatureHashingBits(), pTrainingData->getFeatureHashingSeed() );
 
 		// perform the resuming if necessary. If not it will just return
 		resumeProcess(ss, pTrainingData, pTestData, pOutInfo);
 
+		if (_shypQueueSize > 0)
+			ss.startWriter(_shypQueueSize, _shypSyncPeriod);
+
 		if (_verbose == 1)
 			cout << "Learning in progress..." << endl;
 
@@ -225,19 +239,25 @@ namespace MultiBoost {
 				cout << "--> Size of training data = " << pTrainingData->getNumExamples() << endl;
 			}
 
-			BaseLearner* pWeakHypothesis = pWeakHypothesisSource->create();
-			pWeakHypothesis->initLearningOptions(args);
-			//pTrainingData->clearIndexSet();
-			pWeakHypothesis->setTrainingData(pTrainingData);
-			float energy = pWeakHypothesis->run();
-
-			BaseLearner* pConstantWeakHypothesis;
-			if (_withConstantLearner) // check constant learner if user wants it
+			BaseLearner* pWeakHypothesis;
+			float energy;
+			BaseLearner* pConstantWeakHypothesis = NULL;
 			{
-				pConstantWeakHypothesis = pConstantWeakHypothesisSource->create() ;
-				pConstantWeakHypothesis->initLearningOptions(args);
-				pConstantWeakHypothesis->setTrainingData(pTrainingData);
-				float constantEnergy = pConstantWeakHypothesis->run();
+				ScopedTimer timer(Profiler::PH_WEAK_LEARNER);
+
+				pWeakHypothesis = pWeakHypothesisSource->create();
+				pWeakHypothesis->initLearningOptions(args);
+				//pTrainingData->clearIndexSet();
+				pWeakHypothesis->setTrainingData(pTrainingData);
+				energy = pWeakHypothesis->run();
+
+				if (_withConstantLearner) // check constant learner if user wants it
+				{
+					pConstantWeakHypothesis = pConstantWeakHypothesisSource->create() ;
+					pConstantWeakHypothesis->initLearningOptions(args);
+					pConstantWeakHypothesis->setTrainingData(pTrainingData);
+					float constantEnergy = pConstantWeakHypothesis->run();
+				}
 			}
 
 			//estimate edge
@@ -265,11 +285,16 @@ namespace MultiBoost {
 			if (_verbose > 1)
 				cout << "Weak learner: " << pWeakHypothesis->getName()<< endl;
 			// Output the step-by-step information
+			// (the line is ended after the serialization, for the columns of --profile)
 			pTrainingData->clearIndexSet();
 			printOutputInfo(pOutInfo, t, pTrainingData, pTestData, pWeakHypothesis);
 
 			// Updates the weights and returns the edge
-			float gamma = updateWeights(pTrainingData, pWeakHypothesis);
+			float gamma;
+			{
+				ScopedTimer timer(Profiler::PH_UPDATE_WEIGHTS);
+				gamma = updateWeights(pTrainingData, pWeakHypothesis);
+			}
 
 			if (_verbose > 1)
 			{
@@ -283,14 +308,24 @@ namespace MultiBoost {
 			}
 
 			// update the margins
-			updateMargins( pTrainingData, pWeakHypothesis );
+			{
+				ScopedTimer timer(Profiler::PH_UPDATE_WEIGHTS);
+				updateMargins( pTrainingData, pWeakHypothesis );
+			}
 
 			// append the current weak learner to strong hypothesis file,
-			// that is, serialize it.
-			ss.appendHypothesis(t, pWeakHypothesis);
+			// that is, serialize it. The hypothesis is given to the serialization, 
+			// that deletes it once written (by the writer thread with --shypwriter).
+			{
+				ScopedTimer timer(Profiler::PH_SERIALIZATION);
+				ss.queueHypothesis(t, pWeakHypothesis);
+			}
 
-			// Add it to the internal list of weak hypotheses
-			_foundHypotheses.push_back(pWeakHypothesis); 
+			if (pOutInfo)
+				pOutInfo->endLine();
+
+			// pWeakHypothesis now belongs to the serialization and it is not kept:
+			// _foundHypotheses only holds the resumed hypotheses
 
 			// check if the time limit has been reached
 			if (_maxTime > 0)
@@ -307,7 +342,6 @@ namespace MultiBoost {
 					break;     
 				}
 			} // check for maxtime
-			delete pWeakHypothesis;
 		}  // loop on iterations
 		/////////////////////////////////////////////////////////
 
@@ -372,17 +406,25 @@ namespace MultiBoost {
 
 	// -------------------------------------------------------------------------
 
-	void FilterBoostLearner::doLikelihoods(const nor_utils::Args& args)
+	void FilterBoostLearner::doEvaluations(const nor_utils::Args& args)
 	{
 		FilterBoostClassifier classifier(args, _verbose);
 
-		// -posteriors <dataFile> <shypFile> <outFileName>
-		string testFileName = args.getValue<string>("likelihood", 0);
-		string shypFileName = args.getValue<string>("likelihood", 1);
-		string outFileName = args.getValue<string>("likelihood", 2);
-		int numIterations = args.getValue<int>("likelihood", 3);
+		// all the outputs asked among -likelihood, -roc, -posteriors and 
+		// -cposteriors are computed in a single pass over the model
+		string testFileName, shypFileName;
+		vector<EvaluationOutput*> outputs;
+		int numIterations = IncrementalEvaluator::createOutputs(args, outputs, 
+			testFileName, shypFileName, _verbose);
 
-		classifier.saveLikelihoods(testFileName, shypFileName, outFileName, numIterations);
+		classifier.evaluate(testFileName, shypFileName, numIterations, outputs);
+	}
+
+	// -------------------------------------------------------------------------
+
+	void FilterBoostLearner::doLikelihoods(const nor_utils::Args& args)
+	{
+		doEvaluations(args);
 	}
 
 	// -------------------------------------------------------------------------
@@ -394,30 +436,14 @@ namespace MultiBoost {
 
 	void FilterBoostLearner::doPosteriors(const nor_utils::Args& args)
 	{
-		FilterBoostClassifier classifier(args, _verbose);
-
-		// -posteriors <dataFile> <shypFile> <outFileName>
-		string testFileName = args.getValue<string>("posteriors", 0);
-		string shypFileName = args.getValue<string>("posteriors", 1);
-		string outFileName = args.getValue<string>("posteriors", 2);
-		int numIterations = args.getValue<int>("posteriors", 3);
-
-		classifier.savePosteriors(testFileName, shypFileName, outFileName, numIterations);
+		doEvaluations(args);
 	}
 
 	// -------------------------------------------------------------------------
 
 	void FilterBoostLearner::doCalibratedPosteriors(const nor_utils::Args& args)
 	{
-		FilterBoostClassifier classifier(args, _verbose);
-
-		// -posteriors <dataFile> <shypFile> <outFileName>
-		string testFileName = args.getValue<string>("cposteriors", 0);
-		string shypFileName = args.getValue<string>("cposteriors", 1);
-		string outFileName = args.getValue<string>("cposteriors", 2);
-		int numIterations = args.getValue<int>("cposteriors", 3);
-
-		classifier.saveCalibratedPosteriors(testFileName, shypFileName, outFileName, numIterations);
+		doEvaluations(args);
 	}
 
 
@@ -439,6 +465,7 @@ namespace MultiBoost {
 			_hy[i].resize(numClasses);
 		// recompute weights
 		// computing the normalization factor Z
+		int numClassify = 0;
 
 		// for each example
 		for (int i = 0; i < numExamples; ++i)
@@ -462,8 +489,11 @@ namespace MultiBoost {
 				// where l is NOT the index of the label (lIt->idx), but the index in the 
 				// label vector of the example
 			}
+			numClassify += static_cast<int>( labels.size() );
 		}
 
+		Profiler::count( Profiler::CN_CLASSIFY, numClassify );
+
 		float gamma = 0;
 
 		// Now do the actual re-weight
@@ -579,6 +609,8 @@ namespace MultiBoost {
 
 			// Output the step-by-step information
 			printOutputInfo(pOutInfo, t, pTrainingData, pTestData, pWeakHypothesis);
+			if (pOutInfo)
+				pOutInfo->endLine();
 
 			// Updates the weights and returns the edge
 			updateMargins(pTrainingData, pWeakHypothesis);
@@ -615,6 +647,10 @@ namespace MultiBoost {
 		InputData* pTrainingData, InputData* pTestData, 
 		BaseLearner* pWeakHypothesis)
 	{
+		if (!pOutInfo)
+			return;
+
+		ScopedTimer timer(Profiler::PH_EVALUATION);
 
 		pOutInfo->outputIteration(t);
 		pOutInfo->outputError(pTrainingData, pWeakHypothesis);
@@ -630,22 +666,13 @@ namespace MultiBoost {
 			pOutInfo->outputMAE(pTestData);  
 		*/
 		pOutInfo->outputCurrentTime();
-		pOutInfo->endLine();
 	}
 
 	// -------------------------------------------------------------------------
 
 	void FilterBoostLearner::doROC(const nor_utils::Args& args)
 	{
-		FilterBoostClassifier classifier(args, _verbose);
-
-		// -posteriors <dataFile> <shypFile> <outFileName>
-		string testFileName = args.getValue<string>("roc", 0);
-		string shypFileName = args.getValue<string>("roc", 1);
-		string outFileName = args.getValue<string>("roc", 2);
-		int numIterations = args.getValue<int>("roc", 3);
-
-		classifier.saveROC(testFileName, shypFileName, outFileName, numIterations);
+		doEvaluations(args);
 	}
 
 	// -------------------------------------------------------------------------
@@ -717,9 +744,8 @@ namespace MultiBoost {
 		}
 
 
-		// normalize the weights of the labels
+		// set the weights of the labels
 		set<int>::iterator sIt;
-		float sum = 0.0;
 		// for each example are in use
 		for ( sIt = indexSet.begin(); sIt != indexSet.end(); sIt++ )
 		{
@@ -727,24 +753,13 @@ namespace MultiBoost {
 			vector<Label>::iterator lIt;
 
 			for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
-			{
 				lIt->weight = 1 /( 1+exp( _margins[ *sIt ][lIt->idx] ) );
-				sum += lIt->weight;
-			}
-		}
-
-		for ( sIt = indexSet.begin(); sIt != indexSet.end(); sIt++ )
-		{
-			vector<Label>& labels = pData->getLabels(*sIt);
-			vector<Label>::iterator lIt;
-
-			for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
-			{
-				lIt->weight /= sum;
-			}
 		}
 
 		pData->loadIndexSet( indexSet );
+
+		// and normalize them over the filtered examples
+		pData->applyWeightPolicy( RawData::WIT_PROP_ONLY );
 		/*
 		sum = 0.0;
 		for ( int i=0; i < pData->getNumExamples(); i++ )
@@ -40,6 +40,7 @@
 #include <iomanip> // setprecision
 
 #include "Utils/Utils.h" // for addAndCheckExtension
+#include "Utils/Profiler.h" // for --profile
 #include "Defaults.h" // for defaultLearner
 #include "IO/OutputInfo.h"
 #include "IO/InputData.h"
@@ -262,26 +263,32 @@ namespace MultiBoost {
 				if (_verbose > 1)
 					cout << "------- STAGE " << stagei << " WORKING ON ITERATION " << (t+1) << " -------" << endl;
 				
-				BaseLearner* pWeakHypothesis = pWeakHypothesisSource->create();
-				pWeakHypothesis->initLearningOptions(args);				
-				
-				pWeakHypothesis->setTrainingData(pTrainingData);
-				
-				float energy = pWeakHypothesis->run();
-				
-				//float gamma = pWeakHypothesis->getEdge();
-				//cout << gamma << endl;
-				
-				if ( (_withConstantLearner) || ( energy != energy ) ) // check constant learner if user wants it (if energi is nan, then we chose constant learner
+				BaseLearner* pWeakHypothesis;
+				float energy;
 				{
-					BaseLearner* pConstantWeakHypothesis = pConstantWeakHypothesisSource->create() ;
-					pConstantWeakHypothesis->initLearningOptions(args);
-					pConstantWeakHypothesis->setTrainingData(pTrainingData);
-					float constantEnergy = pConstantWeakHypothesis->run();
+					ScopedTimer timer(Profiler::PH_WEAK_LEARNER);
+					
+					pWeakHypothesis = pWeakHypothesisSource->create();
+					pWeakHypothesis->initLearningOptions(args);				
 					
-					if ( (constantEnergy <= energy) || ( energy != energy ) ) {
-						delete pWeakHypothesis;
-						pWeakHypothesis = pConstantWeakHypothesis;
+					pWeakHypothesis->setTrainingData(pTrainingData);
+					
+					energy = pWeakHypothesis->run();
+					
+					//float gamma = pWeakHypothesis->getEdge();
+					//cout << gamma << endl;
+					
+					if ( (_withConstantLearner) || ( energy != energy ) ) // check constant learner if user wants it (if energi is nan, then we chose constant learner
+					{
+						BaseLearner* pConstantWeakHypothesis = pConstantWeakHypothesisSource->create() ;
+						pConstantWeakHypothesis->initLearningOptions(args);
+						pConstantWeakHypothesis->setTrainingData(pTrainingData);
+						float constantEnergy = pConstantWeakHypothesis->run();
+						
+						if ( (constantEnergy <= energy) || ( energy != energy ) ) {
+							delete pWeakHypothesis;
+							pWeakHypothesis = pConstantWeakHypothesis;
+						}
 					}
 				}
 				
@@ -291,7 +298,11 @@ namespace MultiBoost {
 				//printOutputInfo(pOutInfo, t, pTrainingData, pTestData, pWeakHypothesis);
 				
 				// Updates the weights and returns the edge
-				float gamma = updateWeights(pTrainingData, pWeakHypothesis);
+				float gamma;
+				{
+					ScopedTimer timer(Profiler::PH_UPDATE_WEIGHTS);
+					gamma = updateWeights(pTrainingData, pWeakHypothesis);
+				}
 				
 				//checkWeights(pTrainingData);
 				
@@ -325,16 +336,19 @@ namespace MultiBoost {
 				_foundHypotheses[stagei].push_back(pWeakHypothesis); 
 				
 				// evaluate current detector on validation set
-				updatePosteriors( pTrainingData, pWeakHypothesis, trainPosteriors );
-				updatePosteriors( pValidationData, pWeakHypothesis, validPosteriors );
-				if (pTestData) updatePosteriors( pTestData, pWeakHypothesis, testPosteriors );
-				
-				// caclualte the current detection rate and false positive rate				
-				//getTPRandFPR( pValidationData, validPosteriors, currentTPR, currentFPR );				
-				//if (_verbose>4)
-				//	cout << "Current TPR: " << currentTPR << " Current FPR: " << currentFPR << endl << flush;
-				
-				tunedThreshold = getThresholdBasedOnTPR( pValidationData, validPosteriors, Di, currentTPR, currentFPR );
+				{
+					ScopedTimer timer(Profiler::PH_EVALUATION);
+					updatePosteriors( pTrainingData, pWeakHypothesis, trainPosteriors );
+					updatePosteriors( pValidationData, pWeakHypothesis, validPosteriors );
+					if (pTestData) updatePosteriors( pTestData, pWeakHypothesis, testPosteriors );
+					
+					// caclualte the current detection rate and false positive rate				
+					//getTPRandFPR( pValidationData, validPosteriors, currentTPR, currentFPR );				
+					//if (_verbose>4)
+					//	cout << "Current TPR: " << currentTPR << " Current FPR: " << currentFPR << endl << flush;
+					
+					tunedThreshold = getThresholdBasedOnTPR( pValidationData, validPosteriors, Di, currentTPR, currentFPR );
+				}
 				
 				if (_verbose>1)
 				{
@@ -367,11 +381,14 @@ namespace MultiBoost {
 			// calculate the overall cascade performance
 			pValidationData->clearIndexSet();
 			validPosteriors.resize(pValidationData->getNumExamples());
-			calculatePosteriors( pValidationData, _foundHypotheses[stagei], validPosteriors );
-			
-			// this update the current forecast stored in activeValidationInstances
-			forecastOverAllCascade( pValidationData, validPosteriors, activeValidationInstances, tunedThreshold );
-			if (pTestData) forecastOverAllCascade( pTestData, testPosteriors, activeTestInstances, tunedThreshold );
+			{
+				ScopedTimer timer(Profiler::PH_EVALUATION);
+				calculatePosteriors( pValidationData, _foundHypotheses[stagei], validPosteriors );
+				
+				// this update the current forecast stored in activeValidationInstances
+				forecastOverAllCascade( pValidationData, validPosteriors, activeValidationInstances, tunedThreshold );
+				if (pTestData) forecastOverAllCascade( pTestData, testPosteriors, activeTestInstances, tunedThreshold );
+			}
 			
 			_output << (stagei+1) << "\t";
 			_output << _foundHypotheses[stagei].size() << "\t";
@@ -391,7 +408,10 @@ namespace MultiBoost {
 			pTrainingData->clearIndexSet();
 			//cout << pTrainingData->getNumExamples() << endl << flush;
 			trainPosteriors.resize(pTrainingData->getNumExamples());
-			calculatePosteriors( pTrainingData, _foundHypotheses[stagei], trainPosteriors );
+			{
+				ScopedTimer timer(Profiler::PH_EVALUATION);
+				calculatePosteriors( pTrainingData, _foundHypotheses[stagei], trainPosteriors );
+			}
 
 			int trainPosNum=0;
 			int trainNegNum=0;
@@ -472,8 +492,6 @@ namespace MultiBoost {
 			}
 			
 			
-			_output << endl;			
-			
 			// output posteriors
 			outputPosteriors( activeValidationInstances );
 			if (pTestData) outputPosteriors( activeTestInstances );
@@ -493,8 +511,16 @@ namespace MultiBoost {
 			//ss.appendStageSeparatorFooter();
 			// append the current weak learner to strong hypothesis file,
 			// that is, serialize it.					
-			for (int t=0 ; t < _foundHypotheses[stagei].size(); ++t )
-				ss.appendHypothesis(t, _foundHypotheses[stagei][t]);
+			{
+				ScopedTimer timer(Profiler::PH_SERIALIZATION);
+				for (int t=0 ; t < _foundHypotheses[stagei].size(); ++t )
+					ss.appendHypothesis(t, _foundHypotheses[stagei][t]);
+			}
+			
+			// the line of the stage is ended after the serialization, for the columns of --profile
+			if ( Profiler::isEnabled() )
+				Profiler::outputIteration(_output);
+			_output << endl;
 			
 			
 		}// end of cascade
@@ -534,6 +560,7 @@ namespace MultiBoost {
 			// just for the negative class
 			posteriors[i] += alpha * weakHypotheses->classify(pData, i, _positiveLabelIndex);
 		}			
+		Profiler::count( Profiler::CN_CLASSIFY, numExamples );
 	}
 	
 	
@@ -558,6 +585,7 @@ namespace MultiBoost {
 				posteriors[i] += alpha * currWeakHyp->classify(pData, i, _positiveLabelIndex);
 			}			
 		}
+		Profiler::count( Profiler::CN_CLASSIFY, static_cast<double>(numExamples) * weakHypotheses.size() );
 		/*
 		 for (int i = 0; i < numExamples; ++i)
 		 {
@@ -703,6 +731,7 @@ namespace MultiBoost {
 		}
 		// recompute weights
 		// computing the normalization factor Z
+		int numClassify = 0;
 		
 		// for each example
 		for (int i = 0; i < numExamples; ++i)
@@ -726,8 +755,11 @@ namespace MultiBoost {
 				// where l is NOT the index of the label (lIt->idx), but the index in the 
 				// label vector of the example
 			}
+			numClassify += static_cast<int>( labels.size() );
 		}
 		
+		Profiler::count( Profiler::CN_CLASSIFY, numClassify );
+		
 		float gamma = 0;
 		
 		// Now do the actual re-weight
@@ -841,74 +873,17 @@ namespace MultiBoost {
 	
 	void VJCascadeLearner::resetWeights(InputData* pData)
 	{
-		// this weighting corresponds to the sharepoint one
-		int numOfClasses = pData->getNumClasses();
-		vector< int > numPerClasses(numOfClasses);
-		int numOfSamples = pData->getNumExamples();
-		vector< double > wi( numOfClasses );
-		vector< double > wic( numOfClasses );
+		// this weighting corresponds to the balanced one: with the two classes of the 
+		// cascade, the positive and the negative labels of each class get 1/4 each
+		const double sumWeight = pData->applyWeightPolicy( RawData::WIT_BALANCED );
 		
-		fill(numPerClasses.begin(),numPerClasses.end(), 0 );
-		for (int i = 0; i < numOfSamples; ++i)
-		{
-			vector<Label>& labels = pData->getLabels(i);
-			vector<Label>::iterator lIt;
-			
-			for ( lIt = labels.begin(); lIt != labels.end(); ++lIt )
-			{
-				if ( lIt->y > 0 )
-					numPerClasses[lIt->idx]++;
-			}
-			
-		}			
-		
-		
-		// we assume pl = 1/K
-		for( int i = 0; i < numOfClasses; i ++ ) {
-			wi[i] =  1.0  / (4.0 * numPerClasses[i]);
-			wic[i] = 1.0 / (4.0 * ( numOfSamples - numPerClasses[i] ));
-		}
-		//cout << endl;
-		
-		
-		
-		
-		//this->_nExamplesPerClass
-		// for each example
-		for (int i = 0; i < numOfSamples; ++i)
-		{
-			vector<Label>& labels = pData->getLabels(i);
-			vector<Label>::iterator lIt;
-			
-			// first find the sum of the weights					
-			int i = 0;
-			for ( lIt = labels.begin(); lIt != labels.end(); ++lIt, i++ )
-			{
-				if (lIt->y>0) lIt->weight = wi[lIt->idx];
-				else lIt->weight=wic[lIt->idx];
-			}
-			
-		}
 		// check for the sum of weights!
-		double sumWeight = 0;
-		for (int i = 0; i < numOfSamples; ++i)
-		{
-			vector<Label>& labels = pData->getLabels(i);
-			vector<Label>::iterator lIt;
-			
-			// first find the sum of the weights
-			for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
-				sumWeight += lIt->weight;
-		}
-		
 		if ( !nor_utils::is_zero(sumWeight-1.0, 1E-6 ) )
 		{
 			cerr << "\nERROR: Sum of weights (" << sumWeight << ") != 1!" << endl;
 			cerr << "Try a different weight policy (--weightpolicy under 'Basic Algorithm Options')!" << endl;
 			//exit(1);
 		}
-		
-		
 	}
 	// -------------------------------------------------------------------------
 	void VJCascadeLearner::getTPRandFPR( InputData* pData, vector<double>& posteriors, double& TPR, double& FPR, const double threshold )
@@ -1102,6 +1077,9 @@ namespace MultiBoost {
 		_output << "Pos\t";
 		_output << "Neg\t";
 		
+		if ( Profiler::isEnabled() )
+			Profiler::outputHeader(_output);
+		
 		_output << endl << flush;
 	}
 	
@@ -116,19 +116,8 @@ void ClassHierarchy::eraseTreeUptoDepth( int depth )  {
 
 //--------------------------------------------------------------------
 void ClassHierarchy::getCategorySet( set<int>& categories ){
-	vector<int> tmpVec;
-	vector<int>::iterator it;
-	
 	categories.clear();
-
-	for( int i=0; i<_root.getNumOfChildren(); i++ ) {
-		InnerNode* currNode = _root.getithChild( i );
-		getDescendants( tmpVec, currNode->getCategory() );
-
-		for( it = tmpVec.begin(); it != tmpVec.end(); it++ ) {
-			categories.insert( *it );
-		}
-	}
+	categories.insert( _flatCategories.begin(), _flatCategories.end() );
 }
 
 //--------------------------------------------------------------------
@@ -170,6 +159,103 @@ void ClassHierarchy::updateMemberVariables( void ){
 	}
 	 
 	_numOfCategories = _mapCategoryToIdx.size();
+
+	flatten();
+}
+
+//--------------------------------------------------------------------
+
+void ClassHierarchy::flatten( void ){
+	_flatCategories.clear();
+	_parents.clear();
+	_flatCategories.reserve( _mapCategoryToNode.size() );
+	_parents.reserve( _mapCategoryToNode.size() );
+
+	// preorder numbering (the children are pushed in reverse to be visited in order)
+	vector< pair<InnerNode*,int> > stack;
+	for( int i = _root.getNumOfChildren()-1; i >= 0; i-- ) 
+		stack.push_back( make_pair( _root.getithChild( i ), -1 ) );
+
+	while ( ! stack.empty() ) {
+		InnerNode* currNode = stack.back().first;
+		const int parent = stack.back().second;
+		stack.pop_back();
+
+		const int node = _flatCategories.size();
+		_flatCategories.push_back( currNode->getCategory() );
+		_parents.push_back( parent );
+
+		for( int i = currNode->getNumOfChildren()-1; i >= 0; i-- ) 
+			stack.push_back( make_pair( currNode->getithChild( i ), node ) );
+	}
+	const int numNodes = _flatCategories.size();
+
+	// the subtree sizes, from the bottom
+	_subtreeEnds.assign( numNodes, 1 );
+	for( int v = numNodes-1; v >= 0; v-- ) 
+		if ( _parents[v] >= 0 ) _subtreeEnds[ _parents[v] ] += _subtreeEnds[v];
+	for( int v = 0; v < numNodes; v++ ) _subtreeEnds[v] += v;
+
+	// the ancestors of a node are the ones of its parent and the node itself
+	_ancestorBegins.resize( numNodes+1 );
+	_ancestors.clear();
+	for( int v = 0; v < numNodes; v++ ) {
+		_ancestorBegins[v] = _ancestors.size();
+		if ( _parents[v] >= 0 ) {
+			const int parentBegin = _ancestorBegins[ _parents[v] ];
+			const int parentEnd = _ancestorBegins[ _parents[v]+1 ];
+			for( int a = parentBegin; a < parentEnd; a++ ) _ancestors.push_back( _ancestors[a] );
+		}
+		_ancestors.push_back( v );
+	}
+	_ancestorBegins[numNodes] = _ancestors.size();
+
+	// the children grouped by parent; the preorder keeps them in order within a group
+	_childBegins.assign( numNodes+2, 0 );
+	for( int v = 0; v < numNodes; v++ ) _childBegins[ _parents[v]+2 ]++;
+	for( int g = 1; g < numNodes+2; g++ ) _childBegins[g] += _childBegins[g-1];
+	_children.resize( numNodes );
+	vector<int> nextChild( _childBegins.begin(), _childBegins.end()-1 );
+	for( int v = 0; v < numNodes; v++ ) _children[ nextChild[ _parents[v]+1 ]++ ] = v;
+
+	// the class idx of the nodes, and back
+	_nodeIdx.resize( numNodes );
+	_categoryOfIdx.assign( numNodes, -1 );
+	for( int v = 0; v < numNodes; v++ ) {
+		const int idx = _mapCategoryToIdx[ _flatCategories[v] ];
+		_nodeIdx[v] = idx;
+		if ( idx >= 0 && idx < numNodes ) _categoryOfIdx[idx] = _flatCategories[v];
+	}
+
+	// category -> node
+	_nodeOfCategory.clear();
+	_sortedCategories.clear();
+	_minCategory = 0;
+	if ( numNodes == 0 ) return;
+
+	int maxCategory = _flatCategories[0];
+	_minCategory = _flatCategories[0];
+	for( int v = 1; v < numNodes; v++ ) {
+		if ( _flatCategories[v] < _minCategory ) _minCategory = _flatCategories[v];
+		if ( _flatCategories[v] > maxCategory ) maxCategory = _flatCategories[v];
+	}
+
+	const double range = (double)maxCategory - (double)_minCategory + 1;
+	if ( range <= 4.0 * numNodes + 1024 ) {
+		_nodeOfCategory.assign( (int)range, -1 );
+		for( int v = 0; v < numNodes; v++ ) _nodeOfCategory[ _flatCategories[v] - _minCategory ] = v;
+	} else {
+		vector< pair<int,int> > categoryNodes( numNodes );
+		for( int v = 0; v < numNodes; v++ ) categoryNodes[v] = make_pair( _flatCategories[v], v );
+		sort( categoryNodes.begin(), categoryNodes.end() );
+
+		_sortedCategories.resize( numNodes );
+		_nodeOfCategory.resize( numNodes );
+		for( int i = 0; i < numNodes; i++ ) {
+			_sortedCategories[i] = categoryNodes[i].first;
+			_nodeOfCategory[i] = categoryNodes[i].second;
+		}
+	}
 }
 
 //--------------------------------------------------------------------
@@ -241,6 +327,8 @@ void ClassHierarchy::load( const string fname )
 
 
 	infile.close();
+
+	flatten();
 }
 
 //--------------------------------------------------------------------
@@ -251,7 +339,7 @@ void ClassHierarchy::addHierarchPath( vector<int>& hierarchyPath ){
 		if ( currNode->hasChildWithThisCategory( *it ) ) {
 			currNode = currNode->getChild( *it );
 		} else {
-			if ( existCategory( *it ) ) {
+			if ( _mapCategoryToNode.find( *it ) != _mapCategoryToNode.end() ) {
 				cout << "This category" << *it <<  " exist anywhere in the hierarchy!!!!" << endl;
 				exit( -1 );
 			}
@@ -48,6 +48,7 @@
 #include <iostream>
 #include <sstream>
 #include <set>
+#include <algorithm>
 
 #include "IO/NameMap.h"
 #include "Utils.h"
@@ -146,7 +147,7 @@ protected:
 class ClassHierarchy
 {
 public:
-	ClassHierarchy(void) : _fname( "cat_hier.txt" ), _numOfCategories(0) {
+	ClassHierarchy(void) : _fname( "cat_hier.txt" ), _numOfCategories(0), _minCategory(0) {
 		//_locale = locale(locale(), new nor_utils::white_spaces(", "));
 	}
 
@@ -156,88 +157,91 @@ public:
 	void load( const string fname );
 	
 	
+	/**
+	* The categories on the path from the top level down to \a category
+	* (the category itself included). Empty if the category is unknown.
+	*/
 	void getAncestors( vector<int>& ancestorCategories, int category ) {
-		if ( ! existCategory( category ) ) {
-			ancestorCategories.clear();
-			return;
-		}
-
-		vector<int> tmpVec(0);
-		
-		map<int,InnerNode*>::iterator it = _mapCategoryToNode.find( category );
-		InnerNode* currNode = it->second;
-
-		while ( ! currNode->isRoot() ) {
-			tmpVec.push_back( currNode->getCategory() );
-			currNode = currNode->getParent();
-		}
-		ancestorCategories.resize( tmpVec.size() );
-		copy( tmpVec.rbegin(), tmpVec.rend(), ancestorCategories.begin() );
+		ancestorCategories.clear();
+		const int node = getNode( category );
+		if ( node < 0 ) return;
+
+		const int* pAncestors = getAncestorNodes( node );
+		const int numAncestors = getNumOfAncestors( node );
+		ancestorCategories.resize( numAncestors );
+		for( int i = 0; i < numAncestors; i++ ) ancestorCategories[i] = _flatCategories[ pAncestors[i] ];
 	}
 
+	/**
+	* The children of the parent of \a category (the category itself included).
+	*/
 	void getSiblings( vector<int>& siblings, int category ) {
-		if ( ! existCategory( category ) ) {
-			siblings.clear();
-			return;
-		}
-
-		map<int,InnerNode*>::iterator it = _mapCategoryToNode.find( category );
-		InnerNode* currNode = it->second;
-
-		//go to its parent
-		currNode = currNode->getParent();
-		currNode->getChildCategories( siblings );	
+		siblings.clear();
+		const int node = getNode( category );
+		if ( node < 0 ) return;
+
+		const int* pSiblings = getSiblingNodes( node );
+		const int numSiblings = getNumOfSiblings( node );
+		siblings.resize( numSiblings );
+		for( int i = 0; i < numSiblings; i++ ) siblings[i] = _flatCategories[ pSiblings[i] ];
 	}
 
+	/**
+	* The subtree of \a category (the category itself included) in preorder.
+	*/
 	void getDescendants( vector<int>& descendants, int category ) {
-		if ( ! existCategory( category ) ) {
-			descendants.clear();
-			return;
-		}
-
-		map<int,InnerNode*>::iterator it = _mapCategoryToNode.find( category );
-		InnerNode* currNode = it->second;
-		vector<int> children;
-
 		descendants.clear();
-		descendants.push_back( currNode->getCategory() );
-		
-		size_t currIdx = 0;
-
-		while ( currIdx < descendants.size() ) {
-			currNode = convertCategroyToInnerNode( descendants[ currIdx++ ] );
-			currNode->getChildCategories( children );
-			
-			for( vector<int>::iterator it = children.begin(); it != children.end(); it++ ) descendants.push_back( *it );
-		}
+		const int node = getNode( category );
+		if ( node < 0 ) return;
+
+		descendants.assign( _flatCategories.begin() + node, _flatCategories.begin() + _subtreeEnds[node] );
 	}
 
 	int getParent( int category );
 
-	int convertIdxToCategory( int category ) { 
-		map<int,int>::iterator it = _mapIdxToCategory.find( category );
-		if ( it == _mapIdxToCategory.end() ) {
-			return -1;
-		} else {
-			return it->second;
-		}
+	int convertIdxToCategory( int idx ) { 
+		if ( idx < 0 || idx >= (int)_categoryOfIdx.size() ) return -1;
+		return _categoryOfIdx[idx];
 	}
 
-	int convertCategoryToIdx( int idx ) { 
-		map<int,int>::iterator it = _mapCategoryToIdx.find( idx );
-		if ( it == _mapCategoryToIdx.end() ) {
-			return -1;
-		} else {
-			return it->second;
-		}
+	int convertCategoryToIdx( int category ) { 
+		const int node = getNode( category );
+		return ( node < 0 ) ? -1 : _nodeIdx[node];
 	}
 
+	bool existCategory( int category ) { return getNode( category ) >= 0; }
 
-	bool existCategory( int category ) {
-		map<int,InnerNode*>::iterator it = _mapCategoryToNode.find( category );
-		return ( ! (it == _mapCategoryToNode.end() ) );
+	////////////////////////////////////////////////////////////////////////////
+	// the flattened hierarchy: the nodes are numbered in preorder, so the 
+	// subtree of a node is the range [node, subtree end) of the numbering
+	///////////////////////////////////////////////////////////////////////////
+
+	/**
+	* The preorder number of \a category, -1 if it is not in the hierarchy.
+	*/
+	int getNode( int category ) const {
+		if ( _sortedCategories.empty() ) {
+			// dense categories: direct table
+			const int offset = category - _minCategory;
+			if ( offset < 0 || offset >= (int)_nodeOfCategory.size() ) return -1;
+			return _nodeOfCategory[offset];
+		}
+		vector<int>::const_iterator it = lower_bound( _sortedCategories.begin(), _sortedCategories.end(), category );
+		if ( it == _sortedCategories.end() || *it != category ) return -1;
+		return _nodeOfCategory[ it - _sortedCategories.begin() ];
 	}
 
+	int getNodeCategory( int node ) const { return _flatCategories[node]; }
+	int getNodeIdx( int node ) const { return _nodeIdx[node]; }
+
+	//! The nodes from the top level down to \a node (\a node included)
+	const int* getAncestorNodes( int node ) const { return &_ancestors[ _ancestorBegins[node] ]; }
+	int getNumOfAncestors( int node ) const { return _ancestorBegins[node+1] - _ancestorBegins[node]; }
+
+	//! The children of the parent of \a node (\a node included)
+	const int* getSiblingNodes( int node ) const { return &_children[ _childBegins[ _parents[node]+1 ] ]; }
+	int getNumOfSiblings( int node ) const { return _childBegins[ _parents[node]+2 ] - _childBegins[ _parents[node]+1 ]; }
+
 	void getClassNameMap( NameMap& classNameMap ) { classNameMap = _classMap; }
 
 	////////////////////////////////////////////////////////////////////////////
@@ -263,6 +267,8 @@ public:
 	int getNumOfCategories( void ) { return _numOfCategories; }
 protected:
 	void updateMemberVariables( void );
+	// rebuilds the flattened hierarchy from the tree
+	void flatten( void );
 	void collectCategories( InnerNode* currNode, NameMap& namemap, map<int,int>& idxtocat, map<int,int>& cattoidx, map<int,InnerNode*>& cattonode );
 
 	void addHierarchPath( vector<int>& hierarchyPath );
@@ -277,6 +283,23 @@ protected:
 
 	InnerNode			_root;
 	NameMap				_classMap;
+
+	// the flattened hierarchy, indexed by the preorder number of the nodes
+	vector<int>			_flatCategories;	// the category of the node
+	vector<int>			_nodeIdx;			// the class idx of the node
+	vector<int>			_parents;			// the parent node, -1 on the top level
+	vector<int>			_subtreeEnds;		// one past the last node of the subtree
+	vector<int>			_ancestorBegins;	// where the ancestors of the node start in _ancestors
+	vector<int>			_ancestors;
+	vector<int>			_childBegins;		// the children of node v start at _childBegins[v+1], the top level at _childBegins[0]
+	vector<int>			_children;
+	vector<int>			_categoryOfIdx;
+
+	// category -> node: a direct table from _minCategory if the categories are dense,
+	// otherwise parallel to the sorted _sortedCategories
+	int					_minCategory;
+	vector<int>			_nodeOfCategory;
+	vector<int>			_sortedCategories;
 	locale				_locale;
 };
 
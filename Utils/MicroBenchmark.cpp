@@ -0,0 +1,409 @@
+/*
+*
+*    MultiBoost - Multi-purpose boosting package
+*
+*    Copyright (C) 2010   AppStat group
+*                         Laboratoire de l'Accelerateur Lineaire
+*                         Universite Paris-Sud, 11, CNRS
+*
+*    This file is part of the MultiBoost library
+*
+*    This library is free software; you can redistribute it 
+*    and/or modify it under the terms of the GNU General Public
+*    License as published by the Free Software Foundation; either
+*    version 2.1 of the License, or (at your option) any later version.
+*
+*    This library is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+*    General Public License for more details.
+*
+*    You should have received a copy of the GNU General Public
+*    License along with this library; if not, write to the Free Software
+*    Foundation, Inc., 51 Franklin St, 5th Floor, Boston, MA 02110-1301 USA
+*
+*    Contact: Balazs Kegl (balazs.kegl@gmail.com)
+*             Norman Casagrande (nova77@gmail.com)
+*             Robert Busa-Fekete (busarobi@gmail.com)
+*
+*    For more information and up-to-date version, please visit
+*        
+*                       http://www.multiboost.org/
+*
+*/
+
+#include "Utils/MicroBenchmark.h"
+
+#include "Utils/Utils.h"
+#include "IO/InputData.h"
+#include "IO/HaarData.h"
+#include "WeakLearners/BaseLearner.h"
+#include "WeakLearners/Haar/HaarFeatures.h"
+#include "StrongLearners/AdaBoostMHLearner.h"
+#include "Classifiers/AdaBoostMHClassifier.h"
+#include "Classifiers/ExampleResults.h"
+
+#include <cstdio> // for remove
+#include <cstdlib> // for rand
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+
+namespace MultiBoost {
+
+	// -----------------------------------------------------------------------
+
+	namespace {
+
+		const int   MIN_REPEATS = 3; // each kernel runs at least MIN_REPEATS times...
+		const double MIN_SECONDS = 1.0; // ...and for at least MIN_SECONDS
+		const float SPARSE_DENSITY = 0.05f; // the ratio of the stored values of the sparse data
+		const int   NUM_ITERATIONS = 20; // the size of the model of computeresults
+		const int   MAX_HAAR_CONFIGS = 200; // the configurations of each Haar-like feature
+
+		inline float rand01() { return (float)rand() / ((float)RAND_MAX + 1.0f); }
+
+		// -------------------------------------------------------------------
+
+		struct StumpKernel : public MicroBenchmark::Kernel
+		{
+			StumpKernel(BaseLearner* pSource, InputData* pData, const nor_utils::Args& args) 
+				: _pSource(pSource), _pData(pData), _args(args) {}
+
+			void run()
+			{
+				BaseLearner* pLearner = _pSource->create();
+				pLearner->initLearningOptions(_args);
+				pLearner->setTrainingData(_pData);
+				pLearner->run();
+				delete pLearner;
+			}
+
+			BaseLearner* _pSource;
+			InputData* _pData;
+			const nor_utils::Args& _args;
+		};
+
+		// -------------------------------------------------------------------
+
+		struct UpdateWeightsKernel : public MicroBenchmark::Kernel
+		{
+			UpdateWeightsKernel(InputData* pData, BaseLearner* pWeakHypothesis) 
+				: _pData(pData), _pWeakHypothesis(pWeakHypothesis) {}
+
+			void run() { _learner.updateWeights(_pData, _pWeakHypothesis); }
+
+			AdaBoostMHLearner _learner;
+			InputData* _pData;
+			BaseLearner* _pWeakHypothesis;
+		};
+
+		// -------------------------------------------------------------------
+
+		struct HaarKernel : public MicroBenchmark::Kernel
+		{
+			HaarKernel(const vector<HaarFeature*>& features, const vector<int>& numConfigs, 
+					   const vector<Example>& intImages) 
+				: _features(features), _numConfigs(numConfigs), _intImages(intImages), 
+				  _haarData(intImages.size()) {}
+
+			void run()
+			{
+				for (int f = 0; f < (int)_features.size(); ++f)
+				{
+					for (int c = 0; c < _numConfigs[f]; ++c)
+					{
+						_features[f]->loadConfigByNum(c);
+						_features[f]->fillHaarData(_intImages, _haarData);
+					}
+				}
+			}
+
+			const vector<HaarFeature*>& _features;
+			const vector<int>& _numConfigs;
+			const vector<Example>& _intImages;
+			vector< pair<int, float> > _haarData;
+		};
+
+		// -------------------------------------------------------------------
+
+		// computeResults() is not public
+		class ResultsClassifier : public AdaBoostMHClassifier
+		{
+		public:
+			ResultsClassifier(const nor_utils::Args& args) : AdaBoostMHClassifier(args, 0) {}
+
+			void computeResults(InputData* pData, vector<BaseLearner*>& weakHypotheses, 
+								vector< ExampleResults* >& results)
+			{ AdaBoostMHClassifier::computeResults(pData, weakHypotheses, results, (int)weakHypotheses.size()); }
+		};
+
+		struct ComputeResultsKernel : public MicroBenchmark::Kernel
+		{
+			ComputeResultsKernel(InputData* pData, vector<BaseLearner*>& weakHypotheses, 
+								 const nor_utils::Args& args) 
+				: _pData(pData), _weakHypotheses(weakHypotheses), _classifier(args) {}
+
+			void run()
+			{
+				vector< ExampleResults* > results;
+				_classifier.computeResults(_pData, _weakHypotheses, results);
+
+				vector< ExampleResults* >::iterator it;
+				for (it = results.begin(); it != results.end(); ++it)
+					delete *it;
+			}
+
+			InputData* _pData;
+			vector<BaseLearner*>& _weakHypotheses;
+			ResultsClassifier _classifier;
+		};
+
+	} // end of anonymous namespace
+
+	// -----------------------------------------------------------------------
+
+	MicroBenchmark::MicroBenchmark(int numExamples, int numFeatures, int numClasses, int verbose)
+		: _numExamples(numExamples), _numFeatures(numFeatures), _numClasses(numClasses), 
+		  _verbose(verbose)
+	{
+		if ( _numExamples < 1 || _numFeatures < 1 || _numClasses < 2 )
+		{
+			cerr << "ERROR: The benchmark needs at least one example, one feature and two classes!" << endl;
+			exit(1);
+		}
+
+		// the synthetic data is written in arff
+		_args.setArgumentDiscriminator("--");
+		_args.declareArgument("fileformat", "The format of the synthetic data.", 1, "<format>");
+		const char* argv[] = { "multiboost", "--fileformat", "arff" };
+		_args.readArguments(3, argv);
+	}
+
+	// -----------------------------------------------------------------------
+
+	void MicroBenchmark::run(const string& outFileName)
+	{
+		ofstream outFile(outFileName.c_str());
+		if ( !outFile.is_open() )
+		{
+			cerr << "ERROR: Cannot open the benchmark file <" << outFileName << ">!" << endl;
+			exit(1);
+		}
+
+		outFile << "kernel\tnumExamples\tnumFeatures\tnumClasses\tseconds\tthroughput\tunit\tprocessPeakMemoryKB" << endl;
+
+		//////////////////////////////////////////////////////////////////////////
+		// dense stumps, the weights and the classification
+		const string denseFileName = outFileName + ".dense.arff";
+		writeData(denseFileName, 1);
+		InputData* pDenseData = loadData("SingleStumpLearner", denseFileName);
+		remove(denseFileName.c_str());
+
+		BaseLearner* pStumpSource = BaseLearner::RegisteredLearners().getLearner("SingleStumpLearner");
+		StumpKernel stumpKernel(pStumpSource, pDenseData, _args);
+		report(outFile, "stump", timeKernel(stumpKernel), 
+			   (double)_numExamples * _numFeatures, "examples*features/s");
+
+		// the model of the classification, trained by AdaBoost.MH
+		AdaBoostMHLearner adaBoost;
+		vector<BaseLearner*> weakHypotheses;
+		for (int t = 0; t < NUM_ITERATIONS; ++t)
+		{
+			BaseLearner* pWeakHypothesis = pStumpSource->create();
+			pWeakHypothesis->initLearningOptions(_args);
+			pWeakHypothesis->setTrainingData(pDenseData);
+			pWeakHypothesis->run();
+			adaBoost.updateWeights(pDenseData, pWeakHypothesis);
+			weakHypotheses.push_back(pWeakHypothesis);
+		}
+
+		UpdateWeightsKernel updateWeightsKernel(pDenseData, weakHypotheses[0]);
+		report(outFile, "updateweights", timeKernel(updateWeightsKernel), 
+			   (double)_numExamples * _numClasses, "labels/s");
+
+		ComputeResultsKernel computeResultsKernel(pDenseData, weakHypotheses, _args);
+		report(outFile, "computeresults", timeKernel(computeResultsKernel), 
+			   (double)_numExamples, "predictions/s");
+
+		vector<BaseLearner*>::iterator it;
+		for (it = weakHypotheses.begin(); it != weakHypotheses.end(); ++it)
+			delete *it;
+		delete pDenseData;
+
+		//////////////////////////////////////////////////////////////////////////
+		// sparse stumps
+		const string sparseFileName = outFileName + ".sparse.arff";
+		writeData(sparseFileName, SPARSE_DENSITY);
+		InputData* pSparseData = loadData("SingleSparseStumpLearner", sparseFileName);
+		remove(sparseFileName.c_str());
+
+		StumpKernel sparseStumpKernel( BaseLearner::RegisteredLearners().getLearner("SingleSparseStumpLearner"), 
+									   pSparseData, _args );
+		report(outFile, "sparsestump", timeKernel(sparseStumpKernel), 
+			   (double)_numExamples * _numFeatures, "examples*features/s");
+		delete pSparseData;
+
+		//////////////////////////////////////////////////////////////////////////
+		// Haar-like features
+		const int side = max( 4, (int)sqrt((double)_numFeatures) );
+		HaarData::setAreaSize(side, side);
+
+		vector<Example> intImages;
+		generateIntegralImages(side, side, intImages);
+
+		const char* featureNames[] = { "2h", "2v", "3h", "3v", "4q" };
+		vector<HaarFeature*> features;
+		vector<int> numConfigs;
+		int totalConfigs = 0;
+		for (int f = 0; f < 5; ++f)
+		{
+			HaarFeature* pFeature = HaarFeature::RegisteredFeatures().getFeature(featureNames[f])->create();
+			const int n = min( pFeature->precomputeConfigs(), MAX_HAAR_CONFIGS );
+			features.push_back(pFeature);
+			numConfigs.push_back(n);
+			totalConfigs += n;
+		}
+
+		HaarKernel haarKernel(features, numConfigs, intImages);
+		report(outFile, "haar", timeKernel(haarKernel), 
+			   (double)_numExamples * totalConfigs, "examples*features/s");
+
+		vector<HaarFeature*>::iterator fIt;
+		for (fIt = features.begin(); fIt != features.end(); ++fIt)
+			delete *fIt;
+	}
+
+	// -----------------------------------------------------------------------
+
+	void MicroBenchmark::writeData(const string& fileName, float density)
+	{
+		ofstream outFile(fileName.c_str());
+		if ( !outFile.is_open() )
+		{
+			cerr << "ERROR: Cannot write the synthetic data <" << fileName << ">!" << endl;
+			exit(1);
+		}
+
+		outFile << "@RELATION benchmark" << endl;
+		for (int j = 0; j < _numFeatures; ++j)
+			outFile << "@ATTRIBUTE a" << j << " NUMERIC" << endl;
+		outFile << "@ATTRIBUTE class {c0";
+		for (int l = 1; l < _numClasses; ++l)
+			outFile << ",c" << l;
+		outFile << "}" << endl << "@DATA" << endl;
+
+		outFile << setprecision(4);
+		for (int i = 0; i < _numExamples; ++i)
+		{
+			const int classIdx = rand() % _numClasses;
+
+			if ( density >= 1 )
+			{
+				for (int j = 0; j < _numFeatures; ++j)
+					outFile << rand01() + ( j % _numClasses == classIdx ? 0.5f : 0.0f ) << ",";
+				outFile << "c" << classIdx << endl;
+			}
+			else
+			{
+				vector<int> columns;
+				for (int j = 0; j < _numFeatures; ++j)
+				{
+					if ( rand01() < density )
+						columns.push_back(j);
+				}
+				// the arff parser does not take empty rows
+				if ( columns.empty() )
+					columns.push_back( rand() % _numFeatures );
+
+				outFile << "{";
+				for (int k = 0; k < (int)columns.size(); ++k)
+				{
+					const int j = columns[k];
+					if ( k > 0 )
+						outFile << ", ";
+					outFile << j << " " << rand01() + ( j % _numClasses == classIdx ? 0.5f : 0.0f );
+				}
+				outFile << "} c" << classIdx << endl;
+			}
+		}
+	}
+
+	// -----------------------------------------------------------------------
+
+	InputData* MicroBenchmark::loadData(const string& learnerName, const string& fileName)
+	{
+		InputData* pData = BaseLearner::RegisteredLearners().getLearner(learnerName)->createInputData();
+		pData->initOptions(_args);
+		pData->load(fileName, IT_TRAIN, 0);
+		return pData;
+	}
+
+	// -----------------------------------------------------------------------
+
+	void MicroBenchmark::generateIntegralImages(int width, int height, vector<Example>& intImages)
+	{
+		intImages.resize(_numExamples);
+
+		vector<float> rowSums(width);
+		for (int i = 0; i < _numExamples; ++i)
+		{
+			vector<float> intImage(width * height);
+			fill(rowSums.begin(), rowSums.end(), 0.0f);
+
+			// the same recurrence as the one of the integral images of HaarData
+			int k = 0;
+			for (int y = 0; y < height; ++y)
+			{
+				float prevValue = 0;
+				for (int x = 0; x < width; ++x, ++k)
+				{
+					rowSums[x] += rand01();
+					intImage[k] = prevValue + rowSums[x];
+					prevValue = intImage[k];
+				}
+			}
+			intImages[i].addValues(intImage);
+		}
+	}
+
+	// -----------------------------------------------------------------------
+
+	double MicroBenchmark::timeKernel(Kernel& kernel)
+	{
+		double bestTime = numeric_limits<double>::max();
+		const double start = nor_utils::getWallTime();
+
+		for (int r = 0; r < MIN_REPEATS || nor_utils::getWallTime() - start < MIN_SECONDS; ++r)
+		{
+			const double kernelStart = nor_utils::getWallTime();
+			kernel.run();
+			bestTime = min( bestTime, nor_utils::getWallTime() - kernelStart );
+		}
+
+		return bestTime;
+	}
+
+	// -----------------------------------------------------------------------
+
+	void MicroBenchmark::report(ostream& out, const string& kernelName, double seconds, 
+								double numOps, const string& unit)
+	{
+		const double throughput = seconds > 0 ? numOps / seconds : 0;
+		// the high-water mark of the whole process so far, not of the kernel alone
+		const size_t peakMemory = nor_utils::getPeakMemory();
+
+		out << kernelName << "\t" << _numExamples << "\t" << _numFeatures << "\t" << _numClasses 
+			<< "\t" << seconds << "\t" << throughput << "\t" << unit << "\t" << peakMemory << endl;
+
+		if (_verbose > 0)
+		{
+			cout << kernelName << ": " << seconds << " s, " << throughput << " " << unit 
+				 << ", process peak memory " << peakMemory << " KB" << endl;
+		}
+	}
+
+	// -----------------------------------------------------------------------
+
+} // end of namespace MultiBoost
@@ -0,0 +1,169 @@
+/*
+*
+*    MultiBoost - Multi-purpose boosting package
+*
+*    Copyright (C) 2010   AppStat group
+*                         Laboratoire de l'Accelerateur Lineaire
+*                         Universite Paris-Sud, 11, CNRS
+*
+*    This file is part of the MultiBoost library
+*
+*    This library is free software; you can redistribute it 
+*    and/or modify it under the terms of the GNU General Public
+*    License as published by the Free Software Foundation; either
+*    version 2.1 of the License, or (at your option) any later version.
+*
+*    This library is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+*    General Public License for more details.
+*
+*    You should have received a copy of the GNU General Public
+*    License along with this library; if not, write to the Free Software
+*    Foundation, Inc., 51 Franklin St, 5th Floor, Boston, MA 02110-1301 USA
+*
+*    Contact: Balazs Kegl (balazs.kegl@gmail.com)
+*             Norman Casagrande (nova77@gmail.com)
+*             Robert Busa-Fekete (busarobi@gmail.com)
+*
+*    For more information and up-to-date version, please visit
+*        
+*                       http://www.multiboost.org/
+*
+*/
+
+
+/**
+* \file MicroBenchmark.h The microbenchmarks of the computational kernels.
+*/
+
+#ifndef __MICRO_BENCHMARK_H
+#define __MICRO_BENCHMARK_H
+
+#include "Utils/Args.h"
+#include "Others/Example.h"
+
+#include <vector>
+#include <string>
+#include <iosfwd>
+
+using namespace std;
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace MultiBoost {
+
+	class InputData;
+
+	/**
+	* Times the kernels of the training and of the classification in isolation,
+	* on synthetic data of a given size:
+	* - stump: the search of SingleStumpLearner over all the columns of dense data
+	* (StumpAlgorithm::findSingleThresholdWithInit);
+	* - sparsestump: the same with SingleSparseStumpLearner on sparse data (SparseStumpAlgorithm);
+	* - updateweights: AdaBoostMHLearner::updateWeights();
+	* - haar: HaarFeature::fillHaarData() over the configurations of each Haar-like feature;
+	* - computeresults: the votes of a model of stumps (AdaBoostMHClassifier::computeResults()).
+	*
+	* Each kernel is repeated (at least 3 times and for at least a second), and the best
+	* time is kept. The results go in a tab separated file, one line per kernel with the
+	* size of the data, the time, the throughput and the peak memory of the process, so
+	* that the results of two versions can be compared with a diff or a script.
+	* \remark The peak memory is the high-water mark of the process when the kernel 
+	* ends: it never decreases, so a kernel shows the peak of the earlier ones if 
+	* it uses less memory than them.
+	* \remark The synthetic data depends on the random seed (--seed).
+	* \date 18/10/2026
+	*/
+	class MicroBenchmark
+	{
+	public:
+
+		/**
+		* The constructor.
+		* \param numExamples The number of examples of the synthetic data.
+		* \param numFeatures The number of features (the Haar images are about 
+		* sqrt(numFeatures) x sqrt(numFeatures) pixels).
+		* \param numClasses The number of classes.
+		* \param verbose The level of verbosity.
+		* \date 18/10/2026
+		*/
+		MicroBenchmark(int numExamples, int numFeatures, int numClasses, int verbose = 1);
+
+		/**
+		* Run all the kernels.
+		* \param outFileName The file of the results.
+		* \date 18/10/2026
+		*/
+		void run(const string& outFileName);
+
+		/**
+		* A piece of code to time.
+		*/
+		struct Kernel
+		{
+			virtual ~Kernel() {}
+			virtual void run() = 0;
+		};
+
+	protected:
+
+		/**
+		* Write a synthetic dataset into an arff file. The value of the features
+		* j = l (mod numClasses) is shifted up on the examples of class l.
+		* \param fileName The name of the file.
+		* \param density The probability of a value to be stored (1 for dense data, 
+		* the sparse format is used otherwise).
+		* \date 18/10/2026
+		*/
+		void writeData(const string& fileName, float density);
+
+		/**
+		* Load a synthetic dataset with the input data of a weak learner.
+		* \param learnerName The name of the weak learner.
+		* \param fileName The arff file.
+		* \return The data, to be deleted by the caller.
+		* \date 18/10/2026
+		*/
+		InputData* loadData(const string& learnerName, const string& fileName);
+
+		/**
+		* Compute random integral images.
+		* \param width The width of the images.
+		* \param height The height of the images.
+		* \param intImages The returned images.
+		* \date 18/10/2026
+		*/
+		void generateIntegralImages(int width, int height, vector<Example>& intImages);
+
+		/**
+		* Time a kernel.
+		* \return The best time (in seconds) of the repetitions.
+		* \date 18/10/2026
+		*/
+		double timeKernel(Kernel& kernel);
+
+		/**
+		* Output the results of a kernel.
+		* \param out The stream of the results.
+		* \param kernelName The name of the kernel.
+		* \param seconds The time of a run of the kernel.
+		* \param numOps The work done by a run (e.g. the number of examples x features).
+		* \param unit The unit of the work.
+		* \date 18/10/2026
+		*/
+		void report(ostream& out, const string& kernelName, double seconds, 
+					double numOps, const string& unit);
+
+		int _numExamples;
+		int _numFeatures;
+		int _numClasses;
+		int _verbose;
+
+		nor_utils::Args _args; //!< The options of the data and of the learners (only --fileformat arff).
+	};
+
+} // end of namespace MultiBoost
+
+#endif // __MICRO_BENCHMARK_H
@@ -0,0 +1,174 @@
+/*
+*
+*    MultiBoost - Multi-purpose boosting package
+*
+*    Copyright (C) 2010   AppStat group
+*                         Laboratoire de l'Accelerateur Lineaire
+*                         Universite Paris-Sud, 11, CNRS
+*
+*    This file is part of the MultiBoost library
+*
+*    This library is free software; you can redistribute it 
+*    and/or modify it under the terms of the GNU General Public
+*    License as published by the Free Software Foundation; either
+*    version 2.1 of the License, or (at your option) any later version.
+*
+*    This library is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+*    General Public License for more details.
+*
+*    You should have received a copy of the GNU General Public
+*    License along with this library; if not, write to the Free Software
+*    Foundation, Inc., 51 Franklin St, 5th Floor, Boston, MA 02110-1301 USA
+*
+*    Contact: Balazs Kegl (balazs.kegl@gmail.com)
+*             Norman Casagrande (nova77@gmail.com)
+*             Robert Busa-Fekete (busarobi@gmail.com)
+*
+*    For more information and up-to-date version, please visit
+*        
+*                       http://www.multiboost.org/
+*
+*/
+
+
+
+#include "Utils/Profiler.h"
+#include "Utils/Utils.h" // for getWallTime
+
+#include <iostream>
+#include <iomanip>
+
+namespace MultiBoost {
+
+	// -----------------------------------------------------------------------
+
+	namespace {
+
+		const char* phaseNames[Profiler::NUM_PHASES] = 
+			{ "TimeWL", "TimeUpd", "TimeEval", "TimeSer", "TimeIdx" };
+
+		const char* counterNames[Profiler::NUM_COUNTERS] = 
+			{ "Columns", "Thresholds", "Classify" };
+
+	} // end of anonymous namespace
+
+	bool   Profiler::_enabled = false;
+	double Profiler::_startTime = 0;
+	double Profiler::_iterationTimes[Profiler::NUM_PHASES];
+	double Profiler::_iterationCounts[Profiler::NUM_COUNTERS];
+	double Profiler::_totalTimes[Profiler::NUM_PHASES];
+	double Profiler::_totalCounts[Profiler::NUM_COUNTERS];
+	int    Profiler::_numIterations = 0;
+
+	// -----------------------------------------------------------------------
+
+	void Profiler::enable()
+	{
+		for (int p = 0; p < NUM_PHASES; ++p)
+			_iterationTimes[p] = _totalTimes[p] = 0;
+		for (int c = 0; c < NUM_COUNTERS; ++c)
+			_iterationCounts[c] = _totalCounts[c] = 0;
+		_numIterations = 0;
+		_startTime = nor_utils::getWallTime();
+		_enabled = true;
+	}
+
+	// -----------------------------------------------------------------------
+
+	void Profiler::outputHeader(ostream& out)
+	{
+		for (int p = 0; p < NUM_PHASES; ++p)
+			out << '\t' << phaseNames[p];
+		for (int c = 0; c < NUM_COUNTERS; ++c)
+			out << '\t' << counterNames[c];
+		out << "\tPeakMemKB";
+	}
+
+	// -----------------------------------------------------------------------
+
+	void Profiler::outputIteration(ostream& out)
+	{
+		for (int p = 0; p < NUM_PHASES; ++p)
+			out << '\t' << _iterationTimes[p];
+		for (int c = 0; c < NUM_COUNTERS; ++c)
+			out << '\t' << _iterationCounts[c];
+		out << '\t' << nor_utils::getPeakMemory();
+
+		newIteration();
+		++_numIterations;
+	}
+
+	// -----------------------------------------------------------------------
+
+	void Profiler::newIteration()
+	{
+		for (int p = 0; p < NUM_PHASES; ++p)
+		{
+			_totalTimes[p] += _iterationTimes[p];
+			_iterationTimes[p] = 0;
+		}
+		for (int c = 0; c < NUM_COUNTERS; ++c)
+		{
+			_totalCounts[c] += _iterationCounts[c];
+			_iterationCounts[c] = 0;
+		}
+	}
+
+	// -----------------------------------------------------------------------
+
+	void Profiler::printSummary(ostream& out)
+	{
+		if ( !_enabled ) return;
+
+		// the work done after the last line of the outputinfo
+		newIteration();
+
+		const double totalTime = nor_utils::getWallTime() - _startTime;
+
+		out << "Profile (" << _numIterations << " iterations, " 
+			<< setprecision(4) << totalTime << " s in total):" << endl;
+
+		for (int p = 0; p < NUM_PHASES; ++p)
+		{
+			out << "  " << setw(12) << left << phaseNames[p] << right 
+				<< setw(12) << _totalTimes[p] << " s";
+			if ( totalTime > 0 )
+				out << " (" << setw(5) << 100 * _totalTimes[p] / totalTime << "%)";
+			out << endl;
+		}
+
+		for (int c = 0; c < NUM_COUNTERS; ++c)
+		{
+			out << "  " << setw(12) << left << counterNames[c] << right 
+				<< setw(12) << setprecision(12) << _totalCounts[c];
+			if ( _numIterations > 0 )
+				out << " (" << setprecision(4) << _totalCounts[c] / _numIterations << " per iteration)";
+			out << endl;
+		}
+
+		out << "  " << setw(12) << left << "PeakMemKB" << right 
+			<< setw(12) << nor_utils::getPeakMemory() << endl;
+	}
+
+	// -----------------------------------------------------------------------
+
+	ScopedTimer::ScopedTimer(Profiler::ePhase phase)
+		: _phase(phase), _start(0)
+	{
+		if ( Profiler::isEnabled() )
+			_start = nor_utils::getWallTime();
+	}
+
+	// -----------------------------------------------------------------------
+
+	ScopedTimer::~ScopedTimer()
+	{
+		if ( Profiler::isEnabled() )
+			Profiler::addTime( _phase, nor_utils::getWallTime() - _start );
+	}
+
+	// -----------------------------------------------------------------------
+
+} // end of namespace MultiBoost
@@ -0,0 +1,186 @@
+/*
+*
+*    MultiBoost - Multi-purpose boosting package
+*
+*    Copyright (C) 2010   AppStat group
+*                         Laboratoire de l'Accelerateur Lineaire
+*                         Universite Paris-Sud, 11, CNRS
+*
+*    This file is part of the MultiBoost library
+*
+*    This library is free software; you can redistribute it 
+*    and/or modify it under the terms of the GNU General Public
+*    License as published by the Free Software Foundation; either
+*    version 2.1 of the License, or (at your option) any later version.
+*
+*    This library is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+*    General Public License for more details.
+*
+*    You should have received a copy of the GNU General Public
+*    License along with this library; if not, write to the Free Software
+*    Foundation, Inc., 51 Franklin St, 5th Floor, Boston, MA 02110-1301 USA
+*
+*    Contact: Balazs Kegl (balazs.kegl@gmail.com)
+*             Norman Casagrande (nova77@gmail.com)
+*             Robert Busa-Fekete (busarobi@gmail.com)
+*
+*    For more information and up-to-date version, please visit
+*        
+*                       http://www.multiboost.org/
+*
+*/
+
+
+
+/**
+* \file Profiler.h The per-phase timers and counters of the learning (--profile).
+*/
+
+#ifndef __PROFILER_H
+#define __PROFILER_H
+
+#include <iosfwd>
+
+using namespace std;
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace MultiBoost {
+
+	/**
+	* Collects where the time of the learning goes. The strong learners time their
+	* phases with ScopedTimer, and the weak learners count their work with count().
+	* The values of the current iteration are appended to each line of the outputinfo
+	* file (see OutputInfo::endLine()), and the totals are printed at the end with
+	* printSummary().
+	*
+	* Everything is off unless enable() is called (--profile): a disabled timer or
+	* counter costs a test on a static flag.
+	* \remark The phases can be nested: the index set rebuilds done by a weak learner
+	* (PH_INDEX_SET) are also in PH_WEAK_LEARNER.
+	* \remark The counters are updated atomically, so the weak learners can count
+	* from concurrent threads (--treethreads).
+	* \date 18/10/2026
+	*/
+	class Profiler
+	{
+	public:
+
+		/**
+		* The timed phases of an iteration.
+		*/
+		enum ePhase
+		{
+			PH_WEAK_LEARNER, //!< The training of the weak learner(s).
+			PH_UPDATE_WEIGHTS, //!< The update of the weights.
+			PH_EVALUATION, //!< The errors on the training and test data (outputinfo).
+			PH_SERIALIZATION, //!< The writing of the hypotheses in the shyp file.
+			PH_INDEX_SET, //!< The loading/clearing of the index sets of the data (filtering).
+			NUM_PHASES
+		};
+
+		/**
+		* The counters of an iteration.
+		*/
+		enum eCounter
+		{
+			CN_COLUMNS, //!< The columns scanned by the stump searches.
+			CN_THRESHOLDS, //!< The distinct thresholds visited by the stump searches.
+			CN_CLASSIFY, //!< The calls of BaseLearner::classify() (counted in bulk by the callers).
+			NUM_COUNTERS
+		};
+
+		/**
+		* Switch the profiling on.
+		* \date 18/10/2026
+		*/
+		static void enable();
+
+		static bool isEnabled() { return _enabled; } //!< True if --profile is set.
+
+		/**
+		* Add some time to a phase.
+		* \param phase The phase.
+		* \param seconds The wall clock time spent in it.
+		* \date 18/10/2026
+		*/
+		static void addTime(ePhase phase, double seconds)
+		{
+			if ( !_enabled ) return;
+#pragma omp atomic
+			_iterationTimes[phase] += seconds;
+		}
+
+		/**
+		* Add to a counter.
+		* \param counter The counter.
+		* \param n The amount to add.
+		* \date 18/10/2026
+		*/
+		static void count(eCounter counter, double n)
+		{
+			if ( !_enabled ) return;
+#pragma omp atomic
+			_iterationCounts[counter] += n;
+		}
+
+		/**
+		* Output the names of the columns written by outputIteration(), each 
+		* preceded by a tab.
+		* \param out The stream.
+		* \date 18/10/2026
+		*/
+		static void outputHeader(ostream& out);
+
+		/**
+		* Output the times and counters of the iteration, each preceded by a tab,
+		* then add them to the totals and start a new iteration. The last column
+		* is the peak memory of the process (in kilobytes).
+		* \param out The stream.
+		* \date 18/10/2026
+		*/
+		static void outputIteration(ostream& out);
+
+		/**
+		* Print the totals of the phases and the counters.
+		* \param out The stream.
+		* \date 18/10/2026
+		*/
+		static void printSummary(ostream& out);
+
+	protected:
+
+		static void newIteration(); //!< Add the current iteration to the totals and reset it.
+
+		static bool   _enabled;
+		static double _startTime; //!< When enable() was called.
+		static double _iterationTimes[NUM_PHASES]; //!< The times of the current iteration.
+		static double _iterationCounts[NUM_COUNTERS]; //!< The counters of the current iteration.
+		static double _totalTimes[NUM_PHASES]; //!< The times of the previous iterations.
+		static double _totalCounts[NUM_COUNTERS]; //!< The counters of the previous iterations.
+		static int    _numIterations; //!< The number of lines output by outputIteration().
+	};
+
+	// -----------------------------------------------------------------------
+
+	/**
+	* Adds the time between its construction and its destruction to a phase
+	* of the Profiler. Nothing is measured if the profiling is off.
+	* \date 18/10/2026
+	*/
+	class ScopedTimer
+	{
+	public:
+		explicit ScopedTimer(Profiler::ePhase phase);
+		~ScopedTimer();
+	private:
+		Profiler::ePhase _phase;
+		double           _start;
+	};
+
+} // end of namespace MultiBoost
+
+#endif // __PROFILER_H
@@ -37,16 +37,105 @@
 #include <algorithm>
 #include <sstream>
 #include <fstream>
+#include <limits>
 
 namespace MultiBoost {
 
 // ----------------------------------------------------------------
 
-int	NodeUCTSparse::_depth = 0;
-int	NodeUCTSparse::_branchOrder = 0;
+int	InnerNodeUCTSparse::_depth = 0;
+int	InnerNodeUCTSparse::_branchOrder = 0;
 
 // ----------------------------------------------------------------
 
+int InnerNodeUCTSparse::addChild( int nodeIdx, int arm, bool isLeaf )
+{
+	const int childIdx = (int)_nodes.size();
+	_nodes.push_back( Node( nodeIdx, arm, isLeaf ) );
+
+	int* pLink = &_nodes[nodeIdx]._firstChild;
+	while ( *pLink >= 0 && _nodes[*pLink]._arm < arm )
+		pLink = &_nodes[*pLink]._nextSibling;
+	_nodes[childIdx]._nextSibling = *pLink;
+	*pLink = childIdx;
+
+	return childIdx;
+}
+
+// ----------------------------------------------------------------
+
+int InnerNodeUCTSparse::getChildIndWithMaxBi( int nodeIdx, int& childIdx )
+{
+	const int ni = _nodes[nodeIdx]._ni;
+	int child = _nodes[nodeIdx]._firstChild;
+
+	int retVal = 0;
+	childIdx = ( child >= 0 && _nodes[child]._arm == 0 ) ? child : -1;
+
+	double ucb = 0.0;
+	double maxB = numeric_limits< double >::min();
+	for( int i = 0; i < _branchOrder; i++ ) {
+		int currChild = -1;
+		if ( child >= 0 && _nodes[child]._arm == i ) {
+			const Node& node = _nodes[child];
+			ucb = node._Xini / ((double)node._ni) + sqrt( ( 2 * log( (double) ni )) / node._ni );
+			currChild = child;
+			child = node._nextSibling;
+		}
+		else ucb = ((double) rand() / (double )RAND_MAX ) + sqrt( ( 2 * log( (double) ni )) / 1.0 );
+		if ( maxB < ucb ) {
+			retVal = i;
+			childIdx = currChild;
+			maxB = ucb;
+		}
+	}
+	return retVal;
+}
+
+// ----------------------------------------------------------------
+
+void InnerNodeUCTSparse::getBestTrajectory( vector< int >& trajectory )
+{
+	trajectory.clear();
+
+	int nodeIdx = 0;
+	while ( 1 ) {
+		int childIdx;
+		const int bInd = getChildIndWithMaxBi( nodeIdx, childIdx );
+		trajectory.push_back( bInd );
+
+		if ( childIdx < 0 ) { 
+			if ( (int)trajectory.size() == _depth ) {
+				addChild( nodeIdx, bInd, true );
+				break;
+			} else
+				childIdx = addChild( nodeIdx, bInd, false );
+		} else { 
+			if ( _nodes[childIdx]._isLeaf ) break;
+		}
+
+		nodeIdx = childIdx;
+	}
 }
 
+// ----------------------------------------------------------------
+
+void InnerNodeUCTSparse::updateInnerNodes( double updateValue, vector< int >& trajectory )
+{
+	int nodeIdx = 0;
+	for( int i = 0; i < (int)trajectory.size(); i++ ) {
+		int childIdx = _nodes[nodeIdx]._firstChild;
+		while ( childIdx >= 0 && _nodes[childIdx]._arm != trajectory[i] )
+			childIdx = _nodes[childIdx]._nextSibling;
+		if ( childIdx < 0 )
+			childIdx = addChild( nodeIdx, trajectory[i], i + 1 == _depth );
 
+		_nodes[childIdx]._Xini += updateValue;
+		_nodes[childIdx]._ni++;
+		nodeIdx = childIdx;
+	}
+}
+
+// ----------------------------------------------------------------
+
+}
@@ -34,7 +34,7 @@
 
 
 /**
-* \file SingleStumpLearner.h A single threshold decision stump learner. 
+* \file UCTutils.h The search tree of the UCT bandit over the sequences of arms.
 */
 
 #ifndef __UCTUTILS_H
@@ -65,232 +65,96 @@ namespace MultiBoost {
 		LOGEDGE
 	};
 
-	
-	class NodeUCTSparse;
-	class InnerNodeUCTSparse;
-	class LeafNodeUCTSparse;
-
-	class NodeUCTSparse {
+	/**
+	* The UCT tree, rooted at this object. A path of the tree is a sequence of 
+	* _depth arms, each one out of _branchOrder.
+	* The nodes live in a single pool and refer to each other by their index in it 
+	* (the root is 0): only the visited children of a node are stored, in a list of 
+	* siblings sorted by arm. The tree is grown by getBestTrajectory() and 
+	* dropped at once by setChildrenNum().
+	* \date 18/10/2026
+	*/
+	class InnerNodeUCTSparse {
 	protected:
-		NodeUCTSparse*		_parent;		
-		int					_featureID;
-		int					_ni;
-		double				_Xini;
-		int					_myDepth;
+
+		/**
+		* A node of the tree.
+		*/
+		struct Node {
+			int		_parent;		//!< The index of the parent (-1 for the root).
+			int		_arm;			//!< The arm that leads to the node from its parent.
+			int		_firstChild;	//!< The index of the child with the smallest arm (-1 if none).
+			int		_nextSibling;	//!< The index of the next child of the parent (-1 if none).
+			int		_ni;			//!< The number of visits.
+			bool	_isLeaf;
+			double	_Xini;			//!< The sum of the rewards.
+
+			Node( int parent, int arm, bool isLeaf ) 
+				: _parent( parent ), _arm( arm ), _firstChild( -1 ), _nextSibling( -1 ), 
+				  _ni( 1 ), _isLeaf( isLeaf ), _Xini( INITIAL_X ) {}
+		};
+
+		vector<Node>		_nodes; //!< The pool of the nodes.
 
 		static int			_depth;
 		static int			_branchOrder;
 
 	public:
 
-		virtual bool isLeaf() = 0;
-		bool isRoot() { 
-			if ( _parent == 0 ) return true;
-			else return false;
-		}
-
-		NodeUCTSparse() : _parent( 0 ), _ni( 1 ), _Xini( INITIAL_X ), _myDepth(0) {}
-
-		//virtual double getUpperConfidenceBound() = 0;
-
-		virtual int getNi() { return _ni; }
-		virtual double getXini() { return _Xini / ((double)_ni); }
-		virtual void incNi() { _ni++; }
-		virtual NodeUCTSparse* getParent() { return _parent; }
-		virtual void addValue( double val ) { _Xini += val; }
-
-		virtual double getUpperConfidenceBound() {
-			return getXini() + sqrt( ( 2 * log( (double) _parent->getNi() )) / _ni );
-		}
-		virtual NodeUCTSparse* getithChild( int num ) = 0;
-		virtual void clearInnerNodeChild() = 0;
-		virtual int getNumOfChild() = 0;
-
-		virtual int getChildIndWithMaxBi() = 0;
-		static void setDepth( int d ) { NodeUCTSparse::_depth = d; }
-		static int getDepth() { return NodeUCTSparse::_depth; }
-
-		static void setBranchOrder( int bo ) { NodeUCTSparse::_branchOrder = bo; }
-
-		virtual int getMyDepth() { return _myDepth; }
-		virtual void setMyDepth( int d ) { _myDepth = d; }
-	};
-
-	class LeafNodeSparse : public NodeUCTSparse {
-	public:
-		LeafNodeSparse() : NodeUCTSparse() {}
-		LeafNodeSparse( NodeUCTSparse* n) : NodeUCTSparse() {
-			_parent = n;
-			setMyDepth( n->getMyDepth() + 1 );
-		}
-
-		virtual bool isLeaf() { return true; }
-		
-		virtual NodeUCTSparse* getithChild( int num ) { return 0; }
-		virtual void clearInnerNodeChild() {}
-		virtual int getNumOfChild() {return 0;}
-		virtual int getChildIndWithMaxBi() {return -1; }
-	};
-
-	class InnerNodeUCTSparse : public NodeUCTSparse {
-	protected:
-		vector<NodeUCTSparse*>	_children;
-	public:
-		virtual bool isLeaf() { return false; }
-		
-		InnerNodeUCTSparse() : NodeUCTSparse() { 
-			_children.resize( _branchOrder );
-			for( int i = 0; i < _branchOrder; i++ ) _children[i]=0;
-			//fill( _children.begin(), _children.end(), 0 );
-			setMyDepth( 0 ); //root
-		}
-
-		InnerNodeUCTSparse( NodeUCTSparse* n) : NodeUCTSparse() {
-			_children.resize( _branchOrder );
-			for( int i = 0; i < _branchOrder; i++ ) _children[i]=0;
-			_parent = n;
-			setMyDepth( n->getMyDepth() + 1 );
-		}
+		InnerNodeUCTSparse() { setChildrenNum(); }
 
-		virtual void createInnerNodeChild( int num ) {
-			_children.resize( num );
-			for( int i = 0; i < num; i++ ) {
-				_children[i] = new InnerNodeUCTSparse( (NodeUCTSparse*) this );
-			}
-		}
+		static void setDepth( int d ) { _depth = d; }
+		static int getDepth() { return _depth; }
 
-		virtual void createInnerNodeOneChild( int num ) {
-			if ( _children[num] == 0 )
-				_children[num] = new InnerNodeUCTSparse( (NodeUCTSparse*) this );
-		}
+		static void setBranchOrder( int bo ) { _branchOrder = bo; }
 
-		virtual void createLeafNodeChild( int num ) {
-			_children.resize( num );
-			for( int i = 0; i < num; i++ ) {
-				_children[i] = new LeafNodeSparse( (NodeUCTSparse*) this );
-			}
-		}
-
-		virtual void createLeafNodeOneChild( int num ) {
-			if ( _children[num] == 0 )
-				_children[num] = new LeafNodeSparse( (NodeUCTSparse*) this );
-		}
-
-
-		virtual void clearInnerNodeChild() {
-			for( int i = 0; i < (int)_children.size(); i++ ) {
-				if ( _children[i] ) delete _children[i];
-			}		
-		}
-
-		virtual bool hasIthChild( int num ) {
-			if ( _children[num] != 0 ) return true;
-			else return false;
-		}
-
-		virtual NodeUCTSparse* getithChild( int num ) { return _children[num]; }
-		virtual int getNumOfChild() {return (int)_children.size();}
-
-		virtual void createRecursiveUCTTree( int depth, int numOfChilds ) {
-			if ( depth == 1 ) {
-				createLeafNodeChild( numOfChilds );
-				return;
-			} else {
-				createInnerNodeChild( numOfChilds );
-				for ( int i = 0; i < numOfChilds; i++ ) {
-					((InnerNodeUCTSparse* )getithChild( i ))->createRecursiveUCTTree( depth - 1, numOfChilds );
-				}
-			}
-		}
-
-		virtual void setChildrenNum() { 
-			_children.resize( _branchOrder ); 
-			for( int i = 0; i < _branchOrder; i++ ) _children[i]=0;
-			//fill( _children.begin(), _children.end(), 0 );
+		/**
+		* Drop the tree, only the root is kept.
+		* \date 18/10/2026
+		*/
+		void setChildrenNum() { 
+			_nodes.clear();
+			_nodes.push_back( Node( -1, -1, false ) );
 		} 
 
-		virtual void clearRecursiveUCTTree( ) {
-			if ( isLeaf() ) {
-				return;
-			} else {
-				for ( int i = 0; i < getNumOfChild(); i++ ) {
-					InnerNodeUCTSparse* currNode = (InnerNodeUCTSparse* )getithChild( i );
-					if ( currNode != 0 ) currNode->clearRecursiveUCTTree( );
-				}
-				clearInnerNodeChild();
-			}
-		}
-
-		virtual int getChildIndWithMaxBi() {
-			int retVal = 0;
-			double ucb = 0.0;
-			double maxB = numeric_limits< double >::min();
-			for( int i = 0; i < getNumOfChild(); i++ ) {
-				if ( _children[i] != 0 ) ucb = _children[i]->getUpperConfidenceBound();
-				else ucb = ((double) rand() / (double )RAND_MAX ) + sqrt( ( 2 * log( (double) getNi() )) / 1.0 );
-				if ( maxB < ucb ) {
-					retVal = i;
-					maxB = ucb;
-				}
-			}
-			return retVal;
-		}
-
+		/**
+		* Walk down the tree choosing the arms with the highest upper confidence
+		* bound, and add the first unvisited node of the path to the tree.
+		* \param trajectory The arms of the path.
+		*/
+		void getBestTrajectory( vector< int >& trajectory );
 
-		virtual void getBestTrajectory( vector< int >& trajectory){
-			trajectory.clear();
+		/**
+		* Add a reward to the nodes of a path.
+		* \param updateValue The reward.
+		* \param trajectory The arms of the path. The missing nodes are added.
+		*/
+		void updateInnerNodes( double updateValue, vector< int >& trajectory );
 
-			int bInd; 
-			
-			/*
-			bInd = getChildIndWithMaxBi();
-			trajectory.push_back( bInd );
+		int getNumNodes() const { return (int)_nodes.size(); } //!< The number of nodes, the root included.
 
-			if ( hasIthChild( bInd ) ) { 
-				if ( trajectory.size() == ( _depth - 1 ) ) 
-					createLeafNodeOneChild( bInd );
-				else
-					createInnerNodeOneChild( bInd );
-			}
-				
-			InnerNodeUCTSparse* currNode = getithChild( bInd );
-			*/
-
-			InnerNodeUCTSparse* currNode = this;
-			
-
-			while ( 1 ) {
-				bInd = currNode->getChildIndWithMaxBi();
-				trajectory.push_back( bInd );
-
-				if ( ! currNode->hasIthChild( bInd ) ) { 
-					if ( trajectory.size() == ( _depth  ) )  {
-						currNode->createLeafNodeOneChild( bInd );
-						break;
-					} else
-						currNode->createInnerNodeOneChild( bInd );
-				} else { 
-					if ( currNode->getithChild( bInd )->isLeaf() ) break;
-				}
-
-
-				currNode = ( InnerNodeUCTSparse* )currNode->getithChild( bInd );
-				
-			}
-		}
-
-		void updateInnerNodes( double updateValue, vector< int >& trajectory ) {
-			NodeUCTSparse* currNode = this;
-			for( int i=0; i < (int)trajectory.size(); i++ ) {
-				currNode = currNode->getithChild( trajectory[i] );
-				currNode->addValue( updateValue );
-				currNode->incNi();
-
-			}
-
-		}
+		/**
+		* The size of the pool of the nodes in bytes.
+		* \date 18/10/2026
+		*/
+		size_t getMemoryUsage() const { return _nodes.capacity() * sizeof(Node); }
 
+	protected:
 
+		/**
+		* The arm of a node with the highest upper confidence bound. The unvisited 
+		* arms get a random value of the exploration.
+		* \param nodeIdx The index of the node.
+		* \param childIdx Returns the index of the child of the arm (-1 if it is not in the tree).
+		* \return The arm.
+		*/
+		int getChildIndWithMaxBi( int nodeIdx, int& childIdx );
+
+		/**
+		* Add a child into the list of siblings, keeping the order of the arms.
+		* \return The index of the new node.
+		*/
+		int addChild( int nodeIdx, int arm, bool isLeaf );
 	};
 
 //////////////////////////////////////////////////////////////////////////
@@ -38,6 +38,12 @@
 #include <algorithm>
 #include <sstream>
 #include <fstream>
+#include <ctime>
+
+#ifndef WIN32
+#include <sys/time.h> // for gettimeofday
+#include <sys/resource.h> // for getrusage
+#endif
 
 namespace nor_utils {
 	
@@ -435,5 +441,88 @@ namespace nor_utils {
 	}	
 	// ----------------------------------------------------------------
 	
+	unsigned int murmur_hash(const void* key, int len, unsigned int seed)
+	{
+		const unsigned char* data = static_cast<const unsigned char*>(key);
+		const int nblocks = len / 4;
+		
+		const unsigned int c1 = 0xcc9e2d51;
+		const unsigned int c2 = 0x1b873593;
+		
+		unsigned int h = seed;
+		
+		// body: 4 bytes at a time (read bytewise, so alignment does not matter)
+		for (int i = 0; i < nblocks; ++i)
+		{
+			const unsigned char* p = data + i * 4;
+			unsigned int k = p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned int)p[3] << 24);
+			
+			k *= c1;
+			k = (k << 15) | (k >> 17);
+			k *= c2;
+			
+			h ^= k;
+			h = (h << 13) | (h >> 19);
+			h = h * 5 + 0xe6546b64;
+		}
+		
+		// tail
+		const unsigned char* tail = data + nblocks * 4;
+		unsigned int k = 0;
+		switch (len & 3)
+		{
+		case 3: k ^= tail[2] << 16; // fallthrough
+		case 2: k ^= tail[1] << 8; // fallthrough
+		case 1: k ^= tail[0];
+			k *= c1;
+			k = (k << 15) | (k >> 17);
+			k *= c2;
+			h ^= k;
+		}
+		
+		// finalization
+		h ^= (unsigned int)len;
+		h ^= h >> 16;
+		h *= 0x85ebca6b;
+		h ^= h >> 13;
+		h *= 0xc2b2ae35;
+		h ^= h >> 16;
+		
+		return h;
+	}
+	
+	// ----------------------------------------------------------------
+
+	double getWallTime()
+	{
+#ifdef WIN32
+		// clock() measures the wall-clock time with Visual C++
+		return (double)clock() / CLOCKS_PER_SEC;
+#else
+		timeval tv;
+		gettimeofday(&tv, NULL);
+		return tv.tv_sec + tv.tv_usec * 1e-6;
+#endif
+	}
+
+	// ----------------------------------------------------------------
+
+	size_t getPeakMemory()
+	{
+#ifdef WIN32
+		return 0;
+#else
+		rusage usage;
+		getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+		return usage.ru_maxrss / 1024; // in bytes on Mac OS X
+#else
+		return usage.ru_maxrss;
+#endif
+#endif
+	}
+
+	// ----------------------------------------------------------------
+
 } // end of namespace nor_utils
 
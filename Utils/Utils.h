@@ -290,6 +290,39 @@ namespace nor_utils
 	 * \param in The stream of the file.
 	 */
 	size_t getFileSize(ifstream& in);
+	
+	// ----------------------------------------------------------------
+	
+	/**
+	 * A fast, well mixing 32 bits hash (MurmurHash3, x86 32 bits variant).
+	 * Used for the hashing trick, that is to map an unbounded set of
+	 * feature names into a fixed number of columns.
+	 * \param key The bytes to hash.
+	 * \param len The number of bytes.
+	 * \param seed The seed of the hash. Different seeds give independent mappings.
+	 * \return The hash value.
+	 * \date 18/10/2026
+	 */
+	unsigned int murmur_hash(const void* key, int len, unsigned int seed);
+	
+	// ----------------------------------------------------------------
+	
+	/**
+	 * The wall-clock time in seconds, to measure the elapsed time between 
+	 * two calls (the origin is arbitrary).
+	 * \date 18/10/2026
+	 */
+	double getWallTime();
+	
+	// ----------------------------------------------------------------
+	
+	/**
+	 * The peak resident memory of the process (in kilobytes).
+	 * \return The peak memory, 0 if the platform does not report it.
+	 * \date 18/10/2026
+	 */
+	size_t getPeakMemory();
+	
 	// ----------------------------------------------------------------
 	// ----------------------------------------------------------------
 	
@@ -91,6 +91,11 @@ namespace MultiBoost {
 			"  Default is 10%\n",
 			1, "<p>");
 
+		args.declareArgument("payoffthreads", 
+			"The number of threads computing the payoffs of the columns\n"
+			"  for the initialization of the bandit and for EXP3G2 (default: 1)\n",
+			1, "<numThreads>");
+
 	}
 
 	// ------------------------------------------------------------------------------
@@ -122,6 +127,13 @@ namespace MultiBoost {
 			_percentage = 0.1;
 		}
 
+		if ( args.hasArgument( "payoffthreads" ) )
+			args.getValue("payoffthreads", 0, _numThreads);
+#ifndef _OPENMP
+		if ( _numThreads > 1 && _verbose > 0 )
+			cerr << "Warning: compiled without OpenMP, the payoffs are computed sequentially." << endl;
+#endif
+
 		if ( args.hasArgument( "rsample" ) ){
 			_K = args.getValue<int>("rsample", 0);
 		} else {
@@ -205,26 +217,10 @@ namespace MultiBoost {
 			exit( -1 );
 		}
 
-		BaseLearner* pWeakHypothesisSource = 
-			BaseLearner::RegisteredLearners().getLearner("SingleStumpLearner");
-		
 		_banditAlgo->setArmNumber( numColumns );
 		
 		vector<double> initialValues( numColumns );
-
-		for( int i=0; i < numColumns; i++ )
-		{
-			SingleStumpLearner* singleStump = dynamic_cast<SingleStumpLearner*>( pWeakHypothesisSource->create());
-			
-			singleStump->setTrainingData(_pTrainingData);
-			double energy = singleStump->run( i );
-			double edge = singleStump->getEdge();
-			double reward = getRewardFromEdge( (float) edge );
-			
-			initialValues[i] = reward;
-			
-			delete singleStump;
-		}
+		computeColumnPayoffs( initialValues, false );
 
 		_banditAlgo->initialize( initialValues );
 
@@ -301,15 +297,11 @@ namespace MultiBoost {
 		for( int i = 0; i < (int)_armsForPulling.size(); i++ ) {
 			//columnIndices[i] = p.second;			
 
-			const pair<vpIterator,vpIterator> dataBeginEnd = 
-				static_cast<SortedData*>(_pTrainingData)->getFileteredBeginEnd( _armsForPulling[i] );
-
-
-			const vpIterator dataBegin = dataBeginEnd.first;
-			const vpIterator dataEnd = dataBeginEnd.second;
+			const SortedColumn column = 
+				static_cast<SortedData*>(_pTrainingData)->getFilteredColumn(_armsForPulling[i]);
 
 			// also sets mu, tmpV, and bestHalfEdge
-			tmpThreshold = sAlgo.findSingleThresholdWithInit(dataBegin, dataEnd, _pTrainingData, 
+			tmpThreshold = sAlgo.findSingleThresholdWithInit(column, _pTrainingData, 
 				halfTheta, &mu, &tmpV);
 
 			tmpEnergy = getEnergy(mu, tmpAlpha, tmpV);
@@ -384,7 +376,6 @@ namespace MultiBoost {
 		set<int> oldIndexSet;
 		set<int> randomIndexSet;
 		const int numExamples = _pTrainingData->getNumExamples();
-		const int numColumns = _pTrainingData->getNumAttributes();
 
 		_pTrainingData->getIndexSet( oldIndexSet );
 		int numSubset = static_cast<int>( static_cast<double>(numExamples) * _percentage );
@@ -408,28 +399,70 @@ namespace MultiBoost {
 		}
 		
 		
+		computeColumnPayoffs( payoffs, true );
+
+		//restore the database
+		_pTrainingData->loadIndexSet( oldIndexSet );
+	}
+
+	// ------------------------------------------------------------------------------
+
+	void BanditSingleStumpLearner::computeColumnPayoffs( vector<double>& payoffs, bool skipKnown )
+	{
+		const int numClasses = _pTrainingData->getNumClasses();
+		const int numExamples = _pTrainingData->getNumExamples();
+		const int numColumns = _pTrainingData->getNumAttributes();
+		SortedData* pSortedData = static_cast<SortedData*>(_pTrainingData);
+
 		payoffs.resize( numColumns );
 
-		BaseLearner* pWeakHypothesisSource = 
-			BaseLearner::RegisteredLearners().getLearner("SingleStumpLearner");		
-		
-		for( int i=0; i < numColumns; i++ )
-		{
-			if ( payoffs[i] > 0.0 ) continue;
+		// the constant edges and the weighted labels are computed once, the threads copy them
+		StumpAlgorithm<float> sAlgo(numClasses);
+		sAlgo.initSearchLoop(_pTrainingData);
 
-			SingleStumpLearner* singleStump = dynamic_cast<SingleStumpLearner*>( pWeakHypothesisSource->create());
-			
-			singleStump->setTrainingData(_pTrainingData);
-			double energy = singleStump->run( i );
-			double edge = singleStump->getEdge();
-			double reward = getRewardFromEdge( (float) edge );
-			
-			payoffs[i] = reward;			
-			delete singleStump;
+		// on a subset, the edge is normalized by the weight of the labels (see BaseLearner::getEdge)
+		float totalWeight = 0.0;
+		for (int i = 0; i < numExamples; ++i)
+		{
+			const vector<Label>& labels = _pTrainingData->getLabels(i);
+			for (vector<Label>::const_iterator lIt = labels.begin(); lIt != labels.end(); ++lIt)
+				totalWeight += lIt->weight * fabs( (float)_pTrainingData->getLabelY(i, *lIt) );
 		}
+		const bool isNormalized = _pTrainingData->isFiltered() && !nor_utils::is_zero( totalWeight );
 
-		//restore the database
-		_pTrainingData->loadIndexSet( oldIndexSet );
+		// the payoffs have always been computed by plain stumps, without edge offset
+		const float halfTheta = 0;
+
+#pragma omp parallel num_threads(_numThreads) if (_numThreads > 1)
+		{
+			StumpAlgorithm<float> threadAlgo( sAlgo );
+			vector<sRates> mu(numClasses);
+			vector<float> tmpV(numClasses);
+			vector<int> indexBuffer;
+			vector<float> valueBuffer;
+
+#pragma omp for schedule(dynamic, 64)
+			for( int j = 0; j < numColumns; j++ )
+			{
+				if ( skipKnown && payoffs[j] > 0.0 ) continue;
+
+				const SortedColumn column = pSortedData->getFilteredColumn( j, indexBuffer, valueBuffer );
+				const float threshold = threadAlgo.findSingleThresholdWithInit( column, _pTrainingData, 
+					halfTheta, &mu, &tmpV );
+
+				// the edge of the stump on the data is the sum of rPls - rMin over the classes
+				float edge = 0.0;
+				if ( threshold == threshold ) // tricky way to test Nan
+				{
+					for (int l = 0; l < numClasses; ++l)
+						edge += mu[l].rPls - mu[l].rMin;
+				}
+				if ( isNormalized )
+					edge /= totalWeight;
+
+				payoffs[j] = getRewardFromEdge( edge );
+			}
+		}
 	}
 
 	// -----------------------------------------------------------------------
@@ -505,6 +538,7 @@ namespace MultiBoost {
 		pBanditSingleStumpLearner->_K = _K;
 		pBanditSingleStumpLearner->_updateRule = _updateRule;
 		pBanditSingleStumpLearner->_percentage = _percentage;
+		pBanditSingleStumpLearner->_numThreads = _numThreads;
 	}
 
 	// -----------------------------------------------------------------------
@@ -79,7 +79,7 @@ class BanditSingleStumpLearner : public SingleStumpLearner
 {
 public:
 
-	BanditSingleStumpLearner() : SingleStumpLearner(), _banditAlgo( NULL ) {}
+	BanditSingleStumpLearner() : SingleStumpLearner(), _banditAlgo( NULL ), _numThreads( 1 ) {}
 
    /**
    * The destructor. Must be declared (virtual) for the proper destruction of 
@@ -207,6 +207,18 @@ protected:
    */
    void estimatePayoffs( vector<double>& payoffs );
 
+   /**
+   * Compute the reward of the best stump of each column on the current data (the 
+   * whole training data or the subset loaded by estimatePayoffs()). The labels are
+   * weighted once, then each sorted column is filtered into a buffer and scanned by
+   * a single StumpAlgorithm per thread (--payoffthreads). The edge of a stump is 
+   * obtained from its class-wise rates, so the data is not classified again.
+   * \param payoffs The rewards of the columns.
+   * \param skipKnown If true, the columns with a positive payoff are left as they are.
+   * \date 18/10/2026
+   */
+   void computeColumnPayoffs( vector<double>& payoffs, bool skipKnown );
+
 
    // the notation is borrowed from the paper of Kocsis et. al. ECML
    //static vector< int > _T; // the number of a feature has been selected 
@@ -223,6 +235,7 @@ protected:
    vector<double>			_rewards;
    vector<int>				_armsForPulling;
    double					_percentage; // for EXP3G
+   int						_numThreads; //!< The number of threads of computeColumnPayoffs().
 };
 
 //////////////////////////////////////////////////////////////////////////
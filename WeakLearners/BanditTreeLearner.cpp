@@ -107,7 +107,6 @@ namespace MultiBoost {
 		//declarations
 		NodePoint tmpNodePoint, nodeLeft, nodeRight;
 		ScalarLearner* pPreviousBaseLearner = 0;
-		set< int > tmpIdx;
 		//this contains the current number of baselearners 
 		int ib = 0;
 
@@ -121,6 +120,8 @@ namespace MultiBoost {
 
 		//train the first learner on the whole dataset 
 		_pTrainingData->clearIndexSet();
+		// the nodes are grown by partitioning the dataset
+		const int rootNodeIdx = _pTrainingData->beginPartition();
 		pPreviousBaseLearner = dynamic_cast<ScalarLearner* >(_baseLearners[0]->copyState());
 		float energy = dynamic_cast< FeaturewiseLearner* >(pPreviousBaseLearner)->run( _armsForPulling );
 		if ( energy != energy )
@@ -141,15 +142,14 @@ namespace MultiBoost {
 			tmpNodePoint._edge = 0.0;
 			tmpNodePoint._learner = cLearner;
 			tmpNodePoint._idx = 0;
-			tmpNodePoint._learnerIdxSet = tmpIdx;
+			tmpNodePoint._learnerNodeIdx = rootNodeIdx;
 			tmpNodePoint._extended = false;
 		} else {
 			//try to extend the root
-			for( int i = 0; i < _pTrainingData->getNumExamples(); i++ ) tmpIdx.insert( i );
 			tmpNodePoint._edge = pPreviousBaseLearner->getEdge();
 			tmpNodePoint._learner = pPreviousBaseLearner;
 			tmpNodePoint._idx = 0;
-			tmpNodePoint._learnerIdxSet = tmpIdx;
+			tmpNodePoint._learnerNodeIdx = rootNodeIdx;
 			calculateChildrenAndEnergies( tmpNodePoint );
 		}
 		////////////////////////////////////////////////////////
@@ -208,12 +208,12 @@ namespace MultiBoost {
 
 			nodeLeft._edge = tmpNodePoint._leftEdge;
 			nodeLeft._learner = tmpNodePoint._leftChild;
-			nodeLeft._learnerIdxSet = tmpNodePoint._leftChildIdxSet;
+			nodeLeft._learnerNodeIdx = tmpNodePoint._leftChildNodeIdx;
 
 
 			nodeRight._edge = tmpNodePoint._rightEdge;
 			nodeRight._learner = tmpNodePoint._rightChild;
-			nodeRight._learnerIdxSet = tmpNodePoint._rightChildIdxSet;
+			nodeRight._learnerNodeIdx = tmpNodePoint._rightChildNodeIdx;
 
 
 			//store the baselearner if the delta enrgy will be higher
@@ -356,14 +356,14 @@ namespace MultiBoost {
 		this->_alpha = 0.0;
 		float eps_min = 0.0, eps_pls = 0.0;
 
-		_pTrainingData->clearIndexSet();
+		_pTrainingData->endPartition();
 		for( int i = 0; i < _pTrainingData->getNumExamples(); i++ ) {
 			vector< Label> l = _pTrainingData->getLabels( i );
 			for( vector< Label >::iterator it = l.begin(); it != l.end(); it++ ) {
 				float result  = this->classify( _pTrainingData, i, it->idx );
 
-				if ( ( result * it->y ) < 0 ) eps_min += it->weight;
-				if ( ( result * it->y ) > 0 ) eps_pls += it->weight;
+				if ( ( result * _pTrainingData->getLabelY( i, *it ) ) < 0 ) eps_min += it->weight;
+				if ( ( result * _pTrainingData->getLabelY( i, *it ) ) > 0 ) eps_pls += it->weight;
 			}
 
 		}
@@ -387,30 +387,36 @@ namespace MultiBoost {
 
 	void BanditTreeLearner::calculateChildrenAndEnergies( NodePoint& bLearner ) {
 		bLearner._extended = true;
-		_pTrainingData->loadIndexSet( bLearner._learnerIdxSet );
+		_pTrainingData->selectPartitionNode( bLearner._learnerNodeIdx );
 
 		//separate the dataset
-		set< int > idxPos, idxNeg;
-		idxPos.clear();
-		idxNeg.clear();
+		const int numExamples = _pTrainingData->getNumExamples();
+		vector<signed char> sides( numExamples, 0 );
+		int numPos = 0, numNeg = 0;
 		float phix;
 		float energy;
 
-		for (int i = 0; i < _pTrainingData->getNumExamples(); ++i) {
+		for (int i = 0; i < numExamples; ++i) {
 			// this returns the phi value of classifier
 			phix = bLearner._learner->classify(_pTrainingData,i,0);
-			if ( phix <  0 )
-				idxNeg.insert( _pTrainingData->getRawIndex( i ) );
+			if ( phix <  0 ) {
+				sides[i] = -1;
+				++numNeg;
+			}
 			else if ( phix > 0 ) { // have to redo the multiplications, haven't been tested
-				idxPos.insert( _pTrainingData->getRawIndex( i ) );
+				sides[i] = +1;
+				++numPos;
 			}
 		}
 
-		if ( (idxPos.size() < 1 ) || (idxNeg.size() < 1 ) ) {
+		if ( (numPos < 1 ) || (numNeg < 1 ) ) {
 			bLearner._extended = false;
 		}
 
-		_pTrainingData->loadIndexSet( idxPos );
+		int posNodeIdx, negNodeIdx;
+		_pTrainingData->splitPartitionNode( bLearner._learnerNodeIdx, sides, posNodeIdx, negNodeIdx );
+
+		_pTrainingData->selectPartitionNode( posNodeIdx );
 		energy = numeric_limits<float>::signaling_NaN();	
 
 		if ( ! _pTrainingData->isSamplesFromOneClass() ) {
@@ -421,7 +427,7 @@ namespace MultiBoost {
 				bLearner._leftEdge = posLearner->getEdge();
 
 				bLearner._leftChild = posLearner;
-				bLearner._leftChildIdxSet = idxPos;
+				bLearner._leftChildNodeIdx = posNodeIdx;
 			} else {
 				delete posLearner;
 			}
@@ -437,10 +443,10 @@ namespace MultiBoost {
 
 			bLearner._leftEdge = posLearner->getEdge();
 			bLearner._leftChild = posLearner;
-			bLearner._leftChildIdxSet = idxPos;
+			bLearner._leftChildNodeIdx = posNodeIdx;
 		}
 
-		_pTrainingData->loadIndexSet( idxNeg );
+		_pTrainingData->selectPartitionNode( negNodeIdx );
 		energy = numeric_limits<float>::signaling_NaN();
 
 		if ( ! _pTrainingData->isSamplesFromOneClass() ) {
@@ -452,7 +458,7 @@ namespace MultiBoost {
 			{
 				bLearner._rightEdge = negLearner->getEdge();
 				bLearner._rightChild = negLearner;
-				bLearner._rightChildIdxSet = idxNeg;
+				bLearner._rightChildNodeIdx = negNodeIdx;
 			} else {
 				delete negLearner;
 			}
@@ -470,7 +476,7 @@ namespace MultiBoost {
 			bLearner._rightEdge = negLearner->getEdge();
 			bLearner._rightChild = negLearner;
 
-			bLearner._rightChildIdxSet = idxNeg;
+			bLearner._rightChildNodeIdx = negNodeIdx;
 		}
 
 	}
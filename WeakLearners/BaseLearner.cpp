@@ -75,6 +75,12 @@ namespace MultiBoost {
 			"The shyp file will be compressed", 
 			1, "<flag 0-1>");
 
+		args.declareArgument("shypwriter", 
+			"The shyp file is written by a background thread. At most <queueSize>\n"
+			"  hypotheses wait to be written, and the file is synced to the disk every\n"
+			"  <syncPeriod> hypotheses (0: let the system do it).", 
+			2, "<queueSize> <syncPeriod>");
+
 		args.setGroup("Basic Algorithm Options");
 		args.declareArgument("resume", 
 			"Resumes a training process using the strong hypothesis file.", 
@@ -254,7 +260,7 @@ namespace MultiBoost {
 
 			for( vector<Label>::iterator it = l.begin(); it !=  l.end(); it++ ) {
 				float cl = classify( _pTrainingData, i, it->idx );
-				float tmpVal = cl * it->weight * it->y;
+				float tmpVal = cl * it->weight * _pTrainingData->getLabelY( i, *it );
 				if ( tmpVal >= 0.0 ) sumPos += tmpVal;
 				else sumNeg -= tmpVal;
 			}
@@ -533,10 +533,13 @@ protected:
    InputData* _pTrainingData; //!< The data, needed in run, save, and load 
    /**
    * The smoothing value for alpha.
+   * \remark It is private to each thread, because the learners trained
+   * concurrently (see TreeLearner) set it in their run().
    * \see setSmoothingVal
    * \date 22/11/2005
    */
    static float        _smoothingVal; 
+#pragma omp threadprivate(_smoothingVal)
    
 private:
    /**
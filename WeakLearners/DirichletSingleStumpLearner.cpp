@@ -126,15 +126,11 @@ namespace MultiBoost {
 			}
 		}		
 
-		const pair<vpIterator,vpIterator> dataBeginEnd = 
-			static_cast<SortedData*>(_pTrainingData)->getFileteredBeginEnd(columnIndex);
-
-
-		const vpIterator dataBegin = dataBeginEnd.first;
-		const vpIterator dataEnd = dataBeginEnd.second;
+		const SortedColumn column = 
+			static_cast<SortedData*>(_pTrainingData)->getFilteredColumn(columnIndex);
 
 		// also sets mu, tmpV, and bestHalfEdge
-		tmpThreshold = sAlgo.findSingleThresholdWithInit(dataBegin, dataEnd, _pTrainingData, 
+		tmpThreshold = sAlgo.findSingleThresholdWithInit(column, _pTrainingData, 
 			halfTheta, &mu, &tmpV);
 
 		// small inconsistency compared to the standard algo (but a good
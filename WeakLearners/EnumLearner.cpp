@@ -98,7 +98,7 @@ namespace MultiBoost {
 					const vector<Label>& labels = _pTrainingData->getLabels(i);
 					int io = static_cast<int>(_pTrainingData->getValue(i,j));	    
 					for (int l = 0; l < numClasses; ++l) {
-						entry = labels[l].weight * labels[l].y;
+						entry = labels[l].weight * _pTrainingData->getLabelY(i, labels[l]);
 						if (entry > 0)
 							tmpGammasPls[io][l] += entry;
 						else if (entry < 0)
@@ -271,7 +271,7 @@ namespace MultiBoost {
 			const vector<Label>& labels = _pTrainingData->getLabels(i);
 			int io = static_cast<int>(_pTrainingData->getValue(i,j));	    
 			for (int l = 0; l < numClasses; ++l) {
-				entry = labels[l].weight * labels[l].y;
+				entry = labels[l].weight * _pTrainingData->getLabelY(i, labels[l]);
 				if (entry > 0)
 					tmpGammasPls[io][l] += entry;
 				else if (entry < 0)
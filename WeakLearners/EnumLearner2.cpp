@@ -37,6 +37,7 @@
 #include <limits>
 #include <cstdlib>
 #include "Kmeans/KMlocal.h"			// k-means algorithms
+#include "Kmeans/KMsparse.h"			// mini-batch k-means on sparse points
 #include "IO/Serialization.h"
 
 namespace MultiBoost {
@@ -50,6 +51,64 @@ namespace MultiBoost {
 	int EnumLearner2::_k = 3;
 		// ------------------------------------------------------------------------------
 
+	void EnumLearner2::declareArguments(nor_utils::Args& args)
+	{
+		FeaturewiseLearner::declareArguments(args);
+
+		args.declareArgument("clusteralgo", 
+			"The clustering of the users: lloyd (default), swap or hybrid (Lloyd's,\n"
+			"  the swap heuristic or the hybrid algorithm on the dense vote matrix),\n"
+			"  or minibatch (mini-batch k-means on the sparse votes)\n",
+			1, "<algo>");
+
+		args.declareArgument("clusterrestarts", 
+			"The number of independent runs of lloyd, swap or hybrid, the one\n"
+			"  with the lowest distortion is kept (default: 1)\n",
+			1, "<numRestarts>");
+
+		args.declareArgument("clusterbatch", 
+			"The size and the number of the mini-batches of the clustering\n"
+			"  (default: 1000 100)\n",
+			2, "<batchSize> <numBatches>");
+
+		args.declareArgument("clusterthreads", 
+			"The number of threads of the clustering (default: 1)\n",
+			1, "<numThreads>");
+	}
+
+	// ------------------------------------------------------------------------------
+
+	void EnumLearner2::initLearningOptions(const nor_utils::Args& args)
+	{
+		FeaturewiseLearner::initLearningOptions(args);
+
+		if ( args.hasArgument( "clusteralgo" ) ) {
+			args.getValue("clusteralgo", 0, _clusterAlgo);
+			if ( _clusterAlgo != "minibatch" && _clusterAlgo != "lloyd" && 
+				 _clusterAlgo != "swap" && _clusterAlgo != "hybrid" ) {
+				cerr << "ERROR: Unknown clustering algorithm <" << _clusterAlgo << ">!" << endl;
+				exit(1);
+			}
+		}
+
+		if ( args.hasArgument( "clusterrestarts" ) )
+			args.getValue("clusterrestarts", 0, _numRestarts);
+
+		if ( args.hasArgument( "clusterbatch" ) ) {
+			args.getValue("clusterbatch", 0, _batchSize);
+			args.getValue("clusterbatch", 1, _numStages);
+		}
+
+		if ( args.hasArgument( "clusterthreads" ) )
+			args.getValue("clusterthreads", 0, _numThreads);
+#ifndef _OPENMP
+		if ( _numThreads > 1 && _verbose > 0 )
+			cerr << "Warning: compiled without OpenMP, the users are clustered sequentially." << endl;
+#endif
+	}
+
+		// ------------------------------------------------------------------------------
+
 		float EnumLearner2::run()
 	{
 		const int numClasses = _pTrainingData->getNumClasses();
@@ -105,7 +164,7 @@ namespace MultiBoost {
 					const vector<Label>& labels = _pTrainingData->getLabels(i);
 					int io = static_cast<int>(_pTrainingData->getValue(i,j));	    
 					for (int l = 0; l < numClasses; ++l) {
-						entry = labels[l].weight * labels[l].y;
+						entry = labels[l].weight * _pTrainingData->getLabelY(i, labels[l]);
 						if (entry > 0)
 							tmpGammasPls[io][l] += entry;
 						else if (entry < 0)
@@ -253,7 +312,6 @@ namespace MultiBoost {
 
 	void EnumLearner2::generateSimilarityMatrix( void )
 	{
-		const int numClasses = _pTrainingData->getNumClasses();
 		const int numColumns = _pTrainingData->getNumAttributes();
 		const int numExamples = _pTrainingData->getNumExamples();
 
@@ -279,87 +337,112 @@ namespace MultiBoost {
 			cout << "Allocate memory for vote matrix...";
 		}
 
-		KMdata dataPts(objectNum, userNum);
-		vector< map< int, float> > voteMatrix( userNum );
-		
-		/*
-		_similarityMatrix.resize( userNum );
-		
-		
-		vector< priority_queue< pair< float, int > > > simMatrix( userNum );
-		for( int i = 0; i < userNum; i++ ) {
-			priority_queue< pair<float, int> > tmpPq;
-			simMatrix[i] = tmpPq;
+		// The vote of a user on an object is the first positive class of the first 
+		// example of the pair that has one.
+		vector< KMsparseEntry > entries;
+		entries.reserve( numExamples );
+		for( int i = 0; i<numExamples; i++ ) 
+		{
+			const vector< Label >& labs = _pTrainingData->getLabels( i );
+			for( vector< Label >::const_iterator lIt = labs.begin(); lIt != labs.end(); ++lIt ) 
+			{
+				if ( _pTrainingData->getLabelY( i, *lIt ) == 1 ) {
+					KMsparseEntry entry;
+					entry.pt = (int) _pTrainingData->getValue( i, 0 );
+					entry.col = (int) _pTrainingData->getValue( i, 1 );
+					entry.val = (KMcoord) lIt->idx;
+					entries.push_back( entry );
+					break;
+				}
+			}
 		}
-		*/
 
+		// the votes of the users as sparse points
+		KMsparseData votes( objectNum, userNum, entries );
+		vector< KMsparseEntry >().swap( entries );
 
 		if ( _verbose > 0 ) {
 			cout << "Ready!" << endl;
 		}
 
-		for( int i = 0; i<numExamples; i++ ) 
+		if ( _verbose > 0 ) { 
+			cout << "Clustering..." << endl;
+		}
+
+		EnumLearner2::_clusters.resize( userNum );
+
+		if ( _clusterAlgo == "minibatch" ) 
 		{
-			int userId =  (int) _pTrainingData->getValue( i, 0 );
-			int objectId = (int) _pTrainingData->getValue( i, 1 );
-			vector< Label > labs = _pTrainingData->getLabels( i );
-			for( int j = 0; j < numClasses; j++ ) 
-			{
-				//if ( _pTrainingData->hasLabel( i, j ) ) cout << j << endl;
-				if ( labs[j].y == 1 ) {
-					//cout << j << endl;
-					voteMatrix[userId].insert( map<int,float>::value_type( objectId, (float) j ) );
-				}
+			KMsparseLloyds kmAlg( votes, _k, _numStages, _batchSize, _numThreads );
+			const double distortion = kmAlg.execute();
+
+			if ( _verbose > 0 ) { 
+				cout << "Ready with the clustering (distortion " << distortion << ")..." << endl;
 			}
 
-			//cout << userId << " " << objectId << endl;			
+			const vector<int>& closeCtr = kmAlg.getAssignments();
+			copy( closeCtr.begin(), closeCtr.end(), EnumLearner2::_clusters.begin() );
 		}
-		
-		
-		KMdataArray pa = dataPts.getPts();
-		for( int i = 0; i<userNum; i++ ) {
-			for( int j = 0; j<objectNum; j++ ) {
-				map< int, float >::iterator it = voteMatrix[i].find( j );
-				if ( it != voteMatrix[i].end() ) {
-					pa[i][j] = (KMcoord) it->second;
-				} else {
-					pa[i][j] = (KMcoord) 0.0;
-				}
+		else 
+		{
+			KMdata dataPts(objectNum, userNum);
+			KMdataArray pa = dataPts.getPts();
+			for( int i = 0; i<userNum; i++ ) {
+				fill( pa[i], pa[i] + objectNum, (KMcoord) 0.0 );
+				for( int p = votes.rowBegin(i); p < votes.rowEnd(i); p++ )
+					pa[i][votes.getCol(p)] = votes.getVal(p);
 			}
-		}
 
-		if ( _verbose > 0 ) { 
-			cout << "Clustering..." << endl;
-		}
+			dataPts.buildKcTree();			// build filtering structure
+			KMfilterCenters ctrs(_k, dataPts);		// allocate centers
 
-		dataPts.buildKcTree();			// build filtering structure
-		KMfilterCenters ctrs(_k, dataPts);		// allocate centers
+			// A single run filters the kc-tree with all the threads, the restarts
+			// run side by side with one thread each.
+			kmNumThreads = _numThreads;
+			if ( _numRestarts > 1 ) 
+			{
+				if ( _clusterAlgo == "swap" )
+					ctrs = kmRestarts<KMlocalSwap>(ctrs, term, _numRestarts, _numThreads);
+				else if ( _clusterAlgo == "hybrid" )
+					ctrs = kmRestarts<KMlocalHybrid>(ctrs, term, _numRestarts, _numThreads);
+				else
+					ctrs = kmRestarts<KMlocalLloyds>(ctrs, term, _numRestarts, _numThreads);
+			}
+			else 
+			{
+				KMlocal* kmAlg;							// run the algorithm
+				if ( _clusterAlgo == "swap" )
+					kmAlg = new KMlocalSwap(ctrs, term);	// Swap heuristic
+				else if ( _clusterAlgo == "hybrid" )
+					kmAlg = new KMlocalHybrid(ctrs, term);	// Hybrid heuristic
+				else
+					kmAlg = new KMlocalLloyds(ctrs, term);	// repeated Lloyd's
+
+				ctrs = kmAlg->execute();			// execute
+				delete kmAlg;
+			}
 
-    							// run the algorithm
-		KMlocalLloyds       kmAlg(ctrs, term);	// repeated Lloyd's
-		// KMlocalSwap      kmAlg(ctrs, term);	// Swap heuristic
-		// KMlocalEZ_Hybrid kmAlg(ctrs, term);	// EZ-Hybrid heuristic
-		// KMlocalHybrid    kmAlg(ctrs, term);	// Hybrid heuristic
-		
+			if ( _verbose > 0 ) { 
+				cout << "Ready with the clustering (distortion " << ctrs.getDist() << ")..." << endl;
+			}
 
-		ctrs = kmAlg.execute();			// execute
+			KMctrIdxArray closeCtr = new KMctrIdx[dataPts.getNPts()];
+			double* sqDist = new double[dataPts.getNPts()];
+			ctrs.getAssignments(closeCtr, sqDist);
 
-		if ( _verbose > 0 ) { 
-			cout << "Ready with the clustering..." << endl;
+			for( int i = 0; i < dataPts.getNPts(); i++ ) {
+				//cout << closeCtr[i] << " ";
+				EnumLearner2::_clusters[i] = closeCtr[i];
+			}
+
+			delete [] closeCtr;
+			delete [] sqDist;
 		}
-		
-		KMctrIdxArray closeCtr = new KMctrIdx[dataPts.getNPts()];
-		double* sqDist = new double[dataPts.getNPts()];
-		ctrs.getAssignments(closeCtr, sqDist);
 
-		EnumLearner2::_clusters.resize(dataPts.getNPts() );
-		
 		vector< int > numElementsPerCluster( EnumLearner2::_k );
 		fill( numElementsPerCluster.begin(), numElementsPerCluster.end(), 0 );
 
-		for( int i = 0; i < dataPts.getNPts(); i++ ) {
-			//cout << closeCtr[i] << " ";
-			EnumLearner2::_clusters[i] = closeCtr[i];
+		for( int i = 0; i < userNum; i++ ) {
 			numElementsPerCluster[EnumLearner2::_clusters[i]]++;
 		}
 
@@ -369,9 +452,6 @@ namespace MultiBoost {
 
 		//cout << endl;
 
-		delete [] closeCtr;
-		delete [] sqDist;
-
 
 		/*
 		for( int i = 0; i < userNum - 1; i++ )  {
@@ -63,12 +63,35 @@ class EnumLearner2 : public FeaturewiseLearner
 {
 public:
 
+   /**
+   * The constructor. It sets the default options of the clustering.
+   * \date 18/10/2026
+   */
+   EnumLearner2() : _clusterAlgo("lloyd"), _batchSize(1000), _numStages(100), _numRestarts(1), _numThreads(1) {}
+
    /**
    * The destructor. Must be declared (virtual) for the proper destruction of 
    * the object.
    */
    virtual ~EnumLearner2() {}
 
+   /**
+   * Declare weak-learner-specific arguments.
+   * adding --clusteralgo, --clusterbatch and --clusterthreads
+   * \param args The Args class reference which can be used to declare
+   * additional arguments.
+   * \date 18/10/2026
+   */
+   virtual void declareArguments(nor_utils::Args& args);
+
+   /**
+   * Set the arguments of the algorithm using the standard interface
+   * of the arguments. Call this to set the arguments asked by the user.
+   * \param args The arguments defined by the user in the command line.
+   * \date 18/10/2026
+   */
+   virtual void initLearningOptions(const nor_utils::Args& args);
+
    /**
    * Returns itself as object.
    * \remark It uses the trick described in http://www.parashift.com/c++-faq-lite/serialization.html#faq-36.8
@@ -140,6 +163,12 @@ protected:
    static vector< int > _clusters;
    static int _k;
    vector<float> _u;
+
+   string _clusterAlgo; //!< lloyd (default), swap or hybrid (KMlocal on the dense vote matrix), or minibatch (KMsparseLloyds on the sparse votes).
+   int _batchSize; //!< The size of the mini-batches of KMsparseLloyds.
+   int _numStages; //!< The number of mini-batches of KMsparseLloyds.
+   int _numRestarts; //!< The number of independent runs of the KMlocal algorithms (the best one is kept).
+   int _numThreads; //!< The number of threads of the clustering.
    //static vector<float> _prevU;
 };
 
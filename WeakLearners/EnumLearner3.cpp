@@ -37,6 +37,9 @@
 #include <limits>
 #include <cstdlib>
 #include "Kmeans/KMlocal.h"			// k-means algorithms
+#include "Kmeans/KMsparse.h"			// sparse vote rows
+#include <algorithm> // for push_heap
+#include <functional> // for greater
 #include "IO/Serialization.h"
 
 namespace MultiBoost {
@@ -50,6 +53,31 @@ namespace MultiBoost {
 	int EnumLearner3::_k = 10;
 		// ------------------------------------------------------------------------------
 
+	void EnumLearner3::declareArguments(nor_utils::Args& args)
+	{
+		FeaturewiseLearner::declareArguments(args);
+
+		args.declareArgument("clusterthreads", 
+			"The number of threads of the clustering (default: 1)\n",
+			1, "<numThreads>");
+	}
+
+	// ------------------------------------------------------------------------------
+
+	void EnumLearner3::initLearningOptions(const nor_utils::Args& args)
+	{
+		FeaturewiseLearner::initLearningOptions(args);
+
+		if ( args.hasArgument( "clusterthreads" ) )
+			args.getValue("clusterthreads", 0, _numThreads);
+#ifndef _OPENMP
+		if ( _numThreads > 1 && _verbose > 0 )
+			cerr << "Warning: compiled without OpenMP, the similar users are searched sequentially." << endl;
+#endif
+	}
+
+		// ------------------------------------------------------------------------------
+
 		float EnumLearner3::run()
 	{
 		const int numClasses = _pTrainingData->getNumClasses();
@@ -105,7 +133,7 @@ namespace MultiBoost {
 					const vector<Label>& labels = _pTrainingData->getLabels(i);
 					int io = static_cast<int>(_pTrainingData->getValue(i,j));	    
 					for (int l = 0; l < numClasses; ++l) {
-						entry = labels[l].weight * labels[l].y;
+						entry = labels[l].weight * _pTrainingData->getLabelY(i, labels[l]);
 						if (entry > 0)
 							tmpGammasPls[io][l] += entry;
 						else if (entry < 0)
@@ -251,7 +279,6 @@ namespace MultiBoost {
 
 	void EnumLearner3::generateSimilarityMatrix( void )
 	{
-		const int numClasses = _pTrainingData->getNumClasses();
 		const int numColumns = _pTrainingData->getNumAttributes();
 		const int numExamples = _pTrainingData->getNumExamples();
 
@@ -270,77 +297,88 @@ namespace MultiBoost {
 			cout << "Allocate memory for vote matrix...";
 		}
 
-		vector< map< int, float> > voteMatrix( userNum );
-						
-		_clusters.resize( userNum );
-
-		priority_queue< pair< float, int > > simMatrix;
-		
-		if ( _verbose > 0 ) {
-			cout << "Ready!" << endl;
-		}
-
+		// The vote of a user on an object is the first positive class of the first 
+		// example of the pair that has one.
+		vector< KMsparseEntry > entries;
+		entries.reserve( numExamples );
 		for( int i = 0; i<numExamples; i++ ) 
 		{
-			int userId =  (int) _pTrainingData->getValue( i, 0 );
-			int objectId = (int) _pTrainingData->getValue( i, 1 );
-			vector< Label > labs = _pTrainingData->getLabels( i );
-			for( int j = 0; j < numClasses; j++ ) 
+			const vector< Label >& labs = _pTrainingData->getLabels( i );
+			for( vector< Label >::const_iterator lIt = labs.begin(); lIt != labs.end(); ++lIt ) 
 			{
-				//if ( _pTrainingData->hasLabel( i, j ) ) cout << j << endl;
-				if ( labs[j].y == 1 ) {
-					//cout << j << endl;
-					voteMatrix[userId].insert( map<int,float>::value_type( objectId, (float) j ) );
+				if ( _pTrainingData->getLabelY( i, *lIt ) == 1 ) {
+					KMsparseEntry entry;
+					entry.pt = (int) _pTrainingData->getValue( i, 0 );
+					entry.col = (int) _pTrainingData->getValue( i, 1 );
+					entry.val = (KMcoord) lIt->idx;
+					entries.push_back( entry );
+					break;
 				}
 			}
-
-			//cout << userId << " " << objectId << endl;			
 		}
-		
-		for( int i = 0; i < userNum; i++ )  {
-			while( ! simMatrix.empty() ) {
-				simMatrix.pop();
-			}
 
-			for( int j = 0; j<userNum; j++ ) {
-				
+		// the votes of the users and the voters of the objects
+		KMsparseData votes( objectNum, userNum, entries );
+		vector< KMsparseEntry >().swap( entries );
+		KMsparseData voters = votes.transpose();
+
+		_clusters.assign( userNum, vector<int>() );
+
+		if ( _verbose > 0 ) {
+			cout << "Ready!" << endl;
+		}
 
-				float similarity = 0.0;
-				int voteNum = 0;
-				for( map<int,float>::iterator it1 = voteMatrix[i].begin(); it1 != voteMatrix[i].end(); it1++ ) {
-					
-					map< int, float >::iterator it2 = voteMatrix[j].find( it1->first );
-					if ( it2 != voteMatrix[j].end() ) {
-						similarity += ( ( it1->second - it2->second ) * ( it1->second - it2->second ) );
-						voteNum++;
+		// Only the users that voted on a common object are scored, and only the 
+		// best _k of them are kept (ties go to the larger index).
+#pragma omp parallel num_threads(_numThreads) if (_numThreads > 1)
+		{
+			vector< float > sums( userNum, 0.0 );
+			vector< int > counts( userNum, 0 );
+			vector< int > touched;
+			vector< pair< float, int > > simMatrix;
+			simMatrix.reserve( _k + 1 );
+
+#pragma omp for schedule(dynamic, 64)
+			for( int i = 0; i < userNum; i++ )  {
+				for( int p = votes.rowBegin(i); p < votes.rowEnd(i); p++ ) {
+					const float vote = (float) votes.getVal(p);
+					const int o = votes.getCol(p);
+					for( int q = voters.rowBegin(o); q < voters.rowEnd(o); q++ ) {
+						const int j = voters.getCol(q);
+						const float otherVote = (float) voters.getVal(q);
+						if ( counts[j] == 0 ) touched.push_back( j );
+						sums[j] += ( ( vote - otherVote ) * ( vote - otherVote ) );
+						counts[j]++;
 					}
 				}
 
-				if ( voteNum > 0 ) { 
-					similarity /= (float)voteNum;
+				simMatrix.clear();
+				for( vector< int >::const_iterator tIt = touched.begin(); tIt != touched.end(); ++tIt ) {
+					const int j = *tIt;
+					float similarity = sums[j] / (float)counts[j];
 					similarity = -similarity;
+					sums[j] = 0.0;
+					counts[j] = 0;
 
-					pair< float, int > tmpPair1( similarity, j );
-					simMatrix.push( tmpPair1 );
+					const pair< float, int > tmpPair1( similarity, j );
+					if ( static_cast<int>( simMatrix.size() ) < _k ) {
+						simMatrix.push_back( tmpPair1 );
+						push_heap( simMatrix.begin(), simMatrix.end(), greater< pair< float, int > >() );
+					}
+					else if ( _k > 0 && simMatrix.front() < tmpPair1 ) {
+						pop_heap( simMatrix.begin(), simMatrix.end(), greater< pair< float, int > >() );
+						simMatrix.back() = tmpPair1;
+						push_heap( simMatrix.begin(), simMatrix.end(), greater< pair< float, int > >() );
+					}
 				}
-			}
-
-			size_t st = _k;
-			if ( simMatrix.size() < _k ) st = simMatrix.size();
+				touched.clear();
 
-			_clusters[i].resize( st );
-			int j = 0;
-			float sum = 0.0;
-			while ( ( ! simMatrix.empty() ) && ( j < _k ) ) {
-				pair< float, int > tmpPair = simMatrix.top();
-				simMatrix.pop();
-
-				_clusters[i][j] = tmpPair.second;
-				
-				j++;
+				sort_heap( simMatrix.begin(), simMatrix.end(), greater< pair< float, int > >() );
+				_clusters[i].resize( simMatrix.size() );
+				for( int j = 0; j < static_cast<int>( simMatrix.size() ); j++ )
+					_clusters[i][j] = simMatrix[j].second;
 			}
-
-		}		
+		}
 
     	//write out the similarity matrix
 		ofstream out;
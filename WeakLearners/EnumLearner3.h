@@ -63,12 +63,35 @@ class EnumLearner3 : public FeaturewiseLearner
 {
 public:
 
+   /**
+   * The constructor. It sets the default options of the clustering.
+   * \date 18/10/2026
+   */
+   EnumLearner3() : _numThreads(1) {}
+
    /**
    * The destructor. Must be declared (virtual) for the proper destruction of 
    * the object.
    */
    virtual ~EnumLearner3() {}
 
+   /**
+   * Declare weak-learner-specific arguments.
+   * adding --clusterthreads
+   * \param args The Args class reference which can be used to declare
+   * additional arguments.
+   * \date 18/10/2026
+   */
+   virtual void declareArguments(nor_utils::Args& args);
+
+   /**
+   * Set the arguments of the algorithm using the standard interface
+   * of the arguments. Call this to set the arguments asked by the user.
+   * \param args The arguments defined by the user in the command line.
+   * \date 18/10/2026
+   */
+   virtual void initLearningOptions(const nor_utils::Args& args);
+
    /**
    * Returns itself as object.
    * \remark It uses the trick described in http://www.parashift.com/c++-faq-lite/serialization.html#faq-36.8
@@ -140,6 +163,8 @@ protected:
    static vector< vector< int > > _clusters;
    static int _k;
    vector<float> _u;
+
+   int _numThreads; //!< The number of threads computing the most similar users.
    //static vector<float> _prevU;
 };
 
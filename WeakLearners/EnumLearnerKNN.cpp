@@ -35,6 +35,9 @@
 
 #include "EnumLearnerKNN.h"
 #include <limits>
+#include <algorithm> // for stable_sort, push_heap
+#include <functional> // for greater
+#include <cstring> // for memcmp
 
 #include "IO/Serialization.h"
 
@@ -59,9 +62,13 @@ namespace MultiBoost {
 			1, "<k>");
 
 		args.declareArgument("knnfile", 
-			"k-nn graph filename\n",
+			"k-nn graph filename (binary)\n",
 			1, "<knngraphfile>");
 
+		args.declareArgument("knnthreads", 
+			"The number of threads computing the k-nn graph (default: 1)\n",
+			1, "<numThreads>");
+
 	}
 
 	// ------------------------------------------------------------------------------
@@ -86,6 +93,16 @@ namespace MultiBoost {
 			_kNN.setName( fn );
 		}
 
+		if ( args.hasArgument( "knnthreads" ) ) { 
+			int numThreads;
+			args.getValue("knnthreads", 0, numThreads);
+			_kNN.setNumThreads( numThreads );
+#ifndef _OPENMP
+			if ( numThreads > 1 && _verbose > 0 )
+				cerr << "Warning: compiled without OpenMP, the k-nn graph is computed sequentially." << endl;
+#endif
+		}
+
 	}
 
 
@@ -150,7 +167,7 @@ namespace MultiBoost {
 					const vector<Label>& labels = _pTrainingData->getLabels(i);
 					int io = static_cast<int>(_pTrainingData->getValue(i,j));	    
 					for (int l = 0; l < numClasses; ++l) {
-						entry = labels[l].weight * labels[l].y;
+						entry = labels[l].weight * _pTrainingData->getLabelY(i, labels[l]);
 						if (entry > 0)
 							tmpGammasPls[io][l] += entry;
 						else if (entry < 0)
@@ -340,7 +357,7 @@ namespace MultiBoost {
 			const vector<Label>& labels = _pTrainingData->getLabels(i);
 			int io = static_cast<int>(_pTrainingData->getValue(i,j));	    
 			for (int l = 0; l < numClasses; ++l) {
-				entry = labels[l].weight * labels[l].y;
+				entry = labels[l].weight * _pTrainingData->getLabelY(i, labels[l]);
 				if (entry > 0)
 					tmpGammasPls[io][l] += entry;
 				else if (entry < 0)
@@ -507,4 +524,253 @@ namespace MultiBoost {
 		pEnumLearnerKNN->_uOffset = _uOffset;
 	}
 
+	// -----------------------------------------------------------------------
+	// -----------------------------------------------------------------------
+
+	// The header of a kNN graph file, followed by, for every attribute, the 
+	// number of row begins and of neighbors, the row begins and the neighbors.
+	struct KNNGraphHeader
+	{
+		char magic[8];
+		int  k;
+		int  numAttributes;
+	};
+
+	static const char knnGraphMagic[8] = { 'M', 'B', 'K', 'N', 'N', '1', 0, 0 };
+
+	// A vote of a user on an object: ((user, object), class).
+	typedef pair< pair<int, int>, int > KNNVote;
+
+	// -----------------------------------------------------------------------
+
+	void KNNGraph::calculateFeatureWiseKNNGraph( int sortedAttribute, int targetAttribute )
+	{
+		const int numExamples = _pTrainingData->getNumExamples();
+		const int userNum = _pTrainingData->getEnumMap( sortedAttribute ).getNumNames();
+		const int objectNum = _pTrainingData->getEnumMap( targetAttribute ).getNumNames();
+
+		cout << "Allocate memory for vote matrix...";
+
+		// The vote of a user on an object is the first positive class of the first 
+		// example of the pair that has one.
+		vector< KNNVote > votes;
+		votes.reserve( numExamples );
+		for( int i = 0; i < numExamples; i++ ) 
+		{
+			const vector< Label >& labels = _pTrainingData->getLabels( i );
+			for( vector< Label >::const_iterator lIt = labels.begin(); lIt != labels.end(); ++lIt ) 
+			{
+				if ( _pTrainingData->getLabelY( i, *lIt ) == 1 ) {
+					const int userId = (int) _pTrainingData->getValue( i, sortedAttribute );
+					const int objectId = (int) _pTrainingData->getValue( i, targetAttribute );
+					votes.push_back( KNNVote( make_pair( userId, objectId ), lIt->idx ) );
+					break;
+				}
+			}
+		}
+		stable_sort( votes.begin(), votes.end(), 
+			nor_utils::comparePair< 1, pair<int,int>, int, less< pair<int,int> > >() );
+		votes.erase( unique( votes.begin(), votes.end(), 
+			nor_utils::comparePair< 1, pair<int,int>, int, equal_to< pair<int,int> > >() ), votes.end() );
+		const int numVotes = static_cast<int>( votes.size() );
+
+		// the votes by user (sorted by object) and the inverted index by object
+		vector<int> userBegins( userNum + 1, 0 );
+		vector<int> objectBegins( objectNum + 1, 0 );
+		for( int v = 0; v < numVotes; v++ ) {
+			++userBegins[ votes[v].first.first + 1 ];
+			++objectBegins[ votes[v].first.second + 1 ];
+		}
+		for( int u = 0; u < userNum; u++ )
+			userBegins[u+1] += userBegins[u];
+		for( int o = 0; o < objectNum; o++ )
+			objectBegins[o+1] += objectBegins[o];
+
+		vector<int> userObjects( numVotes );
+		vector<float> userVotes( numVotes );
+		vector<int> objectUsers( numVotes );
+		vector<float> objectVotes( numVotes );
+		vector<int> objectPos( objectBegins.begin(), objectBegins.end() - 1 );
+		for( int v = 0; v < numVotes; v++ ) {
+			userObjects[v] = votes[v].first.second;
+			userVotes[v] = (float) votes[v].second;
+			const int pos = objectPos[ votes[v].first.second ]++;
+			objectUsers[pos] = votes[v].first.first;
+			objectVotes[pos] = (float) votes[v].second;
+		}
+		vector< KNNVote >().swap( votes );
+
+		cout << "Ready!" << endl;
+
+		// the best k neighbors of every user, the most similar first
+		const int k = max( _k, 0 );
+		vector<int> slots( static_cast<size_t>(userNum) * k );
+		vector<int> slotCounts( userNum, 0 );
+
+#pragma omp parallel num_threads(_numThreads) if (_numThreads > 1)
+		{
+			vector<float> sums( userNum, 0.0 );
+			vector<int> counts( userNum, 0 );
+			vector<int> touched;
+			vector< pair< float, int > > heap;
+			heap.reserve( k + 1 );
+
+#pragma omp for schedule(dynamic, 64)
+			for( int i = 0; i < userNum; i++ )  {
+				// score the users that voted on the objects of i
+				for( int p = userBegins[i]; p < userBegins[i+1]; p++ ) {
+					const int o = userObjects[p];
+					const float vote = userVotes[p];
+					for( int q = objectBegins[o]; q < objectBegins[o+1]; q++ ) {
+						const int j = objectUsers[q];
+						if ( i == j ) continue;
+						if ( counts[j] == 0 ) touched.push_back( j );
+						// by the calculation of diffrence of votes we also take into account the value of rating
+						sums[j] += ( ( vote - objectVotes[q] ) * ( vote - objectVotes[q] ) );
+						counts[j]++;
+					}
+				}
+
+				// keep the best k in a min-heap (ties go to the larger index)
+				heap.clear();
+				for( vector<int>::const_iterator tIt = touched.begin(); tIt != touched.end(); ++tIt ) {
+					const int j = *tIt;
+					float similarity = sums[j] / (float)counts[j];
+					similarity = -similarity;
+					sums[j] = 0.0;
+					counts[j] = 0;
+
+					const pair< float, int > candidate( similarity, j );
+					if ( static_cast<int>( heap.size() ) < k ) {
+						heap.push_back( candidate );
+						push_heap( heap.begin(), heap.end(), greater< pair< float, int > >() );
+					}
+					else if ( k > 0 && heap.front() < candidate ) {
+						pop_heap( heap.begin(), heap.end(), greater< pair< float, int > >() );
+						heap.back() = candidate;
+						push_heap( heap.begin(), heap.end(), greater< pair< float, int > >() );
+					}
+				}
+				touched.clear();
+
+				sort_heap( heap.begin(), heap.end(), greater< pair< float, int > >() );
+				for( int n = 0; n < static_cast<int>( heap.size() ); n++ )
+					slots[ static_cast<size_t>(i) * k + n ] = heap[n].second;
+				slotCounts[i] = static_cast<int>( heap.size() );
+			}
+		}
+
+		vector<int>& neighborBegins = _neighborBegins[sortedAttribute];
+		vector<int>& neighbors = _neighbors[sortedAttribute];
+		neighborBegins.resize( userNum + 1 );
+		neighborBegins[0] = 0;
+		for( int i = 0; i < userNum; i++ )
+			neighborBegins[i+1] = neighborBegins[i] + slotCounts[i];
+		neighbors.resize( neighborBegins[userNum] );
+		for( int i = 0; i < userNum; i++ )
+			copy( slots.begin() + static_cast<size_t>(i) * k, 
+				  slots.begin() + static_cast<size_t>(i) * k + slotCounts[i], 
+				  neighbors.begin() + neighborBegins[i] );
+
+		cout << "Similarity matrix ready..." << endl;
+	}
+
+	// -----------------------------------------------------------------------
+
+	void KNNGraph::save()
+	{
+		ofstream outFile( _fname.c_str(), ios::binary );
+	    
+		if (!outFile.is_open())
+		{
+			cerr << "ERROR: Cannot open kNN file <" << _fname << ">!" << endl;
+			exit(1);
+		}
+
+		KNNGraphHeader header;
+		memcpy( header.magic, knnGraphMagic, sizeof(knnGraphMagic) );
+		header.k = _k;
+		header.numAttributes = static_cast<int>( _neighborBegins.size() );
+		outFile.write( reinterpret_cast<const char*>(&header), sizeof(header) );
+
+		for( int a = 0; a < header.numAttributes; a++ ) {
+			const int sizes[2] = { static_cast<int>( _neighborBegins[a].size() ), static_cast<int>( _neighbors[a].size() ) };
+			outFile.write( reinterpret_cast<const char*>(sizes), sizeof(sizes) );
+			if ( sizes[0] > 0 )
+				outFile.write( reinterpret_cast<const char*>(&_neighborBegins[a][0]), sizes[0] * sizeof(int) );
+			if ( sizes[1] > 0 )
+				outFile.write( reinterpret_cast<const char*>(&_neighbors[a][0]), sizes[1] * sizeof(int) );
+		}
+
+		if ( !outFile )
+		{
+			cerr << "ERROR: Cannot write kNN file <" << _fname << ">!" << endl;
+			exit(1);
+		}
+	}
+
+	// -----------------------------------------------------------------------
+
+	bool KNNGraph::load()
+	{
+		if ( ! isExistKNNFile() ) {
+			return false;
+		}
+
+		ifstream inFile( _fname.c_str(), ios::binary );
+		if (!inFile.is_open())
+		{
+			cerr << "ERROR: Cannot open knn file <" << _fname << ">!" << endl;
+			exit(1);
+		}
+
+		const int numAttributes = _pTrainingData->getNumAttributes();
+
+		KNNGraphHeader header;
+		if ( ! inFile.read( reinterpret_cast<char*>(&header), sizeof(header) ) ||
+			 memcmp( header.magic, knnGraphMagic, sizeof(knnGraphMagic) ) != 0 ) {
+			// an old text graph or a foreign file: keep it and use a new name
+			const string binName = _fname + ".bin";
+			cerr << "Warning: the kNN file <" << _fname << "> is not a binary kNN graph, it is kept and <" 
+				 << binName << "> is used instead." << endl;
+			_fname = binName;
+			return load();
+		}
+
+		bool isValid = header.k == _k && header.numAttributes == numAttributes;
+
+		for( int a = 0; isValid && a < numAttributes; a++ ) {
+			int sizes[2];
+			isValid = inFile.read( reinterpret_cast<char*>(sizes), sizeof(sizes) ) &&
+				( sizes[0] == 0 || sizes[0] == _pTrainingData->getEnumMap(a).getNumNames() + 1 ) &&
+				sizes[1] >= 0;
+			if ( !isValid ) break;
+
+			_neighborBegins[a].resize( sizes[0] );
+			_neighbors[a].resize( sizes[1] );
+			if ( sizes[0] > 0 )
+				inFile.read( reinterpret_cast<char*>(&_neighborBegins[a][0]), sizes[0] * sizeof(int) );
+			if ( sizes[1] > 0 )
+				inFile.read( reinterpret_cast<char*>(&_neighbors[a][0]), sizes[1] * sizeof(int) );
+			isValid = inFile && ( sizes[0] == 0 ? sizes[1] == 0 : 
+				_neighborBegins[a][0] == 0 && _neighborBegins[a].back() == sizes[1] );
+
+			// the ranges must be ordered and the neighbors must be values of the attribute
+			for( int v = 1; isValid && v < sizes[0]; v++ )
+				isValid = _neighborBegins[a][v-1] <= _neighborBegins[a][v];
+			for( int n = 0; isValid && n < sizes[1]; n++ )
+				isValid = _neighbors[a][n] >= 0 && _neighbors[a][n] < sizes[0] - 1;
+		}
+
+		if ( !isValid ) {
+			cerr << "Warning: the kNN file <" << _fname << "> is corrupt or does not belong to the data or to k, it is recomputed." << endl;
+			setTrainingData( _pTrainingData );
+			return false;
+		}
+
+		return true;
+	}
+
+	// -----------------------------------------------------------------------
+
 } // end of namespace MultiBoost
@@ -46,7 +46,7 @@
 #include <vector>
 #include <fstream>
 #include <cassert>
-#include <queue>
+#include <string>
 
 using namespace std;
 
@@ -155,17 +155,23 @@ protected:
 };
 
 //////////////////////////////////////////////////////////////////////////
-typedef map< int, int > Neighborhood; 
-typedef vector< Neighborhood > GraphRepresentation;
 
+/**
+* The k-nearest-neighbor graph of the values of the first two (enum) attributes,
+* for instance users and objects: two users are similar if they gave similar votes
+* (classes) to the same objects, and vice versa.
+* The graph is stored in CSR form: the neighbors of the value \a v of the attribute 
+* \a a are _neighbors[a][_neighborBegins[a][v]] .. _neighbors[a][_neighborBegins[a][v+1]-1],
+* the most similar first. It is saved into and loaded from a binary file.
+*/
 class KNNGraph {
 public:
 	KNNGraph() {
 		_isReady = false;
 		_pTrainingData = NULL;
-		_FeatureWiseKNNGraph.clear();
 		_k = 5;
-		_fname = "knngraph.txt";
+		_numThreads = 1;
+		_fname = "knngraph.bin";
 	}
 
 	virtual string getName() { return _fname; }
@@ -185,88 +191,46 @@ public:
 	virtual void setTrainingData(InputData *pTrainingData) {
 		_pTrainingData = pTrainingData;
 
-		// allocate memory for KNN graph
-		_FeatureWiseKNNGraph.resize( _pTrainingData->getNumAttributes() );
-		for( int i = 0; i < _pTrainingData->getNumAttributes(); i++ ) {
-			_FeatureWiseKNNGraph[i].resize( _pTrainingData->getNumExamples() );
-		}
+		// one graph per attribute, empty until it is computed or loaded
+		_neighborBegins.assign( _pTrainingData->getNumAttributes(), vector<int>() );
+		_neighbors.assign( _pTrainingData->getNumAttributes(), vector<int>() );
 	}
 	
 	virtual bool isReady() { return _isReady; }
 	
 	virtual void getjthFeatureithExampleNeighborhood( int i, int j, vector< int >& neighbors ) {
-		neighbors.resize( _FeatureWiseKNNGraph[i][j].size() );
-		map< int, int >::iterator it;
-		int ib;
-
-		for( ib = 0, it = _FeatureWiseKNNGraph[i][j].begin(); it != _FeatureWiseKNNGraph[i][j].end(); it++, ib++  ) {
-			neighbors[ib] = it->first;
+		if ( _neighborBegins[i].empty() ) {
+			neighbors.clear();
+			return;
 		}
+		neighbors.assign( _neighbors[i].begin() + _neighborBegins[i][j], 
+						  _neighbors[i].begin() + _neighborBegins[i][j+1] );
 	}
 
 	virtual void setK( int k ) { _k = k; }
 	virtual int getK() { return _k; }
 
-	virtual void save() {
-		ofstream outFile;
-		outFile.open( _fname.c_str() );
-	    
-		if (!outFile.is_open())
-	    {
-		   cerr << "ERROR: Cannot open kNN file <" << _fname << ">!" << endl;
-		   exit(1);
-	    }
-		
-		for( int i1 = 0; i1 < _FeatureWiseKNNGraph.size(); i1 ++ ) {
-			for( int i2 = 0; i2 < _FeatureWiseKNNGraph[i1].size(); i2++ ) {
-				for( map<int,int>::iterator it = _FeatureWiseKNNGraph[i1][i2].begin(); it != _FeatureWiseKNNGraph[i1][i2].end(); it++ ) {
-					outFile << i1 << " " << i2 << " " << it->first << " " << it->second << endl; 
-				}
-			}
-		}
-
-		outFile.close();
-
-	}
-
-	virtual bool load() {
-		if ( ! isExistKNNFile() ) {
-			return false;
-		}
-		   ifstream inFile( _fname.c_str());
-		if (!inFile.is_open())
-		{
-			cerr << "ERROR: Cannot open knn file <" << _fname << ">!" << endl;
-			exit(1);
-		}
-		
-	    nor_utils::StreamTokenizer st(inFile, " \n\r\t");
-		string token;
-		int i1, i2, i3, i4;
-
-		while ( st.has_token() ) {
-			token = st.next_token();
-			i1 = atoi( token.c_str() );
-			if ( ! st.has_token() ) break;
-
-			token = st.next_token();
-			i2 = atoi( token.c_str() );
-
-			token = st.next_token();
-			i3 = atoi( token.c_str() );
-			
-			token = st.next_token();
-			i4 = atoi( token.c_str() );
-			
-
-			//cout << i1 << " " << i2 << " " << i3 << " " << i4 << endl; 
-			_FeatureWiseKNNGraph[i1][i2].insert( map<int, int>::value_type( i3, i4 ) );
-		}
-
-		inFile.close();
-
-		return true;
-	}
+	/**
+	* Set the number of threads computing the neighbors of the values.
+	* \date 18/10/2026
+	*/
+	virtual void setNumThreads( int numThreads ) { _numThreads = numThreads; }
+
+	/**
+	* Write the graph into the binary file _fname.
+	* \date 18/10/2026
+	*/
+	virtual void save();
+
+	/**
+	* Read the graph from the binary file _fname.
+	* \return false if the file does not exist, is corrupt or does not belong to the data 
+	* and to k, then the graph must be computed.
+	* \remark A file that is not a binary graph, e.g. an old text graph, is not 
+	* overwritten: _fname is changed to _fname + ".bin".
+	* \date 18/10/2026
+	*/
+	virtual bool load();
 
 	virtual bool isExistKNNFile() {
 		if( ifstream( _fname.c_str() ) ) {
@@ -276,135 +240,22 @@ public:
 	}
 
 protected:
-	virtual void calculateFeatureWiseKNNGraph( int sortedAttribute, int targetAttribute ) {
-		const int numClasses = _pTrainingData->getNumClasses();
-		const int numAttribute = _pTrainingData->getNumAttributes();
-		const int numExamples = _pTrainingData->getNumExamples();
-
-		//const int targetObjectNum = _pTrainingData->getEnumMap( attributeNum ).getNumNames();
-		//const int objectNum = _pTrainingData->getEnumMap( 1 ).getNumNames();
-
-
-		const int userNum = _pTrainingData->getEnumMap( sortedAttribute ).getNumNames();
-		const int objectNum = _pTrainingData->getEnumMap( targetAttribute ).getNumNames();
-
-		cout << "Allocate memory for vote matrix...";
-
-		vector< map< int, float> > voteMatrix( userNum );
-						
-		//_clusters.resize( userNum );
-
-		priority_queue< pair< float, int > > simMatrix;
-		
-		cout << "Ready!" << endl;
-
-		for( int i = 0; i<numExamples; i++ ) 
-		{
-			int userId =  (int) _pTrainingData->getValue( i, sortedAttribute  );
-			int objectId = (int) _pTrainingData->getValue( i, targetAttribute );
-			vector< Label > labs = _pTrainingData->getLabels( i );
-			for( int j = 0; j < numClasses; j++ ) 
-			{
-				//if ( _pTrainingData->hasLabel( i, j ) ) cout << j << endl;
-				if ( labs[j].y == 1 ) {
-					//cout << j << endl;
-					voteMatrix[userId].insert( map<int,float>::value_type( objectId, (float) j ) );
-				}
-			}
-
-			//cout << userId << " " << objectId << endl;			
-		}
-		
-		for( int i = 0; i < userNum; i++ )  {
-			while( ! simMatrix.empty() ) {
-				simMatrix.pop();
-			}
-
-			for( int j = 0; j<userNum; j++ ) {
-				if ( i == j ) continue;
-
-				float similarity = 0.0;
-				int voteNum = 0;
-				for( map<int,float>::iterator it1 = voteMatrix[i].begin(); it1 != voteMatrix[i].end(); it1++ ) {
-					
-					map< int, float >::iterator it2 = voteMatrix[j].find( it1->first );
-					// by the calculation of diffrence of votes we also take into account the value of rating
-					if ( it2 != voteMatrix[j].end() ) {
-						similarity += ( ( it1->second - it2->second ) * ( it1->second - it2->second ) );
-						voteNum++;
-					}
-				}
-
-				if ( voteNum > 0 ) { 
-					similarity /= (float)voteNum;
-					similarity = -similarity;
-
-					pair< float, int > tmpPair1( similarity, j );
-					simMatrix.push( tmpPair1 );
-				}
-			}
-
-			size_t st = _k;
-			if ( simMatrix.size() < _k ) st = simMatrix.size();
-
-			//_clusters[i].resize( st );
-			int j = 0;
-			float sum = 0.0;
-			while ( ( ! simMatrix.empty() ) && ( j < _k ) ) {
-				pair< float, int > tmpPair = simMatrix.top();
-				simMatrix.pop();
-
-				//_clusters[i][j] = tmpPair.second;
-				_FeatureWiseKNNGraph[sortedAttribute][ i ].insert( map<int,int>::value_type( tmpPair.second,  j ) );
-				j++;
-			}
-
-		}		
-
-    	//write out the similarity matrix
-		
-		ofstream out;
-		out.open( "sim.txt" );
-		
-		for( int i = 0; i<userNum; i++ )  {
-			for( map< int, int >::iterator it = _FeatureWiseKNNGraph[sortedAttribute][i].begin(); it != _FeatureWiseKNNGraph[sortedAttribute][i].end(); it++ ) {
-				out << it->first << " " << it->second << " ";
-			}
-			out << endl;
-			out.flush();
-		}
-		
-		out.close();
-
-		out.clear();
-
-		
-		/*
-		out.open( "mat.txt" );
-		
-		for( int i = 0; i < userNum; i++ )  {
-			for( int j = 0; j < objectNum; j++ )  {
-				map< int, float >::iterator it = voteMatrix[i].find( j );
-				if ( it != voteMatrix[i].end() ) {
-					out << it->second << "\t";
-				} else {
-					out << "0.0" << "\t";
-				}
-			}
-			out << endl;
-		}
-
-		out.close();
-		*/
-
-		//end of writing out the similarity matrx
-		cout << "Similarity matrix ready..." << endl;
-	}
+	/**
+	* Compute the k nearest neighbors of the values of \a sortedAttribute. The
+	* similarity of two values is minus the mean squared difference of their votes 
+	* on the common values of \a targetAttribute. Through an inverted index over 
+	* \a targetAttribute only the pairs with common values are scored, and only the 
+	* best k candidates are kept.
+	* \date 18/10/2026
+	*/
+	virtual void calculateFeatureWiseKNNGraph( int sortedAttribute, int targetAttribute );
 	
 	bool _isReady;
 	InputData* _pTrainingData;
-	vector< GraphRepresentation > _FeatureWiseKNNGraph;	
+	vector< vector<int> > _neighborBegins; //!< The CSR row begins of the graphs, per attribute.
+	vector< vector<int> > _neighbors; //!< The neighbors of the graphs, per attribute.
 	int _k;
+	int _numThreads; //!< The number of threads of calculateFeatureWiseKNNGraph().
 	string _fname;
 };
 
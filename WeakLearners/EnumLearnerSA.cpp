@@ -37,6 +37,7 @@
 #include <limits>
 
 #include "IO/Serialization.h"
+#include "IO/EnumData.h"
 
 namespace MultiBoost {
 
@@ -74,7 +75,6 @@ namespace MultiBoost {
 	{
 		const int numClasses = _pTrainingData->getNumClasses();
 		const int numColumns = _pTrainingData->getNumAttributes();
-		const int numExamples = _pTrainingData->getNumExamples();
 
 		// set the smoothing value to avoid numerical problem
 		// when theta=0.
@@ -86,6 +86,8 @@ namespace MultiBoost {
 
 		float tmpAlpha,previousTmpAlpha, previousEnergy;
 		float bestEnergy = numeric_limits<float>::max();
+		vector<float> gammasPls; // The numIdxs x numClasses gamma plus matrix, row-wise
+		vector<float> gammasMin; // The gamma minus matrix
 
 		int numOfDimensions = _maxNumOfDimensions;
 		for (int j = 0; j < numColumns; ++j)
@@ -105,31 +107,9 @@ namespace MultiBoost {
 
 				const int numIdxs = _pTrainingData->getEnumMap(j).getNumNames();
 
-				// Create and initialize the numIdxs x numClasses gamma matrix
-				vector<vector<float> > tmpGammasPls(numIdxs);
-				vector<vector<float> > tmpGammasMin(numIdxs);
-				for (int io = 0; io < numIdxs; ++io) {
-					vector<float> tmpGammaPls(numClasses);
-					vector<float> tmpGammaMin(numClasses);
-					fill(tmpGammaPls.begin(), tmpGammaPls.end(), 0.0);
-					fill(tmpGammaMin.begin(), tmpGammaMin.end(), 0.0);
-					tmpGammasPls[io] = tmpGammaPls;
-					tmpGammasMin[io] = tmpGammaMin;
-				}
-
-				// Compute the elements of the gamma plus and minus matrices
-				float entry;
-				for (int i = 0; i < numExamples; ++i) {
-					const vector<Label>& labels = _pTrainingData->getLabels(i);
-					int io = static_cast<int>(_pTrainingData->getValue(i,j));	    
-					for (int l = 0; l < numClasses; ++l) {
-						entry = labels[l].weight * labels[l].y;
-						if (entry > 0)
-							tmpGammasPls[io][l] += entry;
-						else if (entry < 0)
-							tmpGammasMin[io][l] += -entry;
-					}
-				}
+				// Compute the elements of the numIdxs x numClasses gamma plus and minus matrices
+				// (see EnumData::computeGammas)
+				EnumData::computeGammas(_pTrainingData, j, gammasPls, gammasMin);
 
 				// Initialize the u vector to random +-1
 				vector<sRates> uMu(numIdxs); // The idx-wise rates
@@ -162,12 +142,12 @@ namespace MultiBoost {
 						vMu[l].rPls = vMu[l].rMin = vMu[l].rZero = 0; 
 						for (int io = 0; io < numIdxs; ++io) {
 							if (tmpU[io] > 0) {
-								vMu[l].rPls += tmpGammasPls[io][l];
-								vMu[l].rMin += tmpGammasMin[io][l];
+								vMu[l].rPls += gammasPls[io*numClasses+l];
+								vMu[l].rMin += gammasMin[io*numClasses+l];
 							}
 							else if (tmpU[io] < 0) {
-								vMu[l].rPls += tmpGammasMin[io][l];
-								vMu[l].rMin += tmpGammasPls[io][l];
+								vMu[l].rPls += gammasMin[io*numClasses+l];
+								vMu[l].rMin += gammasPls[io*numClasses+l];
 							}
 						}
 						if (vMu[l].rPls >= vMu[l].rMin) {
@@ -200,12 +180,12 @@ namespace MultiBoost {
 						uMu[io].rPls = uMu[io].rMin = uMu[io].rZero = 0; 
 						for (int l = 0; l < numClasses; ++l) {
 							if (tmpV[l] > 0) {
-								uMu[io].rPls += tmpGammasPls[io][l];
-								uMu[io].rMin += tmpGammasMin[io][l];
+								uMu[io].rPls += gammasPls[io*numClasses+l];
+								uMu[io].rMin += gammasMin[io*numClasses+l];
 							}
 							else if (tmpV[l] < 0) {
-								uMu[io].rPls += tmpGammasMin[io][l];
-								uMu[io].rMin += tmpGammasPls[io][l];
+								uMu[io].rPls += gammasMin[io*numClasses+l];
+								uMu[io].rMin += gammasPls[io*numClasses+l];
 							}
 						}
 						// sparse U 
@@ -254,7 +234,6 @@ namespace MultiBoost {
 	{
 		const int numClasses = _pTrainingData->getNumClasses();
 		const int numColumns = _pTrainingData->getNumAttributes();
-		const int numExamples = _pTrainingData->getNumExamples();
 
 		// set the smoothing value to avoid numerical problem
 		// when theta=0.
@@ -266,6 +245,8 @@ namespace MultiBoost {
 
 		float tmpAlpha,previousTmpAlpha, previousEnergy;
 		float bestEnergy = numeric_limits<float>::max();
+		vector<float> gammasPls; // The numIdxs x numClasses gamma plus matrix, row-wise
+		vector<float> gammasMin; // The gamma minus matrix
 
 		int numOfDimensions = _maxNumOfDimensions;
 
@@ -280,31 +261,9 @@ namespace MultiBoost {
 
 		const int numIdxs = _pTrainingData->getEnumMap(j).getNumNames();
 
-		// Create and initialize the numIdxs x numClasses gamma matrix
-		vector<vector<float> > tmpGammasPls(numIdxs);
-		vector<vector<float> > tmpGammasMin(numIdxs);
-		for (int io = 0; io < numIdxs; ++io) {
-			vector<float> tmpGammaPls(numClasses);
-			vector<float> tmpGammaMin(numClasses);
-			fill(tmpGammaPls.begin(), tmpGammaPls.end(), 0.0);
-			fill(tmpGammaMin.begin(), tmpGammaMin.end(), 0.0);
-			tmpGammasPls[io] = tmpGammaPls;
-			tmpGammasMin[io] = tmpGammaMin;
-		}
-
-		// Compute the elements of the gamma plus and minus matrices
-		float entry;
-		for (int i = 0; i < numExamples; ++i) {
-			const vector<Label>& labels = _pTrainingData->getLabels(i);
-			int io = static_cast<int>(_pTrainingData->getValue(i,j));	    
-			for (int l = 0; l < numClasses; ++l) {
-				entry = labels[l].weight * labels[l].y;
-				if (entry > 0)
-					tmpGammasPls[io][l] += entry;
-				else if (entry < 0)
-					tmpGammasMin[io][l] += -entry;
-			}
-		}
+		// Compute the elements of the numIdxs x numClasses gamma plus and minus matrices
+		// (see EnumData::computeGammas)
+		EnumData::computeGammas(_pTrainingData, j, gammasPls, gammasMin);
 
 		// Initialize the u vector to random +-1
 		vector<sRates> uMu(numIdxs); // The idx-wise rates
@@ -337,12 +296,12 @@ namespace MultiBoost {
 				vMu[l].rPls = vMu[l].rMin = vMu[l].rZero = 0; 
 				for (int io = 0; io < numIdxs; ++io) {
 					if (tmpU[io] > 0) {
-						vMu[l].rPls += tmpGammasPls[io][l];
-						vMu[l].rMin += tmpGammasMin[io][l];
+						vMu[l].rPls += gammasPls[io*numClasses+l];
+						vMu[l].rMin += gammasMin[io*numClasses+l];
 					}
 					else if (tmpU[io] < 0) {
-						vMu[l].rPls += tmpGammasMin[io][l];
-						vMu[l].rMin += tmpGammasPls[io][l];
+						vMu[l].rPls += gammasMin[io*numClasses+l];
+						vMu[l].rMin += gammasPls[io*numClasses+l];
 					}
 				}
 				if (vMu[l].rPls >= vMu[l].rMin) {
@@ -375,12 +334,12 @@ namespace MultiBoost {
 				uMu[io].rPls = uMu[io].rMin = uMu[io].rZero = 0; 
 				for (int l = 0; l < numClasses; ++l) {
 					if (tmpV[l] > 0) {
-						uMu[io].rPls += tmpGammasPls[io][l];
-						uMu[io].rMin += tmpGammasMin[io][l];
+						uMu[io].rPls += gammasPls[io*numClasses+l];
+						uMu[io].rMin += gammasMin[io*numClasses+l];
 					}
 					else if (tmpV[l] < 0) {
-						uMu[io].rPls += tmpGammasMin[io][l];
-						uMu[io].rMin += tmpGammasPls[io][l];
+						uMu[io].rPls += gammasMin[io*numClasses+l];
+						uMu[io].rMin += gammasPls[io*numClasses+l];
 					}
 				}
 				if (uMu[io].rPls >= uMu[io].rMin) {
@@ -412,7 +371,15 @@ namespace MultiBoost {
 				bestEnergy = previousEnergy;
 			}
 		}
-		
+
+		// the column is given, so keep the last u and v even if no alpha was positive
+		if ( bestEnergy == numeric_limits<float>::max() ) {
+			_alpha = previousTmpAlpha;
+			_v = tmpV;
+			_u = tmpU;
+			_selectedColumn = j;
+			bestEnergy = previousEnergy;
+		}
 
 		_id = _pTrainingData->getAttributeNameMap().getNameFromIdx(_selectedColumn);
 		return bestEnergy;
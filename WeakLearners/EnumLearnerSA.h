@@ -42,6 +42,7 @@
 
 #include "FeaturewiseLearner.h"
 #include "Utils/Args.h"
+#include "IO/EnumData.h"
 
 #include <vector>
 #include <fstream>
@@ -92,6 +93,17 @@ public:
    */
    virtual BaseLearner* subCreate() { return new EnumLearnerSA(); }
 
+   /**
+   * Creates an InputData object that it is good for the
+   * weak learner. Overridden to return EnumData.
+   * \see InputData
+   * \see BaseLearner::createInputData()
+   * \see EnumData
+   * \warning The object \b must be destroyed by the caller.
+   * \date 18/10/2026
+   */
+   virtual InputData* createInputData() { return new EnumData(); }
+
    /**
    * Run the learner to build the classifier on the given data.
    * \param pData The pointer to the data.
@@ -286,6 +286,13 @@ public:
    */
    int precomputeConfigs();
 
+   /**
+   * Return the number of the pre-computed configurations.
+   * \see precomputeConfigs
+   * \date 18/10/2026
+   */
+   int getNumConfigs() const { return static_cast<int>(_precomputedConfigs.size()); }
+
    /**
    * Return the configuration on the current position of the iterator
    * over the list of pre-computed configurations.
@@ -37,6 +37,7 @@
 #include <limits>
 
 #include "IO/Serialization.h"
+#include "IO/EnumData.h"
 
 namespace MultiBoost {
 
@@ -49,7 +50,6 @@ namespace MultiBoost {
 	{
 		const int numClasses = _pTrainingData->getNumClasses();
 		const int numColumns = _pTrainingData->getNumAttributes();
-		const int numExamples = _pTrainingData->getNumExamples();
 		
 		// set the smoothing value to avoid numerical problem
 		// when theta=0.
@@ -61,6 +61,8 @@ namespace MultiBoost {
 
 		float tmpAlpha,previousTmpAlpha, previousEnergy;
 		float bestEnergy = numeric_limits<float>::max();
+		vector<float> gammasPls; // The numIdxs x numClasses gamma plus matrix, row-wise
+		vector<float> gammasMin; // The gamma minus matrix
 
 		int numOfDimensions = _maxNumOfDimensions;
 		for (int j = 0; j < numColumns; ++j)
@@ -80,31 +82,9 @@ namespace MultiBoost {
 
 				const int numIdxs = _pTrainingData->getEnumMap(j).getNumNames();
 
-				// Create and initialize the numIdxs x numClasses gamma matrix
-				vector<vector<float> > tmpGammasPls(numIdxs);
-				vector<vector<float> > tmpGammasMin(numIdxs);
-				for (int io = 0; io < numIdxs; ++io) {
-					vector<float> tmpGammaPls(numClasses);
-					vector<float> tmpGammaMin(numClasses);
-					fill(tmpGammaPls.begin(), tmpGammaPls.end(), 0.0);
-					fill(tmpGammaMin.begin(), tmpGammaMin.end(), 0.0);
-					tmpGammasPls[io] = tmpGammaPls;
-					tmpGammasMin[io] = tmpGammaMin;
-				}
-
-				// Compute the elements of the gamma plus and minus matrices
-				float entry;
-				for (int i = 0; i < numExamples; ++i) {
-					const vector<Label>& labels = _pTrainingData->getLabels(i);
-					int io = static_cast<int>(_pTrainingData->getValue(i,j));	    
-					for (int l = 0; l < numClasses; ++l) {
-						entry = labels[l].weight * labels[l].y;
-						if (entry > 0)
-							tmpGammasPls[io][l] += entry;
-						else if (entry < 0)
-							tmpGammasMin[io][l] += -entry;
-					}
-				}
+				// Compute the elements of the numIdxs x numClasses gamma plus and minus matrices
+				// (see EnumData::computeGammas)
+				EnumData::computeGammas(_pTrainingData, j, gammasPls, gammasMin);
 
 				// Initialize the u vector to random +-1
 				vector<sRates> uMu(numIdxs); // The idx-wise rates
@@ -137,12 +117,12 @@ namespace MultiBoost {
 						vMu[l].rPls = vMu[l].rMin = vMu[l].rZero = 0; 
 						for (int io = 0; io < numIdxs; ++io) {
 							if (tmpU[io] > 0) {
-								vMu[l].rPls += tmpGammasPls[io][l];
-								vMu[l].rMin += tmpGammasMin[io][l];
+								vMu[l].rPls += gammasPls[io*numClasses+l];
+								vMu[l].rMin += gammasMin[io*numClasses+l];
 							}
 							else if (tmpU[io] < 0) {
-								vMu[l].rPls += tmpGammasMin[io][l];
-								vMu[l].rMin += tmpGammasPls[io][l];
+								vMu[l].rPls += gammasMin[io*numClasses+l];
+								vMu[l].rMin += gammasPls[io*numClasses+l];
 							}
 						}
 						if (vMu[l].rPls >= vMu[l].rMin) {
@@ -175,12 +155,12 @@ namespace MultiBoost {
 						uMu[io].rPls = uMu[io].rMin = uMu[io].rZero = 0; 
 						for (int l = 0; l < numClasses; ++l) {
 							if (tmpV[l] > 0) {
-								uMu[io].rPls += tmpGammasPls[io][l];
-								uMu[io].rMin += tmpGammasMin[io][l];
+								uMu[io].rPls += gammasPls[io*numClasses+l];
+								uMu[io].rMin += gammasMin[io*numClasses+l];
 							}
 							else if (tmpV[l] < 0) {
-								uMu[io].rPls += tmpGammasMin[io][l];
-								uMu[io].rMin += tmpGammasPls[io][l];
+								uMu[io].rPls += gammasMin[io*numClasses+l];
+								uMu[io].rMin += gammasPls[io*numClasses+l];
 							}
 						}
 						if (uMu[io].rPls >= uMu[io].rMin) {
@@ -232,7 +212,6 @@ namespace MultiBoost {
 	{
 		const int numClasses = _pTrainingData->getNumClasses();
 		const int numColumns = _pTrainingData->getNumAttributes();
-		const int numExamples = _pTrainingData->getNumExamples();
 
 		// set the smoothing value to avoid numerical problem
 		// when theta=0.
@@ -244,6 +223,8 @@ namespace MultiBoost {
 
 		float tmpAlpha,previousTmpAlpha, previousEnergy;
 		float bestEnergy = numeric_limits<float>::max();
+		vector<float> gammasPls; // The numIdxs x numClasses gamma plus matrix, row-wise
+		vector<float> gammasMin; // The gamma minus matrix
 
 		int numOfDimensions = _maxNumOfDimensions;
 
@@ -258,31 +239,9 @@ namespace MultiBoost {
 
 		const int numIdxs = _pTrainingData->getEnumMap(j).getNumNames();
 
-		// Create and initialize the numIdxs x numClasses gamma matrix
-		vector<vector<float> > tmpGammasPls(numIdxs);
-		vector<vector<float> > tmpGammasMin(numIdxs);
-		for (int io = 0; io < numIdxs; ++io) {
-			vector<float> tmpGammaPls(numClasses);
-			vector<float> tmpGammaMin(numClasses);
-			fill(tmpGammaPls.begin(), tmpGammaPls.end(), 0.0);
-			fill(tmpGammaMin.begin(), tmpGammaMin.end(), 0.0);
-			tmpGammasPls[io] = tmpGammaPls;
-			tmpGammasMin[io] = tmpGammaMin;
-		}
-
-		// Compute the elements of the gamma plus and minus matrices
-		float entry;
-		for (int i = 0; i < numExamples; ++i) {
-			const vector<Label>& labels = _pTrainingData->getLabels(i);
-			int io = static_cast<int>(_pTrainingData->getValue(i,j));	    
-			for (int l = 0; l < numClasses; ++l) {
-				entry = labels[l].weight * labels[l].y;
-				if (entry > 0)
-					tmpGammasPls[io][l] += entry;
-				else if (entry < 0)
-					tmpGammasMin[io][l] += -entry;
-			}
-		}
+		// Compute the elements of the numIdxs x numClasses gamma plus and minus matrices
+		// (see EnumData::computeGammas)
+		EnumData::computeGammas(_pTrainingData, j, gammasPls, gammasMin);
 
 		// Initialize the u vector to random +-1
 		vector<sRates> uMu(numIdxs); // The idx-wise rates
@@ -315,12 +274,12 @@ namespace MultiBoost {
 				vMu[l].rPls = vMu[l].rMin = vMu[l].rZero = 0; 
 				for (int io = 0; io < numIdxs; ++io) {
 					if (tmpU[io] > 0) {
-						vMu[l].rPls += tmpGammasPls[io][l];
-						vMu[l].rMin += tmpGammasMin[io][l];
+						vMu[l].rPls += gammasPls[io*numClasses+l];
+						vMu[l].rMin += gammasMin[io*numClasses+l];
 					}
 					else if (tmpU[io] < 0) {
-						vMu[l].rPls += tmpGammasMin[io][l];
-						vMu[l].rMin += tmpGammasPls[io][l];
+						vMu[l].rPls += gammasMin[io*numClasses+l];
+						vMu[l].rMin += gammasPls[io*numClasses+l];
 					}
 				}
 				if (vMu[l].rPls >= vMu[l].rMin) {
@@ -353,12 +312,12 @@ namespace MultiBoost {
 				uMu[io].rPls = uMu[io].rMin = uMu[io].rZero = 0; 
 				for (int l = 0; l < numClasses; ++l) {
 					if (tmpV[l] > 0) {
-						uMu[io].rPls += tmpGammasPls[io][l];
-						uMu[io].rMin += tmpGammasMin[io][l];
+						uMu[io].rPls += gammasPls[io*numClasses+l];
+						uMu[io].rMin += gammasMin[io*numClasses+l];
 					}
 					else if (tmpV[l] < 0) {
-						uMu[io].rPls += tmpGammasMin[io][l];
-						uMu[io].rMin += tmpGammasPls[io][l];
+						uMu[io].rPls += gammasMin[io*numClasses+l];
+						uMu[io].rMin += gammasPls[io*numClasses+l];
 					}
 				}
 				if (uMu[io].rPls >= uMu[io].rMin) {
@@ -390,7 +349,15 @@ namespace MultiBoost {
 				bestEnergy = previousEnergy;
 			}
 		}
-		
+
+		// the column is given, so keep the last u and v even if no alpha was positive
+		if ( bestEnergy == numeric_limits<float>::max() ) {
+			_alpha = previousTmpAlpha;
+			_v = tmpV;
+			_u = tmpU;
+			_selectedColumn = j;
+			bestEnergy = previousEnergy;
+		}
 
 		_id = _pTrainingData->getAttributeNameMap().getNameFromIdx(_selectedColumn);
 		return bestEnergy;
@@ -43,6 +43,7 @@
 #include "FeaturewiseLearner.h"
 #include "ScalarLearner.h"
 #include "Utils/Args.h"
+#include "IO/EnumData.h"
 
 #include <vector>
 #include <fstream>
@@ -84,6 +85,17 @@ namespace MultiBoost {
 		 */
 		virtual BaseLearner* subCreate() { return new IndicatorLearner(); }
 		
+		/**
+		 * Creates an InputData object that it is good for the
+		 * weak learner. Overridden to return EnumData.
+		 * \see InputData
+		 * \see BaseLearner::createInputData()
+		 * \see EnumData
+		 * \warning The object \b must be destroyed by the caller.
+		 * \date 18/10/2026
+		 */
+		virtual InputData* createInputData() { return new EnumData(); }
+		
 		/**
 		 * Run the learner to build the classifier on the given data.
 		 * \param pData The pointer to the data.
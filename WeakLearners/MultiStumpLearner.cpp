@@ -115,15 +115,10 @@ namespace MultiBoost {
 			
 			if (static_cast<float> (numOfDimensions) / rest > r) {
 				--numOfDimensions;
-				const pair<vpIterator, vpIterator>
-				dataBeginEnd =
-				static_cast<SortedData*> (_pTrainingData)->getFileteredBeginEnd(j);
+				const SortedColumn column = 
+					static_cast<SortedData*> (_pTrainingData)->getFilteredColumn(j);
 				
-				const vpIterator dataBegin = dataBeginEnd.first;
-				const vpIterator dataEnd = dataBeginEnd.second;
-				
-				sAlgo.findMultiThresholdsWithInit(dataBegin, dataEnd,
-												  _pTrainingData, tmpThresholds, &mu, &tmpV);
+				sAlgo.findMultiThresholdsWithInit(column, _pTrainingData, tmpThresholds, &mu, &tmpV);
 				
 				for ( vector<sRates>::iterator itR = mu.begin(); itR != mu.end(); ++itR )
 				{
@@ -74,16 +74,10 @@ float MultiThresholdStumpLearner::run() {
 
 		if (static_cast<float> (numOfDimensions) / rest > r) {
 			--numOfDimensions;
-			const pair<vpIterator, vpIterator>
-					dataBeginEnd =
-							static_cast<SortedData*> (_pTrainingData)->getFileteredBeginEnd(
-									j);
+			const SortedColumn column = 
+				static_cast<SortedData*> (_pTrainingData)->getFilteredColumn(j);
 
-			const vpIterator dataBegin = dataBeginEnd.first;
-			const vpIterator dataEnd = dataBeginEnd.second;
-
-			sAlgo.findMultiThresholdsWithInit(dataBegin, dataEnd,
-					_pTrainingData, tmpThresholds, &mu, &tmpV);
+			sAlgo.findMultiThresholdsWithInit(column, _pTrainingData, tmpThresholds, &mu, &tmpV);
 
 			tmpEnergy = getEnergy(mu, tmpAlpha, tmpV);
 			if (tmpEnergy < bestEnergy && tmpAlpha > 0) {
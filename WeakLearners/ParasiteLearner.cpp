@@ -128,7 +128,7 @@ float ParasiteLearner::run()
 	       vector<Label> labels = _pTrainingData->getLabels(i);
 	       for (int l = 0; l < numClasses; ++l)
 		  sumGamma += labels[l].weight * 
-		     _baseLearners[j]->classify(_pTrainingData,i,l) * labels[l].y;
+		     _baseLearners[j]->classify(_pTrainingData,i,l) * _pTrainingData->getLabelY(i, labels[l]);
 	    }
 	    if (fabs(sumGamma) > fabs(bestSumGamma)) {
 	       _selectedIdx = j;
@@ -140,7 +140,7 @@ float ParasiteLearner::run()
 	    vector<Label> labels = _pTrainingData->getLabels(i);
 	    for (int l = 0; l < numClasses; ++l) {
 	       gamma = _baseLearners[_selectedIdx]->classify(_pTrainingData,i,l) *
-		  labels[l].y;
+		  _pTrainingData->getLabelY(i, labels[l]);
 	       if ( gamma > 0 )
 		  eps_pls += labels[l].weight;
 	       else if ( gamma < 0 )
@@ -162,7 +162,7 @@ float ParasiteLearner::run()
 	    for (int i = 0; i < numExamples; ++i) {
 	       vector<Label> labels = _pTrainingData->getLabels(i);
 	       for (int l = 0; l < numClasses; ++l) {
-		  gamma = _baseLearners[j]->classify(_pTrainingData,i,l) * labels[l].y;
+		  gamma = _baseLearners[j]->classify(_pTrainingData,i,l) * _pTrainingData->getLabelY(i, labels[l]);
 		  if ( gamma > 0 )
 		     eps_pls += labels[l].weight;
 		  else if ( gamma < 0 )
@@ -196,7 +196,7 @@ float ParasiteLearner::run()
 	       vector<Label> labels = _pTrainingData->getLabels(i);
 	       for (int l = 0; l < numClasses; ++l)
 		  sumGamma += labels[l].weight * 
-		     _baseLearners[j]->classify(_pTrainingData,i,l) * labels[l].y;
+		     _baseLearners[j]->classify(_pTrainingData,i,l) * _pTrainingData->getLabelY(i, labels[l]);
 	    }
 	    if (sumGamma > bestSumGamma) {
 	       _selectedIdx = j;
@@ -208,7 +208,7 @@ float ParasiteLearner::run()
 	    vector<Label> labels = _pTrainingData->getLabels(i);
 	    for (int l = 0; l < numClasses; ++l) {
 	       gamma = _baseLearners[_selectedIdx]->classify(_pTrainingData,i,l) *
-		  labels[l].y;
+		  _pTrainingData->getLabelY(i, labels[l]);
 	       if ( gamma > 0 )
 		  eps_pls += labels[l].weight;
 	       else if ( gamma < 0 )
@@ -224,7 +224,7 @@ float ParasiteLearner::run()
 	    for (int i = 0; i < numExamples; ++i) {
 	       vector<Label> labels = _pTrainingData->getLabels(i);
 	       for (int l = 0; l < numClasses; ++l) {
-		  gamma = _baseLearners[j]->classify(_pTrainingData,i,l) * labels[l].y;
+		  gamma = _baseLearners[j]->classify(_pTrainingData,i,l) * _pTrainingData->getLabelY(i, labels[l]);
 		  if ( gamma > 0 )
 		     eps_pls += labels[l].weight;
 		  else if ( gamma < 0 )
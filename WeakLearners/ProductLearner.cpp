@@ -38,6 +38,7 @@
 #include "IO/Serialization.h"
 #include "Others/Example.h"
 #include "Utils/StreamTokenizer.h"
+#include "Utils/Profiler.h" // for --profile
 
 #include <math.h>
 #include <limits>
@@ -94,25 +95,87 @@ namespace MultiBoost {
 
 	// ------------------------------------------------------------------------------
 
-	float ProductLearner::run()
+	void ProductLearner::cacheSigns(int ib)
+	{
+		const int numClasses = _pTrainingData->getNumClasses();
+		const int numExamples = _pTrainingData->getNumExamples();
+		const int numWords = ( numExamples * numClasses + 31 ) / 32;
+
+		vector<unsigned int>& negativeBits = _negativeBits[ib];
+		vector<unsigned int>& zeroBits = _zeroBits[ib];
+		negativeBits.assign( numWords, 0 );
+		zeroBits.assign( numWords, 0 );
+
+		int k = 0;
+		for (int i = 0; i < numExamples; ++i) {
+			for (int l = 0; l < numClasses; ++l, ++k) {
+				// Here we could have the option of using confidence rated setting so the
+				// real valued output of classify instead of its sign
+				const float hx = _baseLearners[ib]->classify(_pTrainingData,i,l);
+				if ( hx < 0 )
+					negativeBits[k >> 5] |= 1u << (k & 31);
+				else if ( hx == 0 )
+					zeroBits[k >> 5] |= 1u << (k & 31);
+			}
+		}
+		Profiler::count( Profiler::CN_CLASSIFY, static_cast<double>(numExamples) * numClasses );
+	}
+
+	// ------------------------------------------------------------------------------
+
+	void ProductLearner::updateLabelSigns(const vector<unsigned int>& negativeParity, 
+										  const vector<unsigned int>& zeroMask,
+										  const signed char* pPreviousSigns)
 	{
 		const int numClasses = _pTrainingData->getNumClasses();
 		const int numExamples = _pTrainingData->getNumExamples();
 
-		// Backup original labels
+		int k = 0;
 		for (int i = 0; i < numExamples; ++i) {
-			const vector<Label>& labels = _pTrainingData->getLabels(i);
-			vector<char> exampleLabels;
-			for (int l = 0; l < numClasses; ++l)
-				exampleLabels.push_back(labels[l].y);
-			_savedLabels.push_back(exampleLabels);
+			const int offset = _pTrainingData->getRawIndex(i) * numClasses;
+			signed char* signs = &_labelSigns[offset];
+			for (int l = 0; l < numClasses; ++l, ++k) {
+				const unsigned int bit = 1u << (k & 31);
+				if ( zeroMask[k >> 5] & bit )
+					signs[l] = 0;
+				else
+					signs[l] = ( negativeParity[k >> 5] & bit ) ? -1 : 1;
+				if ( pPreviousSigns )
+					signs[l] *= pPreviousSigns[offset + l];
+			}
 		}
+	}
+
+	// ------------------------------------------------------------------------------
+
+	float ProductLearner::run()
+	{
+		const int numClasses = _pTrainingData->getNumClasses();
+		const int numExamples = _pTrainingData->getNumExamples();
+		const int numWords = ( numExamples * numClasses + 31 ) / 32;
+
+		// The base learners are trained on the labels multiplied by the outputs of the 
+		// other terms. The signs are kept in an overlay, the labels are left untouched.
+		const signed char* pPreviousSigns = _pTrainingData->getLabelSigns();
+		_labelSigns.assign( _pTrainingData->getNumRawExamples() * numClasses, 1 );
+		if ( pPreviousSigns )
+			copy( pPreviousSigns, pPreviousSigns + _labelSigns.size(), _labelSigns.begin() );
+		_pTrainingData->setLabelSigns( _labelSigns.empty() ? NULL : &_labelSigns[0] );
 
 		for(int ib = 0; ib < _numBaseLearners; ++ib)
 			_baseLearners[ib]->setTrainingData(_pTrainingData);
 
+		// The product of the signs, bit-packed over the (example, class) pairs: the parity 
+		// of the negative outputs and the mask of the zero outputs (a zero is sticky, 
+		// nothing can flip it back). A term is taken off and put back with word-wide 
+		// XOR/OR on its cached signs, without classifying the data again.
+		vector<unsigned int> negativeParity( numWords, 0 );
+		vector<unsigned int> zeroMask( numWords, 0 );
+		_negativeBits.assign( _numBaseLearners, vector<unsigned int>() );
+		_zeroBits.assign( _numBaseLearners, vector<unsigned int>() );
+
 		float energy = numeric_limits<float>::max();
-		float previousEnergy, hx, previousAlpha;
+		float previousEnergy, previousAlpha;
 		BaseLearner* pPreviousBaseLearner = 0;
 
 		bool firstLoop = true;
@@ -129,28 +192,12 @@ namespace MultiBoost {
 				delete pPreviousBaseLearner;
 			if ( !firstLoop ) {
 				// take the old learner off the labels
-				for (int i = 0; i < numExamples; ++i) {
-					vector<Label>& labels = _pTrainingData->getLabels(i);
-					for (int l = 0; l < numClasses; ++l) {
-						// Here we could have the option of using confidence rated setting so the
-						// real valued output of classify instead of its sign
-						hx = _baseLearners[ib]->classify(_pTrainingData,i,l);
-						if ( hx < 0 )
-							labels[l].y *= -1;
-						else if ( hx == 0 ) { // have to redo the multiplications, haven't been tested
-							for(int ib1 = 0; ib1 < _numBaseLearners && labels[l].y != 0; ++ib1) {
-								if (ib != ib1) {
-									hx = _baseLearners[ib1]->classify(_pTrainingData,i,l);
-									if (hx < 0)
-										labels[l].y *= -1;
-									else if (hx == 0)
-										labels[l].y = 0;
-								}
-							}
-						}
-					}
-				}
+				const vector<unsigned int>& negativeBits = _negativeBits[ib];
+				for (int w = 0; w < numWords; ++w)
+					negativeParity[w] ^= negativeBits[w];
 			}
+			if ( ib > 0 || !firstLoop )
+				updateLabelSigns( negativeParity, zeroMask, pPreviousSigns );
 			pPreviousBaseLearner = _baseLearners[ib]->copyState();
 			energy = _baseLearners[ib]->run();
 			_alpha = _baseLearners[ib]->getAlpha();
@@ -158,19 +205,13 @@ namespace MultiBoost {
 				cout << "E[" << (ib+1) <<  "] = " << energy << endl << flush;
 				cout << "alpha[" << (ib+1) <<  "] = " << _alpha << endl << flush;
 			}
-			for (int i = 0; i < numExamples; ++i) {
-				vector<Label>& labels = _pTrainingData->getLabels(i);
-				for (int l = 0; l < numClasses; ++l) {
-					// Here we could have the option of using confidence rated setting so the
-					// real valued output of classify instead of its sign
-					if (labels[l].y != 0) { // perhaps replace it by nor_utils::is_zero(labels[l].y)
-						hx = _baseLearners[ib]->classify(_pTrainingData,i,l);
-						if ( hx < 0 )
-							labels[l].y *= -1;
-						else if ( hx == 0 )
-							labels[l].y = 0;
-					}
-				}
+			// put the new learner on the labels
+			cacheSigns( ib );
+			const vector<unsigned int>& negativeBits = _negativeBits[ib];
+			const vector<unsigned int>& zeroBits = _zeroBits[ib];
+			for (int w = 0; w < numWords; ++w) {
+				negativeParity[w] ^= negativeBits[w];
+				zeroMask[w] |= zeroBits[w];
 			}
 
 			// We have to do at least one full iteration. For real it's not guaranteed
@@ -200,12 +241,10 @@ namespace MultiBoost {
 			} 
 		}
 
-		// Restore original labels
-		for (int i = 0; i < numExamples; ++i) {
-			vector<Label>& labels = _pTrainingData->getLabels(i);
-			for (int l = 0; l < numClasses; ++l)
-				labels[l].y = _savedLabels[i][l];
-		}
+		// Remove the overlay
+		_pTrainingData->setLabelSigns( pPreviousSigns );
+		_negativeBits.clear();
+		_zeroBits.clear();
 
 		_id = _baseLearners[0]->getId();
 		for(int ib = 1; ib < _numBaseLearners; ++ib)
@@ -168,9 +168,36 @@ public:
 
 protected:
 
+   /**
+   * Classify the training data with the base learner \a ib and cache the signs
+   * of the outputs in _negativeBits[ib] and _zeroBits[ib].
+   * \param ib The index of the base learner.
+   * \date 18/10/2026
+   */
+   void cacheSigns(int ib);
+
+   /**
+   * Write the bit-packed product of the signs into the label overlay.
+   * \param negativeParity The bit of a pair is set if an odd number of terms are negative on it.
+   * \param zeroMask The bit of a pair is set if a term is zero on it.
+   * \param pPreviousSigns The overlay that was set before run() (NULL if none).
+   * \date 18/10/2026
+   */
+   void updateLabelSigns(const vector<unsigned int>& negativeParity, 
+                         const vector<unsigned int>& zeroMask,
+                         const signed char* pPreviousSigns);
+
    vector<BaseLearner*> _baseLearners; //!< the learners of the product
    int _numBaseLearners;
-   vector< vector<char> > _savedLabels; //!< original labels saved before run
+   vector<signed char> _labelSigns; //!< The sign overlay on the labels during run() (see InputData::setLabelSigns())
+
+   /**
+   * The signs of the outputs of the base learners on the training data during run(),
+   * one bit per (example, class) pair, 32 pairs per word: the bit of the pair
+   * (i, l) is bit (i*numClasses+l)%32 of word (i*numClasses+l)/32.
+   */
+   vector< vector<unsigned int> > _negativeBits; 
+   vector< vector<unsigned int> > _zeroBits; //!< As _negativeBits, for the zero outputs.
 
 };
 
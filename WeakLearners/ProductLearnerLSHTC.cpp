@@ -98,14 +98,13 @@ namespace MultiBoost {
 		const int numClasses = _pTrainingData->getNumClasses();
 		const int numExamples = _pTrainingData->getNumExamples();
 
-		// Backup original labels
-		for (int i = 0; i < numExamples; ++i) {
-			const vector<Label>& labels = _pTrainingData->getLabels(i);
-			vector<char> exampleLabels;
-			for (int l = 0; l < labels.size(); ++l)
-				exampleLabels.push_back(labels[l].y);
-			_savedLabels.push_back(exampleLabels);
-		}
+		// The base learners are trained on the labels multiplied by the outputs of the 
+		// other terms. The signs are kept in an overlay, the labels are left untouched.
+		const signed char* pPreviousSigns = _pTrainingData->getLabelSigns();
+		_labelSigns.assign( _pTrainingData->getNumRawExamples() * numClasses, 1 );
+		if ( pPreviousSigns )
+			copy( pPreviousSigns, pPreviousSigns + _labelSigns.size(), _labelSigns.begin() );
+		_pTrainingData->setLabelSigns( _labelSigns.empty() ? NULL : &_labelSigns[0] );
 
 		for(int ib = 0; ib < _numBaseLearners; ++ib)
 			_baseLearners[ib]->setTrainingData(_pTrainingData);
@@ -130,21 +129,22 @@ namespace MultiBoost {
 			if ( !firstLoop ) {
 				// take the old learner off the labels
 				for (int i = 0; i < numExamples; ++i) {
-					vector<Label>& labels = _pTrainingData->getLabels(i);
+					const vector<Label>& labels = _pTrainingData->getLabels(i);
+					signed char* signs = &_labelSigns[ _pTrainingData->getRawIndex(i) * numClasses ];
 					for (int l = 0; l < labels.size(); ++l) {
 						// Here we could have the option of using confidence rated setting so the
 						// real valued output of classify instead of its sign
 						hx = _baseLearners[ib]->classify(_pTrainingData,i,labels[l].idx);
 						if ( hx < 0 )
-							labels[l].y *= -1;
+							signs[labels[l].idx] *= -1;
 						else if ( hx == 0 ) { // have to redo the multiplications, haven't been tested
-							for(int ib1 = 0; ib1 < _numBaseLearners && labels[l].y != 0; ++ib1) {
+							for(int ib1 = 0; ib1 < _numBaseLearners && signs[labels[l].idx] != 0; ++ib1) {
 								if (ib != ib1) {
 									hx = _baseLearners[ib1]->classify(_pTrainingData,i,labels[l].idx);
 									if (hx < 0)
-										labels[l].y *= -1;
+										signs[labels[l].idx] *= -1;
 									else if (hx == 0)
-										labels[l].y = 0;
+										signs[labels[l].idx] = 0;
 								}
 							}
 						}
@@ -173,16 +173,17 @@ namespace MultiBoost {
 				cout << "alpha[" << (ib+1) <<  "] = " << _alpha << endl << flush;
 			}
 			for (int i = 0; i < numExamples; ++i) {
-				vector<Label>& labels = _pTrainingData->getLabels(i);
+				const vector<Label>& labels = _pTrainingData->getLabels(i);
+				signed char* signs = &_labelSigns[ _pTrainingData->getRawIndex(i) * numClasses ];
 				for (int l = 0; l < labels.size(); ++l) {
 					// Here we could have the option of using confidence rated setting so the
 					// real valued output of classify instead of its sign
-					if (labels[l].y != 0) { // perhaps replace it by nor_utils::is_zero(labels[l].y)
+					if (signs[labels[l].idx] != 0) {
 						hx = _baseLearners[ib]->classify(_pTrainingData,i,labels[l].idx);
 						if ( hx < 0 )
-							labels[l].y *= -1;
+							signs[labels[l].idx] *= -1;
 						else if ( hx == 0 )
-							labels[l].y = 0;
+							signs[labels[l].idx] = 0;
 					}
 				}
 			}
@@ -214,12 +215,8 @@ namespace MultiBoost {
 			} 
 		}
 
-		// Restore original labels
-		for (int i = 0; i < numExamples; ++i) {
-			vector<Label>& labels = _pTrainingData->getLabels(i);
-			for (int l = 0; l < labels.size(); ++l)
-				labels[l].y = _savedLabels[i][l];
-		}
+		// Remove the overlay
+		_pTrainingData->setLabelSigns( pPreviousSigns );
 
 		_id = _baseLearners[0]->getId();
 		for(int ib = 1; ib < _numBaseLearners; ++ib)
@@ -172,7 +172,7 @@ protected:
    int _numBaseLearners;
 
 private:
-   vector< vector<char> > _savedLabels; //!< original labels saved before run
+   vector<signed char> _labelSigns; //!< The sign overlay on the labels during run() (see InputData::setLabelSigns())
 
 };
 
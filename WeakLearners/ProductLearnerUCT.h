@@ -170,14 +170,8 @@ namespace MultiBoost {
 		*/
 		virtual void subCopyState(BaseLearner *pBaseLearner);
 
-		virtual void createUCTTree() {
-			const int numColumns = _pTrainingData->getNumAttributes();
-
-			_root.createRecursiveUCTTree( _numBaseLearners, numColumns );
-		}
-
 		virtual void clearUCTTree() {
-			_root.clearRecursiveUCTTree( );
+			_root.setChildrenNum();
 		}
 		//virtual double getEdge();
 
@@ -189,7 +183,7 @@ namespace MultiBoost {
 		static InnerNodeUCTSparse	_root;
 		enum updateType _updateRule;
 	private:
-		vector< vector<char> > _savedLabels; //!< original labels saved before run
+		vector<signed char> _labelSigns; //!< The sign overlay on the labels during run() (see InputData::setLabelSigns())
 		
 	};
 
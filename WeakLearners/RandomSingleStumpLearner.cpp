@@ -85,15 +85,11 @@ void RandomSingleStumpLearner::init() {
 
    for (int j = 0; j < numColumns; ++j)
    {
-     const pair<vpIterator,vpIterator> dataBeginEnd = 
-		 static_cast<SortedData*>(_pTrainingData)->getFileteredBeginEnd(j);
-	 
-
-     const vpIterator dataBegin = dataBeginEnd.first;
-     const vpIterator dataEnd = dataBeginEnd.second;
+     const SortedColumn column = 
+     	static_cast<SortedData*>(_pTrainingData)->getFilteredColumn(j);
 
      // also sets mu, tmpV, and bestHalfEdge
-     tmpThreshold = sAlgo.findSingleThresholdWithInit(dataBegin, dataEnd, _pTrainingData, 
+     tmpThreshold = sAlgo.findSingleThresholdWithInit(column, _pTrainingData, 
                                                       halfTheta, &mu, &tmpV);
 
      if (tmpThreshold == tmpThreshold) // tricky way to test Nan
@@ -145,15 +141,11 @@ float RandomSingleStumpLearner::run()
    float r = rand()/static_cast<float>(RAND_MAX);
    int RandomcolumnIndex = (int) (r * ( numColumns - 1 ));
 
-     const pair<vpIterator,vpIterator> dataBeginEnd = 
-		 static_cast<SortedData*>(_pTrainingData)->getFileteredBeginEnd(RandomcolumnIndex);
-	 
-
-     const vpIterator dataBegin = dataBeginEnd.first;
-     const vpIterator dataEnd = dataBeginEnd.second;
+     const SortedColumn column = 
+     	static_cast<SortedData*>(_pTrainingData)->getFilteredColumn(RandomcolumnIndex);
 
      // also sets mu, tmpV, and bestHalfEdge
-     tmpThreshold = sAlgo.findSingleThresholdWithInit(dataBegin, dataEnd, _pTrainingData, 
+     tmpThreshold = sAlgo.findSingleThresholdWithInit(column, _pTrainingData, 
                                                       halfTheta, &mu, &tmpV);
 
     // small inconsistency compared to the standard algo (but a good
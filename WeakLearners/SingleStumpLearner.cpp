@@ -89,17 +89,13 @@ namespace MultiBoost {
 				--numOfDimensions;
 				//if ( static_cast<SortedData*>(_pTrainingData)->isAttributeEmpty( j ) ) continue;
 
-				const pair<vpIterator,vpIterator> dataBeginEnd = 
-					static_cast<SortedData*>(_pTrainingData)->getFileteredBeginEnd(j);
-
-
-				const vpIterator dataBegin = dataBeginEnd.first;
-				const vpIterator dataEnd = dataBeginEnd.second;
+				const SortedColumn column = 
+					static_cast<SortedData*>(_pTrainingData)->getFilteredColumn(j);
 
 
 
 				// also sets mu, tmpV, and bestHalfEdge
-				tmpThreshold = sAlgo.findSingleThresholdWithInit(dataBegin, dataEnd, _pTrainingData, 
+				tmpThreshold = sAlgo.findSingleThresholdWithInit(column, _pTrainingData, 
 					halfTheta, &mu, &tmpV);
 
 				if (tmpThreshold == tmpThreshold) // tricky way to test Nan
@@ -173,15 +169,11 @@ namespace MultiBoost {
 		int numOfDimensions = _maxNumOfDimensions;
 
 
-		const pair<vpIterator,vpIterator> dataBeginEnd = 
-			static_cast<SortedData*>(_pTrainingData)->getFileteredBeginEnd( colIdx );
-
-
-		const vpIterator dataBegin = dataBeginEnd.first;
-		const vpIterator dataEnd = dataBeginEnd.second;
+		const SortedColumn column = 
+			static_cast<SortedData*>(_pTrainingData)->getFilteredColumn(colIdx);
 
 		// also sets mu, tmpV, and bestHalfEdge
-		_threshold = sAlgo.findSingleThresholdWithInit(dataBegin, dataEnd, _pTrainingData, 
+		_threshold = sAlgo.findSingleThresholdWithInit(column, _pTrainingData, 
 			halfTheta, &mu, &tmpV);
 
 		bestEnergy = getEnergy(mu, tmpAlpha, tmpV);
@@ -234,17 +226,13 @@ namespace MultiBoost {
 		int numOfDimensions = _maxNumOfDimensions;
 		for (int j = 0; j < (int)colIndexes.size(); ++j)
 		{
-			const pair<vpIterator,vpIterator> dataBeginEnd = 
-				static_cast<SortedData*>(_pTrainingData)->getFileteredBeginEnd(colIndexes[j]);
-
-
-			const vpIterator dataBegin = dataBeginEnd.first;
-			const vpIterator dataEnd = dataBeginEnd.second;
+			const SortedColumn column = 
+				static_cast<SortedData*>(_pTrainingData)->getFilteredColumn(colIndexes[j]);
 
 
 
 			// also sets mu, tmpV, and bestHalfEdge
-			tmpThreshold = sAlgo.findSingleThresholdWithInit(dataBegin, dataEnd, _pTrainingData, 
+			tmpThreshold = sAlgo.findSingleThresholdWithInit(column, _pTrainingData, 
 				halfTheta, &mu, &tmpV);
 
 			if (tmpThreshold == tmpThreshold) // tricky way to test Nan
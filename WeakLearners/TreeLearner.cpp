@@ -61,6 +61,11 @@ namespace MultiBoost {
 							 "  Don't forget to add its parameters\n",
 							 2, "<baseLearnerType> <numBaseLearners>");
 		
+		args.declareArgument("treethreads", 
+							 "The number of threads training the children of the nodes\n"
+							 "  concurrently (default: 1). The instances of the base learner\n"
+							 "  must not share any state (e.g. SingleStumpLearner)\n",
+							 1, "<numThreads>");
 	}
 	
 	// ------------------------------------------------------------------------------
@@ -89,6 +94,13 @@ namespace MultiBoost {
 		
 		pWeakHypothesisSource->initLearningOptions(args);
 		
+		if ( args.hasArgument("treethreads") )
+			args.getValue("treethreads", 0, _numThreads);
+#ifndef _OPENMP
+		if ( _numThreads > 1 && _verbose > 0 )
+			cerr << "Warning: compiled without OpenMP, the children of the nodes are trained sequentially." << endl;
+#endif
+		
 		for( int ib = 0; ib < _numBaseLearners; ++ib ) {
 			_baseLearners.push_back(dynamic_cast<ScalarLearner*>(pWeakHypothesisSource->create()));
 			dynamic_cast<BaseLearner*>(_baseLearners[ib])->initLearningOptions(args);
@@ -135,7 +147,6 @@ namespace MultiBoost {
 		float edge = numeric_limits<float>::max();
 		
 		ScalarLearner* pPreviousBaseLearner = 0;
-		set< int > tmpIdx, idxPos, idxNeg, origIdx;
 		//floatBaseLearner tmpPair, tmpPairPos, tmpPairNeg;
 		
 		// for storing the inner point (learneres) which will be extended
@@ -152,9 +163,8 @@ namespace MultiBoost {
 			return numeric_limits<float>::signaling_NaN();
 		}
 		
-		//_pTrainingData->clearIndexSet();
-		//for( int i = 0; i < _pTrainingData->getNumExamples(); i++ ) tmpIdx.insert( i );
-		_pTrainingData->getIndexSet( origIdx );
+		// the nodes are grown by partitioning the current index set
+		const int rootNodeIdx = _pTrainingData->beginPartition();
 		
 		//this contains the current number of baselearners 
 		int ib = 0;
@@ -166,8 +176,8 @@ namespace MultiBoost {
 		tmpNodePoint._edge = pPreviousBaseLearner->getEdge( false );
 		tmpNodePoint._learner = pPreviousBaseLearner;
 		tmpNodePoint._idx = 0;
-		tmpNodePoint._learnerIdxSet = origIdx;
-		calculateChildrenAndEnergies( tmpNodePoint );
+		tmpNodePoint._learnerNodeIdx = rootNodeIdx;
+		calculateChildrenAndEnergies( vector<NodePoint*>( 1, &tmpNodePoint ) );
 		
 		////////////////////////////////////////////////////////
 		
@@ -218,12 +228,12 @@ namespace MultiBoost {
 			
 			nodeLeft._edge = tmpNodePoint._leftEdge;
 			nodeLeft._learner = tmpNodePoint._leftChild;
-			nodeLeft._learnerIdxSet = tmpNodePoint._leftChildIdxSet;
+			nodeLeft._learnerNodeIdx = tmpNodePoint._leftChildNodeIdx;
 			
 			
 			nodeRight._edge = tmpNodePoint._rightEdge;
 			nodeRight._learner = tmpNodePoint._rightChild;
-			nodeRight._learnerIdxSet = tmpNodePoint._rightChildIdxSet;
+			nodeRight._learnerNodeIdx = tmpNodePoint._rightChildNodeIdx;
 			
 			
 			//store the baselearner if the delta enrgy will be higher
@@ -251,16 +261,21 @@ namespace MultiBoost {
 			
 			
 			
-			//extend positive node
+			//extend the positive and the negative nodes together
+			vector<NodePoint*> nodesToExtend;
 			if ( nodeLeft._learner ) {
-				calculateChildrenAndEnergies( nodeLeft );
+				nodesToExtend.push_back( &nodeLeft );
 			} else {
 				nodeLeft._extended = false;
 			}
+			if ( nodeRight._learner ) {
+				nodesToExtend.push_back( &nodeRight );
+			} else {
+				nodeRight._extended = false;
+			}
+			calculateChildrenAndEnergies( nodesToExtend );
 			
 			
-			//calculateChildrenAndEnergies( nodeLeft );
-			
 			// if the energy is getting higher then we push it into the priority queue
 			if ( nodeLeft._extended ) 
 			{
@@ -283,6 +298,12 @@ namespace MultiBoost {
 					
 					if ( ib >= _numBaseLearners ) {
 						delete nodeLeft._learner;
+						// the right node has been split and trained along with the left one
+						if ( nodeRight._extended ) {
+							delete nodeRight._leftChild;
+							delete nodeRight._rightChild;
+						}
+						delete nodeRight._learner;
 						break;
 					} else {
 						//this will be a leaf, we do not extend further
@@ -298,12 +319,7 @@ namespace MultiBoost {
 			
 			
 			
-			//extend negative node
-			if ( nodeRight._learner ) {
-				calculateChildrenAndEnergies( nodeRight );
-			} else {
-				nodeRight._extended = false;
-			}
+			//the negative node
 			
 			
 			
@@ -373,15 +389,14 @@ namespace MultiBoost {
 		this->_alpha = 0.0;
 		float eps_min = 0.0, eps_pls = 0.0;
 		
-		//_pTrainingData->clearIndexSet();
-		_pTrainingData->loadIndexSet( origIdx );
+		_pTrainingData->endPartition();
 		for( int i = 0; i < _pTrainingData->getNumExamples(); i++ ) {
 			vector< Label> l = _pTrainingData->getLabels( i );
 			for( vector< Label >::iterator it = l.begin(); it != l.end(); it++ ) {
 				float result  = this->classify( _pTrainingData, i, it->idx );
 				
-				if ( ( result * it->y ) < 0 ) eps_min += it->weight;
-				if ( ( result * it->y ) > 0 ) eps_pls += it->weight;
+				if ( ( result * _pTrainingData->getLabelY( i, *it ) ) < 0 ) eps_min += it->weight;
+				if ( ( result * _pTrainingData->getLabelY( i, *it ) ) > 0 ) eps_pls += it->weight;
 			}
 			
 		}
@@ -400,98 +415,117 @@ namespace MultiBoost {
 	}
 	// -----------------------------------------------------------------------
 	
-	void TreeLearner::calculateChildrenAndEnergies( NodePoint& bLearner ) {
+	void TreeLearner::calculateChildrenAndEnergies( const vector<NodePoint*>& nodes ) {
+		const int numNodes = static_cast<int>( nodes.size() );
+		const int numChildren = 2 * numNodes;
+		
+		// the splits modify the partition, so they are done first, one at a time
+		vector<int> childNodeIdxs( numChildren );
+		for( int n = 0; n < numNodes; ++n )
+			splitNode( *nodes[n], childNodeIdxs[2*n], childNodeIdxs[2*n+1] );
+		
+		vector<ScalarLearner*> children( numChildren );
+		vector<float> edges( numChildren );
+		
+		// with threads, each child gets its own view on the partition
+		vector<InputData*> views;
+		if ( _numThreads > 1 && numChildren > 1 ) {
+			for( int c = 0; c < numChildren; ++c ) {
+				InputData* pView = _pTrainingData->createPartitionView( childNodeIdxs[c] );
+				if ( ! pView ) break; // this type of data has no views
+				views.push_back( pView );
+			}
+		}
+		
+		if ( static_cast<int>( views.size() ) == numChildren ) {
+#pragma omp parallel for num_threads(_numThreads) schedule(dynamic) copyin(BaseLearner::_smoothingVal)
+			for( int c = 0; c < numChildren; ++c )
+				children[c] = trainChild( views[c], edges[c] );
+			
+			for( int c = 0; c < numChildren; ++c ) {
+				children[c]->setTrainingData( _pTrainingData );
+				delete views[c];
+			}
+		} else {
+			for( int c = 0; c < static_cast<int>( views.size() ); ++c )
+				delete views[c];
+			
+			for( int c = 0; c < numChildren; ++c ) {
+				_pTrainingData->selectPartitionNode( childNodeIdxs[c] );
+				children[c] = trainChild( _pTrainingData, edges[c] );
+			}
+		}
+		
+		for( int n = 0; n < numNodes; ++n ) {
+			NodePoint& bLearner = *nodes[n];
+			bLearner._leftChild = children[2*n];
+			bLearner._leftEdge = edges[2*n];
+			bLearner._leftChildNodeIdx = childNodeIdxs[2*n];
+			bLearner._rightChild = children[2*n+1];
+			bLearner._rightEdge = edges[2*n+1];
+			bLearner._rightChildNodeIdx = childNodeIdxs[2*n+1];
+		}
+	}
+	
+	// -----------------------------------------------------------------------
+	
+	void TreeLearner::splitNode( NodePoint& bLearner, int& posNodeIdx, int& negNodeIdx ) {
 		bLearner._extended = true;
-		_pTrainingData->loadIndexSet( bLearner._learnerIdxSet );
+		_pTrainingData->selectPartitionNode( bLearner._learnerNodeIdx );
 		
 		//separate the dataset
-		set< int > idxPos, idxNeg;
-		idxPos.clear();
-		idxNeg.clear();
+		const int numExamples = _pTrainingData->getNumExamples();
+		vector<signed char> sides( numExamples, 0 );
+		int numPos = 0, numNeg = 0;
 		float phix;
-		float energy;
 		
-		for (int i = 0; i < _pTrainingData->getNumExamples(); ++i) {
+		for (int i = 0; i < numExamples; ++i) {
 			// this returns the phi value of classifier
 			phix = bLearner._learner->cut(_pTrainingData,i);
-			if ( phix <  0 )
-				idxNeg.insert( _pTrainingData->getRawIndex( i ) );
+			if ( phix <  0 ) {
+				sides[i] = -1;
+				++numNeg;
+			}
 			else if ( phix > 0 ) { // have to redo the multiplications, haven't been tested
-				idxPos.insert( _pTrainingData->getRawIndex( i ) );
+				sides[i] = +1;
+				++numPos;
 			}
 		}
 		
-		if ( (idxPos.size() < 1 ) || (idxNeg.size() < 1 ) ) {
+		if ( (numPos < 1 ) || (numNeg < 1 ) ) {
 			bLearner._extended = false;
 		}
 		
-		_pTrainingData->loadIndexSet( idxPos );
-		energy = numeric_limits<float>::signaling_NaN();	
+		_pTrainingData->splitPartitionNode( bLearner._learnerNodeIdx, sides, posNodeIdx, negNodeIdx );
+	}
+	
+	// -----------------------------------------------------------------------
+	
+	ScalarLearner* TreeLearner::trainChild( InputData* pData, float& edge ) {
+		float energy = numeric_limits<float>::signaling_NaN();
 		
-		if ( ! _pTrainingData->isSamplesFromOneClass() ) {
-			ScalarLearner* posLearner = dynamic_cast<ScalarLearner*>(_baseLearners[0]->copyState());
+		if ( ! pData->isSamplesFromOneClass() ) {
+			ScalarLearner* pChild = dynamic_cast<ScalarLearner*>(_baseLearners[0]->copyState());
+			pChild->setTrainingData( pData );
 			
-			energy = posLearner->run();
+			energy = pChild->run();
 			if ( energy == energy ) {
-				bLearner._leftEdge = posLearner->getEdge( false );
-				
-				bLearner._leftChild = posLearner;
-				bLearner._leftChildIdxSet = idxPos;
-			} else {
-				delete posLearner;
+				edge = pChild->getEdge( false );
+				return pChild;
 			}
+			delete pChild;
 		}
 		
-		if ( energy != energy ) { //we don't find column, this case can occur when we have sparse data
-			BaseLearner* pConstantWeakHypothesisSource =
-			BaseLearner::RegisteredLearners().getLearner("ConstantLearner");
-			
-			BaseLearner* posLearner = pConstantWeakHypothesisSource->create();
-			posLearner->setTrainingData(_pTrainingData);
-			float constantEnergy = posLearner->run();
-			
-			bLearner._leftEdge = posLearner->getEdge( false );
-			bLearner._leftChild = dynamic_cast<ScalarLearner*>(posLearner);
-			bLearner._leftChildIdxSet = idxPos;
-		}
-		
-		
-		
-		_pTrainingData->loadIndexSet( idxNeg );
-		energy = numeric_limits<float>::signaling_NaN();
-		
+		//we don't find column, this case can occur when we have sparse data
+		BaseLearner* pConstantWeakHypothesisSource =
+		BaseLearner::RegisteredLearners().getLearner("ConstantLearner");
 		
+		BaseLearner* pChild = pConstantWeakHypothesisSource->create();
+		pChild->setTrainingData( pData );
+		pChild->run();
 		
-		if ( ! _pTrainingData->isSamplesFromOneClass() ) {
-			BaseLearner* negLearner = _baseLearners[0]->copyState();
-			
-			
-			energy = negLearner->run();
-			if ( energy == energy ) 
-			{
-				bLearner._rightEdge = negLearner->getEdge( false );
-				bLearner._rightChild = dynamic_cast<ScalarLearner*>(negLearner);
-				bLearner._rightChildIdxSet = idxNeg;
-			} else {
-				delete negLearner;
-			}
-		}
-		
-		if ( energy != energy ) 
-		{
-			BaseLearner* pConstantWeakHypothesisSource =
-			BaseLearner::RegisteredLearners().getLearner("ConstantLearner");
-			
-			BaseLearner* negLearner =  pConstantWeakHypothesisSource->create();
-			negLearner->setTrainingData(_pTrainingData);
-			float constantEnergy = negLearner->run();
-			
-			bLearner._rightEdge = negLearner->getEdge( false );
-			bLearner._rightChild = dynamic_cast<ScalarLearner*>(negLearner);
-			
-			bLearner._rightChildIdxSet = idxNeg;
-		}
-		
+		edge = pChild->getEdge( false );
+		return dynamic_cast<ScalarLearner*>(pChild);
 	}
 	
 	
@@ -559,6 +593,7 @@ namespace MultiBoost {
 		dynamic_cast<TreeLearner*>(pBaseLearner);
 		
 		pTreeLearner->_numBaseLearners = _numBaseLearners;
+		pTreeLearner->_numThreads = _numThreads;
 		
 		// deep copy
 		for(int ib = 0; ib < _numBaseLearners; ++ib)
@@ -84,9 +84,10 @@ struct NodePoint {
 	ScalarLearner* _rightChild;
 	ScalarLearner* _leftChild;
 	
-	set< int >   _rightChildIdxSet;
-	set< int >   _leftChildIdxSet;
-	set< int >   _learnerIdxSet;
+	// the nodes of the partition of the training data (see InputData::beginPartition())
+	int			_rightChildNodeIdx;
+	int			_leftChildNodeIdx;
+	int			_learnerNodeIdx;
 
 	float		_rightEdge;
 	float		_leftEdge;
@@ -114,7 +115,7 @@ public:
    * The constructor. It initializes _numBaseLearners to -1
    * \date 26/05/2007
    */
-   TreeLearner() : _numBaseLearners(-1) { }
+   TreeLearner() : _numBaseLearners(-1), _numThreads(1) { }
 
    /**
    * The destructor. Must be declared (virtual) for the proper destruction of 
@@ -217,7 +218,34 @@ public:
    }
 
 protected:
-   void calculateChildrenAndEnergies( NodePoint& bLearner );
+   /**
+   * Split the given nodes and train the two children of each of them.
+   * The splits are done one after the other, then the children are trained
+   * concurrently (with --treethreads), each on its own view of the partition.
+   * \param nodes The nodes to be extended.
+   * \see InputData::createPartitionView
+   * \date 18/10/2026
+   */
+   void calculateChildrenAndEnergies( const vector<NodePoint*>& nodes );
+
+   /**
+   * Split the examples of a node with its learner.
+   * \param bLearner The node.
+   * \param posNodeIdx The returned partition node of the positive side.
+   * \param negNodeIdx The returned partition node of the negative side.
+   * \date 18/10/2026
+   */
+   void splitNode( NodePoint& bLearner, int& posNodeIdx, int& negNodeIdx );
+
+   /**
+   * Train a child on the given data: a copy of the base learner, or a 
+   * ConstantLearner if it fails (or the data is from a single class).
+   * \param pData The examples of the child.
+   * \param edge The returned edge of the child.
+   * \return The trained child.
+   * \date 18/10/2026
+   */
+   ScalarLearner* trainChild( InputData* pData, float& edge );
 
 
 
@@ -227,6 +255,7 @@ protected:
    */
    vector< vector<int> > _idxPairs; 
    int _numBaseLearners;
+   int _numThreads; //!< The number of threads training the children of the nodes.
    
    //float getEdge( BaseLearner* learner, InputData* d );
 private:
@@ -39,6 +39,7 @@
 #include "Others/Example.h"
 #include "Utils/StreamTokenizer.h"
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
 #include <queue>
@@ -69,6 +70,8 @@ namespace MultiBoost {
 			"  Default is the first one\n",
 			1, "<type>");
 
+		// --treethreads is declared by TreeLearner
+
 	}
 
 	// ------------------------------------------------------------------------------
@@ -108,6 +111,13 @@ namespace MultiBoost {
 			_updateRule = EDGE_SQUARE;
 		}
 
+		if ( args.hasArgument("treethreads") )
+			args.getValue("treethreads", 0, _numThreads);
+#ifndef _OPENMP
+		if ( _numThreads > 1 && _verbose > 0 )
+			cerr << "Warning: compiled without OpenMP, the children of the nodes are trained sequentially." << endl;
+#endif
+
 	}
 
 	// ------------------------------------------------------------------------------
@@ -147,19 +157,22 @@ namespace MultiBoost {
 			InnerNodeUCTSparse::setDepth( _numBaseLearners );
 			InnerNodeUCTSparse::setBranchOrder( _pTrainingData->getNumAttributes() );
 			_root.setChildrenNum();
-			//createUCTTree();
 		}
 		_numOfCalling++;
 
-		set< int > tmpIdx, idxPos, idxNeg;
-		
 		_pTrainingData->clearIndexSet();
-		for( int i = 0; i < _pTrainingData->getNumExamples(); i++ ) tmpIdx.insert( i );
+		// the nodes are grown by partitioning the dataset
+		const int rootNodeIdx = _pTrainingData->beginPartition();
 
 
 		vector< int > trajectory(0);
 		_root.getBestTrajectory( trajectory );
 
+		if (_verbose > 2) {
+			cout << "UCT tree: " << _root.getNumNodes() << " nodes, " 
+				 << _root.getMemoryUsage() / 1024 << " KB" << endl;
+		}
+
 		// for UCT
 
 		for(int ib = 0; ib < _numBaseLearners; ++ib)
@@ -172,8 +185,8 @@ namespace MultiBoost {
 
 		// for storing the inner point (learneres) which will be extended
 		//vector< floatBaseLearner > bLearnerVector;
-		floatInnerNode innerNode;
-		priority_queue<floatInnerNode, deque<floatInnerNode>, greater_first<floatInnerNode> > pq;
+		floatInnerNodeUCT innerNode;
+		priority_queue<floatInnerNodeUCT, deque<floatInnerNodeUCT>, greater_first<floatInnerNodeUCT> > pq;
 
 
 
@@ -186,7 +199,7 @@ namespace MultiBoost {
 		//this contains the number of baselearners 
 		int ib = 0;
 
-		NodePoint tmpNodePoint, nodeLeft, nodeRight;
+		NodePointUCT tmpNodePoint, nodeLeft, nodeRight;
 
 		////////////////////////////////////////////////////////
 		//set the edge
@@ -208,8 +221,8 @@ namespace MultiBoost {
 		tmpNodePoint._learner = pPreviousBaseLearner;
 		tmpNodePoint._idx = 0;
 		tmpNodePoint._depth = 0;
-		tmpNodePoint._learnerIdxSet = tmpIdx;
-		calculateChildrenAndEnergies( tmpNodePoint, trajectory[1] );
+		tmpNodePoint._learnerNodeIdx = rootNodeIdx;
+		calculateChildrenAndEnergies( vector<NodePointUCT*>( 1, &tmpNodePoint ), trajectory );
 
 		////////////////////////////////////////////////////////
 
@@ -269,12 +282,12 @@ namespace MultiBoost {
 
 			nodeLeft._edge = tmpNodePoint._leftEdge;
 			nodeLeft._learner = tmpNodePoint._leftChild;
-			nodeLeft._learnerIdxSet = tmpNodePoint._leftChildIdxSet;
+			nodeLeft._learnerNodeIdx = tmpNodePoint._leftChildNodeIdx;
 
 
 			nodeRight._edge = tmpNodePoint._rightEdge;
 			nodeRight._learner = tmpNodePoint._rightChild;
-			nodeRight._learnerIdxSet = tmpNodePoint._rightChildIdxSet;
+			nodeRight._learnerNodeIdx = tmpNodePoint._rightChildNodeIdx;
 
 
 			//store the baselearner if the deltaenrgy will be higher
@@ -305,12 +318,19 @@ namespace MultiBoost {
 
 
 			
-			//extend positive node
+			//extend the positive and the negative nodes together
+			vector<NodePointUCT*> nodesToExtend;
 			if ( nodeLeft._learner ) {
-				calculateChildrenAndEnergies( nodeLeft, trajectory[ nodeLeft._depth + 1 ] );
+				nodesToExtend.push_back( &nodeLeft );
 			} else {
 				nodeLeft._extended = false;
 			}
+			if ( nodeRight._learner ) {
+				nodesToExtend.push_back( &nodeRight );
+			} else {
+				nodeRight._extended = false;
+			}
+			calculateChildrenAndEnergies( nodesToExtend, trajectory );
 			
 
 			//calculateChildrenAndEnergies( nodeLeft );
@@ -337,6 +357,12 @@ namespace MultiBoost {
 				
 					if ( ib >= _numBaseLearners ) {
 						delete nodeLeft._learner;
+						// the right node has been split and trained along with the left one
+						if ( nodeRight._extended ) {
+							delete nodeRight._leftChild;
+							delete nodeRight._rightChild;
+						}
+						delete nodeRight._learner;
 						break;
 					} else {
 						//this will be a leaf, we do not extend further
@@ -352,12 +378,7 @@ namespace MultiBoost {
 
 
 
-			//extend negative node
-			if ( nodeRight._learner ) {
-				calculateChildrenAndEnergies( nodeRight, trajectory[ nodeRight._depth + 1 ] );
-			} else {
-				nodeRight._extended = false;
-			}
+			//the negative node
 
 
 
@@ -427,14 +448,14 @@ namespace MultiBoost {
 		this->_alpha = 0.0;
 		float eps_min = 0.0, eps_pls = 0.0;
 
-		_pTrainingData->clearIndexSet();
+		_pTrainingData->endPartition();
 		for( int i = 0; i < _pTrainingData->getNumExamples(); i++ ) {
 			vector< Label> l = _pTrainingData->getLabels( i );
 			for( vector< Label >::iterator it = l.begin(); it != l.end(); it++ ) {
 				float result  = this->classify( _pTrainingData, i, it->idx );
 
-				if ( ( result * it->y ) < 0 ) eps_min += it->weight;
-				if ( ( result * it->y ) > 0 ) eps_pls += it->weight;
+				if ( ( result * _pTrainingData->getLabelY( i, *it ) ) < 0 ) eps_min += it->weight;
+				if ( ( result * _pTrainingData->getLabelY( i, *it ) ) > 0 ) eps_pls += it->weight;
 			}
 
 		}
@@ -478,125 +499,115 @@ namespace MultiBoost {
 // -----------------------------------------------------------------------
 
 
-void TreeLearnerUCT::calculateChildrenAndEnergies( NodePoint& bLearner, int depthIndex ) {
-	bLearner._extended = true;
-	_pTrainingData->loadIndexSet( bLearner._learnerIdxSet );
-	
-	//separate the dataset
-	set< int > idxPos, idxNeg;
-	idxPos.clear();
-	idxNeg.clear();
-	float phix;
-
-	for (int i = 0; i < _pTrainingData->getNumExamples(); ++i) {
-		// this returns the phi value of classifier
-		phix = bLearner._learner->classify(_pTrainingData,i,0);
-		if ( phix <  0 )
-			idxNeg.insert( _pTrainingData->getRawIndex( i ) );
-		else if ( phix > 0 ) { // have to redo the multiplications, haven't been tested
-			idxPos.insert( _pTrainingData->getRawIndex( i ) );
+void TreeLearnerUCT::calculateChildrenAndEnergies( const vector<NodePointUCT*>& nodes, const vector<int>& trajectory ) {
+	const int numNodes = static_cast<int>( nodes.size() );
+	const int numChildren = 2 * numNodes;
+
+	// the splits modify the partition, so they are done first, one at a time
+	vector<int> childNodeIdxs( numChildren );
+	vector<int> colIdxs( numChildren );
+	for( int n = 0; n < numNodes; ++n ) {
+		NodePointUCT& bLearner = *nodes[n];
+		bLearner._extended = true;
+		_pTrainingData->selectPartitionNode( bLearner._learnerNodeIdx );
+
+		//separate the dataset
+		const int numExamples = _pTrainingData->getNumExamples();
+		vector<signed char> sides( numExamples, 0 );
+		int numPos = 0, numNeg = 0;
+		float phix;
+
+		for (int i = 0; i < numExamples; ++i) {
+			// this returns the phi value of classifier
+			phix = bLearner._learner->classify(_pTrainingData,i,0);
+			if ( phix <  0 ) {
+				sides[i] = -1;
+				++numNeg;
+			}
+			else if ( phix > 0 ) { // have to redo the multiplications, haven't been tested
+				sides[i] = +1;
+				++numPos;
+			}
 		}
+
+		if ( (numPos < 1 ) || (numNeg < 1 ) ) {
+			bLearner._extended = false;
+		}
+
+		_pTrainingData->splitPartitionNode( bLearner._learnerNodeIdx, sides, 
+											childNodeIdxs[2*n], childNodeIdxs[2*n+1] );
+		// the children of the deepest nodes are only trained for the delta of the edge,
+		// they reuse the last arm
+		const int arm = min( bLearner._depth + 1, (int)trajectory.size() - 1 );
+		colIdxs[2*n] = colIdxs[2*n+1] = trajectory[ arm ];
 	}
 
-	if ( (idxPos.size() < 1 ) || (idxNeg.size() < 1 ) ) {
-		//retval.clear();
-		bLearner._extended = false;
-		//return retval;
+	vector<BaseLearner*> children( numChildren );
+	vector<float> edges( numChildren );
+
+	// with threads, each child gets its own view on the partition
+	vector<InputData*> views;
+	if ( _numThreads > 1 && numChildren > 1 ) {
+		for( int c = 0; c < numChildren; ++c ) {
+			InputData* pView = _pTrainingData->createPartitionView( childNodeIdxs[c] );
+			if ( ! pView ) break; // this type of data has no views
+			views.push_back( pView );
+		}
 	}
-	
-	_pTrainingData->loadIndexSet( idxPos );
-	
-	if ( ! _pTrainingData->isSamplesFromOneClass() ) {
-		BaseLearner* posLearner = _baseLearners[0]->copyState();
-
-		//posLearner->run();
-		dynamic_cast<FeaturewiseLearner*>(posLearner)->run( depthIndex );
-		//
-		//float posEdge = getEdge( posLearner, _pTrainingData );
-		posLearner->setTrainingData( _pTrainingData );
-		bLearner._leftEdge = posLearner->getEdge();
-
-		//tmpPair.first = posEdge;
-		//tmpPair.second.first.first = posLearner;
-		bLearner._leftChild = posLearner;
-		//set the parent idx to zero
-		//tmpPair.second.first.second.first = 0;
-		//this means that it will be a left child in the tree
-		//tmpPair.second.first.second.second = 0;
-		//tmpPair.second.second = idxPos;
-		bLearner._leftChildIdxSet = idxPos;
-	} else {
-		BaseLearner* pConstantWeakHypothesisSource = 
-			BaseLearner::RegisteredLearners().getLearner("ConstantLearner");
 
-		BaseLearner* posLearner = pConstantWeakHypothesisSource->create();
-		posLearner->setTrainingData(_pTrainingData);
-		//float constantEnergy = posLearner->run();
-		dynamic_cast<FeaturewiseLearner*>(posLearner)->run( depthIndex );
+	if ( static_cast<int>( views.size() ) == numChildren ) {
+#pragma omp parallel for num_threads(_numThreads) schedule(dynamic) copyin(BaseLearner::_smoothingVal)
+		for( int c = 0; c < numChildren; ++c )
+			children[c] = trainChild( views[c], colIdxs[c], edges[c] );
 
-		//BaseLearner* posLearner = _baseLearners[0]->copyState();
-		//float posEdge = getEdge( posLearner, _pTrainingData );
-		posLearner->setTrainingData( _pTrainingData );
-		bLearner._leftEdge = posLearner->getEdge();
+		for( int c = 0; c < numChildren; ++c ) {
+			children[c]->setTrainingData( _pTrainingData );
+			delete views[c];
+		}
+	} else {
+		for( int c = 0; c < static_cast<int>( views.size() ); ++c )
+			delete views[c];
 
-		//tmpPair.first = posEdge;
-		//tmpPair.second.first.first = posLearner;
-		bLearner._leftChild = posLearner;
-		//set the parent idx to zero
-		//tmpPair.second.first.second.first = 0;
-		//this means that it will be a left child in the tree
-		//tmpPair.second.first.second.second = 0;
-		//tmpPair.second.second = idxPos;
-		bLearner._leftChildIdxSet = idxPos;
+		for( int c = 0; c < numChildren; ++c ) {
+			_pTrainingData->selectPartitionNode( childNodeIdxs[c] );
+			children[c] = trainChild( _pTrainingData, colIdxs[c], edges[c] );
+		}
 	}
 
-	//retval.push_back( tmpPair );
+	for( int n = 0; n < numNodes; ++n ) {
+		NodePointUCT& bLearner = *nodes[n];
+		bLearner._leftChild = children[2*n];
+		bLearner._leftEdge = edges[2*n];
+		bLearner._leftChildNodeIdx = childNodeIdxs[2*n];
+		bLearner._rightChild = children[2*n+1];
+		bLearner._rightEdge = edges[2*n+1];
+		bLearner._rightChildNodeIdx = childNodeIdxs[2*n+1];
+	}
+}
 
-	_pTrainingData->loadIndexSet( idxNeg );
+// -----------------------------------------------------------------------
 
-	if ( ! _pTrainingData->isSamplesFromOneClass() ) {
-		BaseLearner* negLearner = _baseLearners[0]->copyState();
+BaseLearner* TreeLearnerUCT::trainChild( InputData* pData, int colIdx, float& edge ) {
+	BaseLearner* pChild;
 
-		
-		//negLearner->run();
-		dynamic_cast<FeaturewiseLearner*>(negLearner)->run( depthIndex );
-		//float negEdge = getEdge( negLearner, _pTrainingData );
-
-		negLearner->setTrainingData( _pTrainingData );
-		bLearner._rightEdge = negLearner->getEdge();
-		//tmpPair.first = negEdge;
-		//tmpPair.second.first.first = negLearner;
-		bLearner._rightChild = negLearner;
-		//set the parent idx to zero
-		//tmpPair.second.first.second.first = 0;
-		//this means that it will be a right child in the tree
-		//tmpPair.second.first.second.second = 1;
-		//tmpPair.second.second = idxNeg;
-		bLearner._rightChildIdxSet = idxNeg;
+	if ( ! pData->isSamplesFromOneClass() ) {
+		pChild = _baseLearners[0]->copyState();
 	} else {
 		BaseLearner* pConstantWeakHypothesisSource = 
 			BaseLearner::RegisteredLearners().getLearner("ConstantLearner");
-
-		BaseLearner* negLearner =  pConstantWeakHypothesisSource->create();
-		negLearner->setTrainingData(_pTrainingData);
-		//float constantEnergy = negLearner->run();
-		dynamic_cast<FeaturewiseLearner*>(negLearner)->run( depthIndex );
-
-		//tmpPair.first = getEdge( negLearner, _pTrainingData );;
-		bLearner._rightChild = negLearner;
-		bLearner._rightChild = negLearner;
-		//tmpPair.second.first.first = negLearner;
-		//set the parent idx to zero
-		//tmpPair.second.first.second.first = 0;
-		//this means that it will be a right child in the tree
-		//tmpPair.second.first.second.second = 1;
-		//tmpPair.second.second = idxNeg;
-		bLearner._rightChildIdxSet = idxNeg;
+		pChild = pConstantWeakHypothesisSource->create();
 	}
 
-	//retval.push_back( tmpPair );
+	pChild->setTrainingData( pData );
+	// the constant learner has no column to choose
+	FeaturewiseLearner* pFeaturewiseChild = dynamic_cast<FeaturewiseLearner*>(pChild);
+	if ( pFeaturewiseChild )
+		pFeaturewiseChild->run( colIdx );
+	else
+		pChild->run();
+	edge = pChild->getEdge();
 
-	//return retval;
+	return pChild;
 }
 
 
@@ -655,6 +666,7 @@ void TreeLearnerUCT::subCopyState(BaseLearner *pBaseLearner)
 		dynamic_cast<TreeLearnerUCT*>(pBaseLearner);
 
 	pTreeLearnerUCT->_numBaseLearners = _numBaseLearners;
+	pTreeLearnerUCT->_numThreads = _numThreads;
 
 	// deep copy
 	for(int ib = 0; ib < _numBaseLearners; ++ib)
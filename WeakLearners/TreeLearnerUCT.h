@@ -82,15 +82,16 @@ namespace MultiBoost {
 		}
 	};
 
-	struct NodePoint {
+	struct NodePointUCT {
 		BaseLearner* _learner;
 
 		BaseLearner* _rightChild;
 		BaseLearner* _leftChild;
 		
-		set< int >   _rightChildIdxSet;
-		set< int >   _leftChildIdxSet;
-		set< int >   _learnerIdxSet;
+		// the nodes of the partition of the training data (see InputData::beginPartition())
+		int			_rightChildNodeIdx;
+		int			_leftChildNodeIdx;
+		int			_learnerNodeIdx;
 
 		float		_rightEdge;
 		float		_leftEdge;
@@ -104,7 +105,7 @@ namespace MultiBoost {
 
 		int			_depth;
 	};
-	typedef pair< float, NodePoint > floatInnerNode;
+	typedef pair< float, NodePointUCT > floatInnerNodeUCT;
 
 	/**
 	* A learner that loads a set of base learners, and boosts on the top of them. 
@@ -118,7 +119,7 @@ namespace MultiBoost {
 		* The constructor. It initializes _numBaseLearners to -1
 		* \date 26/05/2007
 		*/
-		TreeLearnerUCT() : _numBaseLearners(-1) { }
+		TreeLearnerUCT() : _numBaseLearners(-1), _numThreads(1) { }
 
 		/**
 		* The destructor. Must be declared (virtual) for the proper destruction of 
@@ -223,7 +224,24 @@ namespace MultiBoost {
 		//virtual double getEdge();
 
 	protected:
-		void calculateChildrenAndEnergies( NodePoint& bLearner, int depthIndex );
+		/**
+		* Split the given nodes and train the two children of each of them, 
+		* concurrently with --treethreads (see TreeLearner).
+		* \param nodes The nodes to be extended.
+		* \param trajectory The columns chosen by the UCT for each depth.
+		* \date 18/10/2026
+		*/
+		void calculateChildrenAndEnergies( const vector<NodePointUCT*>& nodes, const vector<int>& trajectory );
+
+		/**
+		* Train a child on the given data and column.
+		* \param pData The examples of the child.
+		* \param colIdx The column chosen by the UCT.
+		* \param edge The returned edge of the child.
+		* \return The trained child.
+		* \date 18/10/2026
+		*/
+		BaseLearner* trainChild( InputData* pData, int colIdx, float& edge );
 
 
 		vector<BaseLearner*> _baseLearners; //!< the learners of the product
@@ -232,6 +250,7 @@ namespace MultiBoost {
 		*/
 		vector< vector<int> > _idxPairs; 
 		int _numBaseLearners;
+		int _numThreads; //!< The number of threads training the children of the nodes.
 
 		static int _numOfCalling; //number of the single stump learner have been called
 		static InnerNodeUCTSparse	_root;
@@ -41,6 +41,7 @@
 #include "Algorithms/StumpAlgorithm.h"
 
 #include <limits> // for numeric_limits
+#include <algorithm> // for sort, lower_bound
 #include <ctime> // for time
 #include <math.h>
 
@@ -49,27 +50,36 @@ namespace MultiBoost {
 	REGISTER_LEARNER_NAME(UCBVHaarSingleStump, UCBVHaarSingleStumpLearner)
 
 
-	map<int,FeatureDataUCBV> UCBVHaarSingleStumpLearner::_featuresData;
+	vector<int> UCBVHaarSingleStumpLearner::_armKeys;
+	vector<int> UCBVHaarSingleStumpLearner::_armNumPulls;
+	vector<double> UCBVHaarSingleStumpLearner::_armMeans;
+	vector<double> UCBVHaarSingleStumpLearner::_armSumSquares;
+	vector<int> UCBVHaarSingleStumpLearner::_armOfConfig;
+	vector<int> UCBVHaarSingleStumpLearner::_configOffsets;
 	int UCBVHaarSingleStumpLearner::_numOfCalling = 0;
 
 	//-------------------------------------------------------------------------------
 	void UCBVHaarSingleStumpLearner::init() {
-		UCBVHaarSingleStumpLearner::_featuresData.clear();
 		UCBVHaarSingleStumpLearner::_numOfCalling = 1;
 
 		//choose randomly the feature for the UCBV
 		HaarData* pHaarData = static_cast<HaarData*>(_pTrainingData);
 		vector<HaarFeature*>& loadedFeatures = pHaarData->getLoadedFeatures();
 
+		// the configurations of all the feature types are addressed in a single table
+		const int numTypes = static_cast<int>(loadedFeatures.size());
+		_configOffsets.resize( numTypes + 1 );
+		_configOffsets[0] = 0;
+		for (int t = 0; t < numTypes; ++t)
+			_configOffsets[t+1] = _configOffsets[t] + loadedFeatures[t]->getNumConfigs();
+		_armOfConfig.assign( _configOffsets[numTypes], -1 );
+		_armKeys.clear();
+
 		int numConf = 0;
 		bool quitConfiguration;
 		long numProcessed;
-		FeatureDataUCBV tmpFeatureData;
 		int confIdx = 0;
 
-		tmpFeatureData.T = 0;
-		tmpFeatureData.X.clear();
-		
 		vector<HaarFeature*>::iterator ftIt;
 		for (ftIt = loadedFeatures.begin(), confIdx = 0; ftIt != loadedFeatures.end(); ++ftIt, confIdx++)
 		{
@@ -98,7 +108,7 @@ namespace MultiBoost {
 				//cout << key << "\t" <<  pCurrFeature->getType() << endl;
 				//cout << (int) (key / 10) << "\t" << (key % 10) << endl;
 
-				UCBVHaarSingleStumpLearner::_featuresData[key] = tmpFeatureData;
+				_armKeys.push_back( key );
 
 				// check stopping criterion for random configurations
 				switch (_samplingType)
@@ -121,7 +131,18 @@ namespace MultiBoost {
 			} // end while
 		}
 
-		cout << "The number of the randomly chosen features:\t" << UCBVHaarSingleStumpLearner::_featuresData.size() << endl;
+		// the arms are visited in the order of their keys
+		sort( _armKeys.begin(), _armKeys.end() );
+		_armKeys.erase( unique( _armKeys.begin(), _armKeys.end() ), _armKeys.end() );
+
+		const int numArms = static_cast<int>(_armKeys.size());
+		_armNumPulls.assign( numArms, 0 );
+		_armMeans.assign( numArms, 0.0 );
+		_armSumSquares.assign( numArms, 0.0 );
+		for (int arm = 0; arm < numArms; ++arm)
+			_armOfConfig[ _configOffsets[_armKeys[arm] % 10] + _armKeys[arm] / 10 ] = arm;
+
+		cout << "The number of the randomly chosen features:\t" << numArms << endl;
 	}
 	// ------------------------------------------------------------------------------
 
@@ -166,40 +187,67 @@ namespace MultiBoost {
 
 	//-------------------------------------------------------------------------------
 
-	float UCBVHaarSingleStumpLearner::getBValue( int key )
+	int UCBVHaarSingleStumpLearner::getArm( int key )
 	{
-		float retval = numeric_limits<float>::max();
-		map<int,FeatureDataUCBV>::const_iterator itUCBV = UCBVHaarSingleStumpLearner::_featuresData.find( key );
-		
-		if ( itUCBV != UCBVHaarSingleStumpLearner::_featuresData.end() ) 
-		{
-			int s = itUCBV->second.X.size();
-			
-			if ( s == 0 ) return retval;
-
-			float epsilonT = getTthSeriesElement( UCBVHaarSingleStumpLearner::_numOfCalling );
-			retval = (3.0 * epsilonT ) / s;
-			//claculate the average reward
-			float avgX = 0.0;
-			for( int i = 0; i < s; i++ )
-			{
-				avgX += itUCBV->second.X[i];
-			}
-			avgX /= s;
-			
-			//claculate the variance of rewards
-			float varX = 0.0;
-			for( int i = 0; i < s; i++ )
-			{
-				varX += ( itUCBV->second.X[i] - avgX ) * ( itUCBV->second.X[i] - avgX );
-			}
-			varX /= s;
+		const int featureType = key % 10;
+		const int featureIdx = key / 10;
+		if ( key >= 0 && featureType + 1 < static_cast<int>(_configOffsets.size()) &&
+			 featureIdx < _configOffsets[featureType+1] - _configOffsets[featureType] )
+			return _armOfConfig[ _configOffsets[featureType] + featureIdx ];
+
+		// not a loaded configuration, it can only have been added by updateKeys()
+		vector<int>::const_iterator it = lower_bound( _armKeys.begin(), _armKeys.end(), key );
+		if ( it == _armKeys.end() || *it != key )
+			return -1;
+		return static_cast<int>( it - _armKeys.begin() );
+	}
 
-			retval += ( avgX + sqrt( ( 2.0 * varX * epsilonT ) / ( s ) ) ); 
+	//-------------------------------------------------------------------------------
+
+	int UCBVHaarSingleStumpLearner::addArm( int key )
+	{
+		const int arm = static_cast<int>( lower_bound( _armKeys.begin(), _armKeys.end(), key ) - _armKeys.begin() );
+		_armKeys.insert( _armKeys.begin() + arm, key );
+		_armNumPulls.insert( _armNumPulls.begin() + arm, 0 );
+		_armMeans.insert( _armMeans.begin() + arm, 0.0 );
+		_armSumSquares.insert( _armSumSquares.begin() + arm, 0.0 );
+
+		// the arms after the new one have been shifted
+		for (int a = arm; a < static_cast<int>(_armKeys.size()); ++a)
+		{
+			const int featureType = _armKeys[a] % 10;
+			if ( featureType + 1 < static_cast<int>(_configOffsets.size()) &&
+				 _armKeys[a] / 10 < _configOffsets[featureType+1] - _configOffsets[featureType] )
+				_armOfConfig[ _configOffsets[featureType] + _armKeys[a] / 10 ] = a;
 		}
+		return arm;
+	}
+
+	//-------------------------------------------------------------------------------
 
+	float UCBVHaarSingleStumpLearner::getArmBValue( int arm, float epsilonT )
+	{
+		const int s = _armNumPulls[arm];
+		if ( s == 0 ) return numeric_limits<float>::max();
+
+		float retval = (3.0 * epsilonT ) / s;
+		const float avgX = static_cast<float>( _armMeans[arm] );
+		const float varX = static_cast<float>( _armSumSquares[arm] / s );
+
+		retval += ( avgX + sqrt( ( 2.0 * varX * epsilonT ) / ( s ) ) ); 
 		return retval;
 	}
+
+	//-------------------------------------------------------------------------------
+
+	float UCBVHaarSingleStumpLearner::getBValue( int key )
+	{
+		const int arm = getArm( key );
+		if ( arm < 0 ) 
+			return numeric_limits<float>::max();
+
+		return getArmBValue( arm, getTthSeriesElement( UCBVHaarSingleStumpLearner::_numOfCalling ) );
+	}
 	
 	// ------------------------------------------------------------------------------
 
@@ -257,7 +305,8 @@ namespace MultiBoost {
 		vector<int> maxNum( loadedFeatures.size() );
 		
 		//claculate the Bk,s,t of the randomly chosen features
-		int key = getKeyOfMaximalElement();
+		const int arm = getMaximalArm();
+		int key = _armKeys[arm];
 		int featureIdx = (int) (key / 10);
 		int featureType = (key % 10);
 
@@ -315,7 +364,7 @@ namespace MultiBoost {
 		float edge = 0.0;
 		for( vector<sRates>::iterator itR = mu.begin(); itR != mu.end(); itR++ ) edge += ( itR->rPls - itR->rMin ); 
 		//need to set the X value
-		updateKeys( key, edge * edge );
+		updateArm( arm, edge * edge );
 		
 		if (!_pSelectedFeature)
 		{
@@ -331,43 +380,56 @@ namespace MultiBoost {
 		return bestEnergy;
 	}
 	
-	int UCBVHaarSingleStumpLearner::getKeyOfMaximalElement()
+	// ------------------------------------------------------------------------------
+
+	int UCBVHaarSingleStumpLearner::getMaximalArm()
 	{
-		int key;
+		const float epsilonT = getTthSeriesElement( UCBVHaarSingleStumpLearner::_numOfCalling );
+		const int numArms = static_cast<int>(_armKeys.size());
+
+		int bestArm = 0;
 		float maxVal = numeric_limits<float>::min();
-		map<int,FeatureDataUCBV>::iterator itUCBV;
-		
-		for( itUCBV = UCBVHaarSingleStumpLearner::_featuresData.begin(); itUCBV != _featuresData.end(); itUCBV++ )
+		for (int arm = 0; arm < numArms; ++arm)
 		{
-			float val = getBValue( itUCBV->first );
+			// an arm that has not been pulled yet wins
+			if ( _armNumPulls[arm] == 0 ) 
+				return arm;
+
+			const float val = getArmBValue( arm, epsilonT );
 			if ( val > maxVal ) 
 			{
 				maxVal = val;
-				key = itUCBV->first;
-
-				if ( maxVal == numeric_limits<float>::max() ) break;
+				bestArm = arm;
 			}
 		}
-		return key;
+		return bestArm;
+	}
+
+	// ------------------------------------------------------------------------------
+
+	int UCBVHaarSingleStumpLearner::getKeyOfMaximalElement()
+	{
+		return _armKeys[ getMaximalArm() ];
 	}
 
 	// ------------------------------------------------------------------------------
+
+	void UCBVHaarSingleStumpLearner::updateArm( int arm, float val )
+	{
+		const int s = ++_armNumPulls[arm];
+		const double delta = val - _armMeans[arm];
+		_armMeans[arm] += delta / s;
+		_armSumSquares[arm] += delta * ( val - _armMeans[arm] );
+	}
+
+	// ------------------------------------------------------------------------------
+
 	void UCBVHaarSingleStumpLearner::updateKeys( int key, float val )
 	{		
-		map<int,FeatureDataUCBV>::const_iterator itUCBV = UCBVHaarSingleStumpLearner::_featuresData.find( key );
-		FeatureDataUCBV tmp;
-
-		if ( itUCBV == UCBVHaarSingleStumpLearner::_featuresData.end() ) 
-		{
-			tmp.T = 1;
-			tmp.X.push_back( val );
-			UCBVHaarSingleStumpLearner::_featuresData[ key ] = tmp;
-		} else {
-			tmp = itUCBV->second;
-			tmp.T++;
-			tmp.X.push_back( val );
-			UCBVHaarSingleStumpLearner::_featuresData[ key ] = tmp;
-		}
+		int arm = getArm( key );
+		if ( arm < 0 ) 
+			arm = addArm( key );
+		updateArm( arm, val );
 	}
 	// ------------------------------------------------------------------------------
 
@@ -47,7 +47,7 @@
 
 #include "Utils/Utils.h"
 
-#include <map>
+#include <vector>
 
 using namespace std;
 
@@ -55,11 +55,6 @@ using namespace std;
 //////////////////////////////////////////////////////////////////////////////////////////////
 
 namespace MultiBoost {
-	struct FeatureDataUCBV {
-		int T;
-		vector< float > X;
-	};
-
 	class HaarData;
 
 	/**
@@ -201,12 +196,44 @@ namespace MultiBoost {
 		virtual void getStateData( vector<float>& data, const string& /*reason = ""*/, InputData* pData = 0 );
 		
 		/**
+		* The UCB-V index of the feature configuration \a key (10*configIdx+featureType).
+		* FLT_MAX if it has not been pulled yet.
 		*/
 		virtual float getBValue( int key );
 		virtual void updateKeys( int key, float val );
 		virtual int getKeyOfMaximalElement();
 	private:
 
+		/**
+		* Return the arm of the given key, -1 if it is not an arm.
+		* \date 18/10/2026
+		*/
+		static int getArm( int key );
+
+		/**
+		* Add a new arm with the given key, keeping the arms sorted by key.
+		* \date 18/10/2026
+		*/
+		static int addArm( int key );
+
+		/**
+		* The UCB-V index of an arm, computed in O(1) from its running statistics.
+		* \date 18/10/2026
+		*/
+		static float getArmBValue( int arm, float epsilonT );
+
+		/**
+		* The arm with the maximal UCB-V index (the first one of the ties).
+		* \date 18/10/2026
+		*/
+		int getMaximalArm();
+
+		/**
+		* Add a reward to the running mean and variance of an arm (Welford's update).
+		* \date 18/10/2026
+		*/
+		static void updateArm( int arm, float val );
+
 		/**
 		* A discriminative function. 
 		* \remarks Positive or negative do NOT refer to positive or negative classification.
@@ -218,7 +245,22 @@ namespace MultiBoost {
 		*/
 		virtual float phi(float val, int /*classIdx*/) const;
 
-		static map<int,FeatureDataUCBV> _featuresData;
+		/**
+		* The state of the arms, indexed by arm and sorted by key (10*configIdx+featureType).
+		* Only the number of pulls and the running mean and sum of squared deviations of
+		* the rewards are kept, so the memory does not grow with the number of iterations.
+		*/
+		static vector<int> _armKeys;
+		static vector<int> _armNumPulls; //!< The number of times the arm has been pulled.
+		static vector<double> _armMeans; //!< The mean of the rewards of the arm.
+		static vector<double> _armSumSquares; //!< The sum of the squared deviations of the rewards from the mean.
+
+		/**
+		* The arm of a configuration, -1 if it has not been chosen: the arm of 
+		* configuration c of the feature type t is _armOfConfig[_configOffsets[t] + c].
+		*/
+		static vector<int> _armOfConfig;
+		static vector<int> _configOffsets; //!< The offset of the configurations of the feature types in _armOfConfig.
 		static int _numOfCalling; //number of the single stump learner have been called
 	};
 
@@ -151,6 +151,9 @@
 #include "StrongLearners/AdaBoostMHLearner.h" // for --encode
 #include "IO/OutputInfo.h" // for --encode
 #include "Bandits/GenericBanditAlgorithm.h" 
+#include "Utils/MicroBenchmark.h" // for --benchmark
+#include "Classifiers/PosteriorsServer.h" // for --serve
+#include "Utils/Profiler.h" // for --profile
 
 using namespace std;
 using namespace MultiBoost;
@@ -335,6 +338,15 @@ int main(int argc, const char* argv[])
 	
 	args.declareArgument("ssfeatures", "Print matrix data for SingleStump-Based weak learners (if numIters=0 it means all of them).", 4, "<dataFile> <shypFile> <outFile> <numIters>");
 	
+	args.declareArgument("benchmark", "Time the kernels of the learning and the classification on synthetic data,\n"
+						 "  and write the throughputs and the peak memory of the process to <outFile> (tab separated).", 4, "<numExamples> <numFeatures> <numClasses> <outFile>");
+	
+	args.declareArgument("serve", "Load the models once, and output the posteriors of the examples read line by line on the standard input\n"
+						 "  (ARFF sparse or SVMLight syntax), one line per example. The header file gives the attributes\n"
+						 "  and the classes, the models are separated by commas.", 2, "<headerFile> <shypFile>[,<shypFile>...]");
+	args.declareArgument("serve", "The same, answering the clients of a local (UNIX) socket.", 3, "<headerFile> <shypFile>[,<shypFile>...] <socketPath>");
+	args.declareArgument("servebatch", "The maximum number of examples classified together by --serve (default: 256).", 1, "<num>");
+	
 	args.declareArgument( "fileformat", "Defines the type of intput file. Available types are:\n" 
 						 "* simple: each line has attributes separated by whitespace and class at the end (DEFAULT!)\n"
 						 "* arff: arff filetype. The header file can be specified using --arffheader option\n"
@@ -378,11 +390,25 @@ int main(int argc, const char* argv[])
 	args.declareArgument("examplename", "The data file has an additional column (the very first) which contains the 'name' of the example.");
 	/////////////////////////////////////////////
 	
+	// preprocessing done while parsing (applied to both train and test files)
+	args.declareArgument("selectcolumns", "Keep only the attributes listed (by name, separated by white spaces) in the given file.\n"
+						 "For the simple format the attributes are named by their 0-based index.", 1, "<fileName>");
+	args.declareArgument("missingvalue", "Replace the missing values of the numeric attributes with the given value.", 1, "<val>");
+	args.declareArgument("quantize", "Round the values of the numeric attributes to the nearest multiple of <step>.", 1, "<step>");
+	args.declareArgument("shareddata", "Share the sorted columns of the training data with the other processes through a file\n"
+						 "mapped read-only: the first process writes it, the next ones using the same data map it\n"
+						 "instead of sorting again. The file is replaced if it belongs to other data.", 1, "<fileName>");
+	args.declareArgument("enumthreads", "The number of threads summing the weights per value of the enum attributes\n"
+						 "(EnumLearnerSA and IndicatorLearner).", 1, "<numThreads>");
+	args.declareArgument("featurehashing", "Map the sparse features (svmlight and lshtc formats) into 2^<bits> columns\n"
+						 "with the hashing trick, without storing their names. The seed is saved in the shyp file.", 2, "<bits> <seed>");
+	
 	args.setGroup("Basic Algorithm Options");
 	args.declareArgument("weightpolicy", "Specify the type of weight initialization. The user specified weights (if available) are used inside the policy which can be:\n"
 						 "* sharepoints Share the weight equally among data points and between positiv and negative labels (DEFAULT)\n"
 						 "* sharelabels Share the weight equally among data points\n"
 						 "* proportional Share the weights freely", 1, "<weightType>");
+	args.declareArgument("weightthreads", "The number of threads initializing the weights with the weight policy.", 1, "<numThreads>");
 	
 	
 	args.setGroup("General Options");
@@ -390,6 +416,9 @@ int main(int argc, const char* argv[])
 	args.declareArgument("verbose", "Set the verbose level 0, 1 or 2 (0=no messages, 1=default, 2=all messages).", 1, "<val>");
 	args.declareArgument("outputinfo", "Output informations on the algorithm performances during training, on file <filename>.", 1, "<filename>");
 	args.declareArgument("seed", "Defines the seed for the random operations.", 1, "<seedval>");
+	args.declareArgument("profile", "Time the phases of the learning and count the work of the weak learners.\n"
+						 "The values of each iteration are added to the lines of --outputinfo,\n"
+						 "and the totals are printed at the end.");
 	
 	//////////////////////////////////////////////////////////////////////////
 	// Shows the list of available learners
@@ -479,6 +508,9 @@ int main(int argc, const char* argv[])
 		srand(seed);
 	}
 	
+	if (args.hasArgument("profile"))
+		Profiler::enable();
+	
 	//////////////////////////////////////////////////////////////////////////////////////////  
 	//////////////////////////////////////////////////////////////////////////////////////////
 	
@@ -533,6 +565,8 @@ int main(int argc, const char* argv[])
 	}
 	//////////////////////////////////////////////////////////////////////////////////////////
 	//////////////////////////////////////////////////////////////////////////////////////////
+	// -likelihood, -roc, -posteriors and -cposteriors can be given together: the 
+	// strong learner computes all of them in a single pass over the model
 	else if ( args.hasArgument("likelihood") )
 	{
 		// -posteriors <dataFile> <shypFile> <outFileName>
@@ -601,6 +635,29 @@ int main(int argc, const char* argv[])
 		//classifier.saveSingleStumpFeatureData(testFileName, shypFileName, outFileName, numIterations);
 	}
 	
+	//////////////////////////////////////////////////////////////////////////////////////////
+	//////////////////////////////////////////////////////////////////////////////////////////
+	else if ( args.hasArgument("benchmark") )
+	{
+		// --benchmark <numExamples> <numFeatures> <numClasses> <outFile>
+		MicroBenchmark benchmark( args.getValue<int>("benchmark", 0), 
+								  args.getValue<int>("benchmark", 1), 
+								  args.getValue<int>("benchmark", 2), verbose );
+		benchmark.run( args.getValue<string>("benchmark", 3) );
+	}
+	//////////////////////////////////////////////////////////////////////////////////////////
+	//////////////////////////////////////////////////////////////////////////////////////////
+	else if ( args.hasArgument("serve") )
+	{
+		// --serve <headerFile> <shypFiles> [<socketPath>]
+		PosteriorsServer server(args, verbose);
+		server.load( args.getValue<string>("serve", 0), args.getValue<string>("serve", 1) );
+		
+		if ( args.getNumValues("serve") > 2 )
+			server.serveSocket( args.getValue<string>("serve", 2) );
+		else
+			server.serveStandardInput();
+	}
 	//////////////////////////////////////////////////////////////////////////////////////////
 	//////////////////////////////////////////////////////////////////////////////////////////
 	else if ( args.hasArgument("encode") )
@@ -697,7 +754,10 @@ int main(int argc, const char* argv[])
 				alphas[pWeakHypothesis->getSelectedIndex()] += 
 				pWeakHypothesis->getAlpha() * pWeakHypothesis->getSignOfAlpha();
 				if ( pOutInfo )
+				{
 					adaBoostMHLearner.printOutputInfo(pOutInfo, t, pOnePoint, NULL, pWeakHypothesis);
+					pOutInfo->endLine();
+				}
 				adaBoostMHLearner.updateWeights(pOnePoint,pWeakHypothesis);
 			}
 			float sumAlphas = 0;
@@ -718,6 +778,9 @@ int main(int argc, const char* argv[])
 	if (pModel)
 		delete pModel;
 	
+	// --profile
+	Profiler::printSummary(cout);
+	
 	return 0;
 }
 